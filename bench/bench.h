@@ -0,0 +1,253 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vision::bench
+{
+    /**
+     * @brief Gets the number of heap allocations made so far, on any thread.
+     *
+     * Counts every call to the replaceable operator new of the benchmark executable.
+     *
+     * @return std::uint64_t The allocation count.
+     */
+    std::uint64_t allocationCount();
+
+    /**
+     * @class state
+     * @brief Per-benchmark measurement state.
+     *
+     * A benchmark either times a body with measure(), one sample per iteration, times
+     * single runs with time(), or records its own samples with record() when it times
+     * work on several threads. measure() and time() also count the heap allocations of
+     * the timed code; benchmarks using record() report theirs with addAllocations().
+     */
+    class state {
+    private:
+        std::size_t iterations; ///< Requested number of timed iterations.
+        std::vector<std::int64_t> samples; ///< Recorded latencies in nanoseconds.
+        std::uint64_t items_per_iteration = 0; ///< Items processed per iteration, for throughput.
+        std::vector<std::pair<std::string, double>> counters; ///< User counters.
+        std::uint64_t allocations = 0; ///< Heap allocations of the counted iterations.
+        std::size_t allocation_iterations = 0; ///< Iterations whose allocations were counted.
+
+    public:
+        /**
+         * @brief Constructs a state.
+         *
+         * @param iterations Requested number of timed iterations.
+         */
+        explicit state(const std::size_t iterations) : iterations(iterations)
+        {
+            samples.reserve(iterations);
+        }
+
+        /**
+         * @brief Gets the requested number of iterations.
+         *
+         * @return std::size_t The iteration count.
+         */
+        [[nodiscard]] std::size_t getIterations() const
+        {
+            return iterations;
+        }
+
+        /**
+         * @brief Runs the body a few untimed times, then once per iteration, recording each run.
+         *
+         * @param body The code under test.
+         */
+        template<typename Body>
+        void measure(Body&& body)
+        {
+            for(std::size_t i = 0; i < std::min<std::size_t>(iterations / 10 + 1, 10); ++i)
+                body();
+            const std::uint64_t allocations_before = allocationCount();
+            for(std::size_t i = 0; i < iterations; ++i)
+            {
+                const auto begin = std::chrono::steady_clock::now();
+                body();
+                const auto end = std::chrono::steady_clock::now();
+                samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+            }
+            addAllocations(allocationCount() - allocations_before, iterations);
+        }
+
+        /**
+         * @brief Runs the body once, recording its latency and allocations as one iteration.
+         *
+         * Lets a benchmark prepare every iteration outside the timed region.
+         *
+         * @param body The code under test.
+         */
+        template<typename Body>
+        void time(Body&& body)
+        {
+            const std::uint64_t allocations_before = allocationCount();
+            const auto begin = std::chrono::steady_clock::now();
+            body();
+            const auto end = std::chrono::steady_clock::now();
+            const std::uint64_t allocations_after = allocationCount();
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+            addAllocations(allocations_after - allocations_before, 1);
+        }
+
+        /**
+         * @brief Records one latency sample. Not thread-safe; merge per-thread samples first.
+         *
+         * @param nanoseconds The sample.
+         */
+        void record(const std::int64_t nanoseconds)
+        {
+            samples.push_back(nanoseconds);
+        }
+
+        /**
+         * @brief Adds heap allocations counted over a number of iterations.
+         *
+         * @param count Allocations, typically a difference of allocationCount() values.
+         * @param _iterations Iterations the allocations were made in.
+         */
+        void addAllocations(const std::uint64_t count, const std::size_t _iterations)
+        {
+            allocations += count;
+            allocation_iterations += _iterations;
+        }
+
+        /**
+         * @brief Sets the number of items one iteration processes.
+         *
+         * @param items Items per iteration.
+         */
+        void setItemsPerIteration(const std::uint64_t items)
+        {
+            items_per_iteration = items;
+        }
+
+        /**
+         * @brief Adds a named value to the report.
+         *
+         * @param name Counter name.
+         * @param value Counter value.
+         */
+        void setCounter(std::string name, const double value)
+        {
+            counters.emplace_back(std::move(name), value);
+        }
+
+        /**
+         * @brief Gets the recorded samples.
+         *
+         * @return std::vector<std::int64_t>& The samples in nanoseconds.
+         */
+        [[nodiscard]] std::vector<std::int64_t>& getSamples()
+        {
+            return samples;
+        }
+
+        /**
+         * @brief Gets the number of items one iteration processes.
+         *
+         * @return std::uint64_t Items per iteration.
+         */
+        [[nodiscard]] std::uint64_t getItemsPerIteration() const
+        {
+            return items_per_iteration;
+        }
+
+        /**
+         * @brief Gets the user counters.
+         *
+         * @return const std::vector<std::pair<std::string, double>>& The counters.
+         */
+        [[nodiscard]] const std::vector<std::pair<std::string, double>>& getCounters() const
+        {
+            return counters;
+        }
+
+        /**
+         * @brief Checks if the benchmark counted its allocations.
+         *
+         * @return bool True if getAllocationsPerIteration() is meaningful.
+         */
+        [[nodiscard]] bool hasAllocations() const
+        {
+            return allocation_iterations > 0;
+        }
+
+        /**
+         * @brief Gets the mean number of heap allocations per counted iteration.
+         *
+         * @return double The allocations per iteration, or 0 if none were counted.
+         */
+        [[nodiscard]] double getAllocationsPerIteration() const
+        {
+            return allocation_iterations > 0
+                   ? static_cast<double>(allocations) / static_cast<double>(allocation_iterations) : 0.0;
+        }
+    };
+
+    /**
+     * @struct bench_case
+     * @brief A registered benchmark.
+     */
+    struct bench_case
+    {
+        std::string name; ///< Name, used for filtering.
+        std::size_t iterations; ///< Default iteration count.
+        std::function<void(state&)> body; ///< Benchmark body.
+    };
+
+    /**
+     * @brief Gets the list of registered benchmarks.
+     *
+     * @return std::vector<bench_case>& The registry.
+     */
+    inline std::vector<bench_case>& registry()
+    {
+        static std::vector<bench_case> cases;
+        return cases;
+    }
+
+    /**
+     * @struct registrar
+     * @brief Registers a benchmark during static initialization.
+     */
+    struct registrar
+    {
+        registrar(std::string name, const std::size_t iterations, std::function<void(state&)> body)
+        {
+            registry().push_back({std::move(name), iterations, std::move(body)});
+        }
+    };
+
+    /**
+     * @brief Keeps the compiler from optimizing a value away.
+     *
+     * @param value The value.
+     */
+    template<typename T>
+    void doNotOptimize(T const& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+}
+
+/// Defines and registers a benchmark: VISION_BENCH(suite_name, iterations) { ... uses state ... }
+#define VISION_BENCH(name, iterations) \
+    static void name(vision::bench::state& state); \
+    static const vision::bench::registrar name##_registrar(#name, iterations, name); \
+    static void name([[maybe_unused]] vision::bench::state& state)
+
+#endif //BENCH_H
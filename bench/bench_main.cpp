@@ -0,0 +1,251 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include "bench.h"
+
+using namespace vision::bench;
+
+namespace
+{
+    std::atomic<std::uint64_t> allocations{0}; ///< Calls to operator new since start-up.
+
+    void* allocate(const std::size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if(void* pointer = std::malloc(size != 0 ? size : 1))
+            return pointer;
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(const std::size_t size, const std::align_val_t alignment)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        const auto align = static_cast<std::size_t>(alignment);
+        // aligned_alloc wants a size that is a multiple of the alignment.
+        if(void* pointer = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align))
+            return pointer;
+        throw std::bad_alloc();
+    }
+}
+
+// Counting replacements of the global allocation functions. The array, nothrow and sized
+// forms of the standard library forward to these.
+void* operator new(const std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+std::uint64_t vision::bench::allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+namespace
+{
+    /**
+     * @struct summary
+     * @brief Statistics of one benchmark run.
+     */
+    struct summary
+    {
+        std::size_t samples = 0; ///< Number of samples.
+        double mean = 0.0; ///< Mean latency in nanoseconds.
+        double p50 = 0.0;  ///< Median latency in nanoseconds.
+        double p99 = 0.0;  ///< 99th percentile latency in nanoseconds.
+        double p999 = 0.0; ///< 99.9th percentile latency in nanoseconds.
+        double items_per_second = 0.0; ///< Throughput, or 0 if the benchmark sets no item count.
+    };
+
+    double percentile(const std::vector<std::int64_t>& sorted, const double fraction)
+    {
+        if(sorted.empty())
+            return 0.0;
+        const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+        return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]);
+    }
+
+    summary summarize(state& _state)
+    {
+        auto& samples = _state.getSamples();
+        std::sort(samples.begin(), samples.end());
+
+        summary result;
+        result.samples = samples.size();
+        double total = 0.0;
+        for(const auto sample : samples)
+            total += static_cast<double>(sample);
+        result.mean = samples.empty() ? 0.0 : total / static_cast<double>(samples.size());
+        result.p50 = percentile(samples, 0.50);
+        result.p99 = percentile(samples, 0.99);
+        result.p999 = percentile(samples, 0.999);
+        if(_state.getItemsPerIteration() > 0 && result.mean > 0.0)
+            result.items_per_second = static_cast<double>(_state.getItemsPerIteration()) / result.mean * 1e9;
+        return result;
+    }
+
+    void report(const bench_case& _case, const state& _state, const summary& result)
+    {
+        std::printf("%-48s %8zu %12.1f %12.1f %12.1f %12.1f", _case.name.c_str(), result.samples,
+                    result.mean / 1000.0, result.p50 / 1000.0, result.p99 / 1000.0, result.p999 / 1000.0);
+        if(_state.hasAllocations())
+            std::printf(" %10.1f", _state.getAllocationsPerIteration());
+        else
+            std::printf(" %10s", "-");
+        if(result.items_per_second > 0.0)
+            std::printf(" %12.2fM/s", result.items_per_second / 1e6);
+        for(const auto& [name, value] : _state.getCounters())
+            std::printf(" %s=%g", name.c_str(), value);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    std::string jsonString(const std::string& text)
+    {
+        std::string quoted = "\"";
+        for(const char c : text)
+        {
+            if(c == '"' || c == '\\')
+                quoted += '\\';
+            if(static_cast<unsigned char>(c) < 0x20)
+                quoted += ' ';
+            else
+                quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    std::string jsonNumber(const double value)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        // JSON has no NaN or infinity.
+        return std::strpbrk(buffer, "ni") != nullptr ? "null" : buffer;
+    }
+
+    void writeJson(std::FILE* file, const bench_case& _case, const state& _state, const summary& result,
+                   const bool first)
+    {
+        std::fprintf(file, "%s\n    {\"name\": %s, \"samples\": %zu, \"mean_ns\": %s, \"p50_ns\": %s, "
+                           "\"p99_ns\": %s, \"p999_ns\": %s, \"items_per_second\": %s, "
+                           "\"allocations_per_iteration\": %s, \"counters\": {",
+                     first ? "" : ",", jsonString(_case.name).c_str(), result.samples,
+                     jsonNumber(result.mean).c_str(), jsonNumber(result.p50).c_str(),
+                     jsonNumber(result.p99).c_str(), jsonNumber(result.p999).c_str(),
+                     jsonNumber(result.items_per_second).c_str(),
+                     _state.hasAllocations() ? jsonNumber(_state.getAllocationsPerIteration()).c_str() : "null");
+        bool first_counter = true;
+        for(const auto& [name, value] : _state.getCounters())
+        {
+            std::fprintf(file, "%s%s: %s", first_counter ? "" : ", ", jsonString(name).c_str(),
+                         jsonNumber(value).c_str());
+            first_counter = false;
+        }
+        std::fprintf(file, "}}");
+    }
+}
+
+/**
+ * @brief Runs the registered benchmarks.
+ *
+ * Usage: fusion_bench [--filter=<substring>] [--iterations=<count>] [--json=<path>]
+ *
+ * With --json the results are also written to the file, for tracking regressions between
+ * builds. The columns are latencies in microseconds, heap allocations per iteration ("-"
+ * when the benchmark does not count them) and throughput.
+ */
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    std::string json_path;
+    std::size_t iterations = 0;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(std::strncmp(argv[i], "--filter=", 9) == 0)
+            filter = argv[i] + 9;
+        else if(std::strncmp(argv[i], "--iterations=", 13) == 0)
+            iterations = std::stoul(argv[i] + 13);
+        else if(std::strncmp(argv[i], "--json=", 7) == 0)
+            json_path = argv[i] + 7;
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--filter=<substring>] [--iterations=<count>] [--json=<path>]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    std::FILE* json = nullptr;
+    if(!json_path.empty())
+    {
+        json = std::fopen(json_path.c_str(), "w");
+        if(json == nullptr)
+        {
+            std::fprintf(stderr, "cannot write %s: %s\n", json_path.c_str(), std::strerror(errno));
+            return 1;
+        }
+        std::fprintf(json, "{\n  \"benchmarks\": [");
+    }
+
+    std::printf("%-48s %8s %12s %12s %12s %12s %10s %13s\n", "benchmark", "samples", "mean(us)", "p50(us)",
+                "p99(us)", "p999(us)", "allocs", "throughput");
+    bool first = true;
+    for(const auto& _case : registry())
+    {
+        if(!filter.empty() && _case.name.find(filter) == std::string::npos)
+            continue;
+        state _state(iterations > 0 ? iterations : _case.iterations);
+        _case.body(_state);
+        const summary result = summarize(_state);
+        report(_case, _state, result);
+        if(json != nullptr)
+        {
+            writeJson(json, _case, _state, result, first);
+            first = false;
+        }
+    }
+
+    if(json != nullptr)
+    {
+        std::fprintf(json, "\n  ]\n}\n");
+        if(std::fclose(json) != 0)
+        {
+            std::fprintf(stderr, "cannot write %s: %s\n", json_path.c_str(), std::strerror(errno));
+            return 1;
+        }
+    }
+    return 0;
+}
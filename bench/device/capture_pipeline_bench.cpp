@@ -0,0 +1,144 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "bench.h"
+#include "libfreenect2/libfreenect2.hpp"
+#include "device/frame_listener.h"
+#include "device/frame_pool.h"
+#include "device/virtual_device.h"
+
+namespace
+{
+    constexpr std::size_t depth_width = 512;
+    constexpr std::size_t depth_height = 424;
+
+    std::int64_t nowNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+/**
+ * @brief Takes a pooled depth buffer and hands it back, as every captured frame does once.
+ */
+VISION_BENCH(frame_pool_acquire_release, 100000)
+{
+    const auto pool = vision::frame_pool::create({1, 1, 4});
+    state.setItemsPerIteration(1);
+    state.measure([&] {
+        vision::frame_handle handle = pool->acquire(libfreenect2::Frame::Depth);
+        vision::bench::doNotOptimize(handle.get());
+    });
+}
+
+/**
+ * @brief Hands depth frames from a device thread to a consumer through frame_listener.
+ *
+ * The device thread sends the next frame once the previous one was taken, so nothing is
+ * dropped. Each sample runs from the frame's arrival in onNewFrame(), before it is copied
+ * into the pool, to the consumer holding it, including the wake-up of a parked consumer.
+ */
+VISION_BENCH(frame_listener_handoff_depth, 2000)
+{
+    vision::frame_listener listener(vision::frame_pool::create({1, 1, 4}));
+    listener.setFrameTypeEnabled(libfreenect2::Frame::Depth, true);
+    const std::size_t frames = state.getIterations();
+    std::atomic<std::size_t> taken{0};
+
+    std::thread device([&] {
+        libfreenect2::Frame depth(depth_width, depth_height, 4);
+        std::memset(depth.data, 0, depth_width * depth_height * 4);
+        depth.format = libfreenect2::Frame::Float;
+        for(std::size_t i = 0; i < frames; ++i)
+        {
+            while(taken.load(std::memory_order_acquire) < i)
+                std::this_thread::yield();
+            depth.sequence = static_cast<std::uint32_t>(i);
+            listener.onNewFrame(libfreenect2::Frame::Depth, &depth);
+        }
+    });
+
+    std::uint64_t allocations_before = 0;
+    for(std::size_t i = 0; i < frames;)
+    {
+        const std::uint32_t seen = listener.getSignal();
+        vision::frame_handle frame = listener.popFrame(libfreenect2::Frame::Depth);
+        if(!frame)
+        {
+            listener.waitForFrame(seen);
+            continue;
+        }
+        state.record(nowNanoseconds() - frame.arrivalTime());
+        // The device thread's set-up is done once the first frame arrives.
+        if(i == 0)
+            allocations_before = vision::bench::allocationCount();
+        frame.reset();
+        taken.store(++i, std::memory_order_release);
+    }
+    device.join();
+    state.addAllocations(vision::bench::allocationCount() - allocations_before, frames - 1);
+
+    state.setItemsPerIteration(1);
+    state.setCounter("dropped", static_cast<double>(listener.getStatistics().dropped));
+}
+
+/**
+ * @brief Streams a firehose synthetic device into frame_listener and records the time between depth frames.
+ *
+ * Covers frame acquisition without hardware: rendering on the device thread, the copy into
+ * the pool and the hand-off to the consumer. Only the depth stream is started.
+ */
+VISION_BENCH(capture_synthetic_depth, 300)
+{
+    vision::virtual_device_config config;
+    config.fps = 0.0;
+    std::unique_ptr<vision::virtual_device> device(vision::virtual_device::open(config));
+    if(device == nullptr)
+        return;
+    vision::frame_listener listener(vision::frame_pool::create({1, 4, 4}));
+    listener.setFrameTypeEnabled(libfreenect2::Frame::Depth, true);
+    device->setIrAndDepthFrameListener(&listener);
+
+    const std::size_t frames = state.getIterations();
+    std::size_t received = 0;
+    std::uint64_t allocations_before = 0;
+    auto begin = std::chrono::steady_clock::now();
+    auto last = begin;
+    device->startStreams(false, true);
+    while(received <= frames)
+    {
+        const std::uint32_t seen = listener.getSignal();
+        vision::frame_handle frame = listener.popFrame(libfreenect2::Frame::Depth);
+        if(!frame)
+        {
+            listener.waitForFrame(seen);
+            continue;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        // The first frame only starts the clock; the device thread's set-up is done by then.
+        if(received == 0)
+        {
+            allocations_before = vision::bench::allocationCount();
+            begin = now;
+        }
+        else
+            state.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+        last = now;
+        ++received;
+    }
+    const std::uint64_t allocations = vision::bench::allocationCount() - allocations_before;
+    device->stop();
+    device->close();
+
+    state.addAllocations(allocations, frames);
+    state.setItemsPerIteration(1);
+    state.setCounter("fps", static_cast<double>(frames) / std::chrono::duration<double>(last - begin).count());
+    state.setCounter("dropped", static_cast<double>(listener.getStatistics().dropped));
+}
@@ -0,0 +1,164 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <cstdlib>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "device/depth_codec.h"
+#include "recorder/recording_reader.h"
+
+namespace
+{
+    constexpr std::size_t width = 512;
+    constexpr std::size_t height = 424;
+    constexpr std::size_t frames = 8; ///< Distinct noisy frames cycled through.
+
+    /**
+     * @brief Depth frames of a slanted wall and a box with Kinect-like noise, holes and a hole band at the edge.
+     */
+    std::vector<std::vector<float>> makeFrames()
+    {
+        std::vector<std::vector<float>> depth(frames, std::vector<float>(width * height));
+        std::mt19937 rng(13);
+        std::normal_distribution<float> noise(0.0f, 2.5f);
+        std::uniform_int_distribution<int> kind(0, 999);
+        for(auto& frame : depth)
+            for(std::size_t r = 0; r < height; ++r)
+                for(std::size_t c = 0; c < width; ++c)
+                {
+                    const bool box = c > 180 && c < 330 && r > 140 && r < 300;
+                    const bool shadow = c >= 330 && c < 345 && r > 140 && r < 300;
+                    const float base = box ? 1400.0f : 2200.0f + static_cast<float>(c) * 2.0f;
+                    frame[r * width + c] = shadow || c < 6 || kind(rng) < 20 ? 0.0f : base + noise(rng);
+                }
+        return depth;
+    }
+
+    /**
+     * @brief Reports the float bytes coded per second and the compression ratio against 16-bit and float frames.
+     */
+    void report(vision::bench::state& state, const std::size_t pixels, const std::size_t raw_frames,
+                const std::size_t encoded_bytes)
+    {
+        const auto& samples = state.getSamples();
+        if(samples.empty() || encoded_bytes == 0)
+            return;
+        const double seconds = static_cast<double>(std::accumulate(samples.begin(), samples.end(), std::int64_t{0}))
+                               / 1e9;
+        const double frame_bytes = static_cast<double>(pixels * sizeof(float));
+        state.setItemsPerIteration(pixels);
+        state.setCounter("MB_per_s", frame_bytes * static_cast<double>(samples.size()) / seconds / 1e6);
+        state.setCounter("ratio_16bit", static_cast<double>(raw_frames * pixels * 2) / static_cast<double>(encoded_bytes));
+        state.setCounter("ratio_float", static_cast<double>(raw_frames * pixels * 4) / static_cast<double>(encoded_bytes));
+    }
+
+    void encodeWith(vision::bench::state& state, const vision::depth_codec_config& config,
+                    const vision::depth_codec::kernel kernel)
+    {
+        const auto depth = makeFrames();
+        vision::depth_codec codec(config, kernel);
+        std::vector<unsigned char> encoded;
+        std::size_t encoded_bytes = 0;
+        codec.encode(depth[0].data(), width, height, encoded);
+        for(std::size_t i = 0; i < state.getIterations(); ++i)
+        {
+            state.time([&] { codec.encode(depth[i % frames].data(), width, height, encoded); });
+            vision::bench::doNotOptimize(encoded.data());
+            encoded_bytes += encoded.size();
+        }
+        report(state, width * height, state.getIterations(), encoded_bytes);
+    }
+
+    void decodeWith(vision::bench::state& state, const vision::depth_codec_config& config,
+                    const vision::depth_codec::kernel kernel)
+    {
+        const auto depth = makeFrames();
+        vision::depth_codec codec(config, kernel);
+        std::vector<std::vector<unsigned char>> encoded(frames);
+        std::size_t encoded_bytes = 0;
+        for(std::size_t f = 0; f < frames; ++f)
+            codec.encode(depth[f].data(), width, height, encoded[f]);
+        std::vector<float> decoded(width * height);
+        for(std::size_t i = 0; i < state.getIterations(); ++i)
+        {
+            const auto& frame = encoded[i % frames];
+            state.time([&] { codec.decode(frame.data(), frame.size(), decoded.data(), decoded.size()); });
+            vision::bench::doNotOptimize(decoded.data());
+            encoded_bytes += frame.size();
+        }
+        report(state, width * height, state.getIterations(), encoded_bytes);
+    }
+
+    constexpr auto scalar = vision::depth_codec::kernel::Scalar;
+    constexpr auto best = vision::depth_codec::kernel::Auto;
+}
+
+VISION_BENCH(depth_codec_encode_scalar, 300)
+{
+    encodeWith(state, {1, {}, 8}, scalar);
+}
+
+VISION_BENCH(depth_codec_encode_avx2, 300)
+{
+    encodeWith(state, {1, {}, 8}, best);
+}
+
+VISION_BENCH(depth_codec_encode_avx2_4_threads, 300)
+{
+    encodeWith(state, {4, {}, 8}, best);
+}
+
+VISION_BENCH(depth_codec_decode_scalar, 300)
+{
+    decodeWith(state, {1, {}, 8}, scalar);
+}
+
+VISION_BENCH(depth_codec_decode_avx2, 300)
+{
+    decodeWith(state, {1, {}, 8}, best);
+}
+
+VISION_BENCH(depth_codec_decode_avx2_4_threads, 300)
+{
+    decodeWith(state, {4, {}, 8}, best);
+}
+
+/**
+ * @brief Encodes the depth frames of a recording, one sample per frame.
+ *
+ * The recording is named by FUSION_BENCH_RECORDING, without extension; every uncompressed
+ * Float depth frame is encoded. Without it the benchmark records nothing.
+ */
+VISION_BENCH(depth_codec_encode_recording, 1)
+{
+    const char* path = std::getenv("FUSION_BENCH_RECORDING");
+    vision::recording_reader reader;
+    if(path == nullptr || !reader.open(path))
+        return;
+
+    vision::depth_codec codec;
+    std::vector<unsigned char> encoded;
+    std::size_t encoded_frames = 0, encoded_bytes = 0, pixels = 0;
+    for(std::size_t i = 0; i < reader.size(); ++i)
+    {
+        const vision::recording::index_entry& entry = reader.entry(i);
+        if(entry.type != static_cast<std::uint32_t>(libfreenect2::Frame::Depth)
+           || entry.format != static_cast<std::uint32_t>(libfreenect2::Frame::Float))
+            continue;
+        // Frames of a recording share one size; a different one is skipped to keep the ratio meaningful.
+        if(pixels != 0 && pixels != std::size_t{entry.width} * entry.height)
+            continue;
+        pixels = std::size_t{entry.width} * entry.height;
+        const auto* depth = reinterpret_cast<const float*>(reader.payload(i));
+        state.time([&] { codec.encode(depth, entry.width, entry.height, encoded); });
+        ++encoded_frames;
+        encoded_bytes += encoded.size();
+    }
+
+    report(state, pixels, encoded_frames, encoded_bytes);
+    state.setCounter("frames", static_cast<double>(encoded_frames));
+}
@@ -0,0 +1,249 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "libfreenect2/libfreenect2.hpp"
+#include "device/depth_decoder.h"
+#include "device/frame_listener.h"
+#include "device/parallel_packet_pipeline.h"
+
+namespace
+{
+    /**
+     * @brief Decoder with flat synthetic tables and a random packet, for timing without a device.
+     */
+    struct synthetic_input
+    {
+        std::vector<unsigned char> p0 = std::vector<unsigned char>(vision::depth_decoder::p0_tables_size, 0);
+        std::vector<float> x = std::vector<float>(vision::depth_decoder::width * vision::depth_decoder::height, 0.0f);
+        std::vector<float> z = std::vector<float>(vision::depth_decoder::width * vision::depth_decoder::height, 1500.0f);
+        std::vector<short> lookup = std::vector<short>(vision::depth_decoder::lookup_table_size);
+        std::vector<unsigned char> packet = std::vector<unsigned char>(10 * vision::depth_decoder::sub_image_size);
+
+        synthetic_input()
+        {
+            for(std::size_t i = 0; i < lookup.size(); ++i)
+                lookup[i] = static_cast<short>(static_cast<int>(i) - 1024);
+            std::mt19937 random(3);
+            for(auto& byte : packet)
+                byte = static_cast<unsigned char>(random());
+        }
+    };
+
+    /**
+     * @brief Decodes the synthetic packet with a number of threads.
+     */
+    void decodeSynthetic(vision::bench::state& state, const std::size_t threads)
+    {
+        const synthetic_input input;
+        vision::depth_decoder decoder({threads});
+        decoder.loadTables(input.p0.data(), input.p0.size(), input.x.data(), input.z.data(), input.x.size(),
+                           input.lookup.data(), input.lookup.size());
+        std::vector<float> ir(vision::depth_decoder::width * vision::depth_decoder::height);
+        std::vector<float> depth(ir.size());
+
+        state.setItemsPerIteration(1);
+        state.measure([&] {
+            decoder.decode(input.packet.data(), input.packet.size(), ir.data(), depth.data());
+            vision::bench::doNotOptimize(depth.data());
+        });
+        state.setCounter("threads", static_cast<double>(decoder.getThreadCount()));
+    }
+
+    /// IR and depth images of a decoded packet, by packet sequence number.
+    using decoded_images = std::map<std::uint32_t, std::pair<std::vector<float>, std::vector<float>>>;
+
+    /**
+     * @brief Replays recorded raw depth packets through a pipeline and records the time between decoded frames.
+     *
+     * The packets are the .depth files of the directory named by FUSION_BENCH_DEPTH_PACKETS, as written
+     * by libfreenect2's packet dumps; without it the benchmark records nothing.
+     *
+     * @param decoder Decoder of a parallel_packet_pipeline, or nullptr for CpuPacketPipeline.
+     * @param images Receives a copy of every decoded IR and depth image, or nullptr.
+     */
+    void replayPackets(vision::bench::state& state, vision::depth_decoder* decoder, decoded_images* images = nullptr)
+    {
+        const char* directory = std::getenv("FUSION_BENCH_DEPTH_PACKETS");
+        if(directory == nullptr || !std::filesystem::is_directory(directory))
+            return;
+
+        std::vector<std::string> files;
+        for(const auto& entry : std::filesystem::directory_iterator(directory))
+            if(entry.path().extension() == ".depth")
+                files.push_back(entry.path().string());
+        std::sort(files.begin(), files.end());
+        if(files.empty())
+            return;
+
+        vision::frame_listener listener(vision::frame_pool::create({1, 4, 4}));
+        listener.setDepthDecoder(decoder);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Depth, true);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Ir, images != nullptr);
+
+        libfreenect2::Freenect2Replay replay;
+        libfreenect2::PacketPipeline* pipeline = decoder != nullptr
+                ? static_cast<libfreenect2::PacketPipeline*>(new vision::parallel_packet_pipeline(*decoder))
+                : new libfreenect2::CpuPacketPipeline();
+        libfreenect2::Freenect2Device* device = replay.openDevice(files, pipeline);
+        if(device == nullptr)
+            return;
+        device->setIrAndDepthFrameListener(&listener);
+
+        // The replay feeds packets as fast as it reads them and a busy pipeline skips packets,
+        // so the decoded count matters as much as the time between frames.
+        std::size_t decoded = 0;
+        const auto begin = std::chrono::steady_clock::now();
+        auto last = begin;
+        device->startStreams(false, true);
+        while(std::chrono::steady_clock::now() - last < std::chrono::seconds(2))
+        {
+            const std::uint32_t seen = listener.getSignal();
+            if(images != nullptr)
+            {
+                if(vision::frame_handle ir = listener.popFrame(libfreenect2::Frame::Ir))
+                {
+                    const auto* data = reinterpret_cast<const float*>(ir->data);
+                    (*images)[ir->sequence].first.assign(data, data + ir->width * ir->height);
+                    continue;
+                }
+            }
+            if(vision::frame_handle frame = listener.popFrame(libfreenect2::Frame::Depth))
+            {
+                if(images != nullptr)
+                {
+                    const auto* data = reinterpret_cast<const float*>(frame->data);
+                    (*images)[frame->sequence].second.assign(data, data + frame->width * frame->height);
+                }
+                const auto now = std::chrono::steady_clock::now();
+                state.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+                last = now;
+                ++decoded;
+                continue;
+            }
+            if(listener.getSignal() == seen)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        device->stop();
+        device->close();
+        delete device;
+
+        state.setItemsPerIteration(1);
+        state.setCounter("packets", static_cast<double>(files.size()));
+        state.setCounter("decoded", static_cast<double>(decoded));
+        state.setCounter("decoded_fps", static_cast<double>(decoded)
+                                        / std::chrono::duration<double>(last - begin).count());
+    }
+
+    /**
+     * @brief Counts the pixels of an image that differ from the reference by more than a tolerance.
+     *
+     * @param max_difference Raised to the largest difference found.
+     * @return std::size_t The number of differing pixels; every pixel if the sizes differ.
+     */
+    std::size_t countMismatches(const std::vector<float>& reference, const std::vector<float>& image,
+                                const float tolerance, float& max_difference)
+    {
+        if(reference.size() != image.size())
+            return std::max(reference.size(), image.size());
+        std::size_t mismatches = 0;
+        for(std::size_t i = 0; i < reference.size(); ++i)
+        {
+            const float difference = std::abs(reference[i] - image[i]);
+            max_difference = std::max(max_difference, difference);
+            if(difference > tolerance)
+                ++mismatches;
+        }
+        return mismatches;
+    }
+}
+
+/**
+ * @brief One depth packet decoded on the calling thread only.
+ */
+VISION_BENCH(depth_decoder_1_thread, 50)
+{
+    decodeSynthetic(state, 1);
+}
+
+/**
+ * @brief One depth packet decoded on one thread per core.
+ */
+VISION_BENCH(depth_decoder_all_threads, 50)
+{
+    decodeSynthetic(state, 0);
+}
+
+/**
+ * @brief Recorded packets decoded by libfreenect2's CpuPacketPipeline.
+ */
+VISION_BENCH(depth_replay_cpu_pipeline, 0)
+{
+    replayPackets(state, nullptr);
+}
+
+/**
+ * @brief Recorded packets decoded by parallel_packet_pipeline on one thread per core.
+ */
+VISION_BENCH(depth_replay_parallel_pipeline, 0)
+{
+    vision::depth_decoder decoder;
+    replayPackets(state, &decoder);
+}
+
+/**
+ * @brief Compares the images of parallel_packet_pipeline with those of CpuPacketPipeline on the recorded packets.
+ *
+ * Both replays may skip packets, so only the packets both decoded are compared. A pixel
+ * mismatches when it differs by more than 1 mm of depth or 1 unit of IR; every mismatching
+ * frame is reported on stderr.
+ */
+VISION_BENCH(depth_replay_pipelines_match, 0)
+{
+    decoded_images reference;
+    decoded_images parallel;
+    vision::bench::state replay_state(0);
+    replayPackets(replay_state, nullptr, &reference);
+    {
+        vision::depth_decoder decoder;
+        replayPackets(replay_state, &decoder, &parallel);
+    }
+
+    std::size_t compared = 0;
+    std::size_t mismatched_frames = 0;
+    std::size_t mismatched_pixels = 0;
+    float max_ir_difference = 0.0f;
+    float max_depth_difference = 0.0f;
+    for(const auto& [sequence, images] : reference)
+    {
+        const auto match = parallel.find(sequence);
+        if(match == parallel.end() || images.first.empty() || images.second.empty()
+           || match->second.first.empty() || match->second.second.empty())
+            continue;
+        ++compared;
+        const std::size_t ir = countMismatches(images.first, match->second.first, 1.0f, max_ir_difference);
+        const std::size_t depth = countMismatches(images.second, match->second.second, 1.0f, max_depth_difference);
+        if(ir + depth == 0)
+            continue;
+        ++mismatched_frames;
+        mismatched_pixels += ir + depth;
+        std::fprintf(stderr, "depth_replay_pipelines_match: packet %u differs in %zu IR and %zu depth pixels\n",
+                     sequence, ir, depth);
+    }
+
+    state.setCounter("compared", static_cast<double>(compared));
+    state.setCounter("mismatched_frames", static_cast<double>(mismatched_frames));
+    state.setCounter("mismatched_pixels", static_cast<double>(mismatched_pixels));
+    state.setCounter("max_ir_difference", max_ir_difference);
+    state.setCounter("max_depth_difference_mm", max_depth_difference);
+}
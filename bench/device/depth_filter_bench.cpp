@@ -0,0 +1,128 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "device/depth_filter.h"
+
+namespace
+{
+    constexpr std::size_t width = 512;
+    constexpr std::size_t height = 424;
+    constexpr std::size_t frames = 8; ///< Distinct noisy frames cycled through, so the temporal filter sees motion.
+
+    /**
+     * @brief Noisy depth frames of a slanted wall and a box, with holes, NaNs and out-of-range pixels.
+     */
+    std::vector<std::vector<float>> makeFrames()
+    {
+        std::vector<std::vector<float>> depth(frames, std::vector<float>(width * height));
+        std::mt19937 rng(11);
+        std::normal_distribution<float> noise(0.0f, 8.0f);
+        std::uniform_int_distribution<int> kind(0, 999);
+        for(auto& frame : depth)
+            for(std::size_t r = 0; r < height; ++r)
+                for(std::size_t c = 0; c < width; ++c)
+                {
+                    const int k = kind(rng);
+                    const bool box = c > 180 && c < 330 && r > 140 && r < 300;
+                    const float base = box ? 1400.0f : 2200.0f + static_cast<float>(c) * 2.0f;
+                    frame[r * width + c] = k < 40 ? 0.0f
+                                         : k < 45 ? std::numeric_limits<float>::quiet_NaN()
+                                         : k < 60 ? 300.0f
+                                         : base + noise(rng);
+                }
+        return depth;
+    }
+
+    /**
+     * @brief Times one filter on fresh copies of the frames, leaving the copy out of the timing.
+     */
+    void filterWith(vision::bench::state& state, vision::depth_filter& filter)
+    {
+        const auto depth = makeFrames();
+        std::vector<float> frame(width * height);
+        for(std::size_t i = 0; i < state.getIterations(); ++i)
+        {
+            frame = depth[i % frames];
+            state.time([&] { filter.apply(frame.data(), width, height); });
+            vision::bench::doNotOptimize(frame.data());
+        }
+        state.setItemsPerIteration(width * height);
+    }
+
+    constexpr auto scalar = vision::depth_filter::kernel::Scalar;
+    constexpr auto best = vision::depth_filter::kernel::Auto;
+}
+
+VISION_BENCH(depth_filter_range_scalar, 400)
+{
+    vision::range_filter filter(500.0f, 4500.0f, scalar);
+    filterWith(state, filter);
+}
+
+VISION_BENCH(depth_filter_range_avx2, 400)
+{
+    vision::range_filter filter(500.0f, 4500.0f, best);
+    filterWith(state, filter);
+}
+
+VISION_BENCH(depth_filter_flying_pixel_scalar, 200)
+{
+    vision::flying_pixel_filter filter(0.04f, 2, scalar);
+    filterWith(state, filter);
+}
+
+VISION_BENCH(depth_filter_flying_pixel_avx2, 200)
+{
+    vision::flying_pixel_filter filter(0.04f, 2, best);
+    filterWith(state, filter);
+}
+
+VISION_BENCH(depth_filter_median_scalar, 100)
+{
+    vision::median_filter filter(scalar);
+    filterWith(state, filter);
+}
+
+VISION_BENCH(depth_filter_median_avx2, 200)
+{
+    vision::median_filter filter(best);
+    filterWith(state, filter);
+}
+
+VISION_BENCH(depth_filter_temporal_scalar, 400)
+{
+    vision::temporal_filter filter(0.4f, 30.0f, scalar);
+    filterWith(state, filter);
+}
+
+VISION_BENCH(depth_filter_temporal_avx2, 400)
+{
+    vision::temporal_filter filter(0.4f, 30.0f, best);
+    filterWith(state, filter);
+}
+
+/**
+ * @brief Every filter in order, as device_capture runs them on a depth frame.
+ */
+VISION_BENCH(depth_filter_chain, 200)
+{
+    vision::depth_filter_config config;
+    config.range = config.flying_pixels = config.median = config.temporal = true;
+    vision::depth_filter_chain chain(config);
+    const auto depth = makeFrames();
+    std::vector<float> pixels(width * height);
+    libfreenect2::Frame frame(width, height, 4, reinterpret_cast<unsigned char*>(pixels.data()));
+    for(std::size_t i = 0; i < state.getIterations(); ++i)
+    {
+        pixels = depth[i % frames];
+        state.time([&] { chain.apply(frame); });
+        vision::bench::doNotOptimize(pixels.data());
+    }
+    state.setItemsPerIteration(width * height);
+}
@@ -0,0 +1,93 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "device/device_registry.h"
+
+namespace
+{
+    /**
+     * @brief A bus of four devices that takes 20 ms to scan, like a libfreenect2 enumeration.
+     */
+    vision::device_registry::scanner slowBus(std::atomic<int>& plugged)
+    {
+        return [&plugged] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::vector<vision::registry_entry> entries;
+            for(int i = 0; i < plugged.load(); ++i)
+                entries.push_back({i, "00351746" + std::to_string(4210 + i)});
+            return entries;
+        };
+    }
+
+    vision::registry_config manualRefresh()
+    {
+        vision::registry_config config;
+        config.watch_hotplug = false;
+        return config;
+    }
+}
+
+/**
+ * @brief Looks a serial number up by device ID, as checkDevice() does.
+ */
+VISION_BENCH(device_registry_get_serial, 100000)
+{
+    std::atomic<int> plugged{4};
+    vision::device_registry registry(slowBus(plugged), manualRefresh());
+    registry.refresh();
+    std::string serial;
+    serial.reserve(32);
+    std::size_t i = 0;
+    state.measure([&] {
+        registry.getSerial(static_cast<int>(i++ % 4), serial);
+        vision::bench::doNotOptimize(serial.data());
+    });
+}
+
+/**
+ * @brief Copies the device list, as getDeviceList() does.
+ */
+VISION_BENCH(device_registry_entries, 100000)
+{
+    std::atomic<int> plugged{4};
+    vision::device_registry registry(slowBus(plugged), manualRefresh());
+    registry.refresh();
+    state.measure([&] {
+        const auto entries = registry.entries();
+        vision::bench::doNotOptimize(entries.data());
+    });
+}
+
+/**
+ * @brief Looks devices up while another thread keeps re-plugging one and refreshing.
+ *
+ * Lookups never wait for the 20 ms scans; refreshes counts the tables published meanwhile.
+ */
+VISION_BENCH(device_registry_lookup_during_refresh, 100000)
+{
+    std::atomic<int> plugged{4};
+    vision::device_registry registry(slowBus(plugged), manualRefresh());
+    registry.refresh();
+    std::atomic<bool> done{false};
+    std::thread refresher([&] {
+        while(!done.load())
+        {
+            plugged = plugged.load() == 4 ? 3 : 4;
+            registry.refresh();
+        }
+    });
+    std::size_t i = 0;
+    state.measure([&] {
+        const auto entry = registry.findSerial("00351746" + std::to_string(4210 + i++ % 3));
+        vision::bench::doNotOptimize(&entry);
+    });
+    done = true;
+    refresher.join();
+    state.setCounter("refreshes", static_cast<double>(registry.getVersion()));
+}
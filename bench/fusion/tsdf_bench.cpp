@@ -0,0 +1,193 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "libfreenect2/registration.h"
+#include "fusion/tsdf_volume.h"
+#include "recorder/recording_reader.h"
+
+namespace
+{
+    using vision::tsdf_volume;
+
+    constexpr std::size_t depth_width = 512;
+    constexpr std::size_t depth_height = 424;
+
+    libfreenect2::Freenect2Device::IrCameraParams irParams()
+    {
+        libfreenect2::Freenect2Device::IrCameraParams params{};
+        params.fx = 365.456f;
+        params.fy = 365.456f;
+        params.cx = 254.878f;
+        params.cy = 205.395f;
+        params.k1 = 0.0905474f;
+        params.k2 = -0.26819f;
+        params.k3 = 0.0950862f;
+        return params;
+    }
+
+    /**
+     * @brief Synthetic scene: a wall at 2.5 m and a sphere in front of it that moves a little every frame.
+     */
+    struct scene
+    {
+        std::vector<float> depth = std::vector<float>(depth_width * depth_height);
+        libfreenect2::Frame depth_frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(depth.data())};
+
+        /**
+         * @brief Renders frame n.
+         */
+        void render(const std::size_t n)
+        {
+            const auto params = irParams();
+            const float center[3] = {0.3f * std::sin(0.05f * static_cast<float>(n)), 0.0f, 1.6f};
+            constexpr float radius = 0.3f;
+            for(std::size_t r = 0; r < depth_height; ++r)
+                for(std::size_t c = 0; c < depth_width; ++c)
+                {
+                    const float x = (static_cast<float>(c) + 0.5f - params.cx) / params.fx;
+                    const float y = (static_cast<float>(r) + 0.5f - params.cy) / params.fy;
+                    const float a = x * x + y * y + 1.0f;
+                    const float b = x * center[0] + y * center[1] + center[2];
+                    const float c0 = center[0] * center[0] + center[1] * center[1] + center[2] * center[2] - radius * radius;
+                    const float discriminant = b * b - a * c0;
+                    depth[r * depth_width + c] = discriminant >= 0.0f ? (b - std::sqrt(discriminant)) / a * 1000.0f : 2500.0f;
+                }
+        }
+    };
+
+    void integrateWith(vision::bench::state& state, const tsdf_volume::kernel kernel, const std::size_t threads)
+    {
+        scene _scene;
+        _scene.render(0);
+        vision::tsdf_config config;
+        config.threads = threads;
+        tsdf_volume volume(config, kernel);
+        volume.integrate(_scene.depth_frame, irParams());
+        state.setItemsPerIteration(depth_width * depth_height);
+        state.measure([&] {
+            volume.integrate(_scene.depth_frame, irParams());
+            vision::bench::doNotOptimize(&volume);
+        });
+        state.setCounter("kernel", static_cast<int>(volume.getKernel()));
+        state.setCounter("threads", static_cast<double>(volume.getThreadCount()));
+        state.setCounter("bricks", static_cast<double>(volume.getBrickCount()));
+    }
+}
+
+VISION_BENCH(tsdf_integrate_scalar, 50)
+{
+    integrateWith(state, tsdf_volume::kernel::Scalar, 1);
+}
+
+VISION_BENCH(tsdf_integrate_avx2, 50)
+{
+    integrateWith(state, tsdf_volume::kernel::AVX2, 1);
+}
+
+/**
+ * @brief Best kernel on one thread per core.
+ */
+VISION_BENCH(tsdf_integrate_all_threads, 50)
+{
+    integrateWith(state, tsdf_volume::kernel::Auto, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Marching cubes over every brick of a freshly fused volume.
+ */
+VISION_BENCH(tsdf_mesh_full, 20)
+{
+    scene _scene;
+    _scene.render(0);
+    tsdf_volume volume;
+    vision::triangle_mesh mesh;
+    std::size_t remeshed = 0;
+    for(std::size_t i = 0; i < state.getIterations(); ++i)
+    {
+        volume.reset();
+        volume.integrate(_scene.depth_frame, irParams());
+        state.time([&] { remeshed = volume.extractMesh(mesh); });
+    }
+    state.setItemsPerIteration(remeshed);
+    state.setCounter("triangles", static_cast<double>(mesh.triangleCount()));
+}
+
+/**
+ * @brief Incremental meshing after a frame where only the sphere moved and the wall was not observed.
+ */
+VISION_BENCH(tsdf_mesh_incremental, 50)
+{
+    scene _scene;
+    _scene.render(0);
+    tsdf_volume volume;
+    vision::triangle_mesh mesh;
+    volume.integrate(_scene.depth_frame, irParams());
+    volume.extractMesh(mesh);
+    std::size_t remeshed = 0;
+    for(std::size_t i = 0; i < state.getIterations(); ++i)
+    {
+        _scene.render(i + 1);
+        for(float& d : _scene.depth)
+            if(d >= 2500.0f)
+                d = 0.0f;
+        volume.integrate(_scene.depth_frame, irParams());
+        state.time([&] { remeshed += volume.extractMesh(mesh); });
+    }
+    state.setItemsPerIteration(1);
+    state.setCounter("remeshed_per_frame", static_cast<double>(remeshed) / static_cast<double>(state.getIterations()));
+    state.setCounter("bricks", static_cast<double>(volume.getBrickCount()));
+}
+
+/**
+ * @brief Fuses and meshes the depth frames of a recording, one sample per frame.
+ *
+ * The recording is named by FUSION_BENCH_RECORDING, without extension; its first device
+ * is fused with default Kinect v2 intrinsics. Without it the benchmark records nothing.
+ */
+VISION_BENCH(tsdf_recording, 1)
+{
+    const char* path = std::getenv("FUSION_BENCH_RECORDING");
+    vision::recording_reader reader;
+    if(path == nullptr || !reader.open(path))
+        return;
+
+    const libfreenect2::Registration registration(irParams(), {});
+    std::vector<float> undistorted(depth_width * depth_height);
+    libfreenect2::Frame undistorted_frame(depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(undistorted.data()));
+    libfreenect2::Frame recorded(depth_width, depth_height, 4, undistorted_frame.data);
+
+    tsdf_volume volume;
+    vision::triangle_mesh mesh;
+    std::size_t frames = 0, remeshed = 0;
+    std::size_t first = 0;
+    while(first < reader.size() && reader.entry(first).type != static_cast<std::uint32_t>(libfreenect2::Frame::Depth))
+        ++first;
+    if(first == reader.size())
+        return;
+    const int device_id = reader.entry(first).device_id;
+    for(auto i = std::optional<std::size_t>(first); i; i = reader.next(*i + 1, device_id, libfreenect2::Frame::Depth))
+    {
+        reader.view(*i, recorded);
+
+        state.time([&] {
+            registration.undistortDepth(&recorded, &undistorted_frame);
+            volume.integrate(undistorted_frame, irParams());
+            remeshed += volume.extractMesh(mesh);
+        });
+        ++frames;
+    }
+
+    state.setItemsPerIteration(1);
+    state.setCounter("frames", static_cast<double>(frames));
+    state.setCounter("bricks", static_cast<double>(volume.getBrickCount()));
+    state.setCounter("triangles", static_cast<double>(mesh.triangleCount()));
+    if(frames > 0)
+        state.setCounter("remeshed_per_frame", static_cast<double>(remeshed) / static_cast<double>(frames));
+}
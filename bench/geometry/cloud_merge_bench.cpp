@@ -0,0 +1,102 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "geometry/cloud_merger.h"
+
+namespace
+{
+    using vision::cloud_merger;
+
+    constexpr std::size_t device_count = 4;
+    constexpr std::size_t depth_width = vision::point_cloud_builder::depth_width;
+    constexpr std::size_t depth_height = vision::point_cloud_builder::depth_height;
+
+    /**
+     * @brief Colored clouds of four devices facing the origin from the four sides.
+     */
+    struct rig
+    {
+        std::vector<vision::point_cloud> clouds = std::vector<vision::point_cloud>(device_count);
+        std::vector<vision::merge_source> sources;
+
+        rig()
+        {
+            const vision::pose poses[device_count] = {
+                {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, -2, 0, 0, 0, 1},
+                {0, 0, -1, 2, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1},
+                {-1, 0, 0, 0, 0, 1, 0, 0, 0, 0, -1, 2, 0, 0, 0, 1},
+                {0, 0, 1, -2, 0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 1}};
+            for(std::size_t d = 0; d < device_count; ++d)
+            {
+                vision::point_cloud& cloud = clouds[d];
+                cloud.resize(depth_width, depth_height, true);
+                for(std::size_t i = 0; i < cloud.size(); ++i)
+                {
+                    cloud.x[i] = static_cast<float>(i % depth_width) * 0.004f - 1.0f;
+                    cloud.y[i] = static_cast<float>(i / depth_width) * 0.004f - 0.8f;
+                    cloud.z[i] = 2.0f + static_cast<float>(d) * 0.01f;
+                    cloud.rgb[i] = static_cast<float>(i);
+                }
+                sources.push_back({&cloud, poses[d]});
+            }
+        }
+    };
+
+    void mergeWith(vision::bench::state& state, const cloud_merger::kernel kernel, const std::size_t threads)
+    {
+        rig _rig;
+        cloud_merger merger(threads, {}, kernel);
+        vision::point_cloud merged;
+        state.setItemsPerIteration(device_count * depth_width * depth_height);
+        state.measure([&] {
+            merger.merge(_rig.sources, merged);
+            vision::bench::doNotOptimize(merged.x.data());
+        });
+        state.setCounter("kernel", static_cast<int>(merger.getKernel()));
+        state.setCounter("threads", static_cast<double>(merger.getThreadCount()));
+    }
+}
+
+/**
+ * @brief Baseline: per-point transform into a packed cloud grown from empty every frame.
+ */
+VISION_BENCH(cloud_merge_append, 100)
+{
+    rig _rig;
+    state.setItemsPerIteration(device_count * depth_width * depth_height);
+    state.measure([&] {
+        std::vector<vision::point_xyzrgb> merged;
+        for(const vision::merge_source& source : _rig.sources)
+        {
+            const vision::pose& m = source.world_from_camera;
+            const vision::point_cloud& cloud = *source.cloud;
+            for(std::size_t i = 0; i < cloud.size(); ++i)
+                merged.push_back({m[0] * cloud.x[i] + m[1] * cloud.y[i] + m[2] * cloud.z[i] + m[3],
+                                  m[4] * cloud.x[i] + m[5] * cloud.y[i] + m[6] * cloud.z[i] + m[7],
+                                  m[8] * cloud.x[i] + m[9] * cloud.y[i] + m[10] * cloud.z[i] + m[11], cloud.rgb[i]});
+        }
+        vision::bench::doNotOptimize(merged.data());
+    });
+}
+
+VISION_BENCH(cloud_merge_scalar, 100)
+{
+    mergeWith(state, cloud_merger::kernel::Scalar, 1);
+}
+
+VISION_BENCH(cloud_merge_avx2, 100)
+{
+    mergeWith(state, cloud_merger::kernel::AVX2, 1);
+}
+
+/**
+ * @brief Best kernel on one thread per core.
+ */
+VISION_BENCH(cloud_merge_all_threads, 100)
+{
+    mergeWith(state, cloud_merger::kernel::Auto, std::thread::hardware_concurrency());
+}
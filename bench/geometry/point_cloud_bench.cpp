@@ -0,0 +1,118 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "libfreenect2/registration.h"
+#include "geometry/point_cloud_builder.h"
+
+namespace
+{
+    using vision::point_cloud_builder;
+
+    constexpr std::size_t width = point_cloud_builder::depth_width;
+    constexpr std::size_t height = point_cloud_builder::depth_height;
+
+    libfreenect2::Freenect2Device::IrCameraParams irParams()
+    {
+        libfreenect2::Freenect2Device::IrCameraParams params{};
+        params.fx = 365.456f;
+        params.fy = 365.456f;
+        params.cx = 254.878f;
+        params.cy = 205.395f;
+        return params;
+    }
+
+    /**
+     * @brief Synthetic scene: a tilted plane with a few percent of invalid pixels.
+     */
+    struct scene
+    {
+        std::vector<float> depth = std::vector<float>(width * height);
+        std::vector<float> color = std::vector<float>(width * height);
+        libfreenect2::Frame undistorted{width, height, 4, reinterpret_cast<unsigned char*>(depth.data())};
+        libfreenect2::Frame registered{width, height, 4, reinterpret_cast<unsigned char*>(color.data())};
+
+        scene()
+        {
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> noise(-2.0f, 2.0f);
+            std::uniform_int_distribution<int> hole(0, 99);
+            for(std::size_t r = 0; r < height; ++r)
+                for(std::size_t c = 0; c < width; ++c)
+                {
+                    const std::size_t i = r * width + c;
+                    depth[i] = hole(rng) < 3 ? 0.0f : 1500.0f + 2.0f * static_cast<float>(r) + noise(rng);
+                    color[i] = static_cast<float>(i);
+                }
+        }
+    };
+
+    void buildWith(vision::bench::state& state, const point_cloud_builder::kernel kernel)
+    {
+        const scene _scene;
+        const point_cloud_builder builder(irParams(), kernel);
+        vision::point_cloud cloud;
+        state.setItemsPerIteration(width * height);
+        state.measure([&] {
+            builder.build(_scene.undistorted, _scene.registered, cloud);
+            vision::bench::doNotOptimize(cloud.x.data());
+        });
+        state.setCounter("kernel", static_cast<int>(builder.getKernel()));
+    }
+}
+
+/**
+ * @brief Baseline: one Registration::getPointXYZRGB call per pixel.
+ */
+VISION_BENCH(point_cloud_libfreenect2_per_pixel, 100)
+{
+    const scene _scene;
+    const libfreenect2::Registration registration(irParams(), libfreenect2::Freenect2Device::ColorCameraParams{});
+    vision::point_cloud cloud;
+    cloud.resize(width, height, true);
+    state.setItemsPerIteration(width * height);
+    state.measure([&] {
+        for(std::size_t r = 0; r < height; ++r)
+            for(std::size_t c = 0; c < width; ++c)
+            {
+                const std::size_t i = r * width + c;
+                registration.getPointXYZRGB(&_scene.undistorted, &_scene.registered,
+                                            static_cast<int>(r), static_cast<int>(c),
+                                            cloud.x[i], cloud.y[i], cloud.z[i], cloud.rgb[i]);
+            }
+        vision::bench::doNotOptimize(cloud.x.data());
+    });
+}
+
+VISION_BENCH(point_cloud_builder_scalar, 300)
+{
+    buildWith(state, point_cloud_builder::kernel::Scalar);
+}
+
+VISION_BENCH(point_cloud_builder_sse, 300)
+{
+    buildWith(state, point_cloud_builder::kernel::SSE);
+}
+
+VISION_BENCH(point_cloud_builder_avx2, 300)
+{
+    buildWith(state, point_cloud_builder::kernel::AVX2);
+}
+
+/**
+ * @brief Packed XYZRGB output with the best kernel.
+ */
+VISION_BENCH(point_cloud_builder_packed, 300)
+{
+    const scene _scene;
+    const point_cloud_builder builder(irParams());
+    std::vector<vision::point_xyzrgb> points;
+    state.setItemsPerIteration(width * height);
+    state.measure([&] {
+        builder.buildPacked(_scene.undistorted, _scene.registered, points);
+        vision::bench::doNotOptimize(points.data());
+    });
+}
@@ -0,0 +1,178 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "libfreenect2/registration.h"
+#include "geometry/registration_engine.h"
+
+namespace
+{
+    using vision::registration_engine;
+
+    constexpr std::size_t depth_width = registration_engine::depth_width;
+    constexpr std::size_t depth_height = registration_engine::depth_height;
+    constexpr std::size_t color_width = registration_engine::color_width;
+    constexpr std::size_t color_height = registration_engine::color_height;
+
+    libfreenect2::Freenect2Device::IrCameraParams irParams()
+    {
+        libfreenect2::Freenect2Device::IrCameraParams params{};
+        params.fx = 365.456f;
+        params.fy = 365.456f;
+        params.cx = 254.878f;
+        params.cy = 205.395f;
+        params.k1 = 0.0905474f;
+        params.k2 = -0.26819f;
+        params.k3 = 0.0950862f;
+        return params;
+    }
+
+    libfreenect2::Freenect2Device::ColorCameraParams colorParams()
+    {
+        libfreenect2::Freenect2Device::ColorCameraParams params{};
+        params.fx = 1081.37f;
+        params.fy = 1081.37f;
+        params.cx = 959.5f;
+        params.cy = 539.5f;
+        params.shift_d = 863.0f;
+        params.shift_m = 52.0f;
+        params.mx_x1y0 = 0.6514f;
+        params.mx_x0y0 = 0.1345f;
+        params.my_x0y1 = 0.6502f;
+        params.my_x0y0 = 0.0081f;
+        return params;
+    }
+
+    /**
+     * @brief Synthetic scene: a wall with a closer box and a few percent of invalid depth pixels.
+     */
+    struct scene
+    {
+        std::vector<float> depth = std::vector<float>(depth_width * depth_height);
+        std::vector<std::uint32_t> color = std::vector<std::uint32_t>(color_width * color_height);
+        std::vector<float> undistorted = std::vector<float>(depth_width * depth_height);
+        std::vector<std::uint32_t> registered = std::vector<std::uint32_t>(depth_width * depth_height);
+        std::vector<float> bigdepth = std::vector<float>(color_width * registration_engine::bigdepth_height);
+        libfreenect2::Frame depth_frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(depth.data())};
+        libfreenect2::Frame color_frame{color_width, color_height, 4, reinterpret_cast<unsigned char*>(color.data())};
+        libfreenect2::Frame undistorted_frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(undistorted.data())};
+        libfreenect2::Frame registered_frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(registered.data())};
+        libfreenect2::Frame bigdepth_frame{color_width, registration_engine::bigdepth_height, 4,
+                                           reinterpret_cast<unsigned char*>(bigdepth.data())};
+
+        scene()
+        {
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> noise(-5.0f, 5.0f);
+            std::uniform_int_distribution<int> hole(0, 99);
+            for(std::size_t r = 0; r < depth_height; ++r)
+                for(std::size_t c = 0; c < depth_width; ++c)
+                {
+                    const bool box = r > 150 && r < 260 && c > 200 && c < 320;
+                    depth[r * depth_width + c] = hole(rng) < 3 ? 0.0f : (box ? 900.0f : 2500.0f) + noise(rng);
+                }
+            for(std::size_t i = 0; i < color.size(); ++i)
+                color[i] = static_cast<std::uint32_t>(i);
+        }
+    };
+
+    void registerWith(vision::bench::state& state, const registration_engine::kernel kernel, const std::size_t threads,
+                      const bool with_bigdepth)
+    {
+        scene _scene;
+        registration_engine engine("", irParams(), colorParams(), {false, "", threads, {}}, kernel);
+        state.setItemsPerIteration(depth_width * depth_height);
+        state.measure([&] {
+            engine.apply(_scene.color_frame, _scene.depth_frame, _scene.undistorted_frame, _scene.registered_frame,
+                         true, with_bigdepth ? &_scene.bigdepth_frame : nullptr);
+            vision::bench::doNotOptimize(_scene.registered.data());
+        });
+        state.setCounter("kernel", static_cast<int>(engine.getKernel()));
+        state.setCounter("threads", static_cast<double>(threads));
+    }
+}
+
+/**
+ * @brief Baseline: libfreenect2's Registration::apply.
+ */
+VISION_BENCH(registration_libfreenect2, 100)
+{
+    scene _scene;
+    const libfreenect2::Registration registration(irParams(), colorParams());
+    state.setItemsPerIteration(depth_width * depth_height);
+    state.measure([&] {
+        registration.apply(&_scene.color_frame, &_scene.depth_frame, &_scene.undistorted_frame,
+                           &_scene.registered_frame, true);
+        vision::bench::doNotOptimize(_scene.registered.data());
+    });
+}
+
+/**
+ * @brief Baseline with the bigdepth frame.
+ */
+VISION_BENCH(registration_libfreenect2_bigdepth, 100)
+{
+    scene _scene;
+    const libfreenect2::Registration registration(irParams(), colorParams());
+    state.setItemsPerIteration(depth_width * depth_height);
+    state.measure([&] {
+        registration.apply(&_scene.color_frame, &_scene.depth_frame, &_scene.undistorted_frame,
+                           &_scene.registered_frame, true, &_scene.bigdepth_frame);
+        vision::bench::doNotOptimize(_scene.registered.data());
+    });
+}
+
+VISION_BENCH(registration_engine_scalar, 100)
+{
+    registerWith(state, registration_engine::kernel::Scalar, 1, false);
+}
+
+VISION_BENCH(registration_engine_avx2, 100)
+{
+    registerWith(state, registration_engine::kernel::AVX2, 1, false);
+}
+
+VISION_BENCH(registration_engine_avx2_bigdepth, 100)
+{
+    registerWith(state, registration_engine::kernel::AVX2, 1, true);
+}
+
+/**
+ * @brief Best kernel on one thread per core.
+ */
+VISION_BENCH(registration_engine_all_threads, 100)
+{
+    registerWith(state, registration_engine::kernel::Auto, std::thread::hardware_concurrency(), false);
+}
+
+/**
+ * @brief Table construction, which the cache skips for a known device.
+ */
+VISION_BENCH(registration_engine_build_tables, 20)
+{
+    state.setItemsPerIteration(1);
+    state.measure([&] {
+        registration_engine engine("", irParams(), colorParams(), {false, "", 1, {}});
+        vision::bench::doNotOptimize(&engine);
+    });
+}
+
+/**
+ * @brief Table load from the on-disk cache.
+ */
+VISION_BENCH(registration_engine_load_cached_tables, 20)
+{
+    const std::string directory = std::filesystem::temp_directory_path() / "registration_bench_cache";
+    registration_engine warm("bench", irParams(), colorParams(), {true, directory, 1, {}});
+    state.setItemsPerIteration(1);
+    state.measure([&] {
+        registration_engine engine("bench", irParams(), colorParams(), {true, directory, 1, {}});
+        vision::bench::doNotOptimize(&engine);
+    });
+    std::filesystem::remove_all(directory);
+}
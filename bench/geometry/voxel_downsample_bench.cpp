@@ -0,0 +1,124 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "bench.h"
+#include "geometry/voxel_downsampler.h"
+
+namespace
+{
+    constexpr std::size_t device_count = 4;
+    constexpr std::size_t device_points = vision::point_cloud_builder::depth_width * vision::point_cloud_builder::depth_height;
+
+    /**
+     * @brief Merged cloud of four devices: noisy, partly overlapping surfaces and a few percent of invalid points.
+     */
+    vision::point_cloud makeMergedCloud()
+    {
+        vision::point_cloud cloud;
+        cloud.resize(device_count * device_points, 1, true);
+        std::mt19937 rng(5);
+        std::normal_distribution<float> noise(0.0f, 0.003f);
+        std::uniform_int_distribution<int> hole(0, 99);
+        for(std::size_t i = 0; i < cloud.size(); ++i)
+        {
+            const std::size_t pixel = i % device_points;
+            const float u = static_cast<float>(pixel % 512) / 512.0f * 3.0f - 1.5f;
+            const float v = static_cast<float>(pixel / 512) / 424.0f * 2.4f - 1.2f;
+            const float depth = 2.0f + 0.3f * std::sin(3.0f * u) * std::cos(2.0f * v);
+            const bool invalid = hole(rng) < 3;
+            cloud.x[i] = invalid ? NAN : u + noise(rng);
+            cloud.y[i] = invalid ? NAN : v + noise(rng);
+            cloud.z[i] = invalid ? NAN : depth + noise(rng) + 0.002f * static_cast<float>(i / device_points);
+            const auto color = static_cast<std::uint32_t>(pixel * 2654435761u);
+            std::memcpy(&cloud.rgb[i], &color, sizeof(color));
+        }
+        return cloud;
+    }
+
+    void downsampleWith(vision::bench::state& state, const vision::voxel_point point, const std::size_t threads)
+    {
+        const vision::point_cloud cloud = makeMergedCloud();
+        vision::voxel_downsampler downsampler({0.01f, point, threads});
+        vision::point_cloud downsampled;
+        state.setItemsPerIteration(cloud.size());
+        state.measure([&] {
+            downsampler.downsample(cloud, downsampled);
+            vision::bench::doNotOptimize(downsampled.x.data());
+        });
+        state.setCounter("voxels", static_cast<double>(downsampled.size()));
+        state.setCounter("threads", static_cast<double>(downsampler.getThreadCount()));
+    }
+}
+
+/**
+ * @brief Baseline: centroids gathered in a std::unordered_map built from empty every frame.
+ */
+VISION_BENCH(voxel_downsample_unordered_map, 20)
+{
+    struct sum
+    {
+        double x = 0, y = 0, z = 0;
+        std::uint32_t b = 0, g = 0, r = 0, count = 0;
+    };
+    const vision::point_cloud cloud = makeMergedCloud();
+    vision::point_cloud downsampled;
+    state.setItemsPerIteration(cloud.size());
+    state.measure([&] {
+        std::unordered_map<std::uint64_t, sum> voxels;
+        for(std::size_t i = 0; i < cloud.size(); ++i)
+        {
+            if(std::isnan(cloud.x[i]) || std::isnan(cloud.y[i]) || std::isnan(cloud.z[i]))
+                continue;
+            const auto coordinate = [](const float v) {
+                return static_cast<std::uint64_t>(static_cast<std::int64_t>(std::floor(v * 100.0f)) + (1 << 20)) & 0x1fffff;
+            };
+            sum& voxel = voxels[coordinate(cloud.x[i]) | coordinate(cloud.y[i]) << 21 | coordinate(cloud.z[i]) << 42];
+            std::uint32_t color;
+            std::memcpy(&color, &cloud.rgb[i], sizeof(color));
+            voxel.x += cloud.x[i];
+            voxel.y += cloud.y[i];
+            voxel.z += cloud.z[i];
+            voxel.b += color & 0xff;
+            voxel.g += color >> 8 & 0xff;
+            voxel.r += color >> 16 & 0xff;
+            ++voxel.count;
+        }
+        downsampled.resize(voxels.size(), 1, true);
+        std::size_t out = 0;
+        for(const auto& [key, voxel] : voxels)
+        {
+            downsampled.x[out] = static_cast<float>(voxel.x / voxel.count);
+            downsampled.y[out] = static_cast<float>(voxel.y / voxel.count);
+            downsampled.z[out] = static_cast<float>(voxel.z / voxel.count);
+            const std::uint32_t color = voxel.b / voxel.count | voxel.g / voxel.count << 8 | voxel.r / voxel.count << 16;
+            std::memcpy(&downsampled.rgb[out++], &color, sizeof(color));
+        }
+        vision::bench::doNotOptimize(downsampled.x.data());
+    });
+    state.setCounter("voxels", static_cast<double>(downsampled.size()));
+}
+
+VISION_BENCH(voxel_downsample_centroid_1_thread, 20)
+{
+    downsampleWith(state, vision::voxel_point::Centroid, 1);
+}
+
+VISION_BENCH(voxel_downsample_first_1_thread, 20)
+{
+    downsampleWith(state, vision::voxel_point::First, 1);
+}
+
+/**
+ * @brief Centroids on one thread per core.
+ */
+VISION_BENCH(voxel_downsample_centroid_all_threads, 20)
+{
+    downsampleWith(state, vision::voxel_point::Centroid, std::thread::hardware_concurrency());
+}
@@ -0,0 +1,40 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <filesystem>
+#include <format>
+#include "bench.h"
+#include "logger/binary_logger.h"
+
+/**
+ * @brief One per-frame telemetry event written by binary_logger.
+ */
+VISION_BENCH(binary_logger_frame_event, 200000)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "fusion_bench.blog").string();
+    vision::binary_logger telemetry;
+    telemetry.open(path);
+    const std::uint16_t id = telemetry.registerFormat("device {} decoded frame {} in {:.2f} ms");
+
+    std::uint32_t sequence = 0;
+    state.setItemsPerIteration(1);
+    state.measure([&] {
+        telemetry.event<vision::logger::Info>(id, 2, ++sequence, 4.25);
+    });
+    telemetry.close();
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief The same event formatted to text, the least a text sink pays before any I/O.
+ */
+VISION_BENCH(text_format_frame_event, 200000)
+{
+    std::uint32_t sequence = 0;
+    state.setItemsPerIteration(1);
+    state.measure([&] {
+        std::string text = std::format("device {} decoded frame {} in {:.2f} ms", 2, ++sequence, 4.25);
+        vision::bench::doNotOptimize(text);
+    });
+}
@@ -0,0 +1,73 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "logger/console_logger.h"
+
+namespace
+{
+    /**
+     * @brief Eight threads logging to /dev/null; each sample is one log() call.
+     *
+     * The stream is a real file, so the synchronous mode pays a write() per call under the
+     * output lock, like stdout does in production. The asynchronous mode blocks on a full
+     * ring instead of dropping, so both modes write every message.
+     */
+    void logFromEightThreads(vision::bench::state& state, const bool async)
+    {
+        constexpr int threads = 8;
+        const std::size_t calls_per_thread = state.getIterations() / threads;
+
+        std::ofstream null_stream("/dev/null");
+        vision::ConsoleLogger* logger = vision::ConsoleLogger::getInstance();
+        logger->setStream(null_stream);
+        const std::uint64_t dropped_before = logger->getDroppedCount();
+        if(async)
+            logger->startAsync({4096, vision::log_overflow::Block, std::chrono::milliseconds(20)});
+
+        std::vector<std::vector<std::int64_t>> samples(threads);
+        std::vector<std::thread> workers;
+        // Includes one thread and one message per worker, negligible against the calls.
+        const std::uint64_t allocations_before = vision::bench::allocationCount();
+        for(int thread = 0; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread] {
+                const std::string message = "device " + std::to_string(thread) + " received depth frame";
+                samples[thread].reserve(calls_per_thread);
+                for(std::size_t i = 0; i < calls_per_thread; ++i)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    logger->log(vision::logger::Info, message);
+                    samples[thread].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start).count());
+                }
+            });
+        }
+        for(auto& worker : workers)
+            worker.join();
+        state.addAllocations(vision::bench::allocationCount() - allocations_before, threads * calls_per_thread);
+
+        logger->stopAsync();
+        logger->setStream(std::cout);
+
+        for(const auto& thread_samples : samples)
+            for(const auto sample : thread_samples)
+                state.record(sample);
+        state.setCounter("dropped", static_cast<double>(logger->getDroppedCount() - dropped_before));
+    }
+}
+
+VISION_BENCH(console_logger_sync_8_threads, 80000)
+{
+    logFromEightThreads(state, false);
+}
+
+VISION_BENCH(console_logger_async_8_threads, 80000)
+{
+    logFromEightThreads(state, true);
+}
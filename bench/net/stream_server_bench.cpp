@@ -0,0 +1,121 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "net/stream_client.h"
+#include "net/stream_server.h"
+
+namespace
+{
+    std::int64_t nowNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Streams pooled frames over loopback to a number of clients as fast as they take them.
+     *
+     * The publisher keeps at most two frames in flight to the slowest client, so nothing
+     * is dropped and the samples measure sending rather than queueing. The samples are the latency from a frame's arrival time to its complete receipt,
+     * over every client; MB_per_s is the payload rate one client receives.
+     */
+    void streamWith(vision::bench::state& state, const libfreenect2::Frame::Type type, const std::size_t client_count,
+                    const bool zerocopy)
+    {
+        const auto pool = vision::frame_pool::create({8, 0, 8});
+        vision::stream_server_config config;
+        config.zerocopy = zerocopy;
+        vision::stream_server server(config);
+        if(server.start().status != vision::Status::Success)
+            return;
+
+        const auto frames = static_cast<std::uint32_t>(state.getIterations());
+        std::vector<std::vector<std::int64_t>> samples(client_count);
+        std::vector<std::uint64_t> payload_bytes(client_count, 0);
+        std::atomic<std::size_t> subscribed{0};
+        const auto received = std::make_unique<std::atomic<std::uint32_t>[]>(client_count);
+        std::vector<std::thread> threads;
+        for(std::size_t c = 0; c < client_count; ++c)
+            threads.emplace_back([&, c] {
+                vision::stream_client client;
+                if(client.connect("127.0.0.1", server.getPort()).status != vision::Status::Success)
+                    return;
+                client.subscribe(type);
+                samples[c].reserve(frames);
+                subscribed.fetch_add(1);
+                vision::received_frame frame;
+                while(client.receive(frame, std::chrono::milliseconds(500)).status == vision::Status::Success)
+                {
+                    samples[c].push_back(nowNanoseconds() - frame.header.arrival_ns);
+                    payload_bytes[c] += frame.payload.size();
+                    received[c].store(frame.header.sequence + 1, std::memory_order_release);
+                    if(frame.header.sequence + 1 == frames)
+                        break;
+                }
+            });
+        while(subscribed.load() < client_count || server.getStatistics().clients < client_count)
+            std::this_thread::yield();
+        // Let the subscriptions reach the event loop.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        const auto begin = std::chrono::steady_clock::now();
+        for(std::uint32_t i = 0; i < frames; ++i)
+        {
+            for(std::size_t c = 0; c < client_count; ++c)
+                while(received[c].load(std::memory_order_acquire) + 2 < i + 1 && threads[c].joinable()
+                      && std::chrono::steady_clock::now() - begin < std::chrono::seconds(30))
+                    std::this_thread::yield();
+            vision::frame_handle frame;
+            while(!(frame = pool->acquire(type)))
+                std::this_thread::yield();
+            frame->sequence = i;
+            frame->format = type == libfreenect2::Frame::Color ? libfreenect2::Frame::BGRX : libfreenect2::Frame::Float;
+            std::memset(frame->data, static_cast<int>(i & 0xff), 4096);
+            frame.setArrivalTime(nowNanoseconds());
+            server.publish(0, frame);
+        }
+        for(auto& thread : threads)
+            thread.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        for(const auto& client_samples : samples)
+            for(const auto sample : client_samples)
+                state.record(sample);
+        const vision::stream_server_statistics statistics = server.getStatistics();
+        state.setCounter("MB_per_s", static_cast<double>(payload_bytes[0]) / seconds / 1e6);
+        state.setCounter("dropped", static_cast<double>(statistics.dropped));
+        state.setCounter("frames_per_send", static_cast<double>(statistics.frames_sent)
+                                            / static_cast<double>(std::max<std::uint64_t>(statistics.send_calls, 1)));
+        state.setCounter("zerocopy_calls", static_cast<double>(statistics.zerocopy_calls));
+        server.stop();
+    }
+}
+
+VISION_BENCH(stream_server_depth, 600)
+{
+    streamWith(state, libfreenect2::Frame::Depth, 1, true);
+}
+
+VISION_BENCH(stream_server_depth_copy, 600)
+{
+    streamWith(state, libfreenect2::Frame::Depth, 1, false);
+}
+
+VISION_BENCH(stream_server_depth_4_clients, 600)
+{
+    streamWith(state, libfreenect2::Frame::Depth, 4, true);
+}
+
+VISION_BENCH(stream_server_color, 120)
+{
+    streamWith(state, libfreenect2::Frame::Color, 1, true);
+}
@@ -0,0 +1,75 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "recorder/frame_recorder.h"
+
+/**
+ * @brief Four capture threads recording full-size color and depth frames at 30 Hz.
+ *
+ * The per-frame samples are the time a capture thread spends inside record(), which is
+ * what capture pays; the disk throughput and the drop count show whether the writer keeps up.
+ */
+VISION_BENCH(frame_recorder_4x_color_depth, 240)
+{
+    constexpr int devices = 4;
+    const std::string path = (std::filesystem::temp_directory_path() / "fusion_bench_recording").string();
+    const std::size_t frames_per_device = state.getIterations() / devices;
+
+    vision::frame_recorder recorder;
+    recorder.open(path);
+
+    std::vector<std::vector<std::int64_t>> samples(devices);
+    std::atomic<int> ready{0};
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for(int device_id = 0; device_id < devices; ++device_id)
+    {
+        threads.emplace_back([&, device_id] {
+            libfreenect2::Frame color(1920, 1080, 4);
+            libfreenect2::Frame depth(512, 424, 4);
+            std::memset(color.data, device_id, 1920 * 1080 * 4);
+            std::memset(depth.data, device_id, 512 * 424 * 4);
+            samples[device_id].reserve(frames_per_device);
+            ready.fetch_add(1);
+            auto next_frame = std::chrono::steady_clock::now();
+            for(std::size_t i = 0; i < frames_per_device; ++i)
+            {
+                next_frame += std::chrono::microseconds(33333);
+                std::this_thread::sleep_until(next_frame);
+                const auto start = std::chrono::steady_clock::now();
+                recorder.record(device_id, color, libfreenect2::Frame::Color, 0);
+                recorder.record(device_id, depth, libfreenect2::Frame::Depth, 0);
+                samples[device_id].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count());
+            }
+        });
+    }
+    // Count the allocations of the recording loops only, not the thread and frame set-up.
+    while(ready.load() < devices)
+        std::this_thread::yield();
+    const std::uint64_t allocations_before = vision::bench::allocationCount();
+    for(auto& thread : threads)
+        thread.join();
+    state.addAllocations(vision::bench::allocationCount() - allocations_before, devices * frames_per_device);
+    recorder.close();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    for(const auto& device_samples : samples)
+        for(const auto sample : device_samples)
+            state.record(sample);
+
+    const vision::recorder_statistics statistics = recorder.getStatistics();
+    state.setCounter("disk_MBps", static_cast<double>(statistics.bytes_written) / seconds / 1e6);
+    state.setCounter("written", static_cast<double>(statistics.frames_written));
+    state.setCounter("dropped", static_cast<double>(statistics.dropped));
+
+    std::filesystem::remove(vision::recording::dataPath(path));
+    std::filesystem::remove(vision::recording::indexPath(path));
+}
@@ -23,4 +23,8 @@
 
 #define DEFAULT_DEVICE_NAME "Kinect"
 
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 4 ///< Most verbose log level compiled in (logger::Level); release builds set 3 to drop Debug formatting.
+#endif
+
 #endif //CONFIG_H
@@ -0,0 +1,166 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef DEPTH_CODEC_H
+#define DEPTH_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "debug/status.h"
+#include "device/simd_dispatch.h"
+#include "device/worker_pool.h"
+
+namespace vision
+{
+    /**
+     * @struct depth_codec_header
+     * @brief Start of an encoded depth frame.
+     *
+     * The header is followed by one 32-bit byte count per band and then the bands
+     * themselves, each a whole number of 32-bit words. All fields are little-endian.
+     */
+    struct depth_codec_header
+    {
+        static constexpr std::uint32_t codec_magic = 0x444c5652u; ///< "RVLD".
+        static constexpr std::uint16_t codec_version = 1; ///< Current stream version.
+
+        std::uint32_t magic = codec_magic; ///< codec_magic.
+        std::uint16_t version = codec_version; ///< Stream version.
+        std::uint16_t bands = 0; ///< Number of bands.
+        std::uint32_t width = 0; ///< Frame width.
+        std::uint32_t height = 0; ///< Frame height.
+    };
+
+    static_assert(sizeof(depth_codec_header) == 16, "depth_codec_header is part of the stream format");
+
+    /**
+     * @struct depth_codec_config
+     * @brief Settings of a depth codec.
+     */
+    struct depth_codec_config
+    {
+        std::size_t threads = 1; ///< Threads coding the bands of one frame, including the caller.
+        std::vector<int> cpus; ///< Cores the extra threads are pinned to; empty leaves them unpinned.
+        std::size_t bands = 8; ///< Horizontal bands coded independently; bounds the parallelism of a frame.
+    };
+
+    /**
+     * @class depth_codec
+     * @brief Lossless codec for depth frames quantized to 16-bit millimeters.
+     *
+     * Depths are rounded to whole millimeters and clamped to [0, 65535]; holes, negative
+     * and NaN depths become 0. The quantized frame is coded without loss with RVL
+     * (Wilson, "Fast Lossless Depth Image Compression", 2017): runs of holes and of valid
+     * pixels alternate, and every valid pixel stores its zigzagged difference to the
+     * previous valid pixel, all as variable-length 3-bit nibbles.
+     *
+     * The frame is cut into horizontal bands coded independently, so the bands of one
+     * frame are coded in parallel on the worker pool and the output does not depend on
+     * the thread count. Quantizing, dequantizing and the run search have a scalar and an
+     * AVX2 kernel working on sixteen pixels at a time, see simd_dispatch.h.
+     *
+     * A codec keeps scratch buffers and its pool, so it must be used by one thread at a time.
+     */
+    class depth_codec {
+    public:
+        using kernel = simd_kernel; ///< Codec kernel implementation.
+
+    private:
+        std::size_t bands; ///< Bands per frame.
+        kernel active_kernel; ///< Kernel used by encode() and decode().
+        worker_pool pool; ///< Threads coding the bands.
+        std::vector<std::uint16_t> quantized; ///< Quantized frame.
+        std::vector<std::uint32_t> band_sizes; ///< Encoded bytes of every band.
+        std::vector<std::size_t> band_offsets; ///< Offset of every band in the frame being decoded.
+
+        /**
+         * @brief Gets the number of bands a frame is cut into.
+         *
+         * @param height Number of rows.
+         * @return std::size_t The band count, at least 1 and at most height.
+         */
+        [[nodiscard]] std::size_t bandCount(std::size_t height) const;
+
+    public:
+        /**
+         * @brief Constructs a codec and starts its threads.
+         *
+         * @param config Codec settings.
+         * @param requested Kernel to use; an unsupported kernel falls back to the best supported one.
+         */
+        explicit depth_codec(const depth_codec_config& config = {}, kernel requested = kernel::Auto);
+
+        /**
+         * @brief Gets the largest encoded size of a frame.
+         *
+         * @param width Number of columns.
+         * @param height Number of rows.
+         * @param bands Bands the frame is cut into.
+         * @return std::size_t The size in bytes.
+         */
+        static std::size_t maxEncodedSize(std::size_t width, std::size_t height, std::size_t bands);
+
+        /**
+         * @brief Reads the frame size of an encoded frame without decoding it.
+         *
+         * @param data The encoded frame.
+         * @param size Size of the encoded frame in bytes.
+         * @param width Receives the width.
+         * @param height Receives the height.
+         * @return Result The result of the operation; InvalidParam if the stream is malformed.
+         */
+        static Result readHeader(const unsigned char* data, std::size_t size, std::size_t& width, std::size_t& height);
+
+        /**
+         * @brief Encodes a frame into a caller buffer.
+         *
+         * @param depth Row-major depths in millimeters.
+         * @param width Number of columns.
+         * @param height Number of rows.
+         * @param out Receives the encoded frame; at least maxEncodedSize() bytes for the bands of this codec.
+         * @param capacity Size of the output buffer in bytes.
+         * @param size Receives the encoded size in bytes.
+         * @return Result The result of the operation; InvalidParam if the buffer is too small.
+         */
+        Result encode(const float* depth, std::size_t width, std::size_t height, unsigned char* out,
+                      std::size_t capacity, std::size_t& size);
+
+        /**
+         * @brief Encodes a frame into a vector, resized to the encoded size.
+         *
+         * The vector keeps its capacity, so encoding frames of one size allocates only once.
+         *
+         * @param depth Row-major depths in millimeters.
+         * @param width Number of columns.
+         * @param height Number of rows.
+         * @param out Receives the encoded frame.
+         * @return Result The result of the operation.
+         */
+        Result encode(const float* depth, std::size_t width, std::size_t height, std::vector<unsigned char>& out);
+
+        /**
+         * @brief Decodes a frame.
+         *
+         * @param data The encoded frame.
+         * @param size Size of the encoded frame in bytes.
+         * @param depth Receives the row-major depths in millimeters.
+         * @param capacity Number of floats the depth buffer holds.
+         * @return Result The result of the operation; InvalidParam if the stream is malformed or the buffer too small.
+         */
+        Result decode(const unsigned char* data, std::size_t size, float* depth, std::size_t capacity);
+
+        /**
+         * @brief Gets the kernel in use.
+         *
+         * @return kernel The kernel.
+         */
+        [[nodiscard]] kernel getKernel() const
+        {
+            return active_kernel;
+        }
+    };
+}
+
+#endif //DEPTH_CODEC_H
@@ -0,0 +1,175 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef DEPTH_DECODER_H
+#define DEPTH_DECODER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "libfreenect2/packet_pipeline.h"
+#include "debug/status.h"
+#include "device/worker_pool.h"
+
+namespace vision
+{
+    /**
+     * @struct depth_decoder_config
+     * @brief Settings of a depth_decoder.
+     */
+    struct depth_decoder_config
+    {
+        std::size_t threads = 0; ///< Threads decoding a packet, including the calling one; 0 uses one per hardware thread.
+        std::vector<int> cpus; ///< Cores the decoding threads are pinned to, round robin; empty leaves them unpinned.
+        bool bilateral_filter = true; ///< Smooth the phase measurements with the joint bilateral filter.
+        bool edge_aware_filter = true; ///< Remove flying pixels at depth edges and depths outside [min_depth, max_depth].
+        float min_depth = 500.0f; ///< Closest depth kept by the edge-aware filter, in millimeters.
+        float max_depth = 4500.0f; ///< Farthest depth kept by the edge-aware filter, in millimeters.
+    };
+
+    /**
+     * @class depth_decoder
+     * @brief Turns raw Kinect2 depth packets into IR and depth images on a worker pool.
+     *
+     * A port of libfreenect2's CPU depth packet processor, with the same parameters and
+     * output, split into three passes over bands of rows: decoding the phase measurements,
+     * the bilateral filter with phase unwrapping, and the edge-aware filter. Each pass
+     * reads the neighbors of a pixel only from the output of the previous one, so bands
+     * run in parallel and the images do not depend on the number of threads.
+     *
+     * The calibration tables come from the device through a DumpPacketPipeline and are
+     * read on the first packet after a table source is set, or passed to loadTables().
+     * decode() must not be called from several threads at once.
+     */
+    class depth_decoder {
+    public:
+        static constexpr std::size_t width = 512;  ///< Output image width.
+        static constexpr std::size_t height = 424; ///< Output image height.
+        static constexpr std::size_t sub_image_size = 298496; ///< One 11-bit packed measurement image in a packet.
+        static constexpr std::size_t packet_size = 9 * sub_image_size; ///< Smallest packet decode() accepts.
+        static constexpr std::size_t p0_tables_size = 32 + 3 * (2 * width * height + 4); ///< Size of the P0 tables response.
+        static constexpr std::size_t lookup_table_size = 2048; ///< Entries of the 11-to-16 bit lookup table.
+
+    private:
+        /**
+         * @struct trig_entry
+         * @brief Phase offsets of the three measurements of one pixel and frequency.
+         */
+        struct trig_entry
+        {
+            float cos[3]; ///< cos(p0 + phase_in_rad[k]).
+            float sin[3]; ///< sin(-(p0 + phase_in_rad[k])).
+        };
+
+        depth_decoder_config config; ///< Decoder settings.
+        std::unique_ptr<worker_pool> pool; ///< Threads running the bands.
+
+        std::atomic<libfreenect2::DumpPacketPipeline*> table_source{nullptr}; ///< Pipeline the tables are read from.
+        std::atomic<bool> tables_stale{false}; ///< Set when the table source changed.
+        bool tables_loaded = false; ///< True once the tables below are filled.
+        std::array<std::int16_t, lookup_table_size> lookup_table{}; ///< 11-bit measurement to signed value.
+        std::vector<trig_entry> trig_table; ///< Three tables, one per modulation frequency, in packet row order.
+        std::vector<float> x_table; ///< Depth fit correction, in packet row order.
+        std::vector<float> z_table; ///< Phase to depth factor, in packet row order.
+        std::array<std::uint16_t, width> word_offset{}; ///< First 16-bit word of every column in a packed row.
+        std::array<std::uint8_t, width> bit_shift{}; ///< Bit offset of every column in its first word.
+
+        std::vector<float> measurements; ///< a, b and amplitude for three frequencies per pixel.
+        std::vector<float> normalized; ///< Normalized a, b and squared norm for three frequencies per pixel.
+        std::vector<float> filtered; ///< Measurements after the bilateral filter.
+        std::vector<std::uint8_t> max_edge_test; ///< Pixels passing the bilateral filter's edge test.
+        std::vector<float> depth_ir_sum; ///< Raw depth, IR sum and edge-tested depth per pixel.
+
+        /**
+         * @brief Reads the tables from the table source.
+         *
+         * @return Result The result of the operation.
+         */
+        Result loadSourceTables();
+
+        /**
+         * @brief Decodes the phase measurements of a band of rows.
+         */
+        void decodeMeasurements(const unsigned char* packet, std::size_t first_row, std::size_t last_row);
+
+        /**
+         * @brief Runs the bilateral filter and phase unwrapping on a band of rows.
+         */
+        void unwrapPhase(std::size_t first_row, std::size_t last_row, float* ir, float* depth);
+
+        /**
+         * @brief Runs the edge-aware filter on a band of rows.
+         */
+        void filterEdges(std::size_t first_row, std::size_t last_row, float* depth) const;
+
+    public:
+        /**
+         * @brief Starts the decoding threads, which inherit the affinity of the calling thread unless cpus is set.
+         *
+         * @param config Decoder settings.
+         */
+        explicit depth_decoder(const depth_decoder_config& config = {});
+
+        depth_decoder(const depth_decoder&) = delete;
+        depth_decoder& operator=(const depth_decoder&) = delete;
+
+        /**
+         * @brief Sets the pipeline the tables are read from on the next packet.
+         *
+         * @param source The pipeline, or nullptr to keep the current tables.
+         */
+        void setTableSource(libfreenect2::DumpPacketPipeline* source);
+
+        /**
+         * @brief Loads the calibration tables, in the layout DumpPacketPipeline exposes them.
+         *
+         * @param p0_tables The P0 tables command response.
+         * @param p0_length Size of the response in bytes.
+         * @param x_table The x table, width * height values.
+         * @param z_table The z table, width * height values.
+         * @param xz_length Number of values in each of the x and z tables.
+         * @param lookup The 11-to-16 bit lookup table.
+         * @param lookup_length Number of lookup table entries.
+         * @return Result The result of the operation.
+         */
+        Result loadTables(const unsigned char* p0_tables, std::size_t p0_length, const float* x_table,
+                          const float* z_table, std::size_t xz_length, const short* lookup, std::size_t lookup_length);
+
+        /**
+         * @brief Decodes one packet.
+         *
+         * @param packet The raw depth packet.
+         * @param length Size of the packet in bytes.
+         * @param ir Receives the width x height IR image, or nullptr.
+         * @param depth Receives the width x height depth image in millimeters, or nullptr.
+         * @return Result The result of the operation.
+         */
+        Result decode(const unsigned char* packet, std::size_t length, float* ir, float* depth);
+
+        /**
+         * @brief Checks if the calibration tables are loaded.
+         *
+         * @return bool True if packets can be decoded.
+         */
+        [[nodiscard]] bool hasTables() const
+        {
+            return tables_loaded;
+        }
+
+        /**
+         * @brief Gets the number of threads decoding a packet.
+         *
+         * @return std::size_t The thread count, including the calling thread.
+         */
+        [[nodiscard]] std::size_t getThreadCount() const
+        {
+            return pool->size();
+        }
+    };
+}
+
+#endif //DEPTH_DECODER_H
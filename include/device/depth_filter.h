@@ -0,0 +1,258 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef DEPTH_FILTER_H
+#define DEPTH_FILTER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "libfreenect2/libfreenect2.hpp"
+#include "debug/status.h"
+#include "device/simd_dispatch.h"
+
+namespace vision
+{
+    /**
+     * @class depth_filter
+     * @brief One stage of a depth_filter_chain, filtering a float depth frame in place.
+     *
+     * Depths are in millimeters and 0 marks a hole; a non-positive or NaN depth is a hole
+     * too and comes out as 0. Every filter has a scalar and an AVX2 kernel working on eight
+     * pixels at a time, see simd_dispatch.h.
+     */
+    class depth_filter {
+    public:
+        using kernel = simd_kernel; ///< Filter kernel implementation.
+
+    protected:
+        kernel active_kernel; ///< Kernel used by apply().
+
+        /**
+         * @brief Resolves the kernel of a filter.
+         *
+         * @param requested Kernel to use; an unsupported kernel falls back to the best supported one.
+         */
+        explicit depth_filter(kernel requested);
+
+    public:
+        virtual ~depth_filter() = default;
+
+        /**
+         * @brief Filters a frame in place.
+         *
+         * @param depth Row-major depths in millimeters.
+         * @param width Number of columns.
+         * @param height Number of rows.
+         */
+        virtual void apply(float* depth, std::size_t width, std::size_t height) = 0;
+
+        /**
+         * @brief Forgets any state carried from previous frames.
+         */
+        virtual void reset()
+        {
+        }
+
+        /**
+         * @brief Gets the name of the filter, for logs and benchmarks.
+         *
+         * @return const char* The name.
+         */
+        [[nodiscard]] virtual const char* getName() const = 0;
+
+        /**
+         * @brief Gets the kernel in use.
+         *
+         * @return kernel The kernel.
+         */
+        [[nodiscard]] kernel getKernel() const
+        {
+            return active_kernel;
+        }
+    };
+
+    /**
+     * @class range_filter
+     * @brief Turns depths outside [min_depth, max_depth] into holes.
+     */
+    class range_filter final : public depth_filter {
+    private:
+        float min_depth; ///< Nearest depth kept, in millimeters.
+        float max_depth; ///< Farthest depth kept, in millimeters.
+
+    public:
+        range_filter(float min_depth, float max_depth, kernel requested = kernel::Auto);
+
+        void apply(float* depth, std::size_t width, std::size_t height) override;
+
+        [[nodiscard]] const char* getName() const override
+        {
+            return "range";
+        }
+    };
+
+    /**
+     * @class flying_pixel_filter
+     * @brief Removes the pixels interpolated between a foreground and a background surface.
+     *
+     * A pixel is removed when at least min_jumps of its four neighbors differ from it by more
+     * than max_jump times its depth. A pixel on a real edge has one such neighbor; a flying
+     * pixel, hanging between the two surfaces, has two or more. Holes are not counted and the
+     * border pixels are kept as they are.
+     */
+    class flying_pixel_filter final : public depth_filter {
+    private:
+        float max_jump; ///< Largest depth step to a neighbor, as a fraction of the depth.
+        int min_jumps; ///< Neighbors that must jump for the pixel to be removed.
+        std::vector<float> source; ///< Copy of the frame being filtered.
+
+    public:
+        flying_pixel_filter(float max_jump, int min_jumps, kernel requested = kernel::Auto);
+
+        void apply(float* depth, std::size_t width, std::size_t height) override;
+
+        [[nodiscard]] const char* getName() const override
+        {
+            return "flying_pixel";
+        }
+    };
+
+    /**
+     * @class median_filter
+     * @brief 3x3 median that keeps holes and edges.
+     *
+     * A hole stays a hole. Hole neighbors take the value of the center pixel, so holes do not
+     * eat into the surfaces around them. The border pixels are kept as they are.
+     */
+    class median_filter final : public depth_filter {
+    private:
+        std::vector<float> source; ///< Copy of the frame being filtered.
+
+    public:
+        explicit median_filter(kernel requested = kernel::Auto);
+
+        void apply(float* depth, std::size_t width, std::size_t height) override;
+
+        [[nodiscard]] const char* getName() const override
+        {
+            return "median";
+        }
+    };
+
+    /**
+     * @class temporal_filter
+     * @brief Exponential moving average of every pixel over frames.
+     *
+     * A pixel is blended with its history, history + alpha * (depth - history), only while it
+     * moves less than max_delta; a larger step is taken as real motion and restarts the
+     * history. Holes are preserved: a hole stays a hole and clears the history of its pixel,
+     * so stale depths are never painted into it.
+     */
+    class temporal_filter final : public depth_filter {
+    private:
+        float alpha; ///< Weight of the new depth, in (0, 1].
+        float max_delta; ///< Largest step blended, in millimeters.
+        std::vector<float> history; ///< Filtered depth of the previous frame.
+
+    public:
+        temporal_filter(float alpha, float max_delta, kernel requested = kernel::Auto);
+
+        void apply(float* depth, std::size_t width, std::size_t height) override;
+
+        void reset() override;
+
+        [[nodiscard]] const char* getName() const override
+        {
+            return "temporal";
+        }
+    };
+
+    /**
+     * @struct depth_filter_config
+     * @brief Filters of a standard depth_filter_chain, applied in the order listed.
+     */
+    struct depth_filter_config
+    {
+        bool range = false; ///< Clip the depth range.
+        float min_depth = 500.0f; ///< Nearest depth kept, in millimeters.
+        float max_depth = 4500.0f; ///< Farthest depth kept, in millimeters.
+        bool flying_pixels = false; ///< Remove flying pixels.
+        float max_jump = 0.04f; ///< Largest depth step to a neighbor, as a fraction of the depth.
+        int min_jumps = 2; ///< Neighbors that must jump for a pixel to be removed.
+        bool median = false; ///< 3x3 median.
+        bool temporal = false; ///< Exponential moving average over frames.
+        float alpha = 0.4f; ///< Weight of the new depth.
+        float max_delta = 30.0f; ///< Largest step blended, in millimeters.
+        depth_filter::kernel kernel = depth_filter::kernel::Auto; ///< Kernel of every filter.
+    };
+
+    /**
+     * @class depth_filter_chain
+     * @brief Ordered filters applied to the depth frames of one device.
+     *
+     * Filters such as temporal_filter keep state between frames, so every device needs its
+     * own chain. The chain works in place on the frame buffer and allocates only when the
+     * frame size changes.
+     */
+    class depth_filter_chain {
+    private:
+        std::vector<std::unique_ptr<depth_filter>> filters; ///< Filters in order.
+
+    public:
+        depth_filter_chain() = default;
+
+        /**
+         * @brief Builds the chain described by a config.
+         *
+         * @param config Enabled filters and their settings.
+         */
+        explicit depth_filter_chain(const depth_filter_config& config);
+
+        depth_filter_chain(const depth_filter_chain&) = delete;
+        depth_filter_chain& operator=(const depth_filter_chain&) = delete;
+
+        /**
+         * @brief Appends a filter.
+         *
+         * @param filter The filter; applied after the ones already added.
+         */
+        void add(std::unique_ptr<depth_filter> filter);
+
+        /**
+         * @brief Filters a depth frame in place.
+         *
+         * @param frame Float depth frame.
+         * @return Result The result of the operation; InvalidParam if the frame is not a float frame.
+         */
+        Result apply(libfreenect2::Frame& frame);
+
+        /**
+         * @brief Resets the state of every filter.
+         */
+        void reset();
+
+        /**
+         * @brief Gets the filters in order.
+         *
+         * @return const std::vector<std::unique_ptr<depth_filter>>& The filters.
+         */
+        [[nodiscard]] const std::vector<std::unique_ptr<depth_filter>>& getFilters() const
+        {
+            return filters;
+        }
+
+        /**
+         * @brief Checks if the chain has no filter.
+         *
+         * @return bool True if frames pass through unchanged.
+         */
+        [[nodiscard]] bool empty() const
+        {
+            return filters.empty();
+        }
+    };
+}
+
+#endif //DEPTH_FILTER_H
@@ -0,0 +1,189 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef DEVICE_CAPTURE_H
+#define DEVICE_CAPTURE_H
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "libfreenect2/libfreenect2.hpp"
+#include "debug/status.h"
+#include "device/depth_decoder.h"
+#include "device/depth_filter.h"
+#include "device/frame_listener.h"
+#include "device/frame_pool.h"
+#include "device/frame_scheduler.h"
+#include "device/latency_tracer.h"
+
+namespace vision
+{
+    /**
+     * @struct capture_config
+     * @brief Per-device capture settings.
+     */
+    struct capture_config
+    {
+        int cpu = -1; ///< Core the capture thread and libfreenect2's packet threads are pinned to; -1 leaves them unpinned.
+        frame_pool_config pool; ///< Number of pooled frame buffers.
+        std::size_t decode_threads = 0; ///< Threads decoding depth on a parallel_packet_pipeline; 0 keeps libfreenect2's CpuPacketPipeline.
+        bool compressed_color = false; ///< Deliver color as Raw JPEG frames, see lazy_color_frame; uses a parallel_packet_pipeline, with one decode thread per core if decode_threads is 0.
+        std::vector<int> decode_cpus; ///< Cores the depth decoding threads are pinned to; empty leaves them on every core of the process, whatever cpu is.
+        depth_filter_config depth_filters; ///< Filters applied to every depth frame before it is delivered.
+        latency_tracer_config latency; ///< Stamps kept for the Chrome trace of the device.
+    };
+
+    /**
+     * @brief Opens the device of a capture. Called on the capture thread with the open mutex held.
+     *
+     * Receives the capture's depth decoder, or nullptr if depth is decoded by libfreenect2, and
+     * returns the opened device, owned by the capture, or nullptr on failure. A Kinect2 opened
+     * with a decoder gets a parallel_packet_pipeline, compressed if capture_config::compressed_color is set.
+     */
+    using device_opener = std::function<libfreenect2::Freenect2Device*(depth_decoder* decoder)>;
+
+    /**
+     * @class device_capture
+     * @brief Owns one opened Kinect2, its packet pipeline and its capture thread.
+     *
+     * The device and its packet pipeline are created on the capture thread after it
+     * has been pinned, so the libfreenect2 decoding threads inherit the same affinity.
+     * The thread then drains the listener rings, filters the depth frames in place and
+     * delivers frames to the scheduler. Every frame is stamped on the way on a
+     * latency_tracer owned with the pool, so frames still held after stop() are traced too.
+     */
+    class device_capture {
+    private:
+        int device_id; ///< ID of the device.
+        std::string serial; ///< Serial number of the device.
+        capture_config config; ///< Capture settings.
+        frame_scheduler& scheduler; ///< Scheduler the frames are delivered to.
+        frame_scheduler::source* source = nullptr; ///< Delivery endpoint of the device.
+        std::shared_ptr<latency_tracer> tracer; ///< Latencies of the device frames, shared with the pool.
+        std::shared_ptr<frame_pool> pool; ///< Buffers the device frames are copied into.
+        std::unique_ptr<frame_listener> listener; ///< Listener receiving the device frames.
+        std::unique_ptr<depth_decoder> decoder; ///< Decodes raw depth packets when decode_threads or compressed_color is set.
+        depth_filter_chain depth_filters; ///< Filters the depth frames on the capture thread.
+        libfreenect2::Freenect2Device* kinect2 = nullptr; ///< Opened Kinect2 or virtual device.
+        std::thread thread; ///< Capture thread.
+        std::atomic<bool> running{false}; ///< False once the capture thread should exit.
+        bool rgb_running = false; ///< True while the color stream is started.
+        bool depth_running = false; ///< True while the IR/depth stream is started.
+
+        /**
+         * @brief Capture thread body.
+         *
+         * @param opener Opens the device.
+         * @param open_mutex Mutex serializing device opening.
+         * @param opened Receives whether the device could be opened.
+         */
+        void run(const device_opener& opener, std::mutex& open_mutex, std::promise<bool> opened);
+
+        /**
+         * @brief Pins the calling thread to the configured core.
+         *
+         * @return bool True if the thread was pinned or no core is configured.
+         */
+        [[nodiscard]] bool pinThread() const;
+
+        /**
+         * @brief Starts or stops the libfreenect2 streams to match the enabled frame types.
+         *
+         * @return Result The result of the operation.
+         */
+        Result applyStreams();
+
+    public:
+        /**
+         * @brief Constructs a capture for a device. Nothing is opened until start().
+         *
+         * @param device_id The ID of the device.
+         * @param serial The serial number of the device.
+         * @param config Capture settings.
+         * @param scheduler Scheduler the frames are delivered to.
+         */
+        device_capture(int device_id, std::string serial, const capture_config& config,
+                       frame_scheduler& scheduler);
+
+        /// Stops the capture thread and closes the device.
+        ~device_capture();
+
+        device_capture(const device_capture&) = delete;
+        device_capture& operator=(const device_capture&) = delete;
+
+        /**
+         * @brief Starts the capture thread and opens the device on it.
+         *
+         * @param opener Opens the device, a Kinect2 or a virtual_device.
+         * @param open_mutex Mutex serializing device opening across captures.
+         * @return bool True if the device was opened, false otherwise.
+         */
+        bool start(device_opener opener, std::mutex& open_mutex);
+
+        /**
+         * @brief Stops the streams and the capture thread, then closes the device.
+         */
+        void stop();
+
+        /**
+         * @brief Enables or disables a frame type and restarts the streams if needed.
+         *
+         * @param type The frame type.
+         * @param enabled True to enable the frame type.
+         * @return Result The result of the operation.
+         */
+        Result setFrameTypeEnabled(libfreenect2::Frame::Type type, bool enabled);
+
+        /**
+         * @brief Gets the frame counters of the device.
+         *
+         * @return stream_statistics Snapshot of the counters.
+         */
+        [[nodiscard]] stream_statistics getStatistics() const;
+
+        /**
+         * @brief Gets the latency histograms of the device frames.
+         *
+         * @return latency_snapshot Snapshot of the histograms.
+         */
+        [[nodiscard]] latency_snapshot getLatencySnapshot() const;
+
+        /**
+         * @brief Gets the latency tracer of the device frames.
+         *
+         * @return const latency_tracer& The tracer.
+         */
+        [[nodiscard]] const latency_tracer& getTracer() const
+        {
+            return *tracer;
+        }
+
+        /**
+         * @brief Gets the opened Kinect2 device.
+         *
+         * @return libfreenect2::Freenect2Device* Pointer to the device, or nullptr if not open.
+         */
+        [[nodiscard]] libfreenect2::Freenect2Device* getKinect2() const
+        {
+            return kinect2;
+        }
+
+        /**
+         * @brief Gets the core the capture is pinned to.
+         *
+         * @return int The core index, or -1 if unpinned.
+         */
+        [[nodiscard]] int getCpu() const
+        {
+            return config.cpu;
+        }
+    };
+}
+
+#endif //DEVICE_CAPTURE_H
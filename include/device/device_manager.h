@@ -18,6 +18,18 @@
 #include "logger/console_logger.h"
 #include "debug/status.h"
 #include "device.h" // Device header
+#include "device/device_capture.h"
+#include "device/device_registry.h"
+#include "device/frame_bus.h"
+#include "device/frame_scheduler.h"
+#include "device/virtual_device.h"
+#include "geometry/extrinsics_store.h"
+#include "ipc/shm_publisher.h"
+#include "net/stream_server.h"
+#include "recorder/frame_recorder.h"
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>  // C++17 feature for optional return types
 #include "gtest/gtest.h"
 
@@ -35,11 +47,23 @@ namespace vision
     class device_manager {
     private:
         libfreenect2::Freenect2 freenect2; ///< Instance of the Freenect2 library.
-        libfreenect2::Freenect2Device *freenect2_device = nullptr; ///< Device manager instance.
-        libfreenect2::PacketPipeline *freenect2_pipeline = nullptr; ///< Packet pipeline instance.
+        std::mutex open_mutex; ///< Serializes opening and closing devices on the USB context.
         ConsoleLogger* console_logger = ConsoleLogger::getInstance(); ///< Logger instance.
+        device_registry registry{[this] { return scanDevices(); }}; ///< Cached Kinect2 enumeration, refreshed on hotplug.
+        std::uint64_t devices_version = 0; ///< Registry version the device list was built from.
         std::vector<device> devices; ///< List of devices.
         std::vector<device> selected_devices; ///< List of selected devices.
+        // Declared before the captures, which detach from the scheduler when they are destroyed.
+        frame_scheduler scheduler; ///< Delivers the frames of every opened device to consumers.
+        frame_bus bus{scheduler}; ///< Queues the scheduled frames for each subscriber.
+        std::map<int, std::unique_ptr<device_capture>> captures; ///< Opened devices, keyed by device ID.
+        std::map<int, capture_config> capture_configs; ///< Capture settings, keyed by device ID.
+        std::map<int, virtual_device_config> virtual_devices; ///< Registered virtual devices, keyed by device ID.
+        int next_virtual_id = first_virtual_id; ///< ID of the next virtual device.
+        std::unique_ptr<frame_recorder> recorder; ///< Records the scheduled frames while a recording is open.
+        std::unique_ptr<shm_publisher> publisher; ///< Publishes the scheduled frames to shared memory while open.
+        std::unique_ptr<stream_server> streamer; ///< Streams the scheduled frames over TCP while running.
+        extrinsics_store extrinsics; ///< Poses of the calibrated devices, loaded at startup.
         static device_manager* instance; ///< Singleton instance.
 
         // Private constructor and destructor for Singleton pattern
@@ -95,6 +119,9 @@ namespace vision
         /**
          * @brief Starts the specified device.
          *
+         * Opens the device with its own packet pipeline on a dedicated capture thread,
+         * pinned according to its capture_config.
+         *
          * @param device_id The ID of the device to start.
          * @return bool True if the device was started successfully, false otherwise.
          */
@@ -125,13 +152,53 @@ namespace vision
         bool openDevice(int device_id);
 
         /**
-         * @brief Enumerates all available devices.
+         * @brief Gets the capture of an opened device.
+         *
+         * @param device_id The ID of the device.
+         * @return device_capture* Pointer to the capture, or nullptr if the device is not open.
+         */
+        device_capture* getCapture(int device_id);
+
+        /**
+         * @brief Enables or disables a frame type on a device, opening it if needed.
+         *
+         * @param device_id The ID of the device.
+         * @param type The frame type to change.
+         * @param enabled True to enable the frame type.
+         * @return Result The result of the operation.
+         */
+        Result setStreamEnabled(int device_id, libfreenect2::Frame::Type type, bool enabled);
+
+        /**
+         * @brief Enumerates all available devices from the enumeration cache.
          *
          * @return std::vector<Device> A list of available devices.
          */
         std::vector<device> enumerateDevices();
 
+        /**
+         * @brief Scans the USB bus for Kinect2 devices; called by the registry only.
+         *
+         * @return std::vector<registry_entry> The devices found, with their serial numbers.
+         */
+        std::vector<registry_entry> scanDevices();
+
+        /**
+         * @brief Rebuilds the device list if the registry changed since it was built.
+         */
+        void syncDevices();
+
+        /**
+         * @brief Gets the serial number of a Kinect2 or virtual device.
+         *
+         * @param device_id The ID of the device.
+         * @return std::string The serial number, or empty if the ID is invalid.
+         */
+        std::string getDeviceSerial(int device_id);
+
     public:
+        static constexpr int first_virtual_id = 1000; ///< Virtual device IDs start here, above any USB device index.
+
         /**
          * @brief Gets the singleton instance of the DeviceManager.
          *
@@ -151,7 +218,7 @@ namespace vision
         std::optional<device> getDevice(int device_id);
 
         /**
-         * @brief Gets the count of available devices.
+         * @brief Gets the count of available devices, Kinect2 and virtual, from the enumeration cache.
          *
          * @return int The count of available devices.
          */
@@ -160,6 +227,8 @@ namespace vision
         /**
          * @brief Gets the list of devices.
          *
+         * Served from the enumeration cache; the bus is not scanned.
+         *
          * @return std::vector<Device> A list of devices.
          */
         [[nodiscard]] std::vector<device> getDeviceList();
@@ -186,7 +255,7 @@ namespace vision
         [[nodiscard]] bool deviceListIsEmpty() const;
 
         /**
-         * @brief Refreshes the device list.
+         * @brief Refreshes the device list, scanning the bus now instead of waiting for the registry.
          *
          * @return Result The result of the refresh operation.
          */
@@ -275,10 +344,200 @@ namespace vision
         /**
          * @brief Captures a single frame from a device.
          *
+         * Pops the oldest queued frame of every enabled stream without blocking.
+         * On success the result data holds a captured_frames.
+         *
          * @param device_id The ID of the device to capture the frame from.
-         * @return Result The result of the capture operation.
+         * @return Result The result of the capture operation; Pending if no frame is queued yet.
          */
         Result captureFrame(int device_id);
+
+        /**
+         * @brief Sets the capture settings of a device, such as its CPU core.
+         *
+         * Takes effect the next time the device is started.
+         *
+         * @param device_id The ID of the device.
+         * @param config The capture settings.
+         */
+        void setCaptureConfig(int device_id, const capture_config& config);
+
+        /**
+         * @brief Starts every selected device, each on its own capture thread.
+         *
+         * @return Result The result of the operation; Error lists the devices that failed.
+         */
+        Result startSelectedDevices();
+
+        /**
+         * @brief Stops every opened device.
+         */
+        void stopAllDevices();
+
+        /**
+         * @brief Gets the cached Kinect2 enumeration.
+         *
+         * Subscribe to it for hotplug events; virtual devices are not part of it.
+         *
+         * @return device_registry& The registry.
+         */
+        device_registry& getDeviceRegistry();
+
+        /**
+         * @brief Gets the scheduler that delivers frames from every opened device.
+         *
+         * @return frame_scheduler& The scheduler consumers subscribe to.
+         */
+        frame_scheduler& getScheduler();
+
+        /**
+         * @brief Gets the bus that queues frames from every opened device for each subscriber.
+         *
+         * @return frame_bus& The bus consumers subscribe to with their own queue depth and backpressure policy.
+         */
+        frame_bus& getBus();
+
+        /**
+         * @brief Gets the poses of the calibrated devices.
+         *
+         * Loaded from extrinsics_store::defaultPath() at startup.
+         *
+         * @return extrinsics_store& The store, keyed by device serial.
+         */
+        extrinsics_store& getExtrinsics();
+
+        /**
+         * @brief Gets the pose of a device in the shared world frame.
+         *
+         * @param device_id The ID of the device.
+         * @return std::optional<pose> The pose if the device is calibrated; otherwise, std::nullopt.
+         */
+        std::optional<pose> getDevicePose(int device_id);
+
+        /**
+         * @brief Gets the frame counters of a streaming device.
+         *
+         * @param device_id The ID of the device.
+         * @return std::optional<stream_statistics> The counters if the device is open; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<stream_statistics> getStreamStatistics(int device_id) const;
+
+        /**
+         * @brief Gets the latency histograms of a streaming device, from frame arrival to every stage.
+         *
+         * @param device_id The ID of the device.
+         * @return std::optional<latency_snapshot> The histograms if the device is open; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<latency_snapshot> getLatencySnapshot(int device_id) const;
+
+        /**
+         * @brief Writes the latest frame stamps of every opened device as a Chrome trace.
+         *
+         * Only devices started with capture_config::latency.trace_events set keep stamps.
+         *
+         * @param path Output JSON file path.
+         * @return Result The result of the operation.
+         */
+        [[nodiscard]] Result writeLatencyTrace(const std::string& path) const;
+
+        /**
+         * @brief Starts recording the frames of every opened device.
+         *
+         * @param path Recording path without extension.
+         * @param config Recorder settings, such as the recorded devices and frame types.
+         * @return Result The result of the operation.
+         */
+        Result startRecording(const std::string& path, const recorder_config& config = {});
+
+        /**
+         * @brief Stops the recording and writes the remaining frames.
+         *
+         * @return Result The result of the operation.
+         */
+        Result stopRecording();
+
+        /**
+         * @brief Gets the counters of the open recording.
+         *
+         * @return std::optional<recorder_statistics> The counters if a recording is open; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<recorder_statistics> getRecordingStatistics() const;
+
+        /**
+         * @brief Starts publishing the frames of every opened device to a shared-memory segment.
+         *
+         * Other processes on the host read the frames in place with shm_client.
+         *
+         * @param name Segment name.
+         * @param config Publisher settings, such as the published devices and frame types.
+         * @return Result The result of the operation.
+         */
+        Result startPublishing(const std::string& name, const publisher_config& config = {});
+
+        /**
+         * @brief Stops publishing and removes the segment name.
+         *
+         * @return Result The result of the operation.
+         */
+        Result stopPublishing();
+
+        /**
+         * @brief Gets the counters of the open publisher.
+         *
+         * @return std::optional<publisher_statistics> The counters if a segment is open; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<publisher_statistics> getPublisherStatistics() const;
+
+        /**
+         * @brief Starts streaming the frames of every opened device over TCP.
+         *
+         * Clients connect with stream_client and subscribe to the streams they want. The
+         * server listens on the loopback interface unless config.address says otherwise;
+         * the streams are unauthenticated.
+         *
+         * @param config Server settings, such as the listen address and port.
+         * @return Result The result of the operation.
+         */
+        Result startStreaming(const stream_server_config& config = {});
+
+        /**
+         * @brief Stops streaming and disconnects every client.
+         *
+         * @return Result The result of the operation.
+         */
+        Result stopStreaming();
+
+        /**
+         * @brief Gets the counters of the streaming server.
+         *
+         * @return std::optional<stream_server_statistics> The counters if the server is running; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<stream_server_statistics> getStreamingStatistics() const;
+
+        /**
+         * @brief Gets the port the streaming server listens on.
+         *
+         * @return std::uint16_t The port, or 0 if the server is not running.
+         */
+        [[nodiscard]] std::uint16_t getStreamingPort() const;
+
+        /**
+         * @brief Registers a virtual device beside the Kinect2 devices.
+         *
+         * The device is listed, selected, started and streamed like a Kinect2.
+         *
+         * @param config Virtual device settings.
+         * @return int The ID of the new device.
+         */
+        int addVirtualDevice(const virtual_device_config& config);
+
+        /**
+         * @brief Stops and unregisters a virtual device.
+         *
+         * @param device_id The ID of the device.
+         * @return bool True if the device was removed, false if it is not a virtual device.
+         */
+        bool removeVirtualDevice(int device_id);
     };
 
 } // namespace vision
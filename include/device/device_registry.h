@@ -0,0 +1,276 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef DEVICE_REGISTRY_H
+#define DEVICE_REGISTRY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "debug/status.h"
+
+namespace vision
+{
+    /**
+     * @struct registry_entry
+     * @brief A device found on the bus.
+     */
+    struct registry_entry
+    {
+        int index = -1; ///< Enumeration index, the device ID of a Kinect2.
+        std::string serial; ///< Serial number; stable across re-plugs, unlike the index.
+
+        bool operator==(const registry_entry&) const = default;
+    };
+
+    /**
+     * @struct device_table
+     * @brief Immutable result of one bus scan.
+     */
+    struct device_table
+    {
+        std::uint64_t version = 0; ///< Incremented on every change of the entries.
+        std::vector<registry_entry> entries; ///< Devices ordered by index.
+        std::unordered_map<std::string, std::size_t> by_serial; ///< Position in entries, keyed by serial.
+
+        /**
+         * @brief Finds a device by its enumeration index.
+         *
+         * @return const registry_entry* The device, or nullptr.
+         */
+        [[nodiscard]] const registry_entry* find(int index) const;
+
+        /**
+         * @brief Finds a device by its serial number.
+         *
+         * @return const registry_entry* The device, or nullptr.
+         */
+        [[nodiscard]] const registry_entry* findSerial(const std::string& serial) const;
+    };
+
+    /**
+     * @enum device_event_type
+     * @brief Kind of change found by a refresh.
+     */
+    enum class device_event_type
+    {
+        Added, ///< A serial appeared.
+        Removed, ///< A serial disappeared.
+        Reindexed ///< A serial is still present under another index.
+    };
+
+    /**
+     * @struct device_event
+     * @brief One change found by a refresh.
+     */
+    struct device_event
+    {
+        device_event_type type = device_event_type::Added; ///< Kind of change.
+        registry_entry entry; ///< The device; its old index for Removed, its new one otherwise.
+        std::uint64_t version = 0; ///< Version of the table that contains the change.
+    };
+
+    /**
+     * @struct registry_config
+     * @brief Settings of the background refresh.
+     */
+    struct registry_config
+    {
+        std::chrono::milliseconds refresh_interval{10000}; ///< Time between scans without a hotplug event, the fallback for missed events.
+        std::chrono::milliseconds settle_time{300}; ///< Wait after a hotplug event, until the device answers on the bus.
+        bool watch_hotplug = true; ///< Scan when device nodes appear or disappear under usb_path.
+        std::string usb_path = "/dev/bus/usb"; ///< Directory of the USB device nodes, watched with inotify.
+    };
+
+    /**
+     * @class device_registry
+     * @brief Caches the devices on the bus and keeps the cache fresh from a background thread.
+     *
+     * A bus scan takes tens of milliseconds, so lookups never scan: they read the latest
+     * immutable device_table. Readers only announce themselves on an atomic counter while
+     * they copy from the table, so a lookup takes microseconds and never waits for a scan.
+     * A refresh publishes a new table only when the bus changed and frees the replaced
+     * ones once no reader is inside a table.
+     *
+     * The background thread scans when inotify reports device nodes appearing or
+     * disappearing under registry_config::usb_path, and every refresh_interval anyway.
+     * Every change is reported to the listeners, from the thread that ran the refresh.
+     */
+    class device_registry {
+    public:
+        using scanner = std::function<std::vector<registry_entry>()>; ///< Scans the bus; called from one thread at a time.
+        using listener = std::function<void(const device_event&)>; ///< Change callback.
+
+    private:
+        scanner scan; ///< Scans the bus.
+        registry_config config; ///< Refresh settings.
+
+        std::atomic<const device_table*> current{nullptr}; ///< Latest table.
+        mutable std::atomic<std::uint64_t> readers{0}; ///< Lookups reading a table right now.
+        std::vector<std::unique_ptr<const device_table>> retired; ///< Replaced tables a reader may still use.
+        std::mutex refresh_mutex; ///< Serializes scans and guards retired.
+        std::atomic<std::uint64_t> scans{0}; ///< Completed scans.
+
+        mutable std::shared_mutex listeners_mutex; ///< Guards listeners.
+        std::map<int, listener> listeners; ///< Change callbacks, keyed by subscription ID.
+        int next_subscription = 0; ///< ID of the next subscription.
+
+        std::thread watcher; ///< Background refresh thread.
+        int wake_fd = -1; ///< eventfd stopping the background thread.
+        int inotify_fd = -1; ///< Watches the bus directories, or -1 without hotplug events.
+
+        /**
+         * @brief Background thread body.
+         */
+        void run();
+
+        /**
+         * @brief Watches the bus directories for device nodes; returns the inotify descriptor or -1.
+         */
+        int watchBus() const;
+
+        /**
+         * @brief Runs a function on the latest table while it cannot be freed.
+         */
+        template<typename Function>
+        auto read(Function&& function) const
+        {
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            const device_table& table = *current.load(std::memory_order_seq_cst);
+            auto value = function(table);
+            readers.fetch_sub(1, std::memory_order_release);
+            return value;
+        }
+
+    public:
+        /**
+         * @brief Constructs a registry holding an empty table.
+         *
+         * @param scan Scans the bus.
+         * @param config Refresh settings.
+         */
+        explicit device_registry(scanner scan, const registry_config& config = {});
+
+        /// Stops the background thread.
+        ~device_registry();
+
+        device_registry(const device_registry&) = delete;
+        device_registry& operator=(const device_registry&) = delete;
+
+        /**
+         * @brief Scans once, then starts the background thread.
+         *
+         * @return Result The result of the operation.
+         */
+        Result start();
+
+        /**
+         * @brief Stops the background thread; lookups keep answering from the last table.
+         */
+        void stop();
+
+        /**
+         * @brief Scans now and publishes the result, waiting for a scan in progress first.
+         *
+         * Listeners run before this returns, so they must not call refresh() themselves.
+         *
+         * @return Result Success if the table changed, Unsuccess if the bus is unchanged.
+         */
+        Result refresh();
+
+        /**
+         * @brief Copies the devices of the latest table.
+         *
+         * @return std::vector<registry_entry> Devices ordered by index.
+         */
+        [[nodiscard]] std::vector<registry_entry> entries() const;
+
+        /**
+         * @brief Gets the number of devices in the latest table.
+         *
+         * @return std::size_t The count.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * @brief Finds a device by its enumeration index.
+         *
+         * @param index The index.
+         * @return std::optional<registry_entry> The device if present; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<registry_entry> find(int index) const;
+
+        /**
+         * @brief Finds a device by its serial number.
+         *
+         * @param serial The serial number.
+         * @return std::optional<registry_entry> The device if present; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<registry_entry> findSerial(const std::string& serial) const;
+
+        /**
+         * @brief Gets the serial number of a device without copying the entry.
+         *
+         * @param index The index.
+         * @param serial Receives the serial number if the device is present.
+         * @return bool True if the device is present.
+         */
+        bool getSerial(int index, std::string& serial) const;
+
+        /**
+         * @brief Gets the version of the latest table.
+         *
+         * @return std::uint64_t The version; 0 before the first scan found a device.
+         */
+        [[nodiscard]] std::uint64_t getVersion() const;
+
+        /**
+         * @brief Gets the number of completed scans.
+         *
+         * @return std::uint64_t The count.
+         */
+        [[nodiscard]] std::uint64_t getScanCount() const
+        {
+            return scans.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Registers a change callback.
+         *
+         * @param callback Invoked with each change, from the refreshing thread.
+         * @return int The subscription ID.
+         */
+        int subscribe(listener callback);
+
+        /**
+         * @brief Removes a change callback. Waits for a call to it in progress to finish.
+         *
+         * @param subscription_id The ID returned by subscribe().
+         * @return bool True if the callback was registered.
+         */
+        bool unsubscribe(int subscription_id);
+
+        /**
+         * @brief Checks whether the background thread is running.
+         *
+         * @return bool True between start() and stop().
+         */
+        [[nodiscard]] bool isRunning() const
+        {
+            return watcher.joinable();
+        }
+    };
+}
+
+#endif //DEVICE_REGISTRY_H
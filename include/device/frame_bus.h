@@ -0,0 +1,208 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_BUS_H
+#define FRAME_BUS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include "device/frame_scheduler.h"
+
+namespace vision
+{
+    /**
+     * @enum backpressure
+     * @brief What a subscription does with a new frame when its queue is full.
+     */
+    enum class backpressure
+    {
+        DropOldest, ///< Evict the oldest queued frame.
+        DropNewest, ///< Discard the new frame.
+        Block,      ///< Stall the capture thread until there is room, up to subscriber_config::block_timeout.
+        LatestOnly, ///< Keep only the newest frame; the queue depth is ignored.
+    };
+
+    /**
+     * @struct subscriber_config
+     * @brief Settings of a frame_bus subscription.
+     */
+    struct subscriber_config
+    {
+        std::size_t queue_depth = 4; ///< Frames queued before the policy applies.
+        backpressure policy = backpressure::DropOldest; ///< Policy when the queue is full.
+        std::chrono::milliseconds block_timeout{100}; ///< Longest a Block subscription stalls a capture thread; the frame is dropped after it.
+        int device_id = -1; ///< Device to receive frames from; -1 receives every device.
+        unsigned int types = libfreenect2::Frame::Color | libfreenect2::Frame::Ir | libfreenect2::Frame::Depth; ///< Mask of frame types to receive.
+    };
+
+    /**
+     * @struct subscriber_metrics
+     * @brief Counters of a frame_bus subscription.
+     */
+    struct subscriber_metrics
+    {
+        std::uint64_t received = 0;  ///< Frames offered to the subscription.
+        std::uint64_t delivered = 0; ///< Frames popped by the subscriber.
+        std::uint64_t dropped = 0;   ///< Frames discarded by the backpressure policy.
+        std::uint64_t blocked = 0;   ///< Frames that stalled a capture thread waiting for room.
+        std::size_t queued = 0;      ///< Frames waiting in the queue.
+        std::size_t peak_queued = 0; ///< Most frames ever waiting in the queue.
+        std::int64_t last_lag_ns = 0; ///< Time from arrival to pop of the last delivered frame.
+        std::int64_t max_lag_ns = 0;  ///< Longest time from arrival to pop.
+    };
+
+    /**
+     * @class frame_bus
+     * @brief Fans the frames of a frame_scheduler out to subscribers, each with its own queue.
+     *
+     * Every subscription gets a reference to the same pooled frame, never a copy, and
+     * consumes it at its own pace from its own thread. A slow subscriber only affects
+     * the others if its policy is Block, which stalls the capture thread that produced the frame.
+     */
+    class frame_bus {
+    public:
+        /**
+         * @class subscription
+         * @brief Bounded queue of frames for one subscriber.
+         *
+         * Filled by the capture threads, drained by the subscriber. Unsubscribing wakes any waiting pop().
+         */
+        class subscription {
+        private:
+            friend class frame_bus;
+
+            const subscriber_config config; ///< Subscription settings.
+            mutable std::mutex mutex; ///< Guards the queue and the metrics.
+            std::condition_variable not_empty; ///< Signaled when a frame is queued or the subscription closes.
+            std::condition_variable not_full; ///< Signaled when a frame is popped or the subscription closes.
+            std::vector<scheduled_frame> queue; ///< Circular queue storage.
+            std::size_t head = 0; ///< Index of the oldest queued frame.
+            std::size_t count = 0; ///< Number of queued frames.
+            bool closed = false; ///< True once unsubscribed.
+            subscriber_metrics metrics; ///< Counters.
+
+            /**
+             * @brief Checks if the subscription wants a frame.
+             */
+            [[nodiscard]] bool accepts(const scheduled_frame& frame) const;
+
+            /**
+             * @brief Queues a frame according to the policy. Called from capture threads.
+             */
+            void push(const scheduled_frame& frame);
+
+            /**
+             * @brief Takes the oldest frame out of the queue. The mutex must be held and the queue not empty.
+             */
+            void take(scheduled_frame& frame);
+
+            /**
+             * @brief Marks the subscription closed and wakes every waiter.
+             */
+            void close();
+
+        public:
+            explicit subscription(const subscriber_config& config);
+
+            /**
+             * @brief Pops the oldest queued frame, waiting for one up to a timeout.
+             *
+             * @param frame Receives the frame.
+             * @param timeout Longest time to wait.
+             * @return bool True if a frame was popped, false on timeout or once unsubscribed and drained.
+             */
+            bool pop(scheduled_frame& frame, std::chrono::nanoseconds timeout);
+
+            /**
+             * @brief Pops the oldest queued frame without waiting.
+             *
+             * @param frame Receives the frame.
+             * @return bool True if a frame was popped, false if the queue was empty.
+             */
+            bool tryPop(scheduled_frame& frame);
+
+            /**
+             * @brief Gets the counters of the subscription.
+             *
+             * @return subscriber_metrics A snapshot of the counters.
+             */
+            [[nodiscard]] subscriber_metrics getMetrics() const;
+
+            /**
+             * @brief Gets the settings of the subscription.
+             *
+             * @return const subscriber_config& The settings.
+             */
+            [[nodiscard]] const subscriber_config& getConfig() const
+            {
+                return config;
+            }
+
+            /**
+             * @brief Checks if the subscription was removed from its bus.
+             *
+             * @return bool True once unsubscribed.
+             */
+            [[nodiscard]] bool isClosed() const;
+        };
+
+    private:
+        frame_scheduler& scheduler; ///< Source of the frames.
+        int scheduler_subscription; ///< Subscription of the bus on the scheduler.
+        mutable std::shared_mutex subscriptions_mutex; ///< Guards subscriptions.
+        std::vector<std::shared_ptr<subscription>> subscriptions; ///< Active subscriptions.
+
+        /**
+         * @brief Offers a frame to every subscription. Called from capture threads.
+         */
+        void publish(const scheduled_frame& frame);
+
+    public:
+        /**
+         * @brief Attaches the bus to a scheduler.
+         *
+         * @param scheduler The scheduler to take the frames of. Must outlive the bus.
+         */
+        explicit frame_bus(frame_scheduler& scheduler);
+
+        /// Detaches from the scheduler and closes every subscription.
+        ~frame_bus();
+
+        frame_bus(const frame_bus&) = delete;
+        frame_bus& operator=(const frame_bus&) = delete;
+
+        /**
+         * @brief Adds a subscriber.
+         *
+         * @param config The subscription settings. A queue depth of 0 is treated as 1.
+         * @return std::shared_ptr<subscription> The subscription to pop frames from.
+         */
+        std::shared_ptr<subscription> subscribe(const subscriber_config& config = {});
+
+        /**
+         * @brief Removes a subscriber and releases the capture threads blocked on it.
+         *
+         * Frames still queued can be popped until the subscription is drained.
+         *
+         * @param subscriber The subscription returned by subscribe().
+         * @return bool True if the subscription was removed, false if it was not found.
+         */
+        bool unsubscribe(const std::shared_ptr<subscription>& subscriber);
+
+        /**
+         * @brief Gets the number of active subscriptions.
+         *
+         * @return std::size_t The number of subscriptions.
+         */
+        [[nodiscard]] std::size_t subscriberCount() const;
+    };
+}
+
+#endif //FRAME_BUS_H
@@ -0,0 +1,197 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_LISTENER_H
+#define FRAME_LISTENER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "libfreenect2/frame_listener.hpp"
+#include "device/depth_decoder.h"
+#include "device/frame_pool.h"
+#include "device/frame_ring.h"
+
+namespace vision
+{
+    /**
+     * @struct stream_statistics
+     * @brief Counters describing the traffic seen by a frame listener.
+     */
+    struct stream_statistics
+    {
+        std::uint64_t received = 0; ///< Frames accepted from libfreenect2.
+        std::uint64_t dropped = 0;  ///< Frames evicted because the consumer fell behind or the pool ran dry.
+        std::uint64_t ignored = 0;  ///< Frames of a disabled stream handed back to libfreenect2.
+    };
+
+    /**
+     * @class frame_listener
+     * @brief Non-blocking libfreenect2 listener feeding one ring per frame type.
+     *
+     * onNewFrame() runs on the libfreenect2 packet threads and must never block them.
+     * Frames are pushed into a bounded SPSC ring; when the consumer falls behind the
+     * oldest frame is dropped and counted instead of stalling the producer.
+     *
+     * Frame data is copied into a pooled buffer and libfreenect2 keeps its own
+     * frame, so the processors reuse their buffers and steady-state capture does
+     * not allocate. With a depth decoder set, raw depth packets are decoded straight
+     * into the pooled IR and depth buffers instead.
+     */
+    class frame_listener : public libfreenect2::FrameListener {
+    public:
+        static constexpr std::size_t ring_capacity = 4; ///< Frames buffered per stream.
+
+    private:
+        using ring = frame_ring<frame_slot*, ring_capacity>;
+
+        std::shared_ptr<frame_pool> pool; ///< Pool providing the frame buffers.
+        ring color_ring; ///< Color frames.
+        ring ir_ring;    ///< Infrared frames.
+        ring depth_ring; ///< Depth frames.
+        std::atomic<unsigned int> frame_types{0}; ///< Mask of enabled libfreenect2::Frame::Type values.
+        std::atomic<std::uint64_t> received{0};  ///< Accepted frame counter.
+        std::atomic<std::uint64_t> dropped{0};   ///< Dropped frame counter.
+        std::atomic<std::uint64_t> ignored{0};   ///< Ignored frame counter.
+        std::atomic<std::uint32_t> frame_signal{0}; ///< Bumped on every queued frame to wake the consumer.
+        depth_decoder* decoder = nullptr; ///< Decodes raw depth packets, or nullptr.
+
+        /**
+         * @brief Gets the ring that stores frames of the given type.
+         *
+         * @param type The frame type.
+         * @return ring* Pointer to the ring, or nullptr for an unknown type.
+         */
+        ring* getRing(libfreenect2::Frame::Type type);
+
+        /**
+         * @brief Takes a pooled buffer, counting a drop if none of the required size is free.
+         *
+         * @param type The frame type.
+         * @param bytes Required buffer size.
+         * @param sequence Sequence number of the frame, for the log.
+         * @return frame_handle The buffer, or an empty handle.
+         */
+        frame_handle acquire(libfreenect2::Frame::Type type, std::size_t bytes, std::uint32_t sequence);
+
+        /**
+         * @brief Queues a filled frame, evicting the oldest one if the ring is full.
+         */
+        void deliver(ring& _ring, frame_handle handle);
+
+        /**
+         * @brief Decodes a raw depth packet into pooled IR and depth frames and queues them.
+         *
+         * @param packet The Raw depth frame of a parallel_packet_pipeline.
+         */
+        void decodeDepthPacket(const libfreenect2::Frame& packet);
+
+    public:
+        /**
+         * @brief Constructs a listener filling buffers from a pool.
+         *
+         * @param pool The pool providing the frame buffers.
+         */
+        explicit frame_listener(std::shared_ptr<frame_pool> pool);
+
+        /// Releases every frame still queued.
+        ~frame_listener() override;
+
+        frame_listener(const frame_listener&) = delete;
+        frame_listener& operator=(const frame_listener&) = delete;
+
+        /**
+         * @brief Receives a decoded frame from libfreenect2.
+         *
+         * @param type Type of the new frame.
+         * @param frame The frame data.
+         * @return bool True if the listener took ownership of the frame, false otherwise.
+         */
+        bool onNewFrame(libfreenect2::Frame::Type type, libfreenect2::Frame* frame) override;
+
+        /**
+         * @brief Sets the decoder for the raw depth packets of a parallel_packet_pipeline.
+         *
+         * Raw IR and depth frames are then decoded into IR and depth frames instead of
+         * being queued. Must be called before the device is opened.
+         *
+         * @param decoder The decoder, or nullptr; must outlive the device.
+         */
+        void setDepthDecoder(depth_decoder* decoder);
+
+        /**
+         * @brief Enables or disables a frame type.
+         *
+         * Frames of disabled types are handed straight back to libfreenect2.
+         *
+         * @param type The frame type.
+         * @param enabled True to accept frames of this type.
+         */
+        void setFrameTypeEnabled(libfreenect2::Frame::Type type, bool enabled);
+
+        /**
+         * @brief Checks if a frame type is enabled.
+         *
+         * @param type The frame type.
+         * @return bool True if frames of this type are accepted.
+         */
+        [[nodiscard]] bool isFrameTypeEnabled(libfreenect2::Frame::Type type) const;
+
+        /**
+         * @brief Pops the oldest queued frame of a type.
+         *
+         * Single consumer only.
+         *
+         * @param type The frame type.
+         * @return frame_handle The frame, or an empty handle if none is queued.
+         */
+        frame_handle popFrame(libfreenect2::Frame::Type type);
+
+        /**
+         * @brief Gets the current frame signal value, to be passed to waitForFrame().
+         *
+         * @return std::uint32_t The signal value.
+         */
+        [[nodiscard]] std::uint32_t getSignal() const;
+
+        /**
+         * @brief Blocks the consumer until a frame is queued after the signal value was read.
+         *
+         * @param seen The signal value read before checking the rings.
+         */
+        void waitForFrame(std::uint32_t seen) const;
+
+        /**
+         * @brief Wakes a consumer blocked in waitForFrame().
+         */
+        void wakeConsumer();
+
+        /**
+         * @brief Releases every queued frame.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the traffic counters.
+         *
+         * @return stream_statistics Snapshot of the counters.
+         */
+        [[nodiscard]] stream_statistics getStatistics() const;
+    };
+
+    /**
+     * @struct captured_frames
+     * @brief Frames returned by a single capture call. Streams without a new frame are empty.
+     *
+     * toMat() in device/frame_mat.h wraps a handle in a cv::Mat without copying the frame.
+     */
+    struct captured_frames
+    {
+        frame_handle color; ///< Color frame.
+        frame_handle ir;    ///< Infrared frame.
+        frame_handle depth; ///< Depth frame.
+    };
+}
+
+#endif //FRAME_LISTENER_H
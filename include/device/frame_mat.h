@@ -0,0 +1,51 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_MAT_H
+#define FRAME_MAT_H
+
+#include <opencv2/core.hpp>
+#include "device/frame_pool.h"
+
+namespace vision
+{
+    /**
+     * @brief Gets the OpenCV element type of a frame format.
+     *
+     * BGRX and RGBX map to CV_8UC4 in their own channel order, Float to CV_32FC1,
+     * Gray and Raw to CV_8UC1.
+     *
+     * @param format The frame format.
+     * @return int The OpenCV type, or -1 for an invalid format.
+     */
+    int toMatType(libfreenect2::Frame::Format format);
+
+    /**
+     * @brief Wraps a pooled frame in a cv::Mat without copying it.
+     *
+     * The Mat holds a reference to the frame through its UMatData, so the buffer stays out of
+     * the pool until the last Mat, Mat copy, ROI or UMat derived from it is released, even if
+     * every frame_handle is gone. Writes through the Mat are seen by every holder of the frame.
+     * A Raw frame is wrapped as a single row of bytes.
+     *
+     * @param frame The frame.
+     * @return cv::Mat The view, or an empty Mat if the handle is empty or the format is invalid.
+     */
+    cv::Mat toMat(const frame_handle& frame);
+
+    /**
+     * @brief Wraps a pooled frame in a cv::UMat.
+     *
+     * Shares the frame the same way as toMat(). Without OpenCL the UMat uses the pooled
+     * buffer directly; with OpenCL the runtime may map it instead of copying since the
+     * buffers are page aligned.
+     *
+     * @param frame The frame.
+     * @param access Access the UMat is used with.
+     * @return cv::UMat The view, or an empty UMat if the handle is empty or the format is invalid.
+     */
+    cv::UMat toUMat(const frame_handle& frame, cv::AccessFlag access = cv::ACCESS_READ);
+}
+
+#endif //FRAME_MAT_H
@@ -0,0 +1,345 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "libfreenect2/frame_listener.hpp"
+#include "device/latency_tracer.h"
+
+namespace vision
+{
+    class frame_pool;
+
+    /**
+     * @struct frame_pool_config
+     * @brief Number of preallocated buffers per frame type.
+     */
+    struct frame_pool_config
+    {
+        std::size_t color_frames = 8; ///< 1920x1080x4 buffers.
+        std::size_t ir_frames = 8;    ///< 512x424x4 buffers.
+        std::size_t depth_frames = 8; ///< 512x424x4 buffers.
+    };
+
+    /**
+     * @struct frame_slot
+     * @brief A pooled buffer and the libfreenect2::Frame describing it.
+     *
+     * The frame is a non-owning view over the pooled buffer; its metadata is
+     * rewritten every time the slot is filled.
+     */
+    struct frame_slot
+    {
+        libfreenect2::Frame frame; ///< Frame view over the pooled buffer.
+        libfreenect2::Frame::Type type; ///< Frame type the buffer is sized for.
+        std::size_t capacity;      ///< Size of the pooled buffer in bytes.
+        frame_pool* pool;          ///< Pool the slot belongs to.
+        std::uint32_t index;       ///< Index of the slot inside its pool.
+        std::int64_t arrival_ns = 0; ///< Host steady-clock time the frame was received, in nanoseconds.
+        std::atomic<std::uint32_t> refs{0}; ///< Number of live handles.
+
+        static constexpr std::size_t derived_count = 4; ///< Frames that can be derived from one frame.
+        std::array<std::mutex, derived_count> derived_mutex; ///< Held while a derived frame is made, so it is made once.
+        std::array<frame_slot*, derived_count> derived{}; ///< Frames derived from this one, one reference each; see frame_handle::derive().
+
+        frame_slot(unsigned char* buffer, libfreenect2::Frame::Type type, std::size_t capacity,
+                   frame_pool* pool, std::uint32_t index);
+    };
+
+    /**
+     * @class frame_handle
+     * @brief Reference-counted handle to a pooled frame.
+     *
+     * Copies share the frame; the buffer goes back to its pool when the last handle is dropped.
+     */
+    class frame_handle {
+    private:
+        frame_slot* slot = nullptr; ///< Referenced slot.
+
+    public:
+        /// Constructs an empty handle.
+        frame_handle() = default;
+
+        /**
+         * @brief Adopts one reference already taken on the slot.
+         *
+         * @param slot The slot to adopt.
+         */
+        explicit frame_handle(frame_slot* slot)
+                : slot(slot)
+        {
+        }
+
+        frame_handle(const frame_handle& other);
+        frame_handle(frame_handle&& other) noexcept;
+        frame_handle& operator=(const frame_handle& other);
+        frame_handle& operator=(frame_handle&& other) noexcept;
+
+        /// Drops the reference.
+        ~frame_handle();
+
+        /**
+         * @brief Drops the reference and empties the handle.
+         */
+        void reset();
+
+        /**
+         * @brief Gives up ownership of the reference without dropping it.
+         *
+         * @return frame_slot* The slot; the caller now owns one reference.
+         */
+        frame_slot* release();
+
+        /**
+         * @brief Gets the frame.
+         *
+         * @return libfreenect2::Frame* Pointer to the frame, or nullptr if empty.
+         */
+        [[nodiscard]] libfreenect2::Frame* get() const
+        {
+            return slot != nullptr ? &slot->frame : nullptr;
+        }
+
+        libfreenect2::Frame* operator->() const
+        {
+            return get();
+        }
+
+        libfreenect2::Frame& operator*() const
+        {
+            return slot->frame;
+        }
+
+        /**
+         * @brief Gets the frame type the buffer belongs to.
+         *
+         * @return libfreenect2::Frame::Type The frame type. Only valid for a non-empty handle.
+         */
+        [[nodiscard]] libfreenect2::Frame::Type type() const
+        {
+            return slot->type;
+        }
+
+        /**
+         * @brief Gets the host time the frame was received.
+         *
+         * @return std::int64_t Steady-clock time in nanoseconds. Only valid for a non-empty handle.
+         */
+        [[nodiscard]] std::int64_t arrivalTime() const
+        {
+            return slot->arrival_ns;
+        }
+
+        /**
+         * @brief Sets the host time the frame was received.
+         *
+         * @param arrival_ns Steady-clock time in nanoseconds.
+         */
+        void setArrivalTime(const std::int64_t arrival_ns) const
+        {
+            slot->arrival_ns = arrival_ns;
+        }
+
+        /**
+         * @brief Records that the frame reached a stage, on the tracer of its pool.
+         *
+         * Does nothing for an empty handle, a pool without a tracer or a frame without an arrival time.
+         *
+         * @param stage The stage.
+         */
+        void stamp(latency_stage stage) const;
+
+        /**
+         * @brief Gets a frame derived from this one, such as a decoded image, making it on the first call.
+         *
+         * The derived frame is kept with the pooled frame, so every handle to it shares the
+         * result, and is released when the frame returns to its pool. Each index has its own
+         * lock, held while making, so an index is made once and one index never waits for another.
+         *
+         * @param index Which derived frame; below frame_slot::derived_count.
+         * @param make Makes the derived frame; an empty handle leaves the index to the next call.
+         * @return frame_handle The derived frame, or an empty handle if make failed. Only valid for a non-empty handle.
+         */
+        template<typename Make>
+        frame_handle derive(const std::size_t index, Make&& make) const
+        {
+            std::lock_guard lock(slot->derived_mutex[index]);
+            if(slot->derived[index] == nullptr)
+            {
+                frame_handle made = make();
+                if(!made)
+                    return {};
+                slot->derived[index] = made.release();
+            }
+            slot->derived[index]->refs.fetch_add(1, std::memory_order_relaxed);
+            return frame_handle(slot->derived[index]);
+        }
+
+        /**
+         * @brief Gets the size of the pooled buffer.
+         *
+         * @return std::size_t The buffer capacity in bytes, or 0 if empty.
+         */
+        [[nodiscard]] std::size_t capacity() const
+        {
+            return slot != nullptr ? slot->capacity : 0;
+        }
+
+        /**
+         * @brief Gets the number of handles sharing the frame.
+         *
+         * @return std::uint32_t The reference count, or 0 if empty.
+         */
+        [[nodiscard]] std::uint32_t useCount() const
+        {
+            return slot != nullptr ? slot->refs.load(std::memory_order_relaxed) : 0;
+        }
+
+        /**
+         * @brief Checks if the handle references a frame.
+         *
+         * @return bool True if the handle is not empty.
+         */
+        explicit operator bool() const
+        {
+            return slot != nullptr;
+        }
+    };
+
+    /**
+     * @class frame_pool
+     * @brief Owns aligned, pre-faulted frame buffers and recycles them without allocating.
+     *
+     * Buffers are handed out lock-free from a per-type free list and come back
+     * when the last frame_handle is dropped, from any thread. The pool stays
+     * alive until its owner and every outstanding handle are gone.
+     */
+    class frame_pool {
+    private:
+        /**
+         * @struct free_list
+         * @brief Lock-free stack of slot indices. The head carries an ABA tag in its upper half.
+         */
+        struct free_list
+        {
+            std::atomic<std::uint64_t> head{0}; ///< (tag << 32) | (index + 1); 0 means empty.
+            std::unique_ptr<std::atomic<std::uint32_t>[]> next; ///< Next index + 1 for every slot.
+            std::atomic<std::size_t> size{0}; ///< Number of free slots.
+        };
+
+        static constexpr std::size_t buffer_alignment = 4096; ///< Page alignment of the buffers.
+        static constexpr int type_count = 3; ///< Color, IR and depth.
+
+        std::vector<std::unique_ptr<frame_slot>> slots[type_count]; ///< Slots per frame type.
+        free_list free_slots[type_count]; ///< Free slots per frame type.
+        std::vector<unsigned char*> buffers; ///< Owned aligned buffers.
+        std::atomic<std::size_t> refs{1}; ///< Outstanding slots plus the owner reference.
+        std::shared_ptr<latency_tracer> tracer; ///< Receives the stamps of the pooled frames, or nullptr.
+
+        explicit frame_pool(const frame_pool_config& config);
+        ~frame_pool();
+
+        /**
+         * @brief Maps a frame type to its slot table.
+         *
+         * @param type The frame type.
+         * @return int The table index, or -1 for an unknown type.
+         */
+        static int typeIndex(libfreenect2::Frame::Type type);
+
+        /**
+         * @brief Allocates and pre-faults the slots of one frame type.
+         */
+        void allocateSlots(libfreenect2::Frame::Type type, std::size_t count,
+                           std::size_t width, std::size_t height, std::size_t bytes_per_pixel);
+
+        /**
+         * @brief Drops one pool reference, deleting the pool on the last one.
+         */
+        void unref();
+
+        friend class frame_handle;
+
+        /**
+         * @brief Returns a slot whose last handle was dropped.
+         *
+         * @param slot The slot to recycle.
+         */
+        void recycle(frame_slot* slot);
+
+        /**
+         * @brief Pushes a slot onto its free list.
+         *
+         * @param slot The free slot.
+         */
+        void pushFree(frame_slot* slot);
+
+    public:
+        /**
+         * @brief Creates a pool.
+         *
+         * @param config Number of buffers per frame type.
+         * @return std::shared_ptr<frame_pool> The pool. Releasing it keeps the memory until every handle is dropped.
+         */
+        static std::shared_ptr<frame_pool> create(const frame_pool_config& config = {});
+
+        frame_pool(const frame_pool&) = delete;
+        frame_pool& operator=(const frame_pool&) = delete;
+
+        /**
+         * @brief Sets the tracer receiving the stamps of the pooled frames, including their release.
+         *
+         * Must be called before the first buffer is acquired.
+         *
+         * @param tracer The tracer, or nullptr.
+         */
+        void setTracer(std::shared_ptr<latency_tracer> tracer);
+
+        /**
+         * @brief Gets the tracer receiving the stamps of the pooled frames.
+         *
+         * @return latency_tracer* The tracer, or nullptr.
+         */
+        [[nodiscard]] latency_tracer* getTracer() const
+        {
+            return tracer.get();
+        }
+
+        /**
+         * @brief Takes a free buffer of a frame type.
+         *
+         * Never allocates and never blocks.
+         *
+         * @param type The frame type.
+         * @return frame_handle The handle, or an empty handle if the pool is exhausted.
+         */
+        frame_handle acquire(libfreenect2::Frame::Type type);
+
+        /**
+         * @brief Gets the number of buffers of a frame type.
+         *
+         * @param type The frame type.
+         * @return std::size_t The number of buffers.
+         */
+        [[nodiscard]] std::size_t slotCount(libfreenect2::Frame::Type type) const;
+
+        /**
+         * @brief Gets the number of free buffers of a frame type.
+         *
+         * @param type The frame type.
+         * @return std::size_t The number of free buffers. Approximate while frames are in flight.
+         */
+        [[nodiscard]] std::size_t freeCount(libfreenect2::Frame::Type type) const;
+    };
+}
+
+#endif //FRAME_POOL_H
@@ -0,0 +1,133 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+namespace vision
+{
+    /**
+     * @class frame_ring
+     * @brief Bounded lock-free single-producer/single-consumer ring.
+     *
+     * The producer never waits: when the ring is full, push() evicts the
+     * oldest element and hands it back to the caller so it can be released.
+     * The read cursor is therefore advanced with a CAS by both sides, which
+     * keeps the eviction safe against a concurrent pop().
+     *
+     * @tparam T Element type. Must be trivially copyable and lock-free as an atomic (e.g. a pointer).
+     * @tparam Capacity Number of slots. Must be a power of two.
+     */
+    template<typename T, std::size_t Capacity>
+    class frame_ring {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                      "frame_ring capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T> && std::atomic<T>::is_always_lock_free,
+                      "frame_ring elements must be lock-free atomics");
+
+    private:
+        static constexpr std::uint64_t mask = Capacity - 1; ///< Slot index mask.
+
+        alignas(64) std::atomic<std::uint64_t> head{0}; ///< Next write position, owned by the producer.
+        alignas(64) std::atomic<std::uint64_t> tail{0}; ///< Next read position, shared by both sides.
+        alignas(64) std::array<std::atomic<T>, Capacity> slots{}; ///< Ring storage.
+
+    public:
+        frame_ring() = default;
+        frame_ring(const frame_ring&) = delete;
+        frame_ring& operator=(const frame_ring&) = delete;
+
+        /**
+         * @brief Pushes an element, evicting the oldest one if the ring is full.
+         *
+         * Producer side only. Never blocks.
+         *
+         * @param item The element to push.
+         * @return std::optional<T> The evicted element if the ring overflowed; otherwise, std::nullopt.
+         */
+        std::optional<T> push(T item)
+        {
+            std::optional<T> evicted;
+            const std::uint64_t h = head.load(std::memory_order_relaxed);
+            std::uint64_t t = tail.load(std::memory_order_acquire);
+
+            if (h - t >= Capacity)
+            {
+                // Full: try to take the oldest slot. If the consumer wins the race the slot is free anyway.
+                const T oldest = slots[t & mask].load(std::memory_order_relaxed);
+                if (tail.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel))
+                    evicted = oldest;
+            }
+
+            slots[h & mask].store(item, std::memory_order_relaxed);
+            head.store(h + 1, std::memory_order_release);
+            return evicted;
+        }
+
+        /**
+         * @brief Pops the oldest element.
+         *
+         * Consumer side only. Never blocks.
+         *
+         * @param item Receives the popped element.
+         * @return bool True if an element was popped, false if the ring was empty.
+         */
+        bool pop(T& item)
+        {
+            std::uint64_t t = tail.load(std::memory_order_acquire);
+            while (t != head.load(std::memory_order_acquire))
+            {
+                const T candidate = slots[t & mask].load(std::memory_order_relaxed);
+                if (tail.compare_exchange_weak(t, t + 1, std::memory_order_acq_rel))
+                {
+                    item = candidate;
+                    return true;
+                }
+                // The producer evicted this slot (or a spurious failure); t now holds the new tail.
+            }
+            return false;
+        }
+
+        /**
+         * @brief Gets the number of queued elements.
+         *
+         * @return std::size_t The approximate number of elements in the ring.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            const std::uint64_t t = tail.load(std::memory_order_acquire);
+            const std::uint64_t h = head.load(std::memory_order_acquire);
+            return h > t ? static_cast<std::size_t>(h - t) : 0;
+        }
+
+        /**
+         * @brief Checks if the ring is empty.
+         *
+         * @return bool True if no element is queued, false otherwise.
+         */
+        [[nodiscard]] bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Gets the capacity of the ring.
+         *
+         * @return std::size_t The number of slots.
+         */
+        [[nodiscard]] static constexpr std::size_t capacity()
+        {
+            return Capacity;
+        }
+    };
+}
+
+#endif //FRAME_RING_H
@@ -0,0 +1,140 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include "device/frame_pool.h"
+#include "device/frame_ring.h"
+
+namespace vision
+{
+    /**
+     * @struct scheduled_frame
+     * @brief A frame delivered by the scheduler, tagged with the device it came from.
+     */
+    struct scheduled_frame
+    {
+        int device_id = -1; ///< ID of the device that produced the frame.
+        libfreenect2::Frame::Type type = libfreenect2::Frame::Color; ///< Frame type.
+        frame_handle frame; ///< The pooled frame.
+    };
+
+    /**
+     * @class frame_scheduler
+     * @brief Routes frames from every device capture thread to the registered consumers.
+     *
+     * Each capture thread delivers its own frames, so consumers run concurrently on
+     * the pinned core of the device that produced the frame and must be thread-safe.
+     * The scheduler also keeps the latest frames of each device for pull-style capture.
+     */
+    class frame_scheduler {
+    public:
+        using consumer = std::function<void(const scheduled_frame&)>; ///< Frame consumer callback.
+        static constexpr std::size_t pull_capacity = 2; ///< Frames kept per device and type for pull capture.
+
+        /**
+         * @class source
+         * @brief Delivery endpoint of one device.
+         */
+        class source {
+        private:
+            friend class frame_scheduler;
+            using ring = frame_ring<frame_slot*, pull_capacity>;
+
+            frame_scheduler& scheduler; ///< Owning scheduler.
+            int device_id; ///< ID of the device.
+            ring pull_rings[3]; ///< Latest color, IR and depth frames for pull capture.
+
+            source(frame_scheduler& scheduler, int device_id)
+                    : scheduler(scheduler), device_id(device_id)
+            {
+            }
+
+            ring* getRing(libfreenect2::Frame::Type type);
+
+        public:
+            /// Releases the frames kept for pull capture.
+            ~source();
+
+            /**
+             * @brief Delivers a frame to every consumer and the pull queue.
+             *
+             * Called from the capture thread of the device only.
+             *
+             * @param frame The frame to deliver.
+             */
+            void deliver(const frame_handle& frame);
+
+            /**
+             * @brief Pops the oldest frame kept for pull capture.
+             *
+             * @param type The frame type.
+             * @return frame_handle The frame, or an empty handle if none is queued.
+             */
+            frame_handle pull(libfreenect2::Frame::Type type);
+        };
+
+    private:
+        mutable std::shared_mutex consumers_mutex; ///< Guards consumers.
+        std::map<int, consumer> consumers; ///< Registered consumers, keyed by subscription ID.
+        int next_subscription = 0; ///< Next subscription ID.
+
+        mutable std::mutex sources_mutex; ///< Guards sources.
+        std::map<int, std::unique_ptr<source>> sources; ///< Delivery endpoints, keyed by device ID.
+
+    public:
+        frame_scheduler() = default;
+        frame_scheduler(const frame_scheduler&) = delete;
+        frame_scheduler& operator=(const frame_scheduler&) = delete;
+
+        /**
+         * @brief Registers a consumer for the frames of every device.
+         *
+         * @param callback The consumer. Invoked concurrently from the capture threads.
+         * @return int The subscription ID.
+         */
+        int subscribe(consumer callback);
+
+        /**
+         * @brief Removes a consumer. Waits for in-flight deliveries to it to finish.
+         *
+         * @param subscription_id The subscription ID returned by subscribe().
+         * @return bool True if the consumer was removed, false if it was not found.
+         */
+        bool unsubscribe(int subscription_id);
+
+        /**
+         * @brief Creates the delivery endpoint of a device.
+         *
+         * @param device_id The ID of the device.
+         * @return source* The endpoint, owned by the scheduler until detach().
+         */
+        source* attach(int device_id);
+
+        /**
+         * @brief Removes the delivery endpoint of a device.
+         *
+         * @param device_id The ID of the device.
+         */
+        void detach(int device_id);
+
+        /**
+         * @brief Pops the oldest frame kept for pull capture.
+         *
+         * @param device_id The ID of the device.
+         * @param type The frame type.
+         * @return frame_handle The frame, or an empty handle if none is queued.
+         */
+        frame_handle pull(int device_id, libfreenect2::Frame::Type type);
+    };
+}
+
+#endif //FRAME_SCHEDULER_H
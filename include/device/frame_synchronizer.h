@@ -0,0 +1,249 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_SYNCHRONIZER_H
+#define FRAME_SYNCHRONIZER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "device/frame_pool.h"
+#include "device/frame_scheduler.h"
+
+namespace vision
+{
+    /**
+     * @struct sync_config
+     * @brief Settings of the cross-device frame synchronizer.
+     */
+    struct sync_config
+    {
+        std::chrono::microseconds tolerance{16000}; ///< Maximum distance of a frame from the set reference time.
+        std::size_t max_pending = 8; ///< Frames kept per device and stream while waiting for a match.
+        double clock_smoothing = 0.02; ///< Weight of a new sample in the clock model (exponential forgetting).
+        std::chrono::microseconds outlier_gate{20000}; ///< Late arrivals beyond this are not used to fit the clock.
+    };
+
+    /**
+     * @struct device_frames
+     * @brief The frames of one device inside a frame set.
+     */
+    struct device_frames
+    {
+        int device_id = -1; ///< ID of the device.
+        frame_handle depth; ///< Depth frame.
+        frame_handle color; ///< Color frame.
+        std::int64_t depth_time_ns = 0; ///< Depth capture time on the common host clock.
+        std::int64_t color_time_ns = 0; ///< Color capture time on the common host clock.
+    };
+
+    /**
+     * @struct frame_set
+     * @brief One depth and one color frame per device, captured within the sync tolerance.
+     */
+    struct frame_set
+    {
+        static constexpr std::size_t max_devices = 8; ///< Maximum number of synchronized devices.
+
+        std::uint64_t index = 0; ///< Running number of the set.
+        std::int64_t reference_ns = 0; ///< Reference capture time on the common host clock.
+        std::size_t device_count = 0; ///< Number of valid entries in devices.
+        std::array<device_frames, max_devices> devices; ///< Frames per device, in configured order.
+    };
+
+    /**
+     * @struct clock_estimate
+     * @brief Online estimate of a device clock against the host clock.
+     */
+    struct clock_estimate
+    {
+        double offset_ms = 0.0; ///< Host time minus device time at the first sample, including transfer latency.
+        double drift_ppm = 0.0; ///< Device clock rate error in parts per million; positive if the device clock runs fast.
+        std::uint64_t samples = 0; ///< Samples used for the fit.
+    };
+
+    /**
+     * @struct sync_statistics
+     * @brief Counters of the synchronizer.
+     */
+    struct sync_statistics
+    {
+        std::uint64_t emitted = 0;   ///< Frame sets emitted.
+        std::uint64_t unmatched = 0; ///< Frames discarded because no set could be formed around them.
+        std::uint64_t dropped = 0;   ///< Frames discarded because their pending queue was full.
+    };
+
+    /**
+     * @class frame_synchronizer
+     * @brief Groups frames from several devices into synchronized frame sets.
+     *
+     * Kinect timestamps count 0.125 ms ticks of an unsynchronized device clock. Each
+     * device gets a linear model (offset and drift) mapping its clock onto the host
+     * steady clock, fitted online from the depth frame arrival times. Frames are then
+     * matched on that common time axis. Frames are never copied; sets hold handles.
+     */
+    class frame_synchronizer {
+    public:
+        using set_callback = std::function<void(const frame_set&)>; ///< Receives every emitted set.
+
+    private:
+        static constexpr std::size_t queue_capacity = 16; ///< Upper bound of sync_config::max_pending.
+        static constexpr double tick_seconds = 0.000125; ///< Length of a Kinect timestamp tick.
+
+        /**
+         * @struct pending_frame
+         * @brief A frame waiting to be matched.
+         */
+        struct pending_frame
+        {
+            frame_handle frame; ///< The frame.
+            std::int64_t time_ns = 0; ///< Capture time on the common host clock.
+        };
+
+        /**
+         * @struct pending_queue
+         * @brief Fixed-capacity FIFO of pending frames.
+         */
+        struct pending_queue
+        {
+            std::array<pending_frame, queue_capacity> frames; ///< Ring storage.
+            std::size_t head = 0; ///< Index of the oldest frame.
+            std::size_t count = 0; ///< Number of queued frames.
+
+            [[nodiscard]] pending_frame& at(const std::size_t i)
+            {
+                return frames[(head + i) % queue_capacity];
+            }
+
+            void push(pending_frame frame)
+            {
+                frames[(head + count) % queue_capacity] = std::move(frame);
+                ++count;
+            }
+
+            pending_frame pop()
+            {
+                pending_frame frame = std::move(frames[head]);
+                head = (head + 1) % queue_capacity;
+                --count;
+                return frame;
+            }
+        };
+
+        /**
+         * @struct device_clock
+         * @brief Clock model and timestamp unwrapping state of one device.
+         */
+        struct device_clock
+        {
+            bool initialized = false; ///< True after the first sample.
+            std::uint32_t last_ticks = 0; ///< Last raw timestamp, for wrap detection.
+            std::int64_t wraps = 0; ///< Number of 32-bit timestamp wraps.
+            double origin_device_s = 0.0; ///< Device time of the first sample.
+            std::int64_t origin_host_ns = 0; ///< Host arrival time of the first sample.
+            double mean_x = 0.0; ///< Weighted mean of the device time since origin.
+            double mean_r = 0.0; ///< Weighted mean of host minus device time since origin.
+            double var_x = 0.0; ///< Weighted variance of the device time.
+            double cov_xr = 0.0; ///< Weighted covariance of device time and residual.
+            std::uint64_t samples = 0; ///< Samples used for the fit.
+        };
+
+        /**
+         * @struct device_state
+         * @brief Synchronization state of one device.
+         */
+        struct device_state
+        {
+            int device_id = -1; ///< ID of the device.
+            device_clock clock; ///< Clock model.
+            pending_queue depth; ///< Depth frames waiting for a match.
+            pending_queue color; ///< Color frames waiting for a match.
+        };
+
+        frame_scheduler& scheduler; ///< Scheduler the frames come from.
+        sync_config config; ///< Synchronizer settings.
+        set_callback callback; ///< Receives emitted sets.
+        int subscription = -1; ///< Scheduler subscription ID.
+
+        mutable std::mutex mutex; ///< Guards the state below; deliveries arrive from several capture threads.
+        std::vector<device_state> devices; ///< State per configured device.
+        sync_statistics statistics; ///< Counters.
+        std::uint64_t next_index = 0; ///< Index of the next set.
+
+        /**
+         * @brief Handles a frame delivered by the scheduler.
+         *
+         * @param frame The delivered frame.
+         */
+        void onFrame(const scheduled_frame& frame);
+
+        /**
+         * @brief Unwraps a device timestamp to seconds since the clock origin.
+         */
+        static double unwrapSeconds(device_clock& clock, std::uint32_t ticks);
+
+        /**
+         * @brief Adds a depth arrival sample to the clock model.
+         */
+        void updateClock(device_clock& clock, double device_s, std::int64_t arrival_ns) const;
+
+        /**
+         * @brief Maps a device time onto the host clock.
+         */
+        static std::int64_t toHostTime(const device_clock& clock, double device_s);
+
+        /**
+         * @brief Forms the next frame set from the pending queues. Called with the mutex held.
+         *
+         * @return std::optional<frame_set> The set, or std::nullopt if some device is still missing a frame.
+         */
+        std::optional<frame_set> matchOne();
+
+    public:
+        /**
+         * @brief Creates a synchronizer and subscribes it to the scheduler.
+         *
+         * @param scheduler Scheduler the frames come from.
+         * @param device_ids IDs of the devices to synchronize, at most frame_set::max_devices.
+         * @param callback Receives every emitted set, on the capture thread that completed it.
+         * @param config Synchronizer settings.
+         */
+        frame_synchronizer(frame_scheduler& scheduler, const std::vector<int>& device_ids,
+                           set_callback callback, const sync_config& config = {});
+
+        /// Unsubscribes from the scheduler and releases pending frames.
+        ~frame_synchronizer();
+
+        frame_synchronizer(const frame_synchronizer&) = delete;
+        frame_synchronizer& operator=(const frame_synchronizer&) = delete;
+
+        /**
+         * @brief Gets the counters.
+         *
+         * @return sync_statistics Snapshot of the counters.
+         */
+        [[nodiscard]] sync_statistics getStatistics() const;
+
+        /**
+         * @brief Gets the clock estimate of a device.
+         *
+         * @param device_id The ID of the device.
+         * @return std::optional<clock_estimate> The estimate if the device is synchronized; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<clock_estimate> getClockEstimate(int device_id) const;
+
+        /**
+         * @brief Feeds a frame directly, bypassing the scheduler.
+         *
+         * @param frame The frame.
+         */
+        void push(const scheduled_frame& frame);
+    };
+}
+
+#endif //FRAME_SYNCHRONIZER_H
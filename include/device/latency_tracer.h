@@ -0,0 +1,287 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef LATENCY_TRACER_H
+#define LATENCY_TRACER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "libfreenect2/frame_listener.hpp"
+#include "debug/status.h"
+
+namespace vision
+{
+    /**
+     * @enum latency_stage
+     * @brief Point of the capture path a frame is stamped at, measured from its arrival.
+     */
+    enum class latency_stage : std::uint8_t
+    {
+        Decoded,    ///< Copied or decoded into its pooled buffer by the frame_listener.
+        Filtered,   ///< Through the depth filter chain on the capture thread. Depth only.
+        Delivered,  ///< Handed to the frame_scheduler consumers.
+        Registered, ///< Registered by a consumer, which stamps it with frame_handle::stamp().
+        Released,   ///< Back in its pool after the last handle was dropped.
+    };
+
+    static constexpr std::size_t latency_stage_count = 5; ///< Number of latency_stage values.
+
+    /**
+     * @brief Gets the name of a stage, as used in the Chrome trace.
+     *
+     * @param stage The stage.
+     * @return const char* The lowercase name.
+     */
+    const char* latencyStageName(latency_stage stage);
+
+    /**
+     * @class latency_histogram
+     * @brief Log-linear latency histogram with a relative bucket error of at most 1/16.
+     *
+     * Values below 32 ns get a bucket each; above, every power of two is split into 16
+     * buckets, up to 2^36 ns. Larger values land in the last bucket.
+     */
+    class latency_histogram {
+    public:
+        static constexpr unsigned sub_bucket_bits = 4; ///< log2 of the buckets per power of two.
+        static constexpr unsigned max_bits = 36; ///< Values up to 2^max_bits ns are resolved.
+        static constexpr std::size_t bucket_count = (max_bits - sub_bucket_bits + 1) << sub_bucket_bits; ///< Number of buckets.
+
+    private:
+        std::vector<std::uint64_t> buckets; ///< Sample count of every bucket.
+        std::uint64_t samples = 0; ///< Number of samples.
+        std::int64_t total_ns = 0; ///< Sum of the samples.
+        std::int64_t min_ns = std::numeric_limits<std::int64_t>::max(); ///< Smallest sample.
+        std::int64_t max_ns = 0; ///< Largest sample.
+
+    public:
+        /// Constructs an empty histogram.
+        latency_histogram();
+
+        /**
+         * @brief Gets the bucket of a latency.
+         *
+         * @param ns Latency in nanoseconds; negative values count as 0.
+         * @return std::size_t The bucket index.
+         */
+        static std::size_t bucketIndex(std::int64_t ns);
+
+        /**
+         * @brief Gets the largest latency of a bucket.
+         *
+         * @param index The bucket index.
+         * @return std::int64_t The inclusive upper bound in nanoseconds.
+         */
+        static std::int64_t bucketUpperBound(std::size_t index);
+
+        /**
+         * @brief Adds samples to a bucket.
+         *
+         * @param index The bucket index.
+         * @param count Number of samples.
+         */
+        void addBucket(std::size_t index, std::uint64_t count);
+
+        /**
+         * @brief Merges the totals of a set of samples already added with addBucket().
+         *
+         * @param total_ns Sum of the samples.
+         * @param min_ns Smallest sample.
+         * @param max_ns Largest sample.
+         */
+        void addTotals(std::int64_t total_ns, std::int64_t min_ns, std::int64_t max_ns);
+
+        /**
+         * @brief Adds one sample.
+         *
+         * @param ns Latency in nanoseconds.
+         */
+        void add(std::int64_t ns);
+
+        /**
+         * @brief Gets the latency below which a fraction of the samples fall.
+         *
+         * @param fraction Fraction in [0, 1], such as 0.99.
+         * @return std::int64_t Upper bound of the bucket holding the percentile, clamped to the largest sample; 0 if empty.
+         */
+        [[nodiscard]] std::int64_t percentile(double fraction) const;
+
+        /**
+         * @brief Gets the mean latency.
+         *
+         * @return double The mean in nanoseconds, or 0 if empty.
+         */
+        [[nodiscard]] double mean() const;
+
+        [[nodiscard]] std::uint64_t count() const
+        {
+            return samples;
+        }
+
+        [[nodiscard]] std::int64_t min() const
+        {
+            return samples > 0 ? min_ns : 0;
+        }
+
+        [[nodiscard]] std::int64_t max() const
+        {
+            return max_ns;
+        }
+    };
+
+    /**
+     * @struct latency_snapshot
+     * @brief Latency histograms of one device, from frame arrival to every stage.
+     */
+    struct latency_snapshot
+    {
+        int device_id = -1; ///< ID of the device.
+        std::array<std::array<latency_histogram, latency_stage_count>, 3> histograms; ///< Color, IR and depth, by stage.
+
+        /**
+         * @brief Gets the histogram of a frame type and stage.
+         *
+         * @param type Color, Ir or Depth.
+         * @param stage The stage.
+         * @return const latency_histogram& The histogram.
+         */
+        [[nodiscard]] const latency_histogram& get(libfreenect2::Frame::Type type, latency_stage stage) const;
+    };
+
+    /**
+     * @struct latency_tracer_config
+     * @brief Settings of a latency_tracer.
+     */
+    struct latency_tracer_config
+    {
+        std::size_t trace_events = 0; ///< Most recent stamps kept for writeChromeTrace(); 0 disables the trace.
+    };
+
+    /**
+     * @class latency_tracer
+     * @brief Per-device histograms of the time from frame arrival to each stage of the capture path.
+     *
+     * Every thread that stamps a frame gets its own set of counters, found through a
+     * thread-local cache and written without atomic read-modify-write operations, so
+     * stamping never contends or allocates after a thread's first stamp. snapshot()
+     * sums the counters of every thread. Optionally the latest stamps are also kept in
+     * a ring for a Chrome trace (chrome://tracing, Perfetto).
+     */
+    class latency_tracer {
+    private:
+        /**
+         * @struct shard
+         * @brief Counters written by one thread only.
+         */
+        struct shard
+        {
+            std::atomic<std::uint64_t> buckets[3][latency_stage_count][latency_histogram::bucket_count]; ///< Bucket counts.
+            std::atomic<std::int64_t> total_ns[3][latency_stage_count]; ///< Sums of the samples.
+            std::atomic<std::int64_t> min_ns[3][latency_stage_count]; ///< Smallest samples.
+            std::atomic<std::int64_t> max_ns[3][latency_stage_count]; ///< Largest samples.
+        };
+
+        /**
+         * @struct trace_record
+         * @brief One stamp in the trace ring, guarded by a sequence lock.
+         */
+        struct trace_record
+        {
+            std::atomic<std::uint64_t> ticket{0}; ///< Stamp number + 1 once written, 0 while being written.
+            std::atomic<std::int64_t> arrival_ns{0}; ///< Arrival time of the frame.
+            std::atomic<std::int64_t> stage_ns{0}; ///< Time of the stamp.
+            std::atomic<std::uint32_t> sequence{0}; ///< Sequence number of the frame.
+            std::atomic<std::uint8_t> type{0}; ///< Frame type index.
+            std::atomic<std::uint8_t> stage{0}; ///< latency_stage value.
+        };
+
+        int device_id; ///< ID of the traced device.
+        std::uint64_t id; ///< Unique tracer ID, the key of the thread-local shard cache.
+        mutable std::mutex shards_mutex; ///< Guards shards.
+        std::map<std::thread::id, std::unique_ptr<shard>> shards; ///< Counters of every stamping thread.
+        std::unique_ptr<trace_record[]> trace; ///< Ring of the latest stamps, or nullptr.
+        std::size_t trace_capacity; ///< Size of the trace ring.
+        std::atomic<std::uint64_t> trace_next{0}; ///< Number of stamps written to the ring.
+
+        /**
+         * @brief Gets the counters of the calling thread, creating them on its first stamp.
+         *
+         * @return shard& The counters.
+         */
+        shard& localShard();
+
+    public:
+        /**
+         * @brief Constructs a tracer.
+         *
+         * @param device_id The ID of the traced device.
+         * @param config Tracer settings.
+         */
+        explicit latency_tracer(int device_id, const latency_tracer_config& config = {});
+
+        latency_tracer(const latency_tracer&) = delete;
+        latency_tracer& operator=(const latency_tracer&) = delete;
+
+        /**
+         * @brief Gets the steady-clock time used for frame arrival and stamps.
+         *
+         * @return std::int64_t The time in nanoseconds.
+         */
+        static std::int64_t now();
+
+        /**
+         * @brief Records that a frame reached a stage.
+         *
+         * @param stage The stage.
+         * @param type Frame type; other types than Color, Ir and Depth are ignored.
+         * @param sequence Sequence number of the frame, for the trace.
+         * @param arrival_ns Arrival time of the frame from now().
+         * @param stage_ns Time the stage was reached from now().
+         */
+        void record(latency_stage stage, libfreenect2::Frame::Type type, std::uint32_t sequence,
+                    std::int64_t arrival_ns, std::int64_t stage_ns);
+
+        /**
+         * @brief Sums the counters of every thread.
+         *
+         * Stamps recorded concurrently may or may not be included.
+         *
+         * @return latency_snapshot The histograms.
+         */
+        [[nodiscard]] latency_snapshot snapshot() const;
+
+        /**
+         * @brief Checks if stamps are kept for the Chrome trace.
+         *
+         * @return bool True if the tracer was configured with trace_events.
+         */
+        [[nodiscard]] bool isTracing() const
+        {
+            return trace != nullptr;
+        }
+
+        /**
+         * @brief Writes the kept stamps of several tracers as a Chrome trace JSON file.
+         *
+         * Each device is a process and each frame type a thread; every stamp is a span
+         * from the arrival of its frame to the stage.
+         *
+         * @param path Output file path.
+         * @param tracers The tracers; those without a trace are skipped.
+         * @return Result The result of the operation.
+         */
+        static Result writeChromeTrace(const std::string& path, const std::vector<const latency_tracer*>& tracers);
+    };
+}
+
+#endif //LATENCY_TRACER_H
@@ -0,0 +1,131 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef LAZY_COLOR_FRAME_H
+#define LAZY_COLOR_FRAME_H
+
+#include <cstddef>
+#include "libfreenect2/frame_listener.hpp"
+#include "debug/status.h"
+#include "device/frame_pool.h"
+
+namespace vision
+{
+    /**
+     * @enum jpeg_scale
+     * @brief Downscale applied while decoding, in the DCT domain, so a smaller image is also cheaper.
+     */
+    enum class jpeg_scale
+    {
+        Full = 1,    ///< 1920x1080.
+        Half = 2,    ///< 960x540.
+        Quarter = 4, ///< 480x270.
+        Eighth = 8,  ///< 240x135.
+    };
+
+    /**
+     * @class lazy_color_frame
+     * @brief Color frame kept as the JPEG packet of the Kinect, decoded only when asked.
+     *
+     * With capture_config::compressed_color the color frames are delivered in Raw format,
+     * holding the JPEG bytes. Recording and streaming store them as they are; a consumer
+     * that needs pixels wraps the frame in a lazy_color_frame and decodes it to BGRX at the
+     * scale it needs. Decoding uses TurboJPEG with one decompressor per thread; builds
+     * without it report an error from every decode.
+     *
+     * decode() decodes each scale once and keeps the result with the pooled compressed
+     * frame, so every wrapper of the frame, on any consumer, shares it.
+     */
+    class lazy_color_frame {
+    private:
+        frame_handle jpeg; ///< The Raw color frame.
+
+    public:
+        /**
+         * @brief Wraps a compressed color frame.
+         *
+         * @param frame The frame; see isCompressed().
+         */
+        explicit lazy_color_frame(frame_handle frame);
+
+        /**
+         * @brief Checks if a frame holds a JPEG color packet.
+         *
+         * @param frame The frame.
+         * @return bool True for a non-empty Color frame of Raw format.
+         */
+        static bool isCompressed(const frame_handle& frame);
+
+        /**
+         * @brief Checks if the build can decode compressed frames.
+         *
+         * @return bool True if TurboJPEG is available.
+         */
+        static bool canDecode();
+
+        /**
+         * @brief Gets the JPEG bytes.
+         *
+         * @return const unsigned char* The bytes, or nullptr if the frame is not compressed.
+         */
+        [[nodiscard]] const unsigned char* data() const;
+
+        /**
+         * @brief Gets the size of the JPEG bytes.
+         *
+         * @return std::size_t The size in bytes, or 0 if the frame is not compressed.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * @brief Gets the wrapped frame.
+         *
+         * @return const frame_handle& The Raw frame.
+         */
+        [[nodiscard]] const frame_handle& frame() const
+        {
+            return jpeg;
+        }
+
+        /**
+         * @brief Reads the image size from the JPEG header without decoding.
+         *
+         * @param width Receives the width at the given scale.
+         * @param height Receives the height at the given scale.
+         * @param scale The scale.
+         * @return Result The result of the operation.
+         */
+        Result dimensions(int& width, int& height, jpeg_scale scale = jpeg_scale::Full) const;
+
+        /**
+         * @brief Decodes the frame to BGRX into a caller buffer.
+         *
+         * The target gets the scaled size, BGRX format and the metadata of the compressed frame.
+         *
+         * @param target Frame whose data receives the pixels.
+         * @param capacity Size of the target buffer in bytes.
+         * @param scale The scale.
+         * @return Result The result of the operation; InvalidParam if the buffer is too small.
+         */
+        Result decodeInto(libfreenect2::Frame& target, std::size_t capacity, jpeg_scale scale = jpeg_scale::Full) const;
+
+        /**
+         * @brief Decodes the frame to BGRX into a pooled color buffer, once per scale.
+         *
+         * The decoded frame keeps the arrival time of the compressed one. Later calls for the
+         * same scale, on any wrapper of the same frame, return the same frame without decoding,
+         * so callers share it and must not modify it; use decodeInto() for a private image.
+         * Scales are decoded independently, so a small scale does not wait for a full one.
+         * The buffer returns to its pool once the compressed frame and every handle to the
+         * decoded one are released.
+         *
+         * @param pool Pool providing the buffer on the first call for a scale.
+         * @param scale The scale.
+         * @return frame_handle The decoded frame, or an empty handle if decoding failed or the pool is exhausted.
+         */
+        frame_handle decode(frame_pool& pool, jpeg_scale scale = jpeg_scale::Full) const;
+    };
+}
+
+#endif //LAZY_COLOR_FRAME_H
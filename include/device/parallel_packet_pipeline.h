@@ -0,0 +1,50 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef PARALLEL_PACKET_PIPELINE_H
+#define PARALLEL_PACKET_PIPELINE_H
+
+#include <memory>
+#include "libfreenect2/packet_pipeline.h"
+#include "device/depth_decoder.h"
+
+namespace vision
+{
+    /**
+     * @class parallel_packet_pipeline
+     * @brief Packet pipeline whose depth packets are decoded by a depth_decoder.
+     *
+     * libfreenect2 does not export its depth processor interface, so the pipeline builds
+     * on DumpPacketPipeline: its depth processor hands every raw packet to the frame
+     * listener as a Raw depth frame and keeps the device calibration tables, which the
+     * decoder reads on the first packet. frame_listener decodes the packet straight into
+     * pooled IR and depth buffers. Color packets go through the JPEG decoder of an inner
+     * CpuPacketPipeline, so color frames are the same as with CpuPacketPipeline. With
+     * compressed color the RGB processor of DumpPacketPipeline is kept instead: it delivers
+     * the JPEG bytes of every packet as a Raw color frame without decoding them, to be
+     * decoded on demand by a lazy_color_frame.
+     */
+    class parallel_packet_pipeline : public libfreenect2::DumpPacketPipeline {
+    private:
+        depth_decoder& decoder; ///< Decoder reading the tables of this pipeline.
+        std::unique_ptr<libfreenect2::CpuPacketPipeline> color_pipeline; ///< Provides the color parser and processor, or nullptr for compressed color.
+
+    public:
+        /**
+         * @brief Constructs the pipeline and makes it the table source of a decoder.
+         *
+         * @param decoder The decoder; must outlive the pipeline.
+         * @param compressed_color Deliver color packets as Raw JPEG frames instead of decoding them.
+         */
+        explicit parallel_packet_pipeline(depth_decoder& decoder, bool compressed_color = false);
+
+        /// Detaches the pipeline from the decoder.
+        ~parallel_packet_pipeline() override;
+
+        PacketParser* getRgbPacketParser() const override;
+        libfreenect2::RgbPacketProcessor* getRgbPacketProcessor() const override;
+    };
+}
+
+#endif //PARALLEL_PACKET_PIPELINE_H
@@ -0,0 +1,54 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VISION_X86_KERNELS 1 ///< SSE and AVX2 kernels are compiled in; they are still chosen at runtime.
+#endif
+
+namespace vision
+{
+    /**
+     * @enum simd_kernel
+     * @brief Implementation of a per-pixel or per-point kernel, ordered from the narrowest.
+     *
+     * Modules with vector kernels alias it as their kernel type and take one in their
+     * constructor, resolved with resolveKernel(). Every vector kernel gives results bit-identical to the scalar kernel of its
+     * module, so the choice only changes speed; the scalar kernels are the fallback
+     * on CPUs without the instructions and on other architectures.
+     */
+    enum class simd_kernel
+    {
+        Auto,   ///< Widest kernel supported by both the CPU and the module.
+        Scalar, ///< Portable scalar loop.
+        SSE,    ///< SSE2, 128-bit vectors.
+        AVX2,   ///< AVX2, 256-bit vectors.
+    };
+
+    /**
+     * @brief Gets the widest kernel the running CPU supports; the CPU is probed once.
+     *
+     * @return simd_kernel The kernel; Scalar on non-x86 builds.
+     */
+    [[nodiscard]] simd_kernel cpuKernel();
+
+    /**
+     * @brief Picks the kernel a module runs.
+     *
+     * Auto, or a kernel the CPU or the module lacks, falls back to the widest kernel
+     * both support that is not wider than the requested one.
+     *
+     * @param requested Kernel asked for.
+     * @param implemented Vector kernels the module has; the scalar kernel is always there.
+     * @return simd_kernel The kernel to run.
+     */
+    [[nodiscard]] simd_kernel resolveKernel(simd_kernel requested,
+                                            std::initializer_list<simd_kernel> implemented = {simd_kernel::AVX2});
+}
+
+#endif //SIMD_DISPATCH_H
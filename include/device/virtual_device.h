@@ -0,0 +1,169 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef VIRTUAL_DEVICE_H
+#define VIRTUAL_DEVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "libfreenect2/libfreenect2.hpp"
+#include "recorder/recording_reader.h"
+
+namespace vision
+{
+    /**
+     * @enum virtual_source
+     * @brief Where a virtual device takes its frames from.
+     */
+    enum class virtual_source
+    {
+        Synthetic, ///< Procedural scene: a rippled back wall and a sphere moving in front of it.
+        Replay,    ///< Raw .depth/.jpg packet files decoded by libfreenect2::Freenect2Replay.
+        Recording, ///< A container written by frame_recorder.
+    };
+
+    /**
+     * @struct virtual_device_config
+     * @brief Settings of a virtual device.
+     */
+    struct virtual_device_config
+    {
+        virtual_source source = virtual_source::Synthetic; ///< Frame source.
+        std::string serial = "VIRTUAL"; ///< Serial number reported by the device.
+        double fps = 30.0; ///< Frame rate; 0 or less delivers frames as fast as they are consumed ("firehose").
+                           ///< Recordings keep their recorded frame spacing unless this is 0 or less.
+        std::size_t color_width = 1920; ///< Synthetic color width.
+        std::size_t color_height = 1080; ///< Synthetic color height.
+        std::size_t depth_width = 512; ///< Synthetic depth and IR width.
+        std::size_t depth_height = 424; ///< Synthetic depth and IR height.
+        std::vector<std::string> replay_files; ///< Replay: packet files, named as Freenect2Replay expects.
+        std::string recording_path; ///< Recording: path without extension.
+        int recording_device_id = -1; ///< Recording: device to play back; -1 plays the first recorded device.
+        bool loop = true; ///< Recording: start over at the end instead of going idle.
+    };
+
+    /**
+     * @class virtual_device
+     * @brief A Freenect2Device that needs no hardware.
+     *
+     * It is opened, streamed and closed exactly like a Kinect2, so device_capture and
+     * everything behind it run unchanged. Synthetic and recording frames are produced
+     * on the device thread and handed to the listeners with the usual ownership rules;
+     * replay wraps a Freenect2Replay device and only paces its frames.
+     */
+    class virtual_device : public libfreenect2::Freenect2Device {
+    private:
+        /**
+         * @class pacing_listener
+         * @brief Forwards replayed frames to a listener, throttled to the configured rate.
+         */
+        class pacing_listener : public libfreenect2::FrameListener {
+        private:
+            virtual_device& owner; ///< Device the listener belongs to.
+            std::chrono::steady_clock::time_point next_frame; ///< Earliest time of the next frame.
+
+        public:
+            explicit pacing_listener(virtual_device& owner) : owner(owner) {}
+
+            bool onNewFrame(libfreenect2::Frame::Type type, libfreenect2::Frame* frame) override;
+        };
+
+        virtual_device_config config; ///< Device settings.
+        IrCameraParams ir_params{}; ///< Reported depth camera intrinsics.
+        ColorCameraParams color_params{}; ///< Reported color camera intrinsics.
+        float min_depth = 500.0f; ///< Synthetic depth below this is invalid, in millimeters.
+        float max_depth = 4500.0f; ///< Synthetic depth above this is invalid, in millimeters.
+        std::mutex listener_mutex; ///< Guards the listeners against concurrent replacement.
+        libfreenect2::FrameListener* color_listener = nullptr; ///< Receives color frames.
+        libfreenect2::FrameListener* ir_depth_listener = nullptr; ///< Receives IR and depth frames.
+        bool rgb_enabled = false; ///< Color stream started.
+        bool depth_enabled = false; ///< IR/depth stream started.
+        std::atomic<bool> running{false}; ///< False once the device thread should exit.
+        std::thread thread; ///< Produces synthetic and recording frames.
+
+        std::unique_ptr<libfreenect2::Freenect2Replay> replay; ///< Replay context.
+        libfreenect2::Freenect2Device* replay_device = nullptr; ///< Replayed device.
+        pacing_listener color_pacer{*this}; ///< Paces replayed color frames.
+        pacing_listener ir_depth_pacer{*this}; ///< Paces replayed IR and depth frames.
+
+        std::unique_ptr<recording_reader> reader; ///< Recording being played back.
+
+        explicit virtual_device(const virtual_device_config& config);
+
+        /**
+         * @brief Device thread body for synthetic frames.
+         */
+        void runSynthetic();
+
+        /**
+         * @brief Device thread body for recording playback.
+         */
+        void runRecording();
+
+        /**
+         * @brief Hands a frame to a listener, replacing it if the listener kept it.
+         *
+         * @return bool False if no listener is set.
+         */
+        bool dispatch(libfreenect2::Frame::Type type, std::unique_ptr<libfreenect2::Frame>& frame);
+
+        /**
+         * @brief Sleeps until the next frame is due; does nothing in firehose mode.
+         *
+         * @param next_frame Due time of the next frame, advanced by one period.
+         */
+        void pace(std::chrono::steady_clock::time_point& next_frame) const;
+
+    public:
+        /**
+         * @brief Opens a virtual device.
+         *
+         * @param config Device settings.
+         * @return virtual_device* The device, or nullptr if its source could not be opened. Owned by the caller.
+         */
+        static virtual_device* open(const virtual_device_config& config);
+
+        /// Stops and closes the device.
+        ~virtual_device() override;
+
+        std::string getSerialNumber() override;
+        std::string getFirmwareVersion() override;
+        ColorCameraParams getColorCameraParams() override;
+        IrCameraParams getIrCameraParams() override;
+        void setColorCameraParams(const ColorCameraParams& params) override;
+        void setIrCameraParams(const IrCameraParams& params) override;
+        void setConfiguration(const Config& config) override;
+        void setColorFrameListener(libfreenect2::FrameListener* listener) override;
+        void setIrAndDepthFrameListener(libfreenect2::FrameListener* listener) override;
+        void setColorAutoExposure(float exposure_compensation) override;
+        void setColorSemiAutoExposure(float pseudo_exposure_time_ms) override;
+        void setColorManualExposure(float integration_time_ms, float analog_gain) override;
+        void setColorSetting(libfreenect2::ColorSettingCommandType cmd, std::uint32_t value) override;
+        void setColorSetting(libfreenect2::ColorSettingCommandType cmd, float value) override;
+        std::uint32_t getColorSetting(libfreenect2::ColorSettingCommandType cmd) override;
+        float getColorSettingFloat(libfreenect2::ColorSettingCommandType cmd) override;
+        void setLedStatus(libfreenect2::LedSettings led) override;
+        bool start() override;
+        bool startStreams(bool rgb, bool depth) override;
+        bool stop() override;
+        bool close() override;
+
+        /**
+         * @brief Gets the device settings.
+         *
+         * @return const virtual_device_config& The settings.
+         */
+        [[nodiscard]] const virtual_device_config& getConfig() const
+        {
+            return config;
+        }
+    };
+}
+
+#endif //VIRTUAL_DEVICE_H
@@ -0,0 +1,87 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vision
+{
+    /**
+     * @class worker_pool
+     * @brief Fixed set of threads running index-parallel loops.
+     *
+     * run() hands out task indices from a shared counter, so uneven tasks balance
+     * themselves. The calling thread works on the loop too and returns once every
+     * task has finished. Only one run() may be active at a time.
+     */
+    class worker_pool {
+    private:
+        std::vector<std::thread> workers; ///< Worker threads; the caller is the extra participant.
+        std::mutex mutex; ///< Guards the job state below.
+        std::condition_variable job_ready; ///< Wakes workers for a new job.
+        std::condition_variable job_done; ///< Wakes run() when the last worker leaves the job.
+        std::uint64_t generation = 0; ///< Incremented for every job.
+        std::size_t active = 0; ///< Workers still inside the current job.
+        bool stopping = false; ///< Workers should exit.
+
+        const std::function<void(std::size_t)>* task = nullptr; ///< Body of the current job.
+        std::size_t task_count = 0; ///< Number of tasks in the current job.
+        std::atomic<std::size_t> next_task{0}; ///< Next unclaimed task index.
+
+        /**
+         * @brief Claims and runs tasks of the current job until none is left.
+         */
+        void work();
+
+        /**
+         * @brief Worker thread body.
+         *
+         * @param cpu Core to pin to, or -1.
+         */
+        void runWorker(int cpu);
+
+    public:
+        /**
+         * @brief Starts the worker threads.
+         *
+         * @param threads Total number of threads working on a loop, including the caller; 1 runs everything inline.
+         * @param cpus Cores the workers are pinned to, round robin; empty leaves them unpinned.
+         */
+        explicit worker_pool(std::size_t threads, const std::vector<int>& cpus = {});
+
+        /// Stops and joins the workers.
+        ~worker_pool();
+
+        worker_pool(const worker_pool&) = delete;
+        worker_pool& operator=(const worker_pool&) = delete;
+
+        /**
+         * @brief Runs task(i) for every i in [0, count) and waits for all of them.
+         *
+         * @param count Number of tasks.
+         * @param body Task body; called concurrently from several threads.
+         */
+        void run(std::size_t count, const std::function<void(std::size_t)>& body);
+
+        /**
+         * @brief Gets the number of threads working on a loop.
+         *
+         * @return std::size_t Workers plus the calling thread.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return workers.size() + 1;
+        }
+    };
+}
+
+#endif //WORKER_POOL_H
@@ -0,0 +1,237 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef TSDF_VOLUME_H
+#define TSDF_VOLUME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "libfreenect2/libfreenect2.hpp"
+#include "debug/status.h"
+#include "device/simd_dispatch.h"
+#include "device/worker_pool.h"
+#include "geometry/pose.h"
+
+namespace vision
+{
+    /**
+     * @struct tsdf_config
+     * @brief Settings of a tsdf_volume.
+     */
+    struct tsdf_config
+    {
+        float voxel_size = 0.01f;  ///< Voxel edge in meters.
+        float truncation = 0.04f;  ///< Truncation distance in meters.
+        float max_weight = 64.0f;  ///< Weight a voxel saturates at; lower values adapt faster to change.
+        float min_depth = 0.5f;    ///< Nearest depth integrated, in meters.
+        float max_depth = 4.5f;    ///< Farthest depth integrated, in meters.
+        std::size_t threads = 0;   ///< Threads integrating and meshing, including the caller; 0 uses one per core.
+        std::vector<int> cpus;     ///< Cores the threads are pinned to; empty leaves them unpinned.
+    };
+
+    /**
+     * @struct triangle_mesh
+     * @brief Triangle soup extracted from a volume.
+     */
+    struct triangle_mesh
+    {
+        std::vector<float> vertices; ///< x, y, z of every vertex in meters; three vertices per triangle, counter-clockwise seen from the free side.
+
+        /**
+         * @brief Gets the number of triangles.
+         *
+         * @return std::size_t The triangle count.
+         */
+        [[nodiscard]] std::size_t triangleCount() const
+        {
+            return vertices.size() / 9;
+        }
+    };
+
+    /**
+     * @class tsdf_volume
+     * @brief Fuses depth frames into a truncated signed distance field and meshes it.
+     *
+     * Space is split into bricks of 8x8x8 voxels that are allocated on demand, around
+     * the observed surfaces only, and found through an open-addressing hash of their
+     * coordinates. integrate() allocates the bricks inside the truncation band of every
+     * depth pixel, then projects the voxels of those bricks into the depth frame in
+     * parallel, one brick per task. The AVX2 kernel projects eight voxels at a time, see
+     * simd_dispatch.h.
+     *
+     * extractMesh() runs marching cubes only on the bricks changed since the previous
+     * call and keeps the triangles of the others, so its cost follows the part of the
+     * scene that moved rather than the size of the volume.
+     *
+     * Frames of several devices are fused by integrating them one after another with
+     * the parameters and pose of each device. integrate() and extractMesh() must not be
+     * called concurrently.
+     */
+    class tsdf_volume {
+    public:
+        using kernel = simd_kernel; ///< Voxel projection kernel implementation.
+
+        static constexpr int brick_size = 8; ///< Voxels along each edge of a brick.
+        static constexpr int brick_voxels = brick_size * brick_size * brick_size; ///< Voxels in a brick.
+
+    private:
+        /**
+         * @struct brick
+         * @brief 8x8x8 voxels, x fastest, and the triangles last extracted from them.
+         */
+        struct brick
+        {
+            alignas(32) float tsdf[brick_voxels]; ///< Signed distance over the truncation distance, in [-1, 1].
+            alignas(32) float weight[brick_voxels]; ///< Integration weight; 0 for unobserved voxels.
+            int x, y, z; ///< Brick coordinates.
+            std::uint64_t visible_frame = 0; ///< Last frame the brick was in the truncation band of.
+            bool dirty = false; ///< The triangles are out of date.
+            std::vector<float> mesh; ///< Triangles of the cubes whose lowest corner is in the brick.
+
+            brick(int x, int y, int z);
+        };
+
+        tsdf_config config; ///< Volume settings.
+        kernel active_kernel; ///< Kernel used by integrate().
+        std::unique_ptr<worker_pool> pool; ///< Threads running the bricks.
+
+        std::vector<std::unique_ptr<brick>> bricks; ///< Allocated bricks.
+        std::vector<std::uint64_t> table_keys; ///< Hash slots: packed brick coordinates, or empty_key.
+        std::vector<std::int32_t> table_bricks; ///< Hash slots: index into bricks.
+        std::uint64_t frame_count = 0; ///< Frames integrated.
+
+        std::vector<std::vector<std::uint64_t>> band_keys; ///< Scratch: bricks touched by each band of depth rows.
+        std::vector<std::int32_t> visible; ///< Scratch: bricks in the truncation band of the current frame.
+        std::vector<std::uint8_t> updated; ///< Scratch: per visible brick, true if a voxel changed.
+
+        /**
+         * @brief Finds a brick.
+         *
+         * @param key Packed brick coordinates.
+         * @return std::int32_t The brick index, or -1.
+         */
+        [[nodiscard]] std::int32_t findBrick(std::uint64_t key) const;
+
+        /**
+         * @brief Finds a brick, allocating it if needed.
+         *
+         * @param key Packed brick coordinates.
+         * @return std::int32_t The brick index.
+         */
+        std::int32_t insertBrick(std::uint64_t key);
+
+        /**
+         * @brief Runs marching cubes on the cubes whose lowest corner is in a brick.
+         *
+         * @param index The brick index.
+         */
+        void meshBrick(std::int32_t index);
+
+    public:
+        /**
+         * @brief Creates an empty volume.
+         *
+         * @param config Volume settings.
+         * @param requested Kernel to use; an unsupported kernel falls back to the best supported one.
+         */
+        explicit tsdf_volume(const tsdf_config& config = {}, kernel requested = kernel::Auto);
+
+        tsdf_volume(const tsdf_volume&) = delete;
+        tsdf_volume& operator=(const tsdf_volume&) = delete;
+
+        /**
+         * @brief Packs brick coordinates into a hash key.
+         *
+         * @return std::uint64_t The key.
+         */
+        static std::uint64_t brickKey(int x, int y, int z);
+
+        /**
+         * @brief Fuses an undistorted depth frame.
+         *
+         * @param depth Depth frame in millimeters, such as Registration::apply's undistorted output.
+         * @param params Intrinsics of the depth camera.
+         * @param world_from_camera Pose of the depth camera.
+         * @return Result The result of the operation.
+         */
+        Result integrate(const libfreenect2::Frame& depth, const libfreenect2::Freenect2Device::IrCameraParams& params,
+                         const pose& world_from_camera = identity_pose);
+
+        /**
+         * @brief Re-meshes the bricks changed since the last call and gathers every triangle.
+         *
+         * @param mesh Receives the triangles of the whole volume.
+         * @return std::size_t The number of bricks re-meshed.
+         */
+        std::size_t extractMesh(triangle_mesh& mesh);
+
+        /**
+         * @brief Reads the voxel nearest to a point.
+         *
+         * @param x World x in meters.
+         * @param y World y in meters.
+         * @param z World z in meters.
+         * @param tsdf Receives the truncated signed distance over the truncation distance.
+         * @param weight Receives the integration weight.
+         * @return bool True if the voxel lies in an allocated brick.
+         */
+        bool sample(float x, float y, float z, float& tsdf, float& weight) const;
+
+        /**
+         * @brief Drops every brick.
+         */
+        void reset();
+
+        /**
+         * @brief Gets the kernel in use.
+         *
+         * @return kernel The kernel.
+         */
+        [[nodiscard]] kernel getKernel() const
+        {
+            return active_kernel;
+        }
+
+        /**
+         * @brief Gets the number of allocated bricks.
+         *
+         * @return std::size_t The brick count.
+         */
+        [[nodiscard]] std::size_t getBrickCount() const
+        {
+            return bricks.size();
+        }
+
+        /**
+         * @brief Gets the number of bricks the next extractMesh() will re-mesh.
+         *
+         * @return std::size_t The dirty brick count.
+         */
+        [[nodiscard]] std::size_t getDirtyBrickCount() const;
+
+        /**
+         * @brief Gets the number of threads integrating a frame.
+         *
+         * @return std::size_t Worker threads plus the calling one.
+         */
+        [[nodiscard]] std::size_t getThreadCount() const
+        {
+            return pool->size();
+        }
+
+        /**
+         * @brief Gets the settings of the volume.
+         *
+         * @return const tsdf_config& The settings.
+         */
+        [[nodiscard]] const tsdf_config& getConfig() const
+        {
+            return config;
+        }
+    };
+}
+
+#endif //TSDF_VOLUME_H
@@ -0,0 +1,112 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef CLOUD_MERGER_H
+#define CLOUD_MERGER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "debug/status.h"
+#include "device/simd_dispatch.h"
+#include "device/worker_pool.h"
+#include "geometry/point_cloud_builder.h"
+#include "geometry/pose.h"
+
+namespace vision
+{
+    /**
+     * @struct merge_source
+     * @brief One device's contribution to a merged cloud.
+     */
+    struct merge_source
+    {
+        const point_cloud* cloud = nullptr; ///< Points in the device's depth camera frame.
+        pose world_from_camera = identity_pose; ///< Extrinsics of the device, such as extrinsics_store::find's.
+    };
+
+    /**
+     * @class cloud_merger
+     * @brief Transforms the clouds of several devices into the world frame and concatenates them.
+     *
+     * The merged cloud is a single row: the points of the first source, then those of the
+     * second, and so on, each source keeping its pixel order so a point maps back to its
+     * device and pixel. Invalid points stay NaN. The output arrays are reused, so merging
+     * the same devices every frame does not allocate.
+     *
+     * The sources are split into chunks that are transformed in parallel, so a single device
+     * is spread over the threads as well. The AVX2 kernel transforms eight points per
+     * instruction, see simd_dispatch.h.
+     */
+    class cloud_merger {
+    public:
+        using kernel = simd_kernel; ///< Transform kernel implementation.
+
+        static constexpr std::size_t chunk_points = 16384; ///< Points per parallel task.
+
+    private:
+        /**
+         * @struct chunk
+         * @brief Range of a source transformed by one task.
+         */
+        struct chunk
+        {
+            std::size_t source; ///< Index of the source.
+            std::size_t begin;  ///< First point in the source.
+            std::size_t end;    ///< One past the last point in the source.
+            std::size_t offset; ///< Position of the first point in the merged cloud.
+        };
+
+        kernel active_kernel; ///< Kernel used by merge().
+        std::unique_ptr<worker_pool> pool; ///< Threads running the chunks.
+        std::vector<chunk> chunks; ///< Scratch: tasks of the current merge.
+
+    public:
+        /**
+         * @brief Creates a merger.
+         *
+         * @param threads Threads transforming, including the caller; 0 uses one per core.
+         * @param cpus Cores the threads are pinned to; empty leaves them unpinned.
+         * @param requested Kernel to use; an unsupported kernel falls back to the best supported one.
+         */
+        explicit cloud_merger(std::size_t threads = 0, const std::vector<int>& cpus = {},
+                              kernel requested = kernel::Auto);
+
+        cloud_merger(const cloud_merger&) = delete;
+        cloud_merger& operator=(const cloud_merger&) = delete;
+
+        /**
+         * @brief Transforms and concatenates clouds.
+         *
+         * The merged cloud has color if any source has; points of sources without color get 0.
+         *
+         * @param sources Clouds and their poses.
+         * @param merged Receives the points, as one row of every source's points in order.
+         * @return Result The result of the operation; InvalidParam if a source has no cloud or inconsistent arrays.
+         */
+        Result merge(const std::vector<merge_source>& sources, point_cloud& merged);
+
+        /**
+         * @brief Gets the kernel in use.
+         *
+         * @return kernel The kernel.
+         */
+        [[nodiscard]] kernel getKernel() const
+        {
+            return active_kernel;
+        }
+
+        /**
+         * @brief Gets the number of threads merging.
+         *
+         * @return std::size_t Worker threads plus the calling one.
+         */
+        [[nodiscard]] std::size_t getThreadCount() const
+        {
+            return pool->size();
+        }
+    };
+}
+
+#endif //CLOUD_MERGER_H
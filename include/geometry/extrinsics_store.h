@@ -0,0 +1,98 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef EXTRINSICS_STORE_H
+#define EXTRINSICS_STORE_H
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include "debug/status.h"
+#include "geometry/pose.h"
+
+namespace vision
+{
+    /**
+     * @class extrinsics_store
+     * @brief Pose of every calibrated device in the shared world frame, keyed by serial number.
+     *
+     * The poses are kept in a text file with one device per line: the serial followed by the
+     * first three rows of its world_from_camera matrix, twelve numbers in row-major order.
+     * Lines starting with '#' are comments. A serial without an entry has no known pose.
+     *
+     * Lookups and updates may come from different threads.
+     */
+    class extrinsics_store {
+    private:
+        mutable std::shared_mutex mutex; ///< Guards poses.
+        std::map<std::string, pose> poses; ///< Calibrated poses, keyed by serial.
+
+    public:
+        extrinsics_store() = default;
+
+        extrinsics_store(const extrinsics_store&) = delete;
+        extrinsics_store& operator=(const extrinsics_store&) = delete;
+
+        /**
+         * @brief Gets the default calibration file, $XDG_CONFIG_HOME/fusion-kinect2/extrinsics.txt or ~/.config/....
+         *
+         * @return std::string The path.
+         */
+        static std::string defaultPath();
+
+        /**
+         * @brief Replaces the poses with those of a calibration file.
+         *
+         * Nothing is changed if the file cannot be parsed.
+         *
+         * @param path Calibration file.
+         * @return Result The result of the operation; NotFound if the file does not exist.
+         */
+        Result load(const std::string& path);
+
+        /**
+         * @brief Writes every pose to a calibration file, creating its directory.
+         *
+         * @param path Calibration file.
+         * @return Result The result of the operation.
+         */
+        Result save(const std::string& path) const;
+
+        /**
+         * @brief Sets the pose of a device.
+         *
+         * @param serial Serial number of the device; must be a single token.
+         * @param world_from_camera Pose of the depth camera; the last row is ignored.
+         * @return bool True on success, false if the serial is empty or contains whitespace.
+         */
+        bool set(const std::string& serial, const pose& world_from_camera);
+
+        /**
+         * @brief Removes the pose of a device.
+         *
+         * @param serial Serial number of the device.
+         * @return bool True if the device had a pose.
+         */
+        bool remove(const std::string& serial);
+
+        /**
+         * @brief Gets the pose of a device.
+         *
+         * @param serial Serial number of the device.
+         * @return std::optional<pose> The pose if the device is calibrated; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<pose> find(const std::string& serial) const;
+
+        /**
+         * @brief Gets the number of calibrated devices.
+         *
+         * @return std::size_t The device count.
+         */
+        [[nodiscard]] std::size_t size() const;
+    };
+}
+
+#endif //EXTRINSICS_STORE_H
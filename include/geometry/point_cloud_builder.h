@@ -0,0 +1,145 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef POINT_CLOUD_BUILDER_H
+#define POINT_CLOUD_BUILDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "device/simd_dispatch.h"
+#include "libfreenect2/libfreenect2.hpp"
+
+namespace vision
+{
+    /**
+     * @struct point_cloud
+     * @brief Structure-of-arrays point cloud, one entry per depth pixel in row-major order.
+     *
+     * Invalid pixels hold NaN coordinates, exactly like libfreenect2::Registration::getPointXYZ.
+     * The arrays are only resized when the frame size changes, so a cloud can be reused per frame.
+     */
+    struct point_cloud
+    {
+        std::size_t width = 0;  ///< Number of columns.
+        std::size_t height = 0; ///< Number of rows.
+        std::vector<float> x;   ///< X coordinates in meters.
+        std::vector<float> y;   ///< Y coordinates in meters.
+        std::vector<float> z;   ///< Z coordinates in meters.
+        std::vector<float> rgb; ///< Registered color as the float-reinterpreted BGRX pixel; empty without color.
+
+        /**
+         * @brief Resizes the arrays for a frame.
+         *
+         * @param width Number of columns.
+         * @param height Number of rows.
+         * @param with_color True to allocate the color array.
+         */
+        void resize(std::size_t width, std::size_t height, bool with_color);
+
+        /**
+         * @brief Gets the number of points.
+         *
+         * @return std::size_t Width times height.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return width * height;
+        }
+    };
+
+    /**
+     * @struct point_xyzrgb
+     * @brief Packed point layout, matching the output of getPointXYZRGB.
+     */
+    struct point_xyzrgb
+    {
+        float x;   ///< X coordinate in meters.
+        float y;   ///< Y coordinate in meters.
+        float z;   ///< Z coordinate in meters.
+        float rgb; ///< Registered color as the float-reinterpreted BGRX pixel; 0 for invalid points.
+    };
+
+    /**
+     * @class point_cloud_builder
+     * @brief Back-projects whole undistorted depth frames into point clouds.
+     *
+     * The camera rays are separable, so they are precomputed once per device as one
+     * table per column and one per row. The tables are kept in double precision and
+     * the kernels multiply in double, which makes every kernel bit-exact with
+     * libfreenect2::Registration::getPointXYZ. The SSE kernel back-projects two pixels
+     * per instruction and the AVX2 kernel four, see simd_dispatch.h.
+     */
+    class point_cloud_builder {
+    public:
+        using kernel = simd_kernel; ///< Back-projection kernel implementation.
+
+        static constexpr std::size_t depth_width = 512;  ///< Width of a Kinect2 depth frame.
+        static constexpr std::size_t depth_height = 424; ///< Height of a Kinect2 depth frame.
+
+    private:
+        std::vector<double> ray_x; ///< (c + 0.5 - cx) / fx for every column.
+        std::vector<double> ray_y; ///< (r + 0.5 - cy) / fy for every row.
+        kernel active_kernel; ///< Kernel used by build().
+
+        /**
+         * @brief Back-projects one row.
+         */
+        void buildRow(const float* depth, const float* color, std::size_t row,
+                      float* x, float* y, float* z, float* rgb) const;
+
+    public:
+        /**
+         * @brief Precomputes the ray tables of a device.
+         *
+         * @param params Depth camera intrinsics of the device.
+         * @param requested Kernel to use; unsupported kernels fall back to the best supported one.
+         */
+        explicit point_cloud_builder(const libfreenect2::Freenect2Device::IrCameraParams& params,
+                                     kernel requested = kernel::Auto);
+
+        /**
+         * @brief Gets the kernel in use.
+         *
+         * @return kernel The kernel.
+         */
+        [[nodiscard]] kernel getKernel() const
+        {
+            return active_kernel;
+        }
+
+        /**
+         * @brief Back-projects an undistorted depth frame.
+         *
+         * @param undistorted 512x424 undistorted depth frame in millimeters.
+         * @param cloud Receives the points.
+         * @return bool True on success, false if the frame has an unexpected size.
+         */
+        bool build(const libfreenect2::Frame& undistorted, point_cloud& cloud) const;
+
+        /**
+         * @brief Back-projects an undistorted depth frame with its registered color.
+         *
+         * @param undistorted 512x424 undistorted depth frame in millimeters.
+         * @param registered 512x424 registered color frame.
+         * @param cloud Receives the points and colors.
+         * @return bool True on success, false if a frame has an unexpected size.
+         */
+        bool build(const libfreenect2::Frame& undistorted, const libfreenect2::Frame& registered,
+                   point_cloud& cloud) const;
+
+        /**
+         * @brief Back-projects into the packed XYZRGB layout.
+         *
+         * @param undistorted 512x424 undistorted depth frame in millimeters.
+         * @param registered 512x424 registered color frame.
+         * @param points Receives the points; resized only when the size changes.
+         * @return bool True on success, false if a frame has an unexpected size.
+         */
+        bool buildPacked(const libfreenect2::Frame& undistorted, const libfreenect2::Frame& registered,
+                         std::vector<point_xyzrgb>& points) const;
+    };
+}
+
+#endif //POINT_CLOUD_BUILDER_H
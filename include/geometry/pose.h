@@ -0,0 +1,50 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef POSE_H
+#define POSE_H
+
+#include <array>
+
+namespace vision
+{
+    /// Row-major 4x4 rigid transform from camera to world coordinates, translation in meters.
+    using pose = std::array<float, 16>;
+
+    /// Pose of a camera sitting at the world origin.
+    inline constexpr pose identity_pose = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+    /**
+     * @brief Chains two rigid transforms.
+     *
+     * @param a Outer transform.
+     * @param b Inner transform.
+     * @return pose a * b, which applies b first.
+     */
+    inline pose compose(const pose& a, const pose& b)
+    {
+        pose result{};
+        for(int r = 0; r < 4; ++r)
+            for(int c = 0; c < 4; ++c)
+                result[r * 4 + c] = a[r * 4] * b[c] + a[r * 4 + 1] * b[4 + c] + a[r * 4 + 2] * b[8 + c] + a[r * 4 + 3] * b[12 + c];
+        return result;
+    }
+
+    /**
+     * @brief Inverts a rigid transform.
+     *
+     * @param transform Rotation and translation; the last row must be 0 0 0 1.
+     * @return pose The inverse: transposed rotation and -R^T t.
+     */
+    inline pose invertRigid(const pose& transform)
+    {
+        const pose& m = transform;
+        pose result = {m[0], m[4], m[8], 0, m[1], m[5], m[9], 0, m[2], m[6], m[10], 0, 0, 0, 0, 1};
+        for(int r = 0; r < 3; ++r)
+            result[r * 4 + 3] = -(result[r * 4] * m[3] + result[r * 4 + 1] * m[7] + result[r * 4 + 2] * m[11]);
+        return result;
+    }
+}
+
+#endif //POSE_H
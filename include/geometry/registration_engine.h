@@ -0,0 +1,166 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef REGISTRATION_ENGINE_H
+#define REGISTRATION_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "libfreenect2/libfreenect2.hpp"
+#include "debug/status.h"
+#include "device/simd_dispatch.h"
+#include "device/worker_pool.h"
+
+namespace vision
+{
+    /**
+     * @struct registration_config
+     * @brief Settings of a registration_engine.
+     */
+    struct registration_config
+    {
+        bool use_cache = true; ///< Load and store the tables in the on-disk cache.
+        std::string cache_directory; ///< Cache directory; empty uses registration_engine::defaultCacheDirectory().
+        std::size_t threads = 1; ///< Threads registering a frame, including the calling one.
+        std::vector<int> cpus; ///< Cores the registration threads are pinned to; empty leaves them unpinned.
+    };
+
+    /**
+     * @class registration_engine
+     * @brief Maps color frames onto depth frames with per-device lookup tables.
+     *
+     * Produces the same undistorted, registered and bigdepth frames as
+     * libfreenect2::Registration::apply. The distortion and color-mapping tables are
+     * built once per device as separate arrays and stored in an on-disk cache keyed by
+     * the serial number and checked against the camera parameters, so a known device
+     * starts without rebuilding them. A frame is processed in three passes over bands
+     * on a worker pool: undistortion and color offsets, the occlusion filter, and the
+     * color lookup. The AVX2 kernel gathers eight depth and color pixels at a time, see
+     * simd_dispatch.h.
+     *
+     * apply() uses internal scratch buffers and must not be called from several threads at once.
+     */
+    class registration_engine {
+    public:
+        using kernel = simd_kernel; ///< Per-pixel kernel implementation.
+
+        static constexpr std::size_t depth_width = 512;   ///< Width of a Kinect2 depth frame.
+        static constexpr std::size_t depth_height = 424;  ///< Height of a Kinect2 depth frame.
+        static constexpr std::size_t color_width = 1920;  ///< Width of a Kinect2 color frame.
+        static constexpr std::size_t color_height = 1080; ///< Height of a Kinect2 color frame.
+        static constexpr std::size_t bigdepth_height = 1082; ///< Height of the bigdepth frame, one blank row on top and bottom.
+
+    private:
+        libfreenect2::Freenect2Device::IrCameraParams depth_params; ///< Depth camera parameters.
+        libfreenect2::Freenect2Device::ColorCameraParams color_params; ///< Color camera parameters.
+
+        std::vector<std::int32_t> distort_map; ///< Distorted depth pixel of every undistorted pixel, or -1.
+        std::vector<float> color_x; ///< Color x of every depth pixel before the depth-dependent shift.
+        std::vector<float> color_y; ///< Color y of every depth pixel.
+        std::vector<std::int32_t> color_row; ///< color_y rounded to a color row.
+
+        kernel active_kernel; ///< Kernel used by apply().
+        bool from_cache = false; ///< True if the tables were loaded from the cache.
+        std::unique_ptr<worker_pool> pool; ///< Threads running the bands.
+        std::vector<std::int32_t> color_offsets; ///< Scratch color offsets when the caller passes none.
+        std::vector<float> filter_map; ///< Scratch occlusion map when the caller passes no bigdepth frame.
+
+        /**
+         * @brief Computes the tables from the camera parameters.
+         */
+        void buildTables();
+
+        /**
+         * @brief Loads the tables from a cache file if it matches the camera parameters.
+         *
+         * @param path Cache file path.
+         * @return Result The result of the operation.
+         */
+        Result loadTables(const std::string& path);
+
+        /**
+         * @brief Writes the tables to a cache file, replacing it atomically.
+         *
+         * @param path Cache file path.
+         * @return Result The result of the operation.
+         */
+        Result saveTables(const std::string& path) const;
+
+    public:
+        /**
+         * @brief Loads the tables of a device from the cache, or builds and caches them.
+         *
+         * @param serial Serial number of the device, the cache key.
+         * @param depth Depth camera parameters.
+         * @param color Color camera parameters.
+         * @param config Engine settings.
+         * @param requested Kernel to use; an unsupported kernel falls back to the best supported one.
+         */
+        registration_engine(const std::string& serial, const libfreenect2::Freenect2Device::IrCameraParams& depth,
+                            const libfreenect2::Freenect2Device::ColorCameraParams& color,
+                            const registration_config& config = {}, kernel requested = kernel::Auto);
+
+        registration_engine(const registration_engine&) = delete;
+        registration_engine& operator=(const registration_engine&) = delete;
+
+        /**
+         * @brief Gets the default cache directory, $XDG_CACHE_HOME/fusion-kinect2/registration or ~/.cache/....
+         *
+         * @return std::string The directory.
+         */
+        static std::string defaultCacheDirectory();
+
+        /**
+         * @brief Gets the kernel in use.
+         *
+         * @return kernel The kernel.
+         */
+        [[nodiscard]] kernel getKernel() const
+        {
+            return active_kernel;
+        }
+
+        /**
+         * @brief Checks if the tables were loaded from the cache.
+         *
+         * @return bool True if the cache was used, false if the tables were built.
+         */
+        [[nodiscard]] bool isFromCache() const
+        {
+            return from_cache;
+        }
+
+        /**
+         * @brief Maps one undistorted depth pixel to color coordinates.
+         *
+         * @param dx Depth column.
+         * @param dy Depth row.
+         * @param dz Depth in millimeters.
+         * @param cx Receives the color x coordinate.
+         * @param cy Receives the color y coordinate.
+         */
+        void apply(int dx, int dy, float dz, float& cx, float& cy) const;
+
+        /**
+         * @brief Undistorts a depth frame and maps the color frame onto it.
+         *
+         * @param rgb 1920x1080 BGRX color frame.
+         * @param depth 512x424 depth frame in millimeters.
+         * @param undistorted Receives the 512x424 undistorted depth frame.
+         * @param registered Receives the 512x424 color frame for the undistorted depth.
+         * @param enable_filter Drop color pixels occluded from the depth camera.
+         * @param bigdepth Receives the 1920x1082 depth frame for the color camera, or nullptr. Needs enable_filter.
+         * @param color_depth_map Receives the color offset of every depth pixel, or -1; may be nullptr.
+         * @return bool True on success, false if a frame has an unexpected size.
+         */
+        bool apply(const libfreenect2::Frame& rgb, const libfreenect2::Frame& depth, libfreenect2::Frame& undistorted,
+                   libfreenect2::Frame& registered, bool enable_filter = true,
+                   libfreenect2::Frame* bigdepth = nullptr, int* color_depth_map = nullptr);
+    };
+}
+
+#endif //REGISTRATION_ENGINE_H
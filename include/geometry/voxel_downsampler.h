@@ -0,0 +1,153 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef VOXEL_DOWNSAMPLER_H
+#define VOXEL_DOWNSAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "debug/status.h"
+#include "device/worker_pool.h"
+#include "geometry/point_cloud_builder.h"
+
+namespace vision
+{
+    /**
+     * @enum voxel_point
+     * @brief Point a voxel_downsampler keeps for every occupied voxel.
+     */
+    enum class voxel_point
+    {
+        Centroid, ///< Mean position and mean color of the points in the voxel.
+        First,    ///< Position and color of the voxel's point with the lowest index.
+    };
+
+    /**
+     * @struct voxel_config
+     * @brief Settings of a voxel_downsampler.
+     */
+    struct voxel_config
+    {
+        float voxel_size = 0.01f; ///< Voxel edge in meters.
+        voxel_point point = voxel_point::Centroid; ///< Point kept per voxel.
+        std::size_t threads = 0; ///< Threads downsampling, including the caller; 0 uses one per core.
+        std::vector<int> cpus; ///< Cores the threads are pinned to; empty leaves them unpinned.
+    };
+
+    /**
+     * @class voxel_downsampler
+     * @brief Reduces a point cloud to one point per occupied voxel of a regular grid.
+     *
+     * Every valid point gets a 64-bit key from its voxel coordinates. The points are first
+     * radix-partitioned by the top bits of the hashed key, chunk by chunk in parallel, which
+     * keeps the points of a voxel in one partition and in their original order. Each partition
+     * then gathers its voxels in its own open-addressing table, one partition per task, so no
+     * two threads ever touch the same voxel.
+     *
+     * The output does not depend on the thread count. Every buffer is kept across calls, so
+     * downsampling clouds of a steady size does not allocate.
+     */
+    class voxel_downsampler {
+    public:
+        static constexpr std::size_t partition_bits = 8; ///< log2 of the number of partitions.
+        static constexpr std::size_t partitions = std::size_t{1} << partition_bits; ///< Number of partitions.
+        static constexpr std::size_t chunk_points = 16384; ///< Points keyed per task.
+
+    private:
+        /**
+         * @struct voxel_sum
+         * @brief Points gathered in one voxel.
+         */
+        struct voxel_sum
+        {
+            double x, y, z;         ///< Sum of the positions.
+            std::uint32_t b, g, r;  ///< Sum of the color channels.
+            std::uint32_t count;    ///< Number of points.
+            std::uint32_t first;    ///< Index of the first point.
+        };
+
+        /**
+         * @struct keyed_point
+         * @brief A valid point copied next to its voxel key, so a partition is read sequentially.
+         */
+        struct keyed_point
+        {
+            std::uint64_t key;    ///< Voxel key.
+            float x, y, z;        ///< Position.
+            std::uint32_t color;  ///< BGRX color bits; 0 without color.
+            std::uint32_t index;  ///< Index of the point in the cloud.
+        };
+
+        /**
+         * @struct partition
+         * @brief Hash table of the voxels of one partition.
+         */
+        struct partition
+        {
+            std::vector<std::uint64_t> keys; ///< Hash slots: voxel key, or the empty key.
+            std::vector<std::uint32_t> slots; ///< Hash slots: index into voxels.
+            std::vector<voxel_sum> voxels; ///< Occupied voxels in order of their first point.
+        };
+
+        voxel_config config; ///< Downsampler settings.
+        std::unique_ptr<worker_pool> pool; ///< Threads running the chunks and partitions.
+        std::vector<std::uint64_t> keys; ///< Scratch: voxel key of every point, or the empty key.
+        std::vector<std::uint32_t> counts; ///< Scratch: points per chunk and partition, then their write offsets.
+        std::vector<keyed_point> order; ///< Scratch: valid points grouped by partition, in cloud order within each.
+        std::vector<std::uint32_t> partition_begin; ///< Scratch: first entry of every partition in order, and the end.
+        std::vector<partition> tables; ///< Per-partition voxel tables.
+
+        /**
+         * @brief Gathers the points of one partition into its table.
+         */
+        void gatherPartition(std::size_t index);
+
+    public:
+        /**
+         * @brief Creates a downsampler.
+         *
+         * @param config Downsampler settings.
+         */
+        explicit voxel_downsampler(const voxel_config& config = {});
+
+        voxel_downsampler(const voxel_downsampler&) = delete;
+        voxel_downsampler& operator=(const voxel_downsampler&) = delete;
+
+        /**
+         * @brief Downsamples a cloud.
+         *
+         * NaN points are skipped, as are points more than 2^20 voxels from the origin. The
+         * colors are averaged per B, G and R channel; the padding byte of an averaged color is 0.
+         *
+         * @param cloud Points to downsample, such as a cloud_merger output.
+         * @param downsampled Receives one point per voxel as a single row; colored if the input is.
+         * @return Result The result of the operation; InvalidParam if the cloud arrays are inconsistent.
+         */
+        Result downsample(const point_cloud& cloud, point_cloud& downsampled);
+
+        /**
+         * @brief Gets the settings of the downsampler.
+         *
+         * @return const voxel_config& The settings.
+         */
+        [[nodiscard]] const voxel_config& getConfig() const
+        {
+            return config;
+        }
+
+        /**
+         * @brief Gets the number of threads downsampling.
+         *
+         * @return std::size_t Worker threads plus the calling one.
+         */
+        [[nodiscard]] std::size_t getThreadCount() const
+        {
+            return pool->size();
+        }
+    };
+}
+
+#endif //VOXEL_DOWNSAMPLER_H
@@ -0,0 +1,135 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef SHM_CLIENT_H
+#define SHM_CLIENT_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "libfreenect2/frame_listener.hpp"
+#include "debug/status.h"
+#include "ipc/shm_format.h"
+
+namespace vision
+{
+    /**
+     * @struct shm_frame
+     * @brief A frame read from a shared-memory segment, still in place in its slot.
+     */
+    struct shm_frame
+    {
+        shm::frame_info info; ///< Metadata of the frame.
+        const unsigned char* data = nullptr; ///< Payload in the mapped segment.
+        const shm::slot_header* slot = nullptr; ///< Slot holding the frame.
+        std::uint64_t lock = 0; ///< Slot lock the frame was read under.
+    };
+
+    /**
+     * @class shm_client
+     * @brief Reads frames from a segment written by shm_publisher, without copying them.
+     *
+     * The segment is mapped read-only. Frames are returned in publish order as pointers
+     * into their slots; the publisher may overwrite a slot at any time, so a reader
+     * checks isValid() after using a payload and discards its results if the frame
+     * changed underneath. A client belongs to one thread.
+     */
+    class shm_client {
+    private:
+        const unsigned char* segment = nullptr; ///< Mapped segment.
+        std::size_t segment_size = 0; ///< Size of the mapping.
+        std::uint64_t cursors[shm::ring_count] = {}; ///< Number of the next frame to read from each ring.
+        std::uint64_t lost[shm::ring_count] = {}; ///< Frames overwritten before they were read.
+
+        /**
+         * @brief Gets the segment header.
+         */
+        [[nodiscard]] const shm::segment_header& header() const
+        {
+            return *reinterpret_cast<const shm::segment_header*>(segment);
+        }
+
+        /**
+         * @brief Reads the stable contents of a slot.
+         *
+         * @return bool True if the slot was not being written while it was read.
+         */
+        bool readSlot(const shm::ring_header& ring, std::uint64_t slot, shm_frame& frame) const;
+
+    public:
+        shm_client() = default;
+
+        /// Unmaps the segment.
+        ~shm_client();
+
+        shm_client(const shm_client&) = delete;
+        shm_client& operator=(const shm_client&) = delete;
+
+        /**
+         * @brief Maps a segment. Reading starts at the frames published after this call.
+         *
+         * @param name Segment name, as given to shm_publisher::open().
+         * @return Result The result of the operation.
+         */
+        Result open(const std::string& name);
+
+        /**
+         * @brief Unmaps the segment.
+         */
+        void close();
+
+        /**
+         * @brief Checks whether the publisher still writes to the segment.
+         *
+         * @return bool True if a segment is mapped and its publisher has not closed it.
+         */
+        [[nodiscard]] bool isPublisherOpen() const;
+
+        /**
+         * @brief Gets the next frame of a type in publish order.
+         *
+         * Frames overwritten before they were read are skipped and counted by getLost().
+         *
+         * @param type The frame type.
+         * @return std::optional<shm_frame> The frame, or std::nullopt if no new frame is complete yet.
+         */
+        std::optional<shm_frame> next(libfreenect2::Frame::Type type);
+
+        /**
+         * @brief Gets the newest complete frame of a type and moves the cursor past it.
+         *
+         * @param type The frame type.
+         * @return std::optional<shm_frame> The frame, or std::nullopt if no new frame is complete yet.
+         */
+        std::optional<shm_frame> latest(libfreenect2::Frame::Type type);
+
+        /**
+         * @brief Checks whether a frame is still in its slot. Call after using the payload.
+         *
+         * @param frame The frame.
+         * @return bool True if the publisher has not started overwriting the slot.
+         */
+        [[nodiscard]] bool isValid(const shm_frame& frame) const;
+
+        /**
+         * @brief Gets the number of frames of a type overwritten before they were read.
+         *
+         * @param type The frame type.
+         * @return std::uint64_t The lost frame count.
+         */
+        [[nodiscard]] std::uint64_t getLost(libfreenect2::Frame::Type type) const;
+
+        /**
+         * @brief Points a frame at the payload of a shared frame and copies its metadata.
+         *
+         * The frame must not own its buffer. The payload is read-only.
+         *
+         * @param _frame The shared frame.
+         * @param frame Receives the metadata and the payload pointer.
+         */
+        static void view(const shm_frame& _frame, libfreenect2::Frame& frame);
+    };
+}
+
+#endif //SHM_CLIENT_H
@@ -0,0 +1,145 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef SHM_FORMAT_H
+#define SHM_FORMAT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vision::shm
+{
+    /*
+     * A frame segment is one POSIX shared-memory object:
+     *
+     *   segment_header   first page: magic, version and one ring_header per frame type.
+     *   slot headers     per ring, slot_count cache-line aligned slot_headers.
+     *   payloads         per ring, slot_count page-aligned payloads of slot_size bytes.
+     *
+     * The publisher writes frame n of a ring into slot n % slot_count. Every slot is a
+     * seqlock: its lock is odd while the publisher writes the slot and is incremented
+     * again once the frame is complete. A reader copies the frame_info between two reads
+     * of the lock and uses the payload in place; reading the lock again afterwards tells
+     * whether the payload was overwritten while it was being used.
+     *
+     * Fields are in host byte order; the segment never leaves the host.
+     */
+
+    inline constexpr std::uint64_t magic = 0x314d454d48534b46ull; ///< "FKSHMEM1".
+    inline constexpr std::uint32_t version = 1; ///< Current format version.
+
+    inline constexpr std::size_t page_size = 4096; ///< Alignment of the payloads.
+    inline constexpr std::size_t ring_count = 3; ///< One ring each for Color, Ir and Depth frames.
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "slot locks must work across processes");
+
+    /**
+     * @struct frame_info
+     * @brief Metadata of the frame in a slot.
+     */
+    struct frame_info
+    {
+        std::uint64_t frame_number = 0; ///< Position of the frame in the publish order of its ring.
+        std::uint64_t size = 0; ///< Payload size in bytes.
+        std::int64_t arrival_ns = 0; ///< Host steady-clock arrival time of the frame.
+        std::int32_t device_id = -1; ///< ID of the device that produced the frame.
+        std::uint32_t type = 0; ///< libfreenect2::Frame::Type.
+        std::uint32_t format = 0; ///< libfreenect2::Frame::Format.
+        std::uint32_t timestamp = 0; ///< Device timestamp in 0.125 ms ticks.
+        std::uint32_t sequence = 0; ///< Device sequence number.
+        std::uint32_t status = 0; ///< libfreenect2 frame status.
+        std::uint32_t width = 0; ///< Frame width.
+        std::uint32_t height = 0; ///< Frame height.
+        std::uint32_t bytes_per_pixel = 0; ///< Bytes per pixel.
+        float exposure = 0.0f; ///< Color exposure.
+        float gain = 0.0f; ///< Color gain.
+        float gamma = 0.0f; ///< Color gamma.
+    };
+
+    /**
+     * @struct slot_header
+     * @brief Seqlock and metadata of one slot.
+     */
+    struct alignas(64) slot_header
+    {
+        std::atomic<std::uint64_t> lock{0}; ///< Even when the slot is stable, odd while it is being written.
+        frame_info info; ///< The frame in the slot; only valid when read under an unchanged even lock.
+    };
+
+    /**
+     * @struct ring_header
+     * @brief Layout and progress of the ring of one frame type.
+     */
+    struct alignas(64) ring_header
+    {
+        std::atomic<std::uint64_t> published{0}; ///< Frames claimed so far; the number of the next frame.
+        std::uint32_t slot_count = 0; ///< Number of slots; 0 if the type is not published.
+        std::uint32_t reserved = 0; ///< Zero.
+        std::uint64_t slot_size = 0; ///< Payload capacity of a slot, a multiple of the page size.
+        std::uint64_t slots_offset = 0; ///< Offset of the first slot_header in the segment.
+        std::uint64_t payload_offset = 0; ///< Offset of the first payload in the segment.
+    };
+
+    /**
+     * @struct segment_header
+     * @brief Start of the segment.
+     */
+    struct segment_header
+    {
+        std::uint64_t magic = shm::magic; ///< shm::magic.
+        std::uint32_t version = shm::version; ///< Format version.
+        std::uint32_t header_size = sizeof(segment_header); ///< sizeof(segment_header) when written.
+        std::uint64_t segment_size = 0; ///< Size of the whole segment in bytes.
+        std::atomic<std::uint32_t> open{0}; ///< 1 while the publisher runs, 0 once it closed the segment.
+        std::int32_t publisher_pid = 0; ///< Process ID of the publisher.
+        ring_header rings[ring_count]; ///< Color, Ir and Depth rings.
+    };
+
+    static_assert(sizeof(segment_header) <= page_size);
+    static_assert(sizeof(slot_header) == 128, "slot_header is part of the segment format");
+
+    /**
+     * @brief Gets the ring of a frame type.
+     *
+     * @param type libfreenect2::Frame::Type.
+     * @return int Index into segment_header::rings, or -1 for other types.
+     */
+    constexpr int ringIndex(const std::uint32_t type)
+    {
+        switch(type)
+        {
+            case 1: return 0; // Color
+            case 2: return 1; // Ir
+            case 4: return 2; // Depth
+            default: return -1;
+        }
+    }
+
+    /**
+     * @brief Rounds a size up to a power-of-two alignment.
+     *
+     * @param value The size.
+     * @param alignment The alignment.
+     * @return std::size_t The aligned size.
+     */
+    constexpr std::size_t alignUp(const std::size_t value, const std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * @brief Gets the shared-memory object name of a segment.
+     *
+     * @param name Segment name, with or without the leading slash.
+     * @return std::string The name passed to shm_open().
+     */
+    inline std::string objectName(const std::string& name)
+    {
+        return !name.empty() && name.front() == '/' ? name : "/" + name;
+    }
+}
+
+#endif //SHM_FORMAT_H
@@ -0,0 +1,169 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef SHM_PUBLISHER_H
+#define SHM_PUBLISHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "libfreenect2/frame_listener.hpp"
+#include "debug/status.h"
+#include "device/frame_pool.h"
+#include "device/frame_bus.h"
+#include "ipc/shm_format.h"
+
+namespace vision
+{
+    /**
+     * @struct publisher_config
+     * @brief Settings of the shared-memory publisher.
+     */
+    struct publisher_config
+    {
+        std::size_t slot_count = 4; ///< Slots per frame type; a reader can hold a frame for about this many frames.
+        std::size_t color_slot_size = 1920 * 1080 * 4; ///< Largest color payload in bytes.
+        std::size_t depth_slot_size = 512 * 424 * 4; ///< Largest IR or depth payload in bytes.
+        unsigned frame_types = libfreenect2::Frame::Color | libfreenect2::Frame::Depth; ///< Published frame types.
+        std::vector<int> device_ids; ///< Published devices; empty publishes every device.
+        std::size_t queue_depth = 2; ///< Frames waiting for the publishing thread; the oldest is dropped beyond this.
+    };
+
+    /**
+     * @struct publisher_statistics
+     * @brief Counters of the shared-memory publisher.
+     */
+    struct publisher_statistics
+    {
+        std::uint64_t frames_published = 0; ///< Frames written to the segment.
+        std::uint64_t bytes_published = 0; ///< Payload bytes written to the segment.
+        std::uint64_t dropped = 0; ///< Frames larger than their slot, overtaken while waiting for it, or dropped from the queue.
+    };
+
+    /**
+     * @class shm_publisher
+     * @brief Publishes frames to other processes through a shared-memory segment, see shm_format.h.
+     *
+     * Every frame is copied once into the slot of its ring; readers map the segment
+     * with shm_client and use the payloads in place. The publisher never waits for
+     * readers: a reader that falls behind by more than slot_count frames loses the
+     * oldest ones. Attached to a frame_bus, the capture threads only queue references
+     * to their pooled frames and a publishing thread does the copies, dropping the
+     * oldest queued frames when it falls behind.
+     */
+    class shm_publisher {
+    private:
+        publisher_config config; ///< Publisher settings.
+        std::string object_name; ///< Name of the shared-memory object.
+        unsigned char* segment = nullptr; ///< Mapped segment.
+        std::size_t segment_size = 0; ///< Size of the mapping.
+        frame_bus* bus = nullptr; ///< Bus the publisher is subscribed to.
+        std::shared_ptr<frame_bus::subscription> subscriber; ///< Queue of frames to publish.
+        std::thread publisher_thread; ///< Publishes the queued frames.
+
+        std::atomic<std::uint64_t> frames_published{0}; ///< See publisher_statistics.
+        std::atomic<std::uint64_t> bytes_published{0}; ///< See publisher_statistics.
+        std::atomic<std::uint64_t> dropped{0}; ///< See publisher_statistics.
+
+        /**
+         * @brief Gets the segment header.
+         */
+        [[nodiscard]] shm::segment_header& header() const
+        {
+            return *reinterpret_cast<shm::segment_header*>(segment);
+        }
+
+        /**
+         * @brief Checks whether a frame passes the device and type filters.
+         */
+        [[nodiscard]] bool accepts(int device_id, libfreenect2::Frame::Type type) const;
+
+        /**
+         * @brief Publishing thread body; returns once the subscription is closed and drained.
+         */
+        void run();
+
+    public:
+        /**
+         * @brief Constructs a publisher.
+         *
+         * @param config Publisher settings.
+         */
+        explicit shm_publisher(const publisher_config& config = {});
+
+        /// Closes the segment.
+        ~shm_publisher();
+
+        shm_publisher(const shm_publisher&) = delete;
+        shm_publisher& operator=(const shm_publisher&) = delete;
+
+        /**
+         * @brief Creates and maps the segment.
+         *
+         * @param name Segment name; an existing segment of the same name is replaced.
+         * @return Result The result of the operation.
+         */
+        Result open(const std::string& name);
+
+        /**
+         * @brief Publishes the frames of a bus on a publishing thread until close().
+         *
+         * @param bus The bus to subscribe to; must outlive the attachment.
+         * @return Result The result of the operation.
+         */
+        Result attach(frame_bus& bus);
+
+        /**
+         * @brief Stops publishing, marks the segment closed and removes its name.
+         *
+         * Readers that still map the segment keep their mapping until they close it.
+         *
+         * @return Result The result of the operation.
+         */
+        Result close();
+
+        /**
+         * @brief Copies a frame into the next slot of its ring. Never waits for readers.
+         *
+         * @param device_id ID of the device that produced the frame.
+         * @param frame The frame.
+         * @param type The frame type.
+         * @param arrival_ns Host steady-clock arrival time of the frame.
+         * @return bool True if the frame was published, false if it was filtered or dropped.
+         */
+        bool publish(int device_id, const libfreenect2::Frame& frame, libfreenect2::Frame::Type type,
+                     std::int64_t arrival_ns);
+
+        /**
+         * @brief Copies a pooled frame into the next slot of its ring. Never waits for readers.
+         *
+         * @param device_id ID of the device that produced the frame.
+         * @param frame The pooled frame.
+         * @return bool True if the frame was published, false if it was filtered or dropped.
+         */
+        bool publish(int device_id, const frame_handle& frame);
+
+        /**
+         * @brief Gets the counters.
+         *
+         * @return publisher_statistics Snapshot of the counters.
+         */
+        [[nodiscard]] publisher_statistics getStatistics() const;
+
+        /**
+         * @brief Checks whether a segment is open.
+         *
+         * @return bool True between open() and close().
+         */
+        [[nodiscard]] bool isOpen() const
+        {
+            return segment != nullptr;
+        }
+    };
+}
+
+#endif //SHM_PUBLISHER_H
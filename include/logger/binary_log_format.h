@@ -0,0 +1,171 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef BINARY_LOG_FORMAT_H
+#define BINARY_LOG_FORMAT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace vision::binary_log
+{
+    /*
+     * A binary log is one memory-mapped file:
+     *
+     *   file_header    one page.
+     *   format table   format_table_size bytes of registered format strings, null-terminated,
+     *                  in format id order.
+     *   ring           capacity bytes of records, back to back and 8-byte aligned.
+     *
+     * Record positions are absolute byte counts since the log was opened; a record lives at
+     * position % capacity. A record never crosses a block_size boundary: a writer that would
+     * cross one pads the rest of the block with a padding record, or leaves it if less than a
+     * record header remains. record_header::position is stored last, so a reader tells a
+     * complete record from an unfinished or overwritten one by comparing it with the position
+     * it expects, and resynchronizes at the next block when they differ.
+     *
+     * Arguments follow the record header as a one-byte argument_type tag and a payload:
+     * eight bytes for numbers, a 16-bit length and the bytes for strings. All fields are
+     * little-endian, as produced by the x86 and ARM hosts we run on.
+     */
+
+    inline constexpr std::uint64_t magic = 0x31474f4c4e494246ull; ///< "FBINLOG1".
+    inline constexpr std::uint32_t version = 1; ///< Current format version.
+
+    inline constexpr std::size_t header_size = 4096; ///< Size of the file header page.
+    inline constexpr std::size_t format_table_size = 64u << 10; ///< Size of the format table.
+    inline constexpr std::size_t block_size = 64u << 10; ///< Records never cross a block boundary.
+    inline constexpr std::size_t record_alignment = 8; ///< Alignment of every record.
+    inline constexpr std::size_t max_string_size = 1024; ///< Longer string arguments are truncated.
+
+    inline constexpr std::uint16_t padding_format = 0xffff; ///< Format id of a padding record.
+    inline constexpr std::uint16_t invalid_format = 0xfffe; ///< Returned when no format id is left.
+
+    /**
+     * @struct file_header
+     * @brief First page of the file.
+     */
+    struct file_header
+    {
+        std::uint64_t magic = binary_log::magic; ///< magic.
+        std::uint32_t version = binary_log::version; ///< Format version.
+        std::uint32_t reserved = 0; ///< Zero.
+        std::uint64_t capacity = 0; ///< Ring size in bytes, a multiple of block_size.
+        std::uint64_t write_position = 0; ///< Position of the next record; updated atomically by writers.
+        std::uint32_t format_count = 0; ///< Number of registered format strings.
+        std::uint32_t format_table_used = 0; ///< Bytes used in the format table.
+    };
+
+    /**
+     * @struct record_header
+     * @brief Start of every record.
+     */
+    struct record_header
+    {
+        std::uint64_t position = 0; ///< Position of the record; stored last.
+        std::int64_t timestamp_ns = 0; ///< System clock time since the Unix epoch.
+        std::uint32_t size = 0; ///< Record size including this header and the padding.
+        std::uint32_t thread_id = 0; ///< Kernel id of the logging thread.
+        std::uint16_t format_id = 0; ///< Format string id, or padding_format.
+        std::uint8_t level = 0; ///< logger::Level.
+        std::uint8_t argument_count = 0; ///< Number of encoded arguments.
+        std::uint32_t reserved = 0; ///< Zero.
+    };
+
+    /**
+     * @enum argument_type
+     * @brief Tag of an encoded argument.
+     */
+    enum class argument_type : std::uint8_t
+    {
+        Signed = 1,   ///< std::int64_t.
+        Unsigned = 2, ///< std::uint64_t.
+        Float = 3,    ///< double.
+        String = 4,   ///< std::uint16_t length, then the bytes.
+    };
+
+    /**
+     * @brief True for argument types encoded as strings.
+     */
+    template<typename T>
+    inline constexpr bool is_string_argument = std::is_convertible_v<const T&, std::string_view>;
+
+    /**
+     * @brief Rounds a size up to a multiple of an alignment.
+     */
+    constexpr std::size_t alignUp(const std::size_t size, const std::size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Gets the encoded size of an argument.
+     *
+     * @param value Number, enum or string.
+     * @return std::size_t The size in bytes, including the tag.
+     */
+    template<typename T>
+    std::size_t encodedSize(const T& value)
+    {
+        if constexpr (is_string_argument<T>)
+            return 3 + std::min(std::string_view(value).size(), max_string_size);
+        else
+        {
+            static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>,
+                          "binary log arguments must be numbers, enums or strings");
+            return 9;
+        }
+    }
+
+    /**
+     * @brief Encodes an argument.
+     *
+     * @param out Destination; must have encodedSize(value) bytes.
+     * @param value Number, enum or string.
+     * @return unsigned char* The byte after the encoded argument.
+     */
+    template<typename T>
+    unsigned char* encode(unsigned char* out, const T& value)
+    {
+        if constexpr (is_string_argument<T>)
+        {
+            const std::string_view text(value);
+            const auto length = static_cast<std::uint16_t>(std::min(text.size(), max_string_size));
+            *out = static_cast<unsigned char>(argument_type::String);
+            std::memcpy(out + 1, &length, sizeof(length));
+            std::memcpy(out + 3, text.data(), length);
+            return out + 3 + length;
+        }
+        else if constexpr (std::is_enum_v<T>)
+            return encode(out, static_cast<std::underlying_type_t<T>>(value));
+        else
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                const auto number = static_cast<double>(value);
+                *out = static_cast<unsigned char>(argument_type::Float);
+                std::memcpy(out + 1, &number, sizeof(number));
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                const auto number = static_cast<std::int64_t>(value);
+                *out = static_cast<unsigned char>(argument_type::Signed);
+                std::memcpy(out + 1, &number, sizeof(number));
+            }
+            else
+            {
+                const auto number = static_cast<std::uint64_t>(value);
+                *out = static_cast<unsigned char>(argument_type::Unsigned);
+                std::memcpy(out + 1, &number, sizeof(number));
+            }
+            return out + 9;
+        }
+    }
+}
+
+#endif //BINARY_LOG_FORMAT_H
@@ -0,0 +1,99 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef BINARY_LOG_READER_H
+#define BINARY_LOG_READER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "logger.h"
+#include "debug/status.h"
+#include "logger/binary_log_format.h"
+
+namespace vision
+{
+    /**
+     * @struct binary_log_record
+     * @brief One decoded record of a binary log.
+     */
+    struct binary_log_record
+    {
+        std::uint64_t position = 0; ///< Position of the record in the log.
+        std::int64_t timestamp_ns = 0; ///< System clock time since the Unix epoch.
+        std::uint32_t thread_id = 0; ///< Kernel id of the logging thread.
+        logger::Level level = logger::None; ///< Level of the record.
+        std::uint16_t format_id = 0; ///< Format string id.
+        std::string text; ///< Rendered message.
+    };
+
+    /**
+     * @class binary_log_reader
+     * @brief Decodes a file written by binary_logger.
+     *
+     * The file is mapped read-only. Records that were overwritten by the ring or were
+     * still being written when the file was read are skipped.
+     */
+    class binary_log_reader {
+    private:
+        unsigned char* mapping = nullptr; ///< Mapped file.
+        std::size_t mapping_size = 0; ///< Size of the mapping.
+        binary_log::file_header header; ///< Copy of the file header.
+        std::vector<std::string> formats; ///< Format strings by id.
+
+        /**
+         * @brief Renders a record's arguments with its format string.
+         *
+         * @param format The format string.
+         * @param arguments First encoded argument.
+         * @param end End of the record.
+         * @param count Number of encoded arguments.
+         * @return std::string The message; missing or malformed arguments render as "{?}".
+         */
+        static std::string render(std::string_view format, const unsigned char* arguments,
+                                  const unsigned char* end, std::size_t count);
+
+    public:
+        binary_log_reader() = default;
+
+        /// Unmaps the file.
+        ~binary_log_reader();
+
+        binary_log_reader(const binary_log_reader&) = delete;
+        binary_log_reader& operator=(const binary_log_reader&) = delete;
+
+        /**
+         * @brief Maps a binary log and reads its format table.
+         *
+         * @param path File path.
+         * @return Result The result of the operation.
+         */
+        Result open(const std::string& path);
+
+        /**
+         * @brief Unmaps the file.
+         */
+        void close();
+
+        /**
+         * @brief Decodes every record still in the ring.
+         *
+         * @return std::vector<binary_log_record> The records, oldest first.
+         */
+        [[nodiscard]] std::vector<binary_log_record> read() const;
+
+        /**
+         * @brief Gets the registered format strings.
+         *
+         * @return const std::vector<std::string>& The format strings, indexed by id.
+         */
+        [[nodiscard]] const std::vector<std::string>& getFormats() const
+        {
+            return formats;
+        }
+    };
+}
+
+#endif //BINARY_LOG_READER_H
@@ -0,0 +1,186 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef BINARY_LOGGER_H
+#define BINARY_LOGGER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "logger.h"
+#include "debug/status.h"
+#include "logger/binary_log_format.h"
+
+namespace vision
+{
+    /**
+     * @class binary_logger
+     * @brief Logger that writes compact binary records to a memory-mapped ring file.
+     *
+     * Meant for high-rate telemetry such as per-frame events. A call stores a timestamp,
+     * the level, the thread id, the id of a registered format string and the raw arguments;
+     * nothing is formatted. binary_log_reader, or the binary_log_decode tool, renders the
+     * text offline. Writers reserve space with one CAS on the shared write position and
+     * write straight into the mapping; the oldest records are overwritten once the ring
+     * is full.
+     *
+     * Usage:
+     * @code
+     * static const std::uint16_t frame_received = telemetry.registerFormat("device {} received frame {}");
+     * telemetry.event<logger::Debug>(frame_received, device_id, frame->sequence);
+     * @endcode
+     *
+     * open() and close() must not race with logging calls.
+     */
+    class binary_logger : public logger {
+    private:
+        unsigned char* mapping = nullptr; ///< Mapped file.
+        std::size_t mapping_size = 0; ///< Size of the mapping.
+        binary_log::file_header* header = nullptr; ///< File header in the mapping.
+        unsigned char* ring = nullptr; ///< First byte of the ring.
+        std::uint64_t capacity = 0; ///< Ring size in bytes.
+
+        std::mutex format_mutex; ///< Guards format registration.
+        std::unordered_map<std::string, std::uint16_t> format_ids; ///< Registered format strings.
+        std::uint16_t text_format = binary_log::invalid_format; ///< Format id of "{}", used by log().
+
+        /**
+         * @brief Reserves space for a record, padding to the next block if it would cross one.
+         *
+         * @param size Record size, a multiple of binary_log::record_alignment.
+         * @param position Receives the position of the record.
+         * @return unsigned char* The record's place in the ring, or nullptr if the record is larger than a block.
+         */
+        unsigned char* reserve(std::size_t size, std::uint64_t& position);
+
+        /**
+         * @brief Publishes a written record by storing its position.
+         */
+        static void commit(unsigned char* record, std::uint64_t position);
+
+        /**
+         * @brief Gets the kernel id of the calling thread.
+         */
+        static std::uint32_t threadId();
+
+        /**
+         * @brief Writes one record.
+         */
+        template<typename... Args>
+        void write(const Level level, const std::uint16_t format_id, const Args&... args)
+        {
+            if(level > level_ || mapping == nullptr || format_id >= binary_log::invalid_format)
+                return;
+
+            const std::size_t size = binary_log::alignUp(
+                    sizeof(binary_log::record_header) + (std::size_t{0} + ... + binary_log::encodedSize(args)),
+                    binary_log::record_alignment);
+            std::uint64_t position;
+            unsigned char* record = reserve(size, position);
+            if(record == nullptr)
+                return;
+
+            binary_log::record_header _header;
+            _header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+            _header.size = static_cast<std::uint32_t>(size);
+            _header.thread_id = threadId();
+            _header.format_id = format_id;
+            _header.level = static_cast<std::uint8_t>(level);
+            _header.argument_count = static_cast<std::uint8_t>(sizeof...(Args));
+            std::memcpy(record, &_header, sizeof(_header));
+
+            [[maybe_unused]] unsigned char* out = record + sizeof(_header);
+            ((out = binary_log::encode(out, args)), ...);
+            commit(record, position);
+        }
+
+    public:
+        binary_logger();
+
+        /// Unmaps the file.
+        ~binary_logger() override;
+
+        binary_logger(const binary_logger&) = delete;
+        binary_logger& operator=(const binary_logger&) = delete;
+
+        /**
+         * @brief Creates or truncates a log file and maps it.
+         *
+         * @param path File path.
+         * @param ring_capacity Ring size in bytes, rounded up to a multiple of binary_log::block_size.
+         * @return Result The result of the operation.
+         */
+        Result open(const std::string& path, std::size_t ring_capacity = 64u << 20);
+
+        /**
+         * @brief Unmaps the file. Records already written stay in it.
+         */
+        void close();
+
+        /**
+         * @brief Registers a format string, or finds it if it was registered before.
+         *
+         * The string uses std::format syntax; each replacement field takes one argument.
+         *
+         * @param format The format string.
+         * @return std::uint16_t The format id, or binary_log::invalid_format if the format table is full.
+         */
+        std::uint16_t registerFormat(std::string_view format);
+
+        /**
+         * @brief Logs an event with a registered format and its raw arguments.
+         *
+         * Writes nothing if the level is above min_level; the caller has evaluated the arguments already.
+         *
+         * @tparam level The logging level of the event.
+         * @param format_id Id returned by registerFormat().
+         * @param args Numbers, enums or strings; strings are copied.
+         */
+        template<Level level, typename... Args>
+        void event(const std::uint16_t format_id, const Args&... args)
+        {
+            if constexpr (level <= min_level)
+                write(level, format_id, args...);
+        }
+
+        /**
+         * @brief Log a message with a specific logging level.
+         *
+         * The message is stored as the single argument of a "{}" format.
+         *
+         * @param level The logging level of the message.
+         * @param message The message to log.
+         */
+        void log(Level level, const std::string& message) override;
+
+        /**
+         * @brief Schedules the written records for writeback without waiting.
+         */
+        void flush();
+
+        /**
+         * @brief Checks if a file is mapped.
+         *
+         * @return bool True if events are written.
+         */
+        [[nodiscard]] bool isOpen() const
+        {
+            return mapping != nullptr;
+        }
+
+        /**
+         * @brief Gets the position of the next record.
+         *
+         * @return std::uint64_t Bytes reserved since the file was opened, padding included.
+         */
+        [[nodiscard]] std::uint64_t getWritePosition() const;
+    };
+}
+
+#endif //BINARY_LOGGER_H
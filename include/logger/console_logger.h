@@ -5,19 +5,86 @@
 #ifndef CONSOLE_LOGGER_H
 #define CONSOLE_LOGGER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
 #include "logger.h"
 
 namespace vision
 {
+    /**
+     * @enum log_overflow
+     * @brief What an asynchronous log call does when its thread's ring is full.
+     */
+    enum class log_overflow
+    {
+        Drop,  ///< Discard the record and count it; the caller never waits.
+        Block, ///< Wait for the sink thread to make room.
+    };
+
+    /**
+     * @struct async_log_config
+     * @brief Settings of the asynchronous logging mode.
+     */
+    struct async_log_config
+    {
+        std::size_t ring_capacity = 1024; ///< Records per logging thread, rounded up to a power of two.
+        log_overflow overflow = log_overflow::Drop; ///< Policy for a full ring.
+        std::chrono::milliseconds flush_interval{20}; ///< Longest time a record waits for the sink thread.
+    };
+
     /**
      * @class ConsoleLogger
      * @brief Logger implementation that outputs messages to the console.
      *
      * This class derives from the Logger base class and implements
      * the log function to print messages to the standard output.
+     *
+     * In asynchronous mode a log call only copies the message into a fixed-size record
+     * in a ring owned by the calling thread. A sink thread merges the rings in time order,
+     * formats the records and writes them in batches, so logging threads never share a
+     * lock or wait on the stream. Memory is bounded by ring_capacity records per thread.
      */
     class ConsoleLogger : public logger {
+    public:
+        static constexpr std::size_t record_text_size = 240; ///< Longer messages are truncated in asynchronous mode.
+
     private:
+        /**
+         * @struct log_record
+         * @brief One queued message.
+         */
+        struct log_record
+        {
+            std::int64_t time_ns; ///< Steady clock time of the call, for merging the rings.
+            Level level; ///< Message level.
+            std::uint32_t length; ///< Length of the original message.
+            char text[record_text_size]; ///< Message text, not null-terminated.
+        };
+
+        /**
+         * @struct log_ring
+         * @brief Single-producer/single-consumer ring of records owned by one logging thread.
+         */
+        struct log_ring
+        {
+            alignas(64) std::atomic<std::uint64_t> head{0}; ///< Next write position, owned by the producer.
+            std::atomic<bool> writing{false}; ///< Set while the producer is inside log().
+            std::atomic<bool> retired{false}; ///< Set when the producing thread has exited.
+            alignas(64) std::atomic<std::uint64_t> tail{0}; ///< Next read position, owned by the sink thread.
+            std::vector<log_record> records; ///< Ring storage.
+            std::uint64_t mask; ///< Slot index mask.
+
+            explicit log_ring(std::size_t capacity);
+        };
+
         /**
          * @brief Private constructor for singleton implementation.
          */
@@ -28,6 +95,59 @@ namespace vision
          */
         static ConsoleLogger *instance;
 
+        std::mutex output_mutex; ///< Serializes writes to the stream.
+        std::ostream* stream; ///< Output stream, std::cout by default.
+
+        std::mutex async_mutex; ///< Serializes startAsync() and stopAsync().
+        std::atomic<bool> async_enabled{false}; ///< True while log() queues records.
+        std::atomic<std::uint64_t> async_epoch{0}; ///< Incremented on every start; stale thread rings are replaced.
+        async_log_config config; ///< Settings of the running asynchronous mode.
+        std::atomic<std::uint64_t> dropped{0}; ///< Records discarded by the Drop policy.
+        std::uint64_t reported_dropped = 0; ///< Dropped count already reported by the sink thread.
+
+        std::mutex rings_mutex; ///< Guards rings.
+        std::vector<std::shared_ptr<log_ring>> rings; ///< Rings of all threads that logged asynchronously.
+
+        std::mutex wake_mutex; ///< Guards the sink thread's wake-up state.
+        std::condition_variable wake; ///< Wakes the sink thread early.
+        std::condition_variable flushed; ///< Signals a completed flush.
+        bool wake_requested = false; ///< The sink thread should drain now.
+        bool stopping = false; ///< The sink thread should drain and exit.
+        std::uint64_t flush_requested = 0; ///< Latest flush ticket.
+        std::uint64_t flush_completed = 0; ///< Latest ticket drained and written.
+        std::thread sink; ///< Formats and writes queued records.
+        std::string batch; ///< Sink thread output buffer.
+
+        /**
+         * @brief Gets the calling thread's ring for an epoch, creating and registering it on first use.
+         *
+         * @param epoch The asynchronous mode epoch.
+         * @return log_ring& The ring.
+         */
+        log_ring& localRing(std::uint64_t epoch);
+
+        /**
+         * @brief Writes one message synchronously.
+         */
+        void write(Level level, const std::string& message);
+
+        /**
+         * @brief Wakes the sink thread.
+         */
+        void requestDrain();
+
+        /**
+         * @brief Sink thread body.
+         */
+        void runSink();
+
+        /**
+         * @brief Merges all queued records in time order and writes them in one batch.
+         *
+         * @return bool True if anything was written.
+         */
+        bool drain();
+
     public:
         /**
          * @brief Get the singleton instance of the ConsoleLogger.
@@ -44,11 +164,53 @@ namespace vision
 
         /**
          * @brief Log a message with a specific logging level.
+         *
+         * Writes and flushes the message on the calling thread, or only queues it in
+         * asynchronous mode.
+         *
          * @param level The logging level of the message.
          * @param message The message to log.
          */
         void log(Level level, const std::string& message) override;
 
+        /**
+         * @brief Sets the output stream. The stream must outlive its use by the logger.
+         * @param output The stream to write to.
+         */
+        void setStream(std::ostream& output);
+
+        /**
+         * @brief Switches to asynchronous mode and starts the sink thread.
+         *
+         * Queued records are written at exit if stopAsync() was not called.
+         *
+         * @param async_config Asynchronous mode settings.
+         * @return bool False if asynchronous mode is already running.
+         */
+        bool startAsync(const async_log_config& async_config = {});
+
+        /**
+         * @brief Writes all queued records, stops the sink thread and returns to synchronous mode.
+         */
+        void stopAsync();
+
+        /**
+         * @brief Blocks until every record queued before the call has been written and the stream flushed.
+         */
+        void flush();
+
+        /**
+         * @brief Checks if asynchronous mode is running.
+         * @return bool True if log() queues records.
+         */
+        [[nodiscard]] bool isAsync() const;
+
+        /**
+         * @brief Gets the number of records discarded because a ring was full.
+         * @return std::uint64_t The dropped record count.
+         */
+        [[nodiscard]] std::uint64_t getDroppedCount() const;
+
         /**
          * @brief Deleted copy constructor to prevent copying.
          */
@@ -5,7 +5,10 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <format>
 #include <string>
+#include <utility>
+#include "config/config.h"
 
 namespace vision
 {
@@ -16,6 +19,11 @@ namespace vision
      * This class provides an interface for logging messages at various
      * levels of severity. Derived classes should implement the log
      * method to handle logging functionality.
+     *
+     * The error(), warning(), info() and debug() front-ends take a format string and
+     * its arguments and only format the message if the level is enabled. For levels above
+     * LOG_MIN_LEVEL the formatting and the call to log() are compiled out, but the arguments
+     * are still evaluated at the call site; guard an expensive argument with isEnabled().
      */
     class logger {
     private:
@@ -36,6 +44,8 @@ namespace vision
             Debug = 4,    ///< Debug messages.
         };
 
+        static constexpr Level min_level = static_cast<Level>(LOG_MIN_LEVEL); ///< Most verbose level compiled in.
+
         /**
          * @brief Default destructor.
          */
@@ -73,8 +83,81 @@ namespace vision
          */
         Level getLevel() const;
 
+        /**
+         * @brief Check whether messages of a level are logged.
+         * @param level The logging level to check.
+         * @return True if the level is compiled in and not above the current logging level.
+         */
+        [[nodiscard]] bool isEnabled(const Level level) const
+        {
+            return level <= min_level && level <= level_;
+        }
+
+        /**
+         * @brief Format and log a message if its level is enabled.
+         *
+         * Formats nothing if the level is above min_level; the caller has evaluated the arguments already.
+         *
+         * @tparam level The logging level of the message.
+         * @param format The format string.
+         * @param args The format arguments.
+         */
+        template<Level level, typename... Args>
+        void logFormat(std::format_string<Args...> format, Args&&... args)
+        {
+            if constexpr (level <= min_level)
+            {
+                if(level <= level_)
+                    log(level, std::format(format, std::forward<Args>(args)...));
+            }
+        }
+
+        /**
+         * @brief Format and log an error message.
+         * @param format The format string.
+         * @param args The format arguments.
+         */
+        template<typename... Args>
+        void error(std::format_string<Args...> format, Args&&... args)
+        {
+            logFormat<Error>(format, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Format and log a warning message.
+         * @param format The format string.
+         * @param args The format arguments.
+         */
+        template<typename... Args>
+        void warning(std::format_string<Args...> format, Args&&... args)
+        {
+            logFormat<Warning>(format, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Format and log an informational message.
+         * @param format The format string.
+         * @param args The format arguments.
+         */
+        template<typename... Args>
+        void info(std::format_string<Args...> format, Args&&... args)
+        {
+            logFormat<Info>(format, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Format and log a debug message.
+         * @param format The format string.
+         * @param args The format arguments.
+         */
+        template<typename... Args>
+        void debug(std::format_string<Args...> format, Args&&... args)
+        {
+            logFormat<Debug>(format, std::forward<Args>(args)...);
+        }
+
     protected:
-        Level level_; ///< Current logging level.
+        Level level_ = getDefaultLevel(); ///< Current logging level.
     };
 }
 
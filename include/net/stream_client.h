@@ -0,0 +1,96 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef STREAM_CLIENT_H
+#define STREAM_CLIENT_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "debug/status.h"
+#include "net/stream_protocol.h"
+
+namespace vision
+{
+    /**
+     * @struct received_frame
+     * @brief A frame received from a stream_server.
+     */
+    struct received_frame
+    {
+        stream::frame_header header; ///< Metadata of the frame.
+        std::vector<unsigned char> payload; ///< Payload; its capacity is reused between frames.
+    };
+
+    /**
+     * @class stream_client
+     * @brief Blocking client of stream_server, see stream_protocol.h.
+     *
+     * A client belongs to one thread.
+     */
+    class stream_client {
+    private:
+        int fd = -1; ///< Connected socket.
+
+        /**
+         * @brief Reads exactly size bytes, waiting until the deadline.
+         */
+        Result readExact(void* data, std::size_t size, std::chrono::steady_clock::time_point deadline) const;
+
+    public:
+        stream_client() = default;
+
+        /// Closes the connection.
+        ~stream_client();
+
+        stream_client(const stream_client&) = delete;
+        stream_client& operator=(const stream_client&) = delete;
+
+        /**
+         * @brief Connects to a server.
+         *
+         * @param address IPv4 address of the server.
+         * @param port TCP port of the server.
+         * @return Result The result of the operation.
+         */
+        Result connect(const std::string& address, std::uint16_t port);
+
+        /**
+         * @brief Sets the streams to receive; nothing is sent before the first subscription.
+         *
+         * @param streams Mask of libfreenect2::Frame::Type values and stream::cloud_type.
+         * @param max_fps Frames per second per device and stream; 0 receives every frame.
+         * @param device_id Device to receive; -1 receives every device.
+         * @return Result The result of the operation.
+         */
+        Result subscribe(std::uint32_t streams, std::uint32_t max_fps = 0, std::int32_t device_id = -1);
+
+        /**
+         * @brief Receives the next frame.
+         *
+         * @param frame Receives the header and the payload.
+         * @param timeout Longest wait for the whole frame.
+         * @return Result Timeout if no full frame arrived in time, Error if the connection failed.
+         */
+        Result receive(received_frame& frame, std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+        /**
+         * @brief Closes the connection.
+         */
+        void close();
+
+        /**
+         * @brief Checks whether the client is connected.
+         *
+         * @return bool True between connect() and close() or a connection failure.
+         */
+        [[nodiscard]] bool isConnected() const
+        {
+            return fd >= 0;
+        }
+    };
+}
+
+#endif //STREAM_CLIENT_H
@@ -0,0 +1,82 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef STREAM_PROTOCOL_H
+#define STREAM_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "device/depth_codec.h"
+
+namespace vision::stream
+{
+    /*
+     * A stream connection is one TCP connection:
+     *
+     *   client -> server  subscribe_message, again at any time to change the subscription.
+     *   server -> client  frame_header followed by payload_size payload bytes, repeated.
+     *
+     * Frame payloads are the pixels of the frame as captured. A compressed depth frame
+     * is a depth_codec frame with format compressed_depth_format. A point cloud has
+     * type cloud_type, format Float and bytes_per_pixel 12 or 16: its payload is the x,
+     * y and z planes of the point_cloud, then the rgb plane if the cloud has color.
+     *
+     * All fields are little-endian, as produced by the x86 and ARM hosts we run on.
+     */
+
+    inline constexpr std::uint32_t subscribe_magic = 0x42555346u; ///< "FSUB".
+    inline constexpr std::uint32_t frame_magic = 0x4d524646u; ///< "FFRM".
+    inline constexpr std::uint16_t version = 1; ///< Current protocol version.
+
+    inline constexpr std::uint32_t cloud_type = 8; ///< frame_header::type of a point cloud, beside the libfreenect2 types.
+    inline constexpr std::uint32_t compressed_depth_format = depth_codec_header::codec_magic; ///< Format of a depth_codec payload.
+
+    /**
+     * @struct subscribe_message
+     * @brief Streams a client wants and how fast.
+     */
+    struct subscribe_message
+    {
+        std::uint32_t magic = subscribe_magic; ///< subscribe_magic.
+        std::uint16_t version = stream::version; ///< Protocol version.
+        std::uint16_t reserved = 0; ///< Zero.
+        std::uint32_t streams = 0; ///< Mask of libfreenect2::Frame::Type values and cloud_type.
+        std::uint32_t max_fps = 0; ///< Frames per second per device and stream; 0 sends every frame.
+        std::int32_t device_id = -1; ///< Device to stream; -1 streams every device.
+        std::uint32_t reserved2 = 0; ///< Zero.
+    };
+
+    /**
+     * @struct frame_header
+     * @brief Metadata of one frame sent to a client.
+     */
+    struct frame_header
+    {
+        std::uint32_t magic = frame_magic; ///< frame_magic.
+        std::uint16_t version = stream::version; ///< Protocol version.
+        std::uint16_t header_size = 88; ///< sizeof(frame_header).
+        std::uint64_t payload_size = 0; ///< Bytes following the header.
+        std::int64_t arrival_ns = 0; ///< Host steady-clock arrival time of the frame.
+        std::int64_t queued_ns = 0; ///< Host steady-clock time the frame was queued for sending.
+        std::int32_t device_id = -1; ///< ID of the device that produced the frame.
+        std::uint32_t type = 0; ///< libfreenect2::Frame::Type, or cloud_type.
+        std::uint32_t format = 0; ///< libfreenect2::Frame::Format, or compressed_depth_format.
+        std::uint32_t timestamp = 0; ///< Device timestamp in 0.125 ms ticks.
+        std::uint32_t sequence = 0; ///< Device sequence number.
+        std::uint32_t status = 0; ///< libfreenect2 frame status.
+        std::uint32_t width = 0; ///< Frame width.
+        std::uint32_t height = 0; ///< Frame height.
+        std::uint32_t bytes_per_pixel = 0; ///< Bytes per pixel, of the decoded frame for compressed payloads.
+        float exposure = 0.0f; ///< Color exposure.
+        float gain = 0.0f; ///< Color gain.
+        float gamma = 0.0f; ///< Color gamma.
+        std::uint32_t dropped = 0; ///< Frames dropped for this client since the previous header.
+        std::uint32_t reserved = 0; ///< Zero.
+    };
+
+    static_assert(sizeof(subscribe_message) == 24, "subscribe_message is part of the protocol");
+    static_assert(sizeof(frame_header) == 88, "frame_header is part of the protocol");
+}
+
+#endif //STREAM_PROTOCOL_H
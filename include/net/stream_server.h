@@ -0,0 +1,308 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef STREAM_SERVER_H
+#define STREAM_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "debug/status.h"
+#include "device/depth_codec.h"
+#include "device/frame_bus.h"
+#include "device/frame_pool.h"
+#include "geometry/point_cloud_builder.h"
+#include "net/stream_protocol.h"
+
+namespace vision
+{
+    /**
+     * @struct stream_server_config
+     * @brief Settings of the streaming server.
+     */
+    struct stream_server_config
+    {
+        std::string address = "127.0.0.1"; ///< IPv4 address to listen on; streams are unauthenticated, so serving other hosts ("0.0.0.0") is opt-in.
+        std::uint16_t port = 0; ///< TCP port; 0 picks a free one, see stream_server::getPort().
+        std::size_t max_clients = 16; ///< Connections beyond this are closed right away.
+        std::size_t bus_queue_depth = 4; ///< Frames waiting for the publishing thread when attached to a bus; the oldest is dropped beyond this.
+        std::size_t max_queued_frames = 2; ///< Frames waiting per client; the oldest is dropped beyond this.
+        std::size_t max_batch = 16; ///< Most frames gathered into one sendmsg call.
+        std::size_t max_pinned_frames = 2; ///< Pooled frames held per device and frame type; later frames are copied.
+        bool zerocopy = true; ///< Send large payloads with MSG_ZEROCOPY where the kernel supports it; loopback copies anyway.
+        std::size_t zerocopy_threshold = 64u << 10; ///< Smallest payload sent with MSG_ZEROCOPY.
+        bool compress_depth = false; ///< Send Float depth frames as depth_codec frames.
+        depth_codec_config depth_codec; ///< Codec of compress_depth; more threads code the bands of a frame in parallel.
+        std::size_t socket_buffer = 4u << 20; ///< SO_SNDBUF of client sockets; 0 keeps the system default.
+    };
+
+    /**
+     * @struct stream_server_statistics
+     * @brief Counters of the streaming server.
+     */
+    struct stream_server_statistics
+    {
+        std::uint64_t clients = 0; ///< Connected clients.
+        std::uint64_t frames_sent = 0; ///< Frames fully sent, counted per client.
+        std::uint64_t bytes_sent = 0; ///< Header and payload bytes sent.
+        std::uint64_t dropped = 0; ///< Frames dropped because a client or the publishing thread fell behind.
+        std::uint64_t copied = 0; ///< Pooled frames copied because max_pinned_frames were already held.
+        std::uint64_t send_calls = 0; ///< sendmsg calls.
+        std::uint64_t zerocopy_calls = 0; ///< sendmsg calls made with MSG_ZEROCOPY.
+    };
+
+    /**
+     * @class stream_server
+     * @brief Streams frames and point clouds to TCP clients, see stream_protocol.h.
+     *
+     * Attached to a frame_bus, capture threads only queue references to their pooled
+     * frames; a publishing thread compresses them if asked and queues them for the
+     * subscribed clients. One event-loop thread serves every client with epoll and
+     * sends each batch of queued frames with a single sendmsg, gathering the small
+     * headers and the frame buffers themselves.
+     * Large payloads go out with MSG_ZEROCOPY, and their frames stay referenced until
+     * the kernel reports the send complete.
+     *
+     * Every client has its own short queue. A client that cannot keep up loses its
+     * oldest queued frames, and a client asking for a frame rate gets frames no faster,
+     * so no client ever holds back another one or the capture threads.
+     *
+     * A frame queued for several clients holds its pool buffer once, until the last
+     * client has sent it. Clients that stop reading would otherwise keep buffers from
+     * capture, so the server holds at most max_pinned_frames pooled frames per device
+     * and frame type and sends later frames from copies until some are released. The
+     * capture pools therefore need max_pinned_frames spare buffers per frame type,
+     * plus the bus_queue_depth frames waiting for the publishing thread, however many
+     * clients are connected.
+     */
+    class stream_server {
+    private:
+        /**
+         * @struct pinned_frame
+         * @brief A pooled frame held by the server, counted against max_pinned_frames.
+         */
+        struct pinned_frame
+        {
+            frame_handle frame; ///< The pooled frame.
+            std::shared_ptr<std::atomic<std::size_t>> pins; ///< Pooled frames held for the frame's device and type.
+
+            pinned_frame(frame_handle frame, std::shared_ptr<std::atomic<std::size_t>> pins)
+                : frame(std::move(frame)),
+                  pins(std::move(pins))
+            {
+            }
+
+            ~pinned_frame()
+            {
+                pins->fetch_sub(1, std::memory_order_release);
+            }
+        };
+
+        /**
+         * @struct message
+         * @brief A frame queued for one client.
+         *
+         * Messages are held by pointer, so the header a MSG_ZEROCOPY send points at stays
+         * where it is until the kernel reports the send complete.
+         */
+        struct message
+        {
+            stream::frame_header header; ///< Header sent before the payload.
+            std::shared_ptr<const pinned_frame> frame; ///< Pooled frame holding the payload, if it is one.
+            std::shared_ptr<const std::vector<unsigned char>> buffer; ///< Buffer holding the payload otherwise.
+            const unsigned char* payload = nullptr; ///< First payload byte.
+            std::size_t sent = 0; ///< Bytes of header and payload already sent.
+            std::uint32_t zerocopy_id = 0; ///< Last MSG_ZEROCOPY send that included the message.
+            bool zerocopy = false; ///< True if zerocopy_id is set.
+        };
+
+        /**
+         * @struct client
+         * @brief State of one connection.
+         */
+        struct client
+        {
+            int fd = -1; ///< Socket.
+            std::mutex mutex; ///< Guards the subscription and queued.
+            stream::subscribe_message subscription; ///< Current subscription; streams is 0 until one arrives.
+            std::map<std::pair<int, std::uint32_t>, std::int64_t> last_queued; ///< Last queue time per device and stream.
+            std::deque<std::unique_ptr<message>> queued; ///< Frames waiting to be sent.
+            std::uint32_t dropped = 0; ///< Drops not yet reported to the client.
+
+            // Event-loop thread only.
+            std::deque<std::unique_ptr<message>> sending; ///< Batch being sent.
+            std::deque<std::unique_ptr<message>> completing; ///< Sent with MSG_ZEROCOPY, waiting for the kernel.
+            std::uint32_t next_zerocopy_id = 0; ///< ID of the next MSG_ZEROCOPY send.
+            std::uint32_t completed_zerocopy_id = 0; ///< Every MSG_ZEROCOPY send below this ID has completed.
+            bool zerocopy = false; ///< SO_ZEROCOPY is enabled on the socket.
+            bool writable = true; ///< The socket accepted the last write in full.
+            unsigned char request[sizeof(stream::subscribe_message)] = {}; ///< Partly received subscribe_message.
+            std::size_t request_size = 0; ///< Bytes of the request received.
+        };
+
+        stream_server_config config; ///< Server settings.
+        int listen_fd = -1; ///< Listening socket.
+        int epoll_fd = -1; ///< Event loop.
+        int wake_fd = -1; ///< eventfd waking the loop for new frames and for stop().
+        std::uint16_t port = 0; ///< Port being listened on.
+        std::thread loop; ///< Event-loop thread.
+        std::atomic<bool> stopping{false}; ///< Tells the loop to exit.
+        frame_bus* bus = nullptr; ///< Bus the server is subscribed to.
+        std::shared_ptr<frame_bus::subscription> subscriber; ///< Queue of frames to publish.
+        std::thread publisher_thread; ///< Publishes the queued frames.
+
+        mutable std::shared_mutex clients_mutex; ///< Guards clients; the loop thread alone adds and removes.
+        std::map<int, std::unique_ptr<client>> clients; ///< Connected clients, keyed by socket.
+
+        std::mutex codec_mutex; ///< Guards codec.
+        std::unique_ptr<depth_codec> codec; ///< Encodes depth frames, or nullptr without compress_depth.
+
+        std::mutex pins_mutex; ///< Guards pins.
+        std::map<std::pair<int, std::uint32_t>, std::shared_ptr<std::atomic<std::size_t>>> pins; ///< Held pooled frames per device and type.
+
+        std::atomic<std::uint64_t> frames_sent{0}; ///< See stream_server_statistics.
+        std::atomic<std::uint64_t> bytes_sent{0}; ///< See stream_server_statistics.
+        std::atomic<std::uint64_t> dropped{0}; ///< See stream_server_statistics.
+        std::atomic<std::uint64_t> copied{0}; ///< See stream_server_statistics.
+        std::atomic<std::uint64_t> send_calls{0}; ///< See stream_server_statistics.
+        std::atomic<std::uint64_t> zerocopy_calls{0}; ///< See stream_server_statistics.
+
+        /**
+         * @brief Event-loop thread body.
+         */
+        void run();
+
+        /**
+         * @brief Publishing thread body; returns once the subscription is closed and drained.
+         */
+        void publishQueued();
+
+        /**
+         * @brief Accepts pending connections.
+         */
+        void acceptClients();
+
+        /**
+         * @brief Reads subscription messages; returns false if the client disconnected or misbehaved.
+         */
+        bool readClient(client& _client);
+
+        /**
+         * @brief Sends queued frames until the socket is full; returns false on a socket error.
+         */
+        bool flushClient(client& _client);
+
+        /**
+         * @brief Releases the frames of completed MSG_ZEROCOPY sends.
+         */
+        void reapZerocopy(client& _client);
+
+        /**
+         * @brief Closes a client and releases its frames.
+         */
+        void removeClient(int fd);
+
+        /**
+         * @brief Queues a message for every client subscribed to it and wakes the loop.
+         */
+        bool enqueue(const message& _message);
+
+        /**
+         * @brief Wakes the event loop.
+         */
+        void wake() const;
+
+    public:
+        /**
+         * @brief Constructs a server.
+         *
+         * @param config Server settings.
+         */
+        explicit stream_server(const stream_server_config& config = {});
+
+        /// Stops the server.
+        ~stream_server();
+
+        stream_server(const stream_server&) = delete;
+        stream_server& operator=(const stream_server&) = delete;
+
+        /**
+         * @brief Starts listening and the event-loop thread.
+         *
+         * @return Result The result of the operation.
+         */
+        Result start();
+
+        /**
+         * @brief Streams the frames of a bus from a publishing thread until stop().
+         *
+         * @param bus The bus to subscribe to; must outlive the attachment.
+         * @return Result The result of the operation.
+         */
+        Result attach(frame_bus& bus);
+
+        /**
+         * @brief Disconnects every client and stops the event-loop thread.
+         *
+         * @return Result The result of the operation.
+         */
+        Result stop();
+
+        /**
+         * @brief Queues a pooled frame for the subscribed clients, without copying it while few are held.
+         *
+         * @param device_id ID of the device that produced the frame.
+         * @param frame The pooled frame.
+         * @return bool True if at least one client will be sent the frame.
+         */
+        bool publish(int device_id, const frame_handle& frame);
+
+        /**
+         * @brief Queues a point cloud for the subscribed clients, copying it once for all of them.
+         *
+         * @param device_id ID of the device the cloud was built from.
+         * @param cloud The cloud.
+         * @param sequence Sequence number of the depth frame the cloud was built from.
+         * @param arrival_ns Host steady-clock arrival time of that depth frame.
+         * @return bool True if at least one client will be sent the cloud.
+         */
+        bool publishCloud(int device_id, const point_cloud& cloud, std::uint32_t sequence, std::int64_t arrival_ns);
+
+        /**
+         * @brief Gets the port the server listens on.
+         *
+         * @return std::uint16_t The port, or 0 if the server is not running.
+         */
+        [[nodiscard]] std::uint16_t getPort() const
+        {
+            return port;
+        }
+
+        /**
+         * @brief Gets the counters.
+         *
+         * @return stream_server_statistics Snapshot of the counters.
+         */
+        [[nodiscard]] stream_server_statistics getStatistics() const;
+
+        /**
+         * @brief Checks whether the server is running.
+         *
+         * @return bool True between start() and stop().
+         */
+        [[nodiscard]] bool isRunning() const
+        {
+            return loop.joinable();
+        }
+    };
+}
+
+#endif //STREAM_SERVER_H
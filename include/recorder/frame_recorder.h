@@ -0,0 +1,222 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "libfreenect2/frame_listener.hpp"
+#include "debug/status.h"
+#include "device/depth_codec.h"
+#include "device/frame_pool.h"
+#include "device/frame_scheduler.h"
+#include "recorder/recording_format.h"
+
+namespace vision
+{
+    /**
+     * @struct recorder_config
+     * @brief Settings of the frame recorder.
+     */
+    struct recorder_config
+    {
+        std::size_t chunk_size = 16u << 20; ///< Bytes per staging chunk and per write; a multiple of the page size.
+        std::size_t chunk_count = 16; ///< Staging chunks; bounds the memory and the write backlog.
+        std::size_t max_chunk_frames = 1024; ///< Frames per chunk before it is sealed.
+        bool direct_io = true; ///< Bypass the page cache with O_DIRECT where the file system supports it.
+        std::chrono::milliseconds flush_interval{500}; ///< A partly filled chunk is written after this long.
+        unsigned frame_types = libfreenect2::Frame::Color | libfreenect2::Frame::Depth; ///< Recorded frame types.
+        std::vector<int> device_ids; ///< Recorded devices; empty records every device.
+        bool compress_depth = false; ///< Store Float depth frames losslessly compressed to millimeters, see depth_codec.
+        depth_codec_config depth_codec; ///< Codec of the writer thread; more threads code the bands of a frame in parallel.
+    };
+
+    /**
+     * @struct recorder_statistics
+     * @brief Counters of the frame recorder.
+     */
+    struct recorder_statistics
+    {
+        std::uint64_t frames_written = 0; ///< Frames written to disk.
+        std::uint64_t bytes_written = 0; ///< Data bytes written to disk, including alignment padding.
+        std::uint64_t dropped = 0; ///< Frames dropped because every staging chunk was busy.
+        std::uint64_t write_errors = 0; ///< Failed chunk writes; recording stops at the first one.
+        std::uint64_t compressed_frames = 0; ///< Depth frames stored compressed.
+        std::uint64_t bytes_saved = 0; ///< Payload bytes saved by compressing depth frames.
+    };
+
+    /**
+     * @class frame_recorder
+     * @brief Records frames into an indexed container, see recording_format.h.
+     *
+     * Capture threads copy each frame into a page-aligned staging chunk and return;
+     * they never touch the disk. A writer thread writes full chunks with one aligned
+     * pwrite each and then appends their index entries. When the disk falls behind,
+     * frames are dropped and counted instead of stalling capture. With compress_depth,
+     * Float depth frames are copied as they are and encoded by the writer thread just
+     * before their chunk is written, which packs the chunk; a frame that does not get
+     * smaller is stored uncompressed.
+     */
+    class frame_recorder {
+    private:
+        /**
+         * @struct chunk
+         * @brief A staging buffer holding consecutive payloads of the data file.
+         */
+        struct chunk
+        {
+            unsigned char* data = nullptr; ///< Page-aligned buffer of chunk_size bytes.
+            std::size_t used = 0; ///< Bytes reserved, a multiple of the payload alignment.
+            std::uint64_t file_offset = 0; ///< Offset of the chunk in the data file; set when it is written.
+            std::vector<recording::index_entry> entries; ///< Index entries of the reserved payloads, offsets relative to the chunk until it is written.
+            std::size_t writers = 0; ///< Capture threads still copying into the chunk.
+            bool sealed = false; ///< No further reservations; queued for writing.
+        };
+
+        recorder_config config; ///< Recorder settings.
+        int data_fd = -1; ///< Data file.
+        int index_fd = -1; ///< Index file.
+        frame_scheduler* scheduler = nullptr; ///< Scheduler the recorder is subscribed to.
+        int subscription = -1; ///< Scheduler subscription ID.
+
+        std::unique_ptr<depth_codec> codec; ///< Encodes depth frames on the writer thread, or nullptr without compress_depth.
+        std::vector<unsigned char> encoded; ///< Encoded frame of the writer thread.
+
+        std::vector<chunk> chunks; ///< All staging chunks.
+        mutable std::mutex mutex; ///< Guards the state below.
+        std::condition_variable writer_signal; ///< Wakes the writer thread.
+        std::condition_variable written_signal; ///< Signals written chunks to flush().
+        std::vector<chunk*> free_chunks; ///< Chunks ready for reuse.
+        std::vector<chunk*> write_queue; ///< Sealed chunks in seal order; the front is being or will be written next.
+        chunk* current = nullptr; ///< Chunk receiving new frames.
+        std::size_t in_flight = 0; ///< Sealed chunks not yet written.
+        std::uint64_t next_offset = recording::page_size; ///< File offset of the next chunk written; only the writer thread uses it.
+        std::uint64_t data_end = recording::page_size; ///< End of the written payloads.
+        bool recording = false; ///< True between open() and close().
+        bool stopping = false; ///< Tells the writer thread to drain and exit.
+        recorder_statistics statistics; ///< Counters.
+        std::thread writer; ///< Writer thread.
+
+        /**
+         * @brief Writer thread body.
+         */
+        void run();
+
+        /**
+         * @brief Closes the current chunk for reservations. Called with the mutex held.
+         */
+        void sealCurrent();
+
+        /**
+         * @brief Encodes the depth frames of a sealed chunk and packs its payloads. Runs on the writer thread.
+         *
+         * @param _chunk The chunk; no capture thread is copying into it.
+         */
+        void compressChunk(chunk& _chunk);
+
+        /**
+         * @brief Writes a chunk and its index entries.
+         *
+         * @param _chunk The chunk.
+         * @return bool True on success, false on an I/O error.
+         */
+        bool writeChunk(chunk& _chunk);
+
+        /**
+         * @brief Checks whether a frame passes the device and type filters.
+         */
+        [[nodiscard]] bool accepts(int device_id, libfreenect2::Frame::Type type) const;
+
+        /**
+         * @brief Closes both files.
+         */
+        void closeFiles();
+
+    public:
+        /**
+         * @brief Constructs a recorder and allocates its staging chunks.
+         *
+         * @param config Recorder settings.
+         */
+        explicit frame_recorder(const recorder_config& config = {});
+
+        /// Closes the recording.
+        ~frame_recorder();
+
+        frame_recorder(const frame_recorder&) = delete;
+        frame_recorder& operator=(const frame_recorder&) = delete;
+
+        /**
+         * @brief Creates the recording files and starts the writer thread.
+         *
+         * @param path Recording path without extension; existing files are replaced.
+         * @return Result The result of the operation.
+         */
+        Result open(const std::string& path);
+
+        /**
+         * @brief Records the frames delivered by a scheduler until close().
+         *
+         * @param scheduler The scheduler to subscribe to.
+         * @return Result The result of the operation.
+         */
+        Result attach(frame_scheduler& scheduler);
+
+        /**
+         * @brief Stops recording, writes the remaining frames and closes the files.
+         *
+         * @return Result The result of the operation; Error if a write failed.
+         */
+        Result close();
+
+        /**
+         * @brief Copies a frame into the staging chunk. Never blocks on I/O.
+         *
+         * @param device_id ID of the device that produced the frame.
+         * @param frame The frame.
+         * @param type The frame type.
+         * @param arrival_ns Host steady-clock arrival time of the frame.
+         * @return bool True if the frame was queued, false if it was filtered or dropped.
+         */
+        bool record(int device_id, const libfreenect2::Frame& frame, libfreenect2::Frame::Type type,
+                    std::int64_t arrival_ns);
+
+        /**
+         * @brief Copies a pooled frame into the staging chunk. Never blocks on I/O.
+         *
+         * @param device_id ID of the device that produced the frame.
+         * @param frame The pooled frame.
+         * @return bool True if the frame was queued, false if it was filtered or dropped.
+         */
+        bool record(int device_id, const frame_handle& frame);
+
+        /**
+         * @brief Writes every queued frame and waits until it is on disk.
+         */
+        void flush();
+
+        /**
+         * @brief Gets the counters.
+         *
+         * @return recorder_statistics Snapshot of the counters.
+         */
+        [[nodiscard]] recorder_statistics getStatistics() const;
+
+        /**
+         * @brief Checks whether a recording is open.
+         *
+         * @return bool True between open() and close().
+         */
+        [[nodiscard]] bool isRecording() const;
+    };
+}
+
+#endif //FRAME_RECORDER_H
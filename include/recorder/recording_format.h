@@ -0,0 +1,131 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef RECORDING_FORMAT_H
+#define RECORDING_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vision::recording
+{
+    /*
+     * A recording is two files next to each other:
+     *
+     *   <name>.frames  data file: one data_header page, then chunks of frame payloads.
+     *                  Every payload starts on a payload_alignment boundary and every
+     *                  chunk starts on a page boundary, so chunks can be written with
+     *                  large aligned I/O and payloads can be mapped and used in place.
+     *   <name>.index   index file: one index_header, then one index_entry per frame in
+     *                  recording order. An entry is only appended after its payload
+     *                  has been written, so the index never points past the data.
+     *
+     * Since version 2 a Float depth payload may be a depth_codec frame instead of raw
+     * floats; its entry then has format compressed_depth_format and the size of the
+     * encoded bytes, while width, height and bytes_per_pixel describe the decoded frame.
+     *
+     * All fields are little-endian, as produced by the x86 and ARM hosts we run on.
+     */
+
+    inline constexpr char data_extension[] = ".frames"; ///< Extension of the data file.
+    inline constexpr char index_extension[] = ".index"; ///< Extension of the index file.
+
+    inline constexpr std::uint64_t data_magic = 0x3153454d41524646ull;  ///< "FFRAMES1".
+    inline constexpr std::uint64_t index_magic = 0x315845444e494b46ull; ///< "FKINDEX1".
+    inline constexpr std::uint32_t version = 2; ///< Current format version.
+    inline constexpr std::uint32_t min_version = 1; ///< Oldest version still read; it has no compressed payloads.
+
+    /// index_entry::format of a Float depth payload stored as a depth_codec frame.
+    inline constexpr std::uint32_t compressed_depth_format = 0x444c5652u;
+
+    inline constexpr std::size_t page_size = 4096; ///< Alignment of chunks and of the first chunk offset.
+    inline constexpr std::size_t payload_alignment = 64; ///< Alignment of every frame payload.
+
+    /**
+     * @struct data_header
+     * @brief First page of the data file.
+     */
+    struct data_header
+    {
+        std::uint64_t magic = data_magic; ///< data_magic.
+        std::uint32_t version = recording::version; ///< Format version.
+        std::uint32_t reserved = 0; ///< Zero.
+        std::uint64_t chunk_size = 0; ///< Chunk size the file was written with.
+    };
+
+    /**
+     * @struct index_header
+     * @brief Start of the index file.
+     */
+    struct index_header
+    {
+        std::uint64_t magic = index_magic; ///< index_magic.
+        std::uint32_t version = recording::version; ///< Format version.
+        std::uint32_t entry_size = 0; ///< sizeof(index_entry) when written.
+    };
+
+    /**
+     * @struct index_entry
+     * @brief Location and metadata of one recorded frame.
+     */
+    struct index_entry
+    {
+        std::uint64_t offset = 0; ///< Byte offset of the payload in the data file.
+        std::uint64_t size = 0; ///< Payload size in bytes.
+        std::int64_t arrival_ns = 0; ///< Host steady-clock arrival time of the frame.
+        std::int64_t record_ns = 0; ///< Host steady-clock time the frame was queued; non-decreasing in file order.
+        std::int32_t device_id = -1; ///< ID of the device that produced the frame.
+        std::uint32_t type = 0; ///< libfreenect2::Frame::Type.
+        std::uint32_t format = 0; ///< libfreenect2::Frame::Format, or compressed_depth_format.
+        std::uint32_t timestamp = 0; ///< Device timestamp in 0.125 ms ticks.
+        std::uint32_t sequence = 0; ///< Device sequence number.
+        std::uint32_t status = 0; ///< libfreenect2 frame status.
+        std::uint32_t width = 0; ///< Frame width.
+        std::uint32_t height = 0; ///< Frame height.
+        std::uint32_t bytes_per_pixel = 0; ///< Bytes per pixel, of the decoded frame for compressed payloads.
+        float exposure = 0.0f; ///< Color exposure.
+        float gain = 0.0f; ///< Color gain.
+        float gamma = 0.0f; ///< Color gamma.
+    };
+
+    static_assert(sizeof(data_header) <= page_size);
+    static_assert(sizeof(index_entry) == 80, "index_entry is part of the file format");
+
+    /**
+     * @brief Rounds a size up to a power-of-two alignment.
+     *
+     * @param value The size.
+     * @param alignment The alignment.
+     * @return std::size_t The aligned size.
+     */
+    constexpr std::size_t alignUp(const std::size_t value, const std::size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * @brief Gets the data file path of a recording.
+     *
+     * @param path Recording path without extension.
+     * @return std::string The data file path.
+     */
+    inline std::string dataPath(const std::string& path)
+    {
+        return path + data_extension;
+    }
+
+    /**
+     * @brief Gets the index file path of a recording.
+     *
+     * @param path Recording path without extension.
+     * @return std::string The index file path.
+     */
+    inline std::string indexPath(const std::string& path)
+    {
+        return path + index_extension;
+    }
+}
+
+#endif //RECORDING_FORMAT_H
@@ -0,0 +1,142 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef RECORDING_READER_H
+#define RECORDING_READER_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "libfreenect2/frame_listener.hpp"
+#include "debug/status.h"
+#include "recorder/recording_format.h"
+
+namespace vision
+{
+    /**
+     * @class recording_reader
+     * @brief Random access to a recording written by frame_recorder.
+     *
+     * Both files are memory-mapped; payloads are returned as pointers into the mapping,
+     * so reading a frame copies nothing. The mapping is private, so a consumer writing
+     * into a payload gets its own copy of the touched pages and never changes the file.
+     */
+    class recording_reader {
+    private:
+        unsigned char* data = nullptr; ///< Mapped data file.
+        std::size_t data_size = 0; ///< Size of the data mapping.
+        unsigned char* index = nullptr; ///< Mapped index file.
+        std::size_t index_size = 0; ///< Size of the index mapping.
+        const recording::index_entry* entries = nullptr; ///< First index entry.
+        std::size_t count = 0; ///< Number of complete, valid entries.
+
+    public:
+        recording_reader() = default;
+
+        /// Unmaps the recording.
+        ~recording_reader();
+
+        recording_reader(const recording_reader&) = delete;
+        recording_reader& operator=(const recording_reader&) = delete;
+
+        /**
+         * @brief Maps a recording.
+         *
+         * A truncated index tail, such as the one left by a crash, is ignored.
+         *
+         * @param path Recording path without extension.
+         * @return Result The result of the operation.
+         */
+        Result open(const std::string& path);
+
+        /**
+         * @brief Unmaps the recording.
+         */
+        void close();
+
+        /**
+         * @brief Gets the number of frames.
+         *
+         * @return std::size_t The frame count.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return count;
+        }
+
+        /**
+         * @brief Gets the index entry of a frame.
+         *
+         * @param i Frame number in recording order.
+         * @return const recording::index_entry& The entry.
+         */
+        [[nodiscard]] const recording::index_entry& entry(const std::size_t i) const
+        {
+            return entries[i];
+        }
+
+        /**
+         * @brief Gets the payload of a frame.
+         *
+         * @param i Frame number in recording order.
+         * @return unsigned char* Pointer into the mapping, aligned to recording::payload_alignment.
+         */
+        [[nodiscard]] unsigned char* payload(const std::size_t i) const
+        {
+            return data + entries[i].offset;
+        }
+
+        /**
+         * @brief Finds the first frame queued at or after a time.
+         *
+         * @param record_ns Host steady-clock time.
+         * @return std::size_t The frame number, or size() if every frame is older.
+         */
+        [[nodiscard]] std::size_t seek(std::int64_t record_ns) const;
+
+        /**
+         * @brief Finds the next frame of a device and type.
+         *
+         * @param from Frame number to start searching at.
+         * @param device_id The ID of the device.
+         * @param type The frame type.
+         * @return std::optional<std::size_t> The frame number if found; otherwise, std::nullopt.
+         */
+        [[nodiscard]] std::optional<std::size_t> next(std::size_t from, int device_id,
+                                                      libfreenect2::Frame::Type type) const;
+
+        /**
+         * @brief Points a frame at a recorded payload and copies its metadata.
+         *
+         * The frame must not own its buffer; its data pointer is replaced by the mapped payload.
+         * A compressed depth payload keeps compressed_depth_format; use read() to decode it.
+         *
+         * @param i Frame number in recording order.
+         * @param frame Receives the metadata and the payload pointer.
+         */
+        void view(std::size_t i, libfreenect2::Frame& frame) const;
+
+        /**
+         * @brief Checks whether a frame is stored as a depth_codec frame.
+         *
+         * @param i Frame number in recording order.
+         * @return bool True if the entry has recording::compressed_depth_format.
+         */
+        [[nodiscard]] bool isCompressed(std::size_t i) const;
+
+        /**
+         * @brief Copies a frame into a caller buffer, decoding compressed depth, and copies its metadata.
+         *
+         * A decoded depth frame comes out in Float format, quantized to whole millimeters.
+         *
+         * @param i Frame number in recording order.
+         * @param frame Frame whose data receives the pixels.
+         * @param capacity Size of the frame buffer in bytes.
+         * @return Result The result of the operation; InvalidParam if the buffer is too small or the payload is corrupt.
+         */
+        Result read(std::size_t i, libfreenect2::Frame& frame, std::size_t capacity) const;
+    };
+}
+
+#endif //RECORDING_READER_H
@@ -0,0 +1,448 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/depth_codec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#ifdef VISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::size_t max_pixels = std::size_t{1} << 28; ///< Largest frame; keeps band sizes in 32 bits.
+        constexpr std::size_t max_bands = 1024; ///< Most bands a frame is cut into.
+
+        /**
+         * @brief Gets the rows per band and the number of non-empty bands of a frame.
+         */
+        std::size_t bandLayout(const std::size_t height, const std::size_t bands, std::size_t& rows)
+        {
+            const std::size_t requested = std::clamp<std::size_t>(bands, 1, std::max<std::size_t>(height, 1));
+            rows = std::max<std::size_t>((height + requested - 1) / requested, 1);
+            return (height + rows - 1) / rows;
+        }
+
+        /**
+         * @brief Gets the largest encoded size of a band: eight nibbles per pixel and a partial last word.
+         */
+        constexpr std::size_t bandBound(const std::size_t pixels)
+        {
+            return pixels * 4 + 8;
+        }
+
+        /**
+         * @struct nibble_writer
+         * @brief Packs variable-length values into 32-bit words, first nibble in the high bits.
+         */
+        struct nibble_writer
+        {
+            unsigned char* out; ///< Next word.
+            std::uint32_t word = 0; ///< Word being filled.
+            int nibbles = 0; ///< Nibbles in the word.
+
+            void put(std::uint32_t value)
+            {
+                do
+                {
+                    std::uint32_t nibble = value & 0x7u;
+                    value >>= 3;
+                    if(value != 0)
+                        nibble |= 0x8u;
+                    word = word << 4 | nibble;
+                    if(++nibbles == 8)
+                    {
+                        std::memcpy(out, &word, sizeof(word));
+                        out += sizeof(word);
+                        word = 0;
+                        nibbles = 0;
+                    }
+                } while(value != 0);
+            }
+
+            void flush()
+            {
+                if(nibbles == 0)
+                    return;
+                word <<= 4 * (8 - nibbles);
+                std::memcpy(out, &word, sizeof(word));
+                out += sizeof(word);
+                nibbles = 0;
+            }
+        };
+
+        /**
+         * @struct nibble_reader
+         * @brief Unpacks the values of a nibble_writer, refusing to read past the band.
+         */
+        struct nibble_reader
+        {
+            const unsigned char* in; ///< Next word.
+            const unsigned char* end; ///< End of the band.
+            std::uint32_t word = 0; ///< Word being read.
+            int nibbles = 0; ///< Nibbles left in the word.
+
+            bool get(std::uint32_t& value)
+            {
+                value = 0;
+                for(int shift = 0; shift <= 30; shift += 3)
+                {
+                    if(nibbles == 0)
+                    {
+                        if(end - in < static_cast<std::ptrdiff_t>(sizeof(word)))
+                            return false;
+                        std::memcpy(&word, in, sizeof(word));
+                        in += sizeof(word);
+                        nibbles = 8;
+                    }
+                    const std::uint32_t nibble = word >> 28;
+                    word <<= 4;
+                    --nibbles;
+                    value |= (nibble & 0x7u) << shift;
+                    if((nibble & 0x8u) == 0)
+                        return true;
+                }
+                return false;
+            }
+        };
+
+        // The kernels below mirror each other operation for operation, so they agree to the bit.
+
+        void scalarQuantize(const float* depth, std::uint16_t* out, const std::size_t begin, const std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                const float d = depth[i];
+                out[i] = static_cast<std::uint16_t>(std::nearbyint(d > 0.0f ? std::min(d, 65535.0f) : 0.0f));
+            }
+        }
+
+        void scalarDequantize(const std::uint16_t* in, float* depth, const std::size_t begin, const std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+                depth[i] = static_cast<float>(in[i]);
+        }
+
+        std::size_t scalarRun(const std::uint16_t* pixels, const std::size_t size, const bool holes)
+        {
+            std::size_t n = 0;
+            while(n < size && (pixels[n] == 0) == holes)
+                ++n;
+            return n;
+        }
+
+#ifdef VISION_X86_KERNELS
+        __attribute__((target("avx2")))
+        inline __m256i avx2Quantize8(const __m256 d)
+        {
+            const __m256 keep = _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GT_OQ);
+            // min_ps returns its second operand for NaN, which the mask then clears.
+            const __m256 clamped = _mm256_and_ps(_mm256_min_ps(d, _mm256_set1_ps(65535.0f)), keep);
+            return _mm256_cvtps_epi32(clamped);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2Quantize(const float* depth, std::uint16_t* out, const std::size_t begin, const std::size_t end)
+        {
+            std::size_t i = begin;
+            for(; i + 16 <= end; i += 16)
+            {
+                const __m256i low = avx2Quantize8(_mm256_loadu_ps(depth + i));
+                const __m256i high = avx2Quantize8(_mm256_loadu_ps(depth + i + 8));
+                // packus interleaves the 128-bit lanes; the permute puts them back in order.
+                const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(low, high), 0xd8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+            }
+            scalarQuantize(depth, out, i, end);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2Dequantize(const std::uint16_t* in, float* depth, const std::size_t begin, const std::size_t end)
+        {
+            std::size_t i = begin;
+            for(; i + 8 <= end; i += 8)
+            {
+                const __m128i q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                _mm256_storeu_ps(depth + i, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(q)));
+            }
+            scalarDequantize(in, depth, i, end);
+        }
+
+        __attribute__((target("avx2")))
+        std::size_t avx2Run(const std::uint16_t* pixels, const std::size_t size, const bool holes)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            std::size_t n = 0;
+            for(; n + 16 <= size; n += 16)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + n));
+                // Two mask bits per pixel, set for holes.
+                auto ends = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, zero)));
+                if(holes)
+                    ends = ~ends;
+                if(ends != 0)
+                    return n + static_cast<std::size_t>(__builtin_ctz(ends)) / 2;
+            }
+            return n + scalarRun(pixels + n, size - n, holes);
+        }
+#endif
+
+        void quantize(const depth_codec::kernel kernel, const float* depth, std::uint16_t* out,
+                      const std::size_t begin, const std::size_t end)
+        {
+#ifdef VISION_X86_KERNELS
+            if(kernel == depth_codec::kernel::AVX2)
+            {
+                avx2Quantize(depth, out, begin, end);
+                return;
+            }
+#endif
+            (void)kernel;
+            scalarQuantize(depth, out, begin, end);
+        }
+
+        void dequantize(const depth_codec::kernel kernel, const std::uint16_t* in, float* depth,
+                        const std::size_t begin, const std::size_t end)
+        {
+#ifdef VISION_X86_KERNELS
+            if(kernel == depth_codec::kernel::AVX2)
+            {
+                avx2Dequantize(in, depth, begin, end);
+                return;
+            }
+#endif
+            (void)kernel;
+            scalarDequantize(in, depth, begin, end);
+        }
+
+        std::size_t runLength(const depth_codec::kernel kernel, const std::uint16_t* pixels, const std::size_t size,
+                              const bool holes)
+        {
+#ifdef VISION_X86_KERNELS
+            if(kernel == depth_codec::kernel::AVX2)
+                return avx2Run(pixels, size, holes);
+#endif
+            (void)kernel;
+            return scalarRun(pixels, size, holes);
+        }
+
+        /**
+         * @brief RVL-encodes the pixels of a band.
+         *
+         * @return std::size_t Encoded size in bytes, at most bandBound(count).
+         */
+        std::size_t encodeBand(const depth_codec::kernel kernel, const std::uint16_t* pixels, const std::size_t count,
+                               unsigned char* out)
+        {
+            nibble_writer writer{out};
+            std::int32_t previous = 0;
+            std::size_t i = 0;
+            while(i < count)
+            {
+                const std::size_t holes = runLength(kernel, pixels + i, count - i, true);
+                writer.put(static_cast<std::uint32_t>(holes));
+                i += holes;
+                const std::size_t valid = runLength(kernel, pixels + i, count - i, false);
+                writer.put(static_cast<std::uint32_t>(valid));
+                for(const std::size_t end = i + valid; i < end; ++i)
+                {
+                    const std::int32_t delta = static_cast<std::int32_t>(pixels[i]) - previous;
+                    previous = pixels[i];
+                    writer.put((static_cast<std::uint32_t>(delta) << 1) ^ static_cast<std::uint32_t>(delta >> 31));
+                }
+            }
+            writer.flush();
+            return static_cast<std::size_t>(writer.out - out);
+        }
+
+        /**
+         * @brief Decodes the pixels of a band.
+         *
+         * @return bool True if the band held exactly count valid pixels.
+         */
+        bool decodeBand(const unsigned char* data, const std::size_t size, std::uint16_t* pixels,
+                        const std::size_t count)
+        {
+            nibble_reader reader{data, data + size};
+            std::int32_t previous = 0;
+            std::size_t i = 0;
+            std::uint32_t value = 0;
+            while(i < count)
+            {
+                if(!reader.get(value) || value > count - i)
+                    return false;
+                std::fill_n(pixels + i, value, std::uint16_t{0});
+                i += value;
+                if(!reader.get(value) || value > count - i)
+                    return false;
+                for(const std::size_t end = i + value; i < end; ++i)
+                {
+                    std::uint32_t zigzag = 0;
+                    if(!reader.get(zigzag))
+                        return false;
+                    previous += static_cast<std::int32_t>((zigzag >> 1) ^ (0u - (zigzag & 1u)));
+                    if(previous <= 0 || previous > 65535)
+                        return false;
+                    pixels[i] = static_cast<std::uint16_t>(previous);
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Validates the header and band table of an encoded frame.
+         */
+        Result parseHeader(const unsigned char* data, const std::size_t size, depth_codec_header& header,
+                           std::size_t& payload)
+        {
+            if(data == nullptr || size < sizeof(header))
+                return {Status::InvalidParam, "Encoded depth frame is truncated!"};
+            std::memcpy(&header, data, sizeof(header));
+            if(header.magic != depth_codec_header::codec_magic || header.version != depth_codec_header::codec_version)
+                return {Status::InvalidParam, "Encoded depth frame has an unsupported format!"};
+            const std::size_t pixels = static_cast<std::size_t>(header.width) * header.height;
+            if(pixels == 0 || pixels > max_pixels || header.bands == 0 || header.bands > header.height)
+                return {Status::InvalidParam, "Encoded depth frame has an invalid size!"};
+            std::size_t rows = 0;
+            if(bandLayout(header.height, header.bands, rows) != header.bands)
+                return {Status::InvalidParam, "Encoded depth frame has an invalid band count!"};
+            payload = sizeof(header) + header.bands * sizeof(std::uint32_t);
+            if(size < payload)
+                return {Status::InvalidParam, "Encoded depth frame is truncated!"};
+            return Result(Status::Success);
+        }
+    }
+
+    depth_codec::depth_codec(const depth_codec_config& config, const kernel requested)
+        : bands(std::clamp<std::size_t>(config.bands, 1, max_bands)), pool(std::max<std::size_t>(config.threads, 1),
+                                                                           config.cpus)
+    {
+        active_kernel = resolveKernel(requested);
+    }
+
+    std::size_t depth_codec::bandCount(const std::size_t height) const
+    {
+        std::size_t rows = 0;
+        return bandLayout(height, bands, rows);
+    }
+
+    std::size_t depth_codec::maxEncodedSize(const std::size_t width, const std::size_t height, const std::size_t bands)
+    {
+        std::size_t rows = 0;
+        const std::size_t count = bandLayout(height, std::clamp<std::size_t>(bands, 1, max_bands), rows);
+        return sizeof(depth_codec_header) + count * (sizeof(std::uint32_t) + bandBound(rows * width));
+    }
+
+    Result depth_codec::readHeader(const unsigned char* data, const std::size_t size, std::size_t& width,
+                                   std::size_t& height)
+    {
+        depth_codec_header header;
+        std::size_t payload = 0;
+        if(Result result = parseHeader(data, size, header, payload); result.status != Status::Success)
+            return result;
+        width = header.width;
+        height = header.height;
+        return Result(Status::Success);
+    }
+
+    Result depth_codec::encode(const float* depth, const std::size_t width, const std::size_t height,
+                               unsigned char* out, const std::size_t capacity, std::size_t& size)
+    {
+        size = 0;
+        if(depth == nullptr || width == 0 || height == 0 || width * height > max_pixels)
+            return {Status::InvalidParam, "Depth frame size is not supported!"};
+        if(out == nullptr || capacity < maxEncodedSize(width, height, bands))
+            return {Status::InvalidParam, "Output buffer is too small for the encoded frame!"};
+
+        std::size_t rows = 0;
+        const std::size_t count = bandLayout(height, bands, rows);
+        const std::size_t first = sizeof(depth_codec_header) + count * sizeof(std::uint32_t);
+        const std::size_t slot = bandBound(rows * width);
+        quantized.resize(width * height);
+        band_sizes.assign(count, 0);
+
+        // Every band is encoded into its own worst-case slot, then the bands are moved together.
+        pool.run(count, [&](const std::size_t band) {
+            const std::size_t begin = band * rows * width;
+            const std::size_t end = std::min(begin + rows * width, width * height);
+            quantize(active_kernel, depth, quantized.data(), begin, end);
+            band_sizes[band] = static_cast<std::uint32_t>(
+                    encodeBand(active_kernel, quantized.data() + begin, end - begin, out + first + band * slot));
+        });
+
+        depth_codec_header header;
+        header.bands = static_cast<std::uint16_t>(count);
+        header.width = static_cast<std::uint32_t>(width);
+        header.height = static_cast<std::uint32_t>(height);
+        std::memcpy(out, &header, sizeof(header));
+        std::memcpy(out + sizeof(header), band_sizes.data(), count * sizeof(std::uint32_t));
+
+        size = first;
+        for(std::size_t band = 0; band < count; ++band)
+        {
+            std::memmove(out + size, out + first + band * slot, band_sizes[band]);
+            size += band_sizes[band];
+        }
+        return Result(Status::Success);
+    }
+
+    Result depth_codec::encode(const float* depth, const std::size_t width, const std::size_t height,
+                               std::vector<unsigned char>& out)
+    {
+        out.resize(std::max(out.size(), maxEncodedSize(width, height, bands)));
+        std::size_t size = 0;
+        Result result = encode(depth, width, height, out.data(), out.size(), size);
+        out.resize(size);
+        return result;
+    }
+
+    Result depth_codec::decode(const unsigned char* data, const std::size_t size, float* depth,
+                               const std::size_t capacity)
+    {
+        depth_codec_header header;
+        std::size_t payload = 0;
+        if(Result result = parseHeader(data, size, header, payload); result.status != Status::Success)
+            return result;
+        const std::size_t width = header.width;
+        const std::size_t pixels = width * header.height;
+        if(depth == nullptr || capacity < pixels)
+            return {Status::InvalidParam, "Depth buffer is too small for the decoded frame!"};
+
+        band_sizes.resize(header.bands);
+        std::memcpy(band_sizes.data(), data + sizeof(header), header.bands * sizeof(std::uint32_t));
+        band_offsets.resize(header.bands);
+        std::size_t offset = payload;
+        for(std::size_t band = 0; band < header.bands; ++band)
+        {
+            band_offsets[band] = offset;
+            offset += band_sizes[band];
+            if(band_sizes[band] % sizeof(std::uint32_t) != 0 || offset > size)
+                return {Status::InvalidParam, "Encoded depth frame is truncated!"};
+        }
+
+        std::size_t rows = 0;
+        bandLayout(header.height, header.bands, rows);
+        quantized.resize(pixels);
+        std::atomic<bool> valid{true};
+        pool.run(header.bands, [&](const std::size_t band) {
+            const std::size_t begin = band * rows * width;
+            const std::size_t end = std::min(begin + rows * width, pixels);
+            if(!decodeBand(data + band_offsets[band], band_sizes[band], quantized.data() + begin, end - begin))
+            {
+                valid.store(false, std::memory_order_relaxed);
+                return;
+            }
+            dequantize(active_kernel, quantized.data(), depth, begin, end);
+        });
+        if(!valid.load(std::memory_order_relaxed))
+            return {Status::InvalidParam, "Encoded depth frame is corrupt!"};
+        return Result(Status::Success);
+    }
+}
@@ -0,0 +1,507 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/depth_decoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Default parameters of libfreenect2's depth packet processors.
+         */
+        namespace parameters
+        {
+            constexpr double pi = 3.14159265358979323846;
+
+            constexpr float ab_multiplier = 0.6666667f;
+            constexpr float ab_multiplier_per_frq[3] = {1.322581f, 1.0f, 1.612903f};
+            constexpr float ab_output_multiplier = 16.0f;
+            constexpr float phase_in_rad[3] = {0.0f, 2.094395f, 4.18879f};
+
+            constexpr float joint_bilateral_ab_threshold = 3.0f;
+            constexpr float joint_bilateral_max_edge = 2.5f;
+            constexpr float joint_bilateral_exp = 5.0f;
+            constexpr float gaussian_kernel[9] = {
+                0.1069973f, 0.1131098f, 0.1069973f,
+                0.1131098f, 0.1195716f, 0.1131098f,
+                0.1069973f, 0.1131098f, 0.1069973f
+            };
+
+            constexpr float phase_offset = 0.0f;
+            constexpr float unambigious_dist = 2083.333f;
+            constexpr float individual_ab_threshold = 3.0f;
+            constexpr float ab_threshold = 10.0f;
+            constexpr float ab_confidence_slope = -0.5330578f;
+            constexpr float ab_confidence_offset = 0.7694894f;
+            constexpr float min_dealias_confidence = 0.3490659f;
+            constexpr float max_dealias_confidence = 0.6108653f;
+
+            constexpr float edge_ab_avg_min_value = 50.0f;
+            constexpr float edge_ab_std_dev_threshold = 0.05f;
+            constexpr float edge_close_delta_threshold = 50.0f;
+            constexpr float edge_far_delta_threshold = 30.0f;
+            constexpr float edge_max_delta_threshold = 100.0f;
+            constexpr float edge_avg_delta_threshold = 0.0f;
+        }
+
+        constexpr std::size_t band_rows = 16; ///< Rows per task.
+        constexpr std::size_t row_words = 352; ///< 16-bit words in a packed row of 512 11-bit values.
+    }
+
+    depth_decoder::depth_decoder(const depth_decoder_config& config)
+        : config(config),
+          pool(std::make_unique<worker_pool>(
+                  config.threads != 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency()),
+                  config.cpus)),
+          trig_table(3 * width * height),
+          x_table(width * height),
+          z_table(width * height),
+          measurements(9 * width * height),
+          normalized(9 * width * height),
+          filtered(9 * width * height),
+          max_edge_test(width * height, 1),
+          depth_ir_sum(3 * width * height)
+    {
+        for(std::size_t x = 0; x < width; ++x)
+        {
+            // Columns are interleaved in groups of four 128-pixel quarters, 11 bits each.
+            const std::size_t bit = ((x >> 2) + ((x & 3) << 7)) * 11;
+            word_offset[x] = static_cast<std::uint16_t>(bit >> 4);
+            bit_shift[x] = static_cast<std::uint8_t>(bit & 15);
+        }
+    }
+
+    void depth_decoder::setTableSource(libfreenect2::DumpPacketPipeline* source)
+    {
+        table_source.store(source, std::memory_order_release);
+        tables_stale.store(true, std::memory_order_release);
+    }
+
+    Result depth_decoder::loadSourceTables()
+    {
+        libfreenect2::DumpPacketPipeline* source = table_source.load(std::memory_order_acquire);
+        if(source == nullptr)
+            return {Status::EmptyData, "No depth table source is set."};
+
+        std::size_t p0_length = 0, x_length = 0, z_length = 0, lookup_length = 0;
+        const unsigned char* p0 = source->getDepthP0Tables(&p0_length);
+        const float* x = source->getDepthXTable(&x_length);
+        const float* z = source->getDepthZTable(&z_length);
+        const short* lookup = source->getDepthLookupTable(&lookup_length);
+        if(p0 == nullptr || x == nullptr || z == nullptr || lookup == nullptr)
+            return {Status::EmptyData, "The device has not sent its depth tables yet."};
+        return loadTables(p0, p0_length, x, z, std::min(x_length, z_length), lookup, lookup_length);
+    }
+
+    Result depth_decoder::loadTables(const unsigned char* p0_tables, const std::size_t p0_length,
+                                     const float* x_table, const float* z_table, const std::size_t xz_length,
+                                     const short* lookup, const std::size_t lookup_length)
+    {
+        if(p0_tables == nullptr || x_table == nullptr || z_table == nullptr || lookup == nullptr)
+            return {Status::EmptyParam, "Depth tables are missing."};
+        if(p0_length < p0_tables_size || xz_length < width * height || lookup_length < lookup_table_size)
+            return {Status::InvalidParam, "Depth tables are too small."};
+
+        tables_loaded = false;
+        std::memcpy(lookup_table.data(), lookup, lookup_table_size * sizeof(short));
+
+        // The device tables are stored upside down relative to the packet rows.
+        for(std::size_t y = 0; y < height; ++y)
+        {
+            const std::size_t source_row = (height - 1 - y) * width;
+            std::memcpy(&this->x_table[y * width], x_table + source_row, width * sizeof(float));
+            std::memcpy(&this->z_table[y * width], z_table + source_row, width * sizeof(float));
+        }
+
+        // Response layout: 32-byte header, then per frequency a 16-bit pad, the table and another pad.
+        for(std::size_t frequency = 0; frequency < 3; ++frequency)
+        {
+            const unsigned char* table = p0_tables + 32 + 2 + frequency * (2 * width * height + 4);
+            trig_entry* entries = &trig_table[frequency * width * height];
+            for(std::size_t y = 0; y < height; ++y)
+            {
+                for(std::size_t x = 0; x < width; ++x)
+                {
+                    std::uint16_t value;
+                    std::memcpy(&value, table + 2 * ((height - 1 - y) * width + x), sizeof(value));
+                    const float p0 = -static_cast<float>(value) * 0.000031 * parameters::pi;
+
+                    trig_entry& entry = entries[y * width + x];
+                    for(int k = 0; k < 3; ++k)
+                    {
+                        const float phase = p0 + parameters::phase_in_rad[k];
+                        entry.cos[k] = std::cos(phase);
+                        entry.sin[k] = std::sin(-phase);
+                    }
+                }
+            }
+        }
+
+        tables_loaded = true;
+        return Result(Status::Success);
+    }
+
+    Result depth_decoder::decode(const unsigned char* packet, const std::size_t length, float* ir, float* depth)
+    {
+        if(packet == nullptr || length < packet_size)
+            return {Status::InvalidParam, "Depth packet is too small."};
+
+        // A new source means a new device; its tables replace the current ones before the next packet.
+        if(tables_stale.exchange(false, std::memory_order_acq_rel)
+           && table_source.load(std::memory_order_acquire) != nullptr)
+            tables_loaded = false;
+        if(!tables_loaded)
+        {
+            if(Result result = loadSourceTables(); result.status != Status::Success)
+                return result;
+        }
+
+        const std::size_t bands = (height + band_rows - 1) / band_rows;
+        auto rows = [](const std::size_t band) {
+            return std::pair{band * band_rows, std::min(height, (band + 1) * band_rows)};
+        };
+
+        pool->run(bands, [&](const std::size_t band) {
+            const auto [first, last] = rows(band);
+            decodeMeasurements(packet, first, last);
+        });
+        pool->run(bands, [&](const std::size_t band) {
+            const auto [first, last] = rows(band);
+            unwrapPhase(first, last, ir, depth);
+        });
+        if(config.edge_aware_filter && depth != nullptr)
+        {
+            pool->run(bands, [&](const std::size_t band) {
+                const auto [first, last] = rows(band);
+                filterEdges(first, last, depth);
+            });
+        }
+        return Result(Status::Success);
+    }
+
+    void depth_decoder::decodeMeasurements(const unsigned char* packet, const std::size_t first_row,
+                                           const std::size_t last_row)
+    {
+        for(std::size_t y = first_row; y < last_row; ++y)
+        {
+            // The two halves of the image are stored from the middle outwards.
+            const std::size_t packed_row = y < height / 2 ? y + height / 2 : height - 1 - y;
+            const unsigned char* rows[9];
+            for(std::size_t image = 0; image < 9; ++image)
+                rows[image] = packet + image * sub_image_size + packed_row * row_words * 2;
+
+            for(std::size_t x = 0; x < width; ++x)
+            {
+                const std::size_t pixel = y * width + x;
+                float* m = &measurements[9 * pixel];
+                float* n = &normalized[9 * pixel];
+
+                for(std::size_t frequency = 0; frequency < 3; ++frequency, m += 3, n += 3)
+                {
+                    // libfreenect2 tests the truncated factor, so factors below one also mark invalid pixels.
+                    if(static_cast<std::int32_t>(z_table[pixel]) <= 0)
+                    {
+                        m[0] = m[1] = m[2] = 0.0f;
+                    }
+                    else
+                    {
+                        std::int32_t value[3];
+                        bool saturated = false;
+                        for(std::size_t k = 0; k < 3; ++k)
+                        {
+                            if(x < 1 || x > width - 2)
+                                value[k] = lookup_table[0];
+                            else
+                            {
+                                std::uint32_t words;
+                                std::memcpy(&words, rows[3 * frequency + k] + 2 * word_offset[x], sizeof(words));
+                                value[k] = lookup_table[(words >> bit_shift[x]) & 2047];
+                            }
+                            saturated |= value[k] == 32767;
+                        }
+
+                        if(saturated)
+                        {
+                            m[0] = 0.0f;
+                            m[1] = 0.0f;
+                            m[2] = 65535.0f;
+                        }
+                        else
+                        {
+                            const trig_entry& trig = trig_table[frequency * width * height + pixel];
+                            float a = trig.cos[0] * value[0] + trig.cos[1] * value[1] + trig.cos[2] * value[2];
+                            float b = trig.sin[0] * value[0] + trig.sin[1] * value[1] + trig.sin[2] * value[2];
+                            a *= parameters::ab_multiplier_per_frq[frequency];
+                            b *= parameters::ab_multiplier_per_frq[frequency];
+                            m[0] = a;
+                            m[1] = b;
+                            m[2] = std::sqrt(a * a + b * b) * parameters::ab_multiplier;
+                        }
+                    }
+
+                    // Precomputed once here instead of for every neighbor in the bilateral filter.
+                    const float norm2 = m[0] * m[0] + m[1] * m[1];
+                    float inv_norm = 1.0f / std::sqrt(norm2);
+                    inv_norm = inv_norm == inv_norm ? inv_norm : std::numeric_limits<float>::infinity();
+                    n[0] = m[0] * inv_norm;
+                    n[1] = m[1] * inv_norm;
+                    n[2] = norm2;
+                }
+            }
+        }
+    }
+
+    void depth_decoder::unwrapPhase(const std::size_t first_row, const std::size_t last_row, float* ir, float* depth)
+    {
+        using namespace parameters;
+
+        const float bilateral_threshold = joint_bilateral_ab_threshold * joint_bilateral_ab_threshold
+                                          / (ab_multiplier * ab_multiplier);
+
+        for(std::size_t y = first_row; y < last_row; ++y)
+        {
+            const std::size_t output_row = (height - 1 - y) * width;
+            for(std::size_t x = 0; x < width; ++x)
+            {
+                const std::size_t pixel = y * width + x;
+                const float* m = &measurements[9 * pixel];
+
+                if(config.bilateral_filter)
+                {
+                    float* out = &filtered[9 * pixel];
+                    bool edge_test = true;
+                    if(x < 1 || y < 1 || x > width - 2 || y > height - 2)
+                        std::copy_n(m, 9, out);
+                    else
+                    {
+                        for(std::size_t frequency = 0; frequency < 3; ++frequency)
+                        {
+                            const std::size_t offset = 3 * frequency;
+                            const float* self = &normalized[9 * pixel + offset];
+
+                            float threshold = bilateral_threshold;
+                            float exponent = joint_bilateral_exp;
+                            if(self[2] < threshold)
+                            {
+                                threshold = 0.0f;
+                                exponent = 0.0f;
+                            }
+
+                            float weight_acc = 0.0f;
+                            float weighted_a = 0.0f, weighted_b = 0.0f;
+                            float dist_acc = 0.0f;
+                            int j = 0;
+                            for(int yi = -1; yi < 2; ++yi)
+                            {
+                                for(int xi = -1; xi < 2; ++xi, ++j)
+                                {
+                                    if(yi == 0 && xi == 0)
+                                    {
+                                        weight_acc += gaussian_kernel[j];
+                                        weighted_a += gaussian_kernel[j] * m[offset];
+                                        weighted_b += gaussian_kernel[j] * m[offset + 1];
+                                        continue;
+                                    }
+
+                                    const std::size_t other = (y + yi) * width + x + xi;
+                                    const float* other_m = &measurements[9 * other + offset];
+                                    const float* other_n = &normalized[9 * other + offset];
+
+                                    float dist = -(other_n[0] * self[0] + other_n[1] * self[1]);
+                                    dist += 1.0f;
+                                    dist *= 0.5f;
+
+                                    float weight = 0.0f;
+                                    if(other_n[2] >= threshold)
+                                    {
+                                        weight = gaussian_kernel[j] * std::exp(-1.442695f * exponent * dist);
+                                        dist_acc += dist;
+                                    }
+                                    weighted_a += weight * other_m[0];
+                                    weighted_b += weight * other_m[1];
+                                    weight_acc += weight;
+                                }
+                            }
+
+                            out[offset] = 0.0f < weight_acc ? weighted_a / weight_acc : 0.0f;
+                            out[offset + 1] = 0.0f < weight_acc ? weighted_b / weight_acc : 0.0f;
+                            out[offset + 2] = m[offset + 2];
+                            edge_test = edge_test && dist_acc < joint_bilateral_max_edge;
+                        }
+                    }
+                    max_edge_test[pixel] = edge_test;
+                    m = out;
+                }
+
+                float tmp0 = std::atan2(m[1], m[0]);
+                float tmp1 = std::atan2(m[4], m[3]);
+                float tmp2 = std::atan2(m[7], m[6]);
+                tmp0 = tmp0 < 0 ? tmp0 + pi * 2.0f : tmp0;
+                tmp1 = tmp1 < 0 ? tmp1 + pi * 2.0f : tmp1;
+                tmp2 = tmp2 < 0 ? tmp2 + pi * 2.0f : tmp2;
+                tmp0 = tmp0 != tmp0 ? 0 : tmp0;
+                tmp1 = tmp1 != tmp1 ? 0 : tmp1;
+                tmp2 = tmp2 != tmp2 ? 0 : tmp2;
+
+                const float ir_sum = m[2] + m[5] + m[8];
+                const float ir_min = std::min(std::min(m[2], m[5]), m[8]);
+                const float ir_max = std::max(std::max(m[2], m[5]), m[8]);
+
+                float phase;
+                if(ir_min < individual_ab_threshold || ir_sum < ab_threshold)
+                    phase = 0;
+                else
+                {
+                    // Dealiasing of the three wrapped phases, as in libfreenect2.
+                    const float t0 = tmp0 / (2.0f * pi) * 3.0f;
+                    const float t1 = tmp1 / (2.0f * pi) * 15.0f;
+                    const float t2 = tmp2 / (2.0f * pi) * 2.0f;
+
+                    const float t5 = std::floor((t1 - t0) * 0.333333f + 0.5f) * 3.0f + t0;
+                    float t3 = -t2 + t5;
+                    const float t4 = t3 * 2.0f;
+
+                    const bool c1 = t4 >= -t4;
+                    const float f1 = c1 ? 2.0f : -2.0f;
+                    const float f2 = c1 ? 0.5f : -0.5f;
+                    t3 *= f2;
+                    t3 = (t3 - std::floor(t3)) * f1;
+
+                    const bool c2 = 0.5f < std::abs(t3) && std::abs(t3) < 1.5f;
+                    float t6 = c2 ? t5 + 15.0f : t5;
+                    float t7 = c2 ? t1 + 15.0f : t1;
+                    float t8 = (std::floor((-t2 + t6) * 0.5f + 0.5f) * 2.0f + t2) * 0.5f;
+
+                    t6 *= 0.333333f;
+                    t7 *= 0.066667f;
+
+                    const float t9 = t8 + t6 + t7;
+                    float t10 = t9 * 0.333333f;
+
+                    t6 *= 2.0f * pi;
+                    t7 *= 2.0f * pi;
+                    t8 *= 2.0f * pi;
+
+                    const float t8_new = t7 * 0.826977f - t8 * 0.110264f;
+                    const float t6_new = t8 * 0.551318f - t6 * 0.826977f;
+                    const float t7_new = t6 * 0.110264f - t7 * 0.551318f;
+                    const float norm = t8_new * t8_new + t6_new * t6_new + t7_new * t7_new;
+
+                    t10 *= t9 >= 0.0f ? 1.0f : 0.0f;
+
+                    float ir_x = 0 < ab_confidence_slope ? ir_min : ir_max;
+                    ir_x = std::log(ir_x);
+                    ir_x = (ir_x * ab_confidence_slope * 0.301030f + ab_confidence_offset) * 3.321928f;
+                    ir_x = std::exp(ir_x);
+                    ir_x = std::min(max_dealias_confidence, std::max(min_dealias_confidence, ir_x));
+                    ir_x *= ir_x;
+
+                    phase = ir_x >= norm ? t10 : 0.0f;
+                }
+
+                const float z_multiplier = z_table[pixel];
+                float x_multiplier = x_table[pixel];
+                phase = 0 < phase ? phase + phase_offset : phase;
+
+                const float depth_linear = z_multiplier * phase;
+                const float max_depth = phase * unambigious_dist * 2;
+                const bool fit = 0 < depth_linear && 0 < max_depth;
+
+                x_multiplier = x_multiplier * 90 / (max_depth * max_depth * 8192.0);
+                float depth_fit = depth_linear / (-depth_linear * x_multiplier + 1);
+                depth_fit = depth_fit < 0 ? 0 : depth_fit;
+                const float raw_depth = fit ? depth_fit : depth_linear;
+
+                if(ir != nullptr)
+                    ir[output_row + x] = std::min(ir_sum * 0.3333333f * ab_output_multiplier, 65535.0f);
+
+                if(config.edge_aware_filter)
+                {
+                    const bool edge_test = !config.bilateral_filter || max_edge_test[pixel] != 0;
+                    float* sums = &depth_ir_sum[3 * pixel];
+                    sums[0] = raw_depth;
+                    sums[1] = edge_test ? ir_sum : raw_depth;
+                    sums[2] = edge_test ? raw_depth : 0.0f;
+                }
+                else if(depth != nullptr)
+                    depth[output_row + x] = raw_depth;
+            }
+        }
+    }
+
+    void depth_decoder::filterEdges(const std::size_t first_row, const std::size_t last_row, float* depth) const
+    {
+        using namespace parameters;
+
+        for(std::size_t y = first_row; y < last_row; ++y)
+        {
+            const std::size_t output_row = (height - 1 - y) * width;
+            for(std::size_t x = 0; x < width; ++x)
+            {
+                const std::size_t pixel = y * width + x;
+                const float raw_depth = depth_ir_sum[3 * pixel];
+                const float ir_sum = depth_ir_sum[3 * pixel + 1];
+                float& out = depth[output_row + x];
+
+                if(raw_depth < config.min_depth || raw_depth > config.max_depth)
+                {
+                    out = 0.0f;
+                    continue;
+                }
+                if(x < 1 || y < 1 || x > width - 2 || y > height - 2)
+                {
+                    out = raw_depth;
+                    continue;
+                }
+
+                float ir_sum_acc = ir_sum, squared_ir_sum_acc = ir_sum * ir_sum;
+                float min_depth = raw_depth, max_depth = raw_depth;
+                for(int yi = -1; yi < 2; ++yi)
+                {
+                    for(int xi = -1; xi < 2; ++xi)
+                    {
+                        if(yi == 0 && xi == 0)
+                            continue;
+
+                        const float* other = &depth_ir_sum[3 * ((y + yi) * width + x + xi)];
+                        ir_sum_acc += other[1];
+                        squared_ir_sum_acc += other[1] * other[1];
+                        if(0.0f < other[2])
+                        {
+                            min_depth = std::min(min_depth, other[2]);
+                            max_depth = std::max(max_depth, other[2]);
+                        }
+                    }
+                }
+
+                float deviation = std::sqrt(squared_ir_sum_acc * 9.0f - ir_sum_acc * ir_sum_acc) / 9.0f;
+                deviation /= std::max(ir_sum_acc / 9.0f, edge_ab_avg_min_value);
+
+                const float abs_min_diff = std::abs(raw_depth - min_depth);
+                const float abs_max_diff = std::abs(raw_depth - max_depth);
+                const float avg_diff = (abs_min_diff + abs_max_diff) * 0.5f;
+                const float max_abs_diff = std::max(abs_min_diff, abs_max_diff);
+
+                const bool flying_pixel = 0.0f < raw_depth
+                                          && deviation >= edge_ab_std_dev_threshold
+                                          && edge_close_delta_threshold < abs_min_diff
+                                          && edge_far_delta_threshold < abs_max_diff
+                                          && edge_max_delta_threshold < max_abs_diff
+                                          && edge_avg_delta_threshold < avg_diff;
+
+                if(flying_pixel)
+                    out = 0.0f;
+                else
+                    out = !config.bilateral_filter || max_edge_test[pixel] != 0 ? raw_depth : 0.0f;
+            }
+        }
+    }
+}
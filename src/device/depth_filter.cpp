@@ -0,0 +1,315 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/depth_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#ifdef VISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace vision
+{
+    namespace
+    {
+        /// Compare-exchange network leaving the median of nine values in element 4 (Paeth).
+        constexpr std::pair<int, int> median9_network[] = {
+                {1, 2}, {4, 5}, {7, 8}, {0, 1}, {3, 4}, {6, 7}, {1, 2}, {4, 5}, {7, 8}, {0, 3},
+                {5, 8}, {4, 7}, {3, 6}, {1, 4}, {2, 5}, {4, 7}, {4, 2}, {6, 4}, {4, 2}};
+
+        // The kernels below mirror each other operation for operation, so they agree to the bit.
+
+        void scalarRange(float* depth, const std::size_t begin, const std::size_t end, const float min_depth,
+                         const float max_depth)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+                depth[i] = depth[i] >= min_depth && depth[i] <= max_depth ? depth[i] : 0.0f;
+        }
+
+        float scalarFlying(const float* source, const std::size_t i, const std::size_t width, const float max_jump,
+                           const int min_jumps)
+        {
+            const float center = source[i];
+            if(!(center > 0.0f))
+                return 0.0f;
+            const float limit = center * max_jump;
+            int jumps = 0;
+            for(const float neighbor : {source[i - 1], source[i + 1], source[i - width], source[i + width]})
+                jumps += neighbor > 0.0f && std::fabs(center - neighbor) > limit ? 1 : 0;
+            return jumps >= min_jumps ? 0.0f : center;
+        }
+
+        float scalarMedian(const float* source, const std::size_t i, const std::size_t width)
+        {
+            const float center = source[i];
+            if(!(center > 0.0f))
+                return 0.0f;
+            float p[9];
+            int n = 0;
+            for(const std::size_t row : {i - width, i, i + width})
+                for(const std::size_t column : {row - 1, row, row + 1})
+                {
+                    const float value = source[column];
+                    p[n++] = value > 0.0f ? value : center;
+                }
+            for(const auto& [a, b] : median9_network)
+            {
+                const float low = p[a] < p[b] ? p[a] : p[b];
+                const float high = p[a] > p[b] ? p[a] : p[b];
+                p[a] = low;
+                p[b] = high;
+            }
+            return p[4];
+        }
+
+        void scalarTemporal(float* depth, float* history, const std::size_t begin, const std::size_t end,
+                            const float alpha, const float max_delta)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                const float current = depth[i], previous = history[i];
+                const float delta = current - previous;
+                float out = previous > 0.0f && std::fabs(delta) <= max_delta ? previous + alpha * delta : current;
+                out = current > 0.0f ? out : 0.0f;
+                depth[i] = out;
+                history[i] = out;
+            }
+        }
+
+#ifdef VISION_X86_KERNELS
+        __attribute__((target("avx2")))
+        inline __m256 absPs(const __m256 v)
+        {
+            return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2Range(float* depth, const std::size_t size, const float min_depth, const float max_depth)
+        {
+            const __m256 low = _mm256_set1_ps(min_depth), high = _mm256_set1_ps(max_depth);
+            std::size_t i = 0;
+            for(; i + 8 <= size; i += 8)
+            {
+                const __m256 d = _mm256_loadu_ps(depth + i);
+                const __m256 keep = _mm256_and_ps(_mm256_cmp_ps(d, low, _CMP_GE_OQ), _mm256_cmp_ps(d, high, _CMP_LE_OQ));
+                _mm256_storeu_ps(depth + i, _mm256_and_ps(d, keep));
+            }
+            scalarRange(depth, i, size, min_depth, max_depth);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2FlyingRow(const float* source, float* out, const std::size_t row, const std::size_t width,
+                           const float max_jump, const int min_jumps)
+        {
+            const __m256 zero = _mm256_setzero_ps(), jump = _mm256_set1_ps(max_jump);
+            const __m256i needed = _mm256_set1_epi32(min_jumps);
+            std::size_t c = 1;
+            for(; c + 8 <= width - 1; c += 8)
+            {
+                const std::size_t i = row * width + c;
+                const __m256 center = _mm256_loadu_ps(source + i);
+                const __m256 limit = _mm256_mul_ps(center, jump);
+                __m256i jumps = _mm256_setzero_si256();
+                for(const float* neighbor : {source + i - 1, source + i + 1, source + i - width, source + i + width})
+                {
+                    const __m256 n = _mm256_loadu_ps(neighbor);
+                    const __m256 jumped = _mm256_and_ps(_mm256_cmp_ps(n, zero, _CMP_GT_OQ),
+                                                        _mm256_cmp_ps(absPs(_mm256_sub_ps(center, n)), limit, _CMP_GT_OQ));
+                    jumps = _mm256_sub_epi32(jumps, _mm256_castps_si256(jumped));
+                }
+                const __m256 few_jumps = _mm256_castsi256_ps(_mm256_cmpgt_epi32(needed, jumps));
+                const __m256 keep = _mm256_and_ps(_mm256_cmp_ps(center, zero, _CMP_GT_OQ), few_jumps);
+                _mm256_storeu_ps(out + i, _mm256_and_ps(center, keep));
+            }
+            for(; c < width - 1; ++c)
+                out[row * width + c] = scalarFlying(source, row * width + c, width, max_jump, min_jumps);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2MedianRow(const float* source, float* out, const std::size_t row, const std::size_t width)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            std::size_t c = 1;
+            for(; c + 8 <= width - 1; c += 8)
+            {
+                const std::size_t i = row * width + c;
+                const __m256 center = _mm256_loadu_ps(source + i);
+                __m256 p[9];
+                int n = 0;
+                for(const std::size_t line : {i - width, i, i + width})
+                    for(const std::size_t column : {line - 1, line, line + 1})
+                    {
+                        const __m256 value = _mm256_loadu_ps(source + column);
+                        p[n++] = _mm256_blendv_ps(center, value, _mm256_cmp_ps(value, zero, _CMP_GT_OQ));
+                    }
+                for(const auto& [a, b] : median9_network)
+                {
+                    const __m256 low = _mm256_min_ps(p[a], p[b]);
+                    const __m256 high = _mm256_max_ps(p[a], p[b]);
+                    p[a] = low;
+                    p[b] = high;
+                }
+                _mm256_storeu_ps(out + i, _mm256_and_ps(p[4], _mm256_cmp_ps(center, zero, _CMP_GT_OQ)));
+            }
+            for(; c < width - 1; ++c)
+                out[row * width + c] = scalarMedian(source, row * width + c, width);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2Temporal(float* depth, float* history, const std::size_t size, const float alpha,
+                          const float max_delta)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 weight = _mm256_set1_ps(alpha), limit = _mm256_set1_ps(max_delta);
+            std::size_t i = 0;
+            for(; i + 8 <= size; i += 8)
+            {
+                const __m256 current = _mm256_loadu_ps(depth + i);
+                const __m256 previous = _mm256_loadu_ps(history + i);
+                const __m256 delta = _mm256_sub_ps(current, previous);
+                const __m256 blend = _mm256_and_ps(_mm256_cmp_ps(previous, zero, _CMP_GT_OQ),
+                                                   _mm256_cmp_ps(absPs(delta), limit, _CMP_LE_OQ));
+                __m256 out = _mm256_blendv_ps(current, _mm256_add_ps(previous, _mm256_mul_ps(weight, delta)), blend);
+                out = _mm256_and_ps(out, _mm256_cmp_ps(current, zero, _CMP_GT_OQ));
+                _mm256_storeu_ps(depth + i, out);
+                _mm256_storeu_ps(history + i, out);
+            }
+            scalarTemporal(depth, history, i, size, alpha, max_delta);
+        }
+#endif
+    }
+
+    depth_filter::depth_filter(const kernel requested)
+    {
+        active_kernel = resolveKernel(requested);
+    }
+
+    range_filter::range_filter(const float min_depth, const float max_depth, const kernel requested)
+        : depth_filter(requested), min_depth(min_depth), max_depth(max_depth)
+    {
+    }
+
+    void range_filter::apply(float* depth, const std::size_t width, const std::size_t height)
+    {
+#ifdef VISION_X86_KERNELS
+        if(active_kernel == kernel::AVX2)
+        {
+            avx2Range(depth, width * height, min_depth, max_depth);
+            return;
+        }
+#endif
+        scalarRange(depth, 0, width * height, min_depth, max_depth);
+    }
+
+    flying_pixel_filter::flying_pixel_filter(const float max_jump, const int min_jumps, const kernel requested)
+        : depth_filter(requested), max_jump(max_jump), min_jumps(min_jumps)
+    {
+    }
+
+    void flying_pixel_filter::apply(float* depth, const std::size_t width, const std::size_t height)
+    {
+        if(width < 3 || height < 3)
+            return;
+        source.assign(depth, depth + width * height);
+        for(std::size_t row = 1; row + 1 < height; ++row)
+        {
+#ifdef VISION_X86_KERNELS
+            if(active_kernel == kernel::AVX2)
+            {
+                avx2FlyingRow(source.data(), depth, row, width, max_jump, min_jumps);
+                continue;
+            }
+#endif
+            for(std::size_t c = 1; c + 1 < width; ++c)
+                depth[row * width + c] = scalarFlying(source.data(), row * width + c, width, max_jump, min_jumps);
+        }
+    }
+
+    median_filter::median_filter(const kernel requested)
+        : depth_filter(requested)
+    {
+    }
+
+    void median_filter::apply(float* depth, const std::size_t width, const std::size_t height)
+    {
+        if(width < 3 || height < 3)
+            return;
+        source.assign(depth, depth + width * height);
+        for(std::size_t row = 1; row + 1 < height; ++row)
+        {
+#ifdef VISION_X86_KERNELS
+            if(active_kernel == kernel::AVX2)
+            {
+                avx2MedianRow(source.data(), depth, row, width);
+                continue;
+            }
+#endif
+            for(std::size_t c = 1; c + 1 < width; ++c)
+                depth[row * width + c] = scalarMedian(source.data(), row * width + c, width);
+        }
+    }
+
+    temporal_filter::temporal_filter(const float alpha, const float max_delta, const kernel requested)
+        : depth_filter(requested), alpha(alpha), max_delta(max_delta)
+    {
+    }
+
+    void temporal_filter::apply(float* depth, const std::size_t width, const std::size_t height)
+    {
+        // A new frame size starts a new history.
+        if(history.size() != width * height)
+            history.assign(width * height, 0.0f);
+#ifdef VISION_X86_KERNELS
+        if(active_kernel == kernel::AVX2)
+        {
+            avx2Temporal(depth, history.data(), history.size(), alpha, max_delta);
+            return;
+        }
+#endif
+        scalarTemporal(depth, history.data(), 0, history.size(), alpha, max_delta);
+    }
+
+    void temporal_filter::reset()
+    {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+
+    depth_filter_chain::depth_filter_chain(const depth_filter_config& config)
+    {
+        if(config.range)
+            add(std::make_unique<range_filter>(config.min_depth, config.max_depth, config.kernel));
+        if(config.flying_pixels)
+            add(std::make_unique<flying_pixel_filter>(config.max_jump, config.min_jumps, config.kernel));
+        if(config.median)
+            add(std::make_unique<median_filter>(config.kernel));
+        if(config.temporal)
+            add(std::make_unique<temporal_filter>(config.alpha, config.max_delta, config.kernel));
+    }
+
+    void depth_filter_chain::add(std::unique_ptr<depth_filter> filter)
+    {
+        filters.push_back(std::move(filter));
+    }
+
+    Result depth_filter_chain::apply(libfreenect2::Frame& frame)
+    {
+        if(frame.data == nullptr || frame.width == 0 || frame.height == 0)
+            return {Status::EmptyData, "Depth frame is empty."};
+        if(frame.bytes_per_pixel != sizeof(float))
+            return {Status::InvalidParam, "Depth frame is not a float frame."};
+        auto* depth = reinterpret_cast<float*>(frame.data);
+        for(const auto& filter : filters)
+            filter->apply(depth, frame.width, frame.height);
+        return Result(Status::Success);
+    }
+
+    void depth_filter_chain::reset()
+    {
+        for(const auto& filter : filters)
+            filter->reset();
+    }
+}
@@ -0,0 +1,188 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/device_capture.h"
+
+#include <format>
+#include <pthread.h>
+#include <sched.h>
+#include "logger/console_logger.h"
+
+namespace vision
+{
+    device_capture::device_capture(const int device_id, std::string serial, const capture_config& config,
+                                   frame_scheduler& scheduler)
+        : device_id(device_id),
+          serial(std::move(serial)),
+          config(config),
+          scheduler(scheduler),
+          tracer(std::make_shared<latency_tracer>(device_id, config.latency)),
+          pool(frame_pool::create(config.pool)),
+          listener(std::make_unique<frame_listener>(pool)),
+          depth_filters(config.depth_filters)
+    {
+        pool->setTracer(tracer);
+    }
+
+    device_capture::~device_capture()
+    {
+        stop();
+    }
+
+    bool device_capture::pinThread() const
+    {
+        if(config.cpu < 0)
+            return true;
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(config.cpu, &cpu_set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+
+    bool device_capture::start(device_opener opener, std::mutex& open_mutex)
+    {
+        if(thread.joinable())
+            return kinect2 != nullptr;
+
+        source = scheduler.attach(device_id);
+        running.store(true, std::memory_order_release);
+
+        std::promise<bool> opened;
+        std::future<bool> result = opened.get_future();
+        thread = std::thread([this, opener = std::move(opener), &open_mutex, opened = std::move(opened)]() mutable {
+            run(opener, open_mutex, std::move(opened));
+        });
+
+        if(result.get())
+            return true;
+
+        thread.join();
+        running.store(false, std::memory_order_release);
+        scheduler.detach(device_id);
+        source = nullptr;
+        return false;
+    }
+
+    void device_capture::run(const device_opener& opener, std::mutex& open_mutex, std::promise<bool> opened)
+    {
+        pthread_setname_np(pthread_self(), std::format("capture-{}", device_id).substr(0, 15).c_str());
+        // The decoding workers are started before pinning, so without decode_cpus they keep
+        // the affinity of the process instead of sharing the one capture core.
+        if((config.decode_threads > 0 || config.compressed_color) && decoder == nullptr)
+        {
+            decoder = std::make_unique<depth_decoder>(depth_decoder_config{config.decode_threads, config.decode_cpus});
+            listener->setDepthDecoder(decoder.get());
+        }
+        if(!pinThread())
+            ConsoleLogger::getInstance()->warning("Capture thread of device {} could not be pinned to CPU {}.",
+                                                  device_id, config.cpu);
+
+        {
+            // The pipeline starts its decoding threads in its constructor, so opening the
+            // device here makes them inherit the affinity of this thread.
+            std::lock_guard lock(open_mutex);
+            kinect2 = opener(decoder.get());
+        }
+        if(kinect2 == nullptr)
+        {
+            opened.set_value(false);
+            return;
+        }
+        kinect2->setColorFrameListener(listener.get());
+        kinect2->setIrAndDepthFrameListener(listener.get());
+        opened.set_value(true);
+
+        while(running.load(std::memory_order_acquire))
+        {
+            const std::uint32_t seen = listener->getSignal();
+            bool delivered = false;
+            for(const auto type : {libfreenect2::Frame::Depth, libfreenect2::Frame::Ir, libfreenect2::Frame::Color})
+            {
+                while(frame_handle frame = listener->popFrame(type))
+                {
+                    // Nothing else holds the frame yet, so it can be filtered in place.
+                    if(type == libfreenect2::Frame::Depth && !depth_filters.empty())
+                    {
+                        depth_filters.apply(*frame.get());
+                        frame.stamp(latency_stage::Filtered);
+                    }
+                    frame.stamp(latency_stage::Delivered);
+                    source->deliver(frame);
+                    delivered = true;
+                }
+            }
+            if(!delivered)
+                listener->waitForFrame(seen);
+        }
+
+        std::lock_guard lock(open_mutex);
+        kinect2->close();
+        delete kinect2;
+        kinect2 = nullptr;
+    }
+
+    void device_capture::stop()
+    {
+        if(!thread.joinable())
+            return;
+
+        if(kinect2 != nullptr && (rgb_running || depth_running))
+            kinect2->stop();
+        rgb_running = false;
+        depth_running = false;
+
+        running.store(false, std::memory_order_release);
+        listener->wakeConsumer();
+        thread.join();
+
+        listener->clear();
+        scheduler.detach(device_id);
+        source = nullptr;
+    }
+
+    Result device_capture::applyStreams()
+    {
+        if(kinect2 == nullptr)
+            return {Status::Error, "Device is not open!"};
+
+        const bool rgb = listener->isFrameTypeEnabled(libfreenect2::Frame::Color);
+        const bool depth = listener->isFrameTypeEnabled(libfreenect2::Frame::Ir)
+                           || listener->isFrameTypeEnabled(libfreenect2::Frame::Depth);
+
+        // IR and depth share one libfreenect2 stream; toggling one of them is handled by the listener alone.
+        if(rgb == rgb_running && depth == depth_running)
+            return {Status::Success, "Streams unchanged."};
+
+        if((rgb_running || depth_running) && !kinect2->stop())
+            return {Status::Error, "Streams could not be stopped!"};
+        rgb_running = false;
+        depth_running = false;
+
+        if(!rgb && !depth)
+            return {Status::Success, "Streams stopped."};
+
+        if(!kinect2->startStreams(rgb, depth))
+            return {Status::Error, "Streams could not be started!"};
+        rgb_running = rgb;
+        depth_running = depth;
+        return {Status::Success, "Streams started."};
+    }
+
+    Result device_capture::setFrameTypeEnabled(const libfreenect2::Frame::Type type, const bool enabled)
+    {
+        listener->setFrameTypeEnabled(type, enabled);
+        return applyStreams();
+    }
+
+    stream_statistics device_capture::getStatistics() const
+    {
+        return listener->getStatistics();
+    }
+
+    latency_snapshot device_capture::getLatencySnapshot() const
+    {
+        return tracer->snapshot();
+    }
+}
@@ -8,6 +8,8 @@
 #include <format>
 #include "debug/status.h"
 #include "device/device.h"
+#include "device/parallel_packet_pipeline.h"
+#include "libfreenect2/packet_pipeline.h"
 
 namespace vision
 {
@@ -16,11 +18,15 @@ namespace vision
 
     device_manager::device_manager()
     {
-        freenect2_device = nullptr;
-        freenect2_pipeline = new libfreenect2::CpuPacketPipeline();
-
-        auto _devices = enumerateDevices();
-        devices.assign(_devices.begin(), _devices.end());
+        if(const Result result = registry.start(); result.status != Status::Success)
+            console_logger->warning("Device enumeration is not refreshed in the background: {}", result.message);
+        syncDevices();
+
+        const std::string extrinsics_path = extrinsics_store::defaultPath();
+        if(const Result result = extrinsics.load(extrinsics_path); result.status == Status::Success)
+            console_logger->info("Loaded the extrinsics of {} devices from {}", extrinsics.size(), extrinsics_path);
+        else if(result.status != Status::NotFound)
+            console_logger->warning("Extrinsics not loaded: {}", result.message);
     }
 
     device_manager* device_manager::getInstance()
@@ -32,22 +38,64 @@ namespace vision
 
     int device_manager::availableDeviceCount()
     {
-        return freenect2.enumerateDevices();
+        return static_cast<int>(registry.size() + virtual_devices.size());
+    }
+
+    std::vector<registry_entry> device_manager::scanDevices()
+    {
+        // libfreenect2 enumerates on the same USB context devices are opened on.
+        std::lock_guard lock(open_mutex);
+        std::vector<registry_entry> entries;
+        const int device_count = freenect2.enumerateDevices();
+        for (int i = 0; i < device_count; ++i)
+        {
+            entries.push_back({i, freenect2.getDeviceSerialNumber(i)});
+        }
+        return entries;
+    }
+
+    void device_manager::syncDevices()
+    {
+        const std::uint64_t version = registry.getVersion();
+        if(version == devices_version && !devices.empty())
+            return;
+
+        devices = enumerateDevices();
+        devices_version = version;
+        for(auto& _device : devices)
+        {
+            if(const device_capture* capture = getCapture(_device.getIdx()))
+            {
+                _device.setKinect2(capture->getKinect2());
+                _device.setOpen(true);
+            }
+        }
     }
 
     std::vector<device> device_manager::enumerateDevices()
     {
         std::vector<device> _devices;
-        int device_count = availableDeviceCount();
-        if (device_count == 0)
-            return _devices;
-        for (int i = 0; i < device_count; ++i)
+        for (const registry_entry& entry : registry.entries())
         {
-            _devices.emplace_back(i,freenect2.getDeviceSerialNumber(i));
+            _devices.emplace_back(entry.index, entry.serial);
+        }
+        for (const auto& [device_id, config] : virtual_devices)
+        {
+            _devices.emplace_back(device_id, config.serial, "virtual");
         }
         return _devices;
     }
 
+    std::string device_manager::getDeviceSerial(const int device_id)
+    {
+        const auto it = virtual_devices.find(device_id);
+        if(it != virtual_devices.end())
+            return it->second.serial;
+        std::string serial;
+        registry.getSerial(device_id, serial);
+        return serial;
+    }
+
     bool device_manager::deviceListIsEmpty() const
     {
         return devices.empty();
@@ -55,22 +103,16 @@ namespace vision
 
     std::vector<device> device_manager::getDeviceList()
     {
-        auto _devices = enumerateDevices();
-        devices.assign(_devices.begin(), _devices.end());
+        syncDevices();
         return devices;
     }
 
     Result device_manager::refreshDeviceList()
     {
-        const auto _devices = enumerateDevices();
-        if(_devices.empty())
-        {
-            devices.clear();
+        registry.refresh();
+        syncDevices();
+        if(devices.empty())
             return {Status::EmptyData,"No devices found!"};
-        }
-
-        devices.clear();
-        devices.assign(_devices.begin(), _devices.end());
         return {Status::Success,"List refreshed."};
     }
 
@@ -82,9 +124,7 @@ namespace vision
         console_logger->log(logger::Info, "Listing devices...");
         for(const auto& device : devices)
         {
-            console_logger->log(
-                    logger::Info,
-                    std::format("{},{}",device.getIdx(),device.getNickName()));
+            console_logger->info("{},{}",device.getIdx(),device.getNickName());
         }
         return Result(Status::Success);
     }
@@ -107,13 +147,7 @@ namespace vision
 
     std::optional<device> device_manager::getDevice(const int device_id)
     {
-        if(!availableDeviceCount())
-        {
-            refreshDeviceList();
-            if(!checkDevice(device_id) || deviceListIsEmpty())
-                return std::nullopt;
-        }
-
+        syncDevices();
         for(auto& device : devices)
         {
             if(device.getIdx() == device_id)
@@ -179,23 +213,343 @@ namespace vision
 
     bool device_manager::checkDevice(const int device_id)
     {
-        return !freenect2.getDeviceSerialNumber(device_id).empty();
+        return !getDeviceSerial(device_id).empty();
     }
 
     bool device_manager::startDevice(const int device_id) {
+        if(getCapture(device_id) != nullptr)
+            return true;
         if(!checkDevice(device_id))
             return false;
 
-         auto device = freenect2.openDevice(device_id);
-         if(device == nullptr){
+        const auto config_it = capture_configs.find(device_id);
+        const capture_config config = config_it != capture_configs.end() ? config_it->second : capture_config{};
+        const std::string serial = getDeviceSerial(device_id);
+        device_opener opener;
+        if(const auto it = virtual_devices.find(device_id); it != virtual_devices.end())
+            opener = [virtual_config = it->second](depth_decoder*) { return virtual_device::open(virtual_config); };
+        else
+            opener = [this, serial, compressed_color = config.compressed_color](depth_decoder* decoder) {
+                libfreenect2::PacketPipeline* pipeline = decoder != nullptr
+                        ? static_cast<libfreenect2::PacketPipeline*>(new parallel_packet_pipeline(*decoder, compressed_color))
+                        : new libfreenect2::CpuPacketPipeline();
+                return freenect2.openDevice(serial, pipeline);
+            };
+
+        auto capture = std::make_unique<device_capture>(device_id, serial, config, scheduler);
+        if(!capture->start(std::move(opener), open_mutex))
+        {
+            console_logger->error("Device {} could not be opened!", device_id);
+            return false;
+        }
+
+        for(auto& _device : devices)
+        {
+            if(_device.getIdx() != device_id)
+                continue;
+            _device.setKinect2(capture->getKinect2());
+            _device.setOpen(true);
+        }
+        captures.emplace(device_id, std::move(capture));
+        return true;
+    }
+
+    bool device_manager::stopDevice(const int device_id)
+    {
+        const auto it = captures.find(device_id);
+        if(it == captures.end())
             return false;
-         }
 
+        captures.erase(it);
+        for(auto& _device : devices)
+        {
+            if(_device.getIdx() != device_id)
+                continue;
+            _device.setKinect2(nullptr);
+            _device.setOpen(false);
+        }
         return true;
+    }
+
+    Result device_manager::startSelectedDevices()
+    {
+        if(selectedListIsEmpty())
+            return {Status::EmptyData, "No device selected!"};
+
+        std::string failed;
+        for(const auto& _device : selected_devices)
+        {
+            if(!startDevice(_device.getIdx()))
+                failed += failed.empty() ? std::to_string(_device.getIdx()) : "," + std::to_string(_device.getIdx());
+        }
+        if(!failed.empty())
+            return {Status::Error, std::format("Devices could not be started: {}", failed)};
+        return {Status::Success, "Selected devices started."};
+    }
 
+    void device_manager::stopAllDevices()
+    {
+        while(!captures.empty())
+            stopDevice(captures.begin()->first);
     }
 
+    void device_manager::setCaptureConfig(const int device_id, const capture_config& config)
+    {
+        capture_configs[device_id] = config;
+    }
 
+    device_registry& device_manager::getDeviceRegistry()
+    {
+        return registry;
+    }
 
+    frame_scheduler& device_manager::getScheduler()
+    {
+        return scheduler;
+    }
 
+    frame_bus& device_manager::getBus()
+    {
+        return bus;
+    }
+
+    extrinsics_store& device_manager::getExtrinsics()
+    {
+        return extrinsics;
+    }
+
+    std::optional<pose> device_manager::getDevicePose(const int device_id)
+    {
+        const std::optional<device> _device = getDevice(device_id);
+        if(!_device)
+            return std::nullopt;
+        return extrinsics.find(_device->getSerial());
+    }
+
+    device_capture* device_manager::getCapture(const int device_id)
+    {
+        const auto it = captures.find(device_id);
+        return it != captures.end() ? it->second.get() : nullptr;
+    }
+
+    Result device_manager::setStreamEnabled(const int device_id, const libfreenect2::Frame::Type type,
+                                            const bool enabled)
+    {
+        if(enabled && !startDevice(device_id))
+            return {Status::Error, "Device could not be opened!"};
+
+        device_capture* capture = getCapture(device_id);
+        if(capture == nullptr)
+            return {Status::NotFound, "Device is not open!"};
+
+        return capture->setFrameTypeEnabled(type, enabled);
+    }
+
+    Result device_manager::startVideoStream(const int device_id)
+    {
+        return setStreamEnabled(device_id, libfreenect2::Frame::Color, true);
+    }
+
+    Result device_manager::stopVideoStream(const int device_id)
+    {
+        return setStreamEnabled(device_id, libfreenect2::Frame::Color, false);
+    }
+
+    Result device_manager::startDepthStream(const int device_id)
+    {
+        return setStreamEnabled(device_id, libfreenect2::Frame::Depth, true);
+    }
+
+    Result device_manager::stopDepthStream(const int device_id)
+    {
+        return setStreamEnabled(device_id, libfreenect2::Frame::Depth, false);
+    }
+
+    Result device_manager::enableIRStream(const int device_id)
+    {
+        return setStreamEnabled(device_id, libfreenect2::Frame::Ir, true);
+    }
+
+    Result device_manager::disableIRStream(const int device_id)
+    {
+        return setStreamEnabled(device_id, libfreenect2::Frame::Ir, false);
+    }
+
+    Result device_manager::captureFrame(const int device_id)
+    {
+        if(getCapture(device_id) == nullptr)
+            return {Status::NotFound, "Device is not open!"};
+
+        captured_frames frames{
+            scheduler.pull(device_id, libfreenect2::Frame::Color),
+            scheduler.pull(device_id, libfreenect2::Frame::Ir),
+            scheduler.pull(device_id, libfreenect2::Frame::Depth)
+        };
+        if(!frames.color && !frames.ir && !frames.depth)
+            return {Status::Pending, "No frame available yet."};
+
+        std::any data = std::move(frames);
+        return {Status::Success, "Frame captured.", data};
+    }
+
+    std::optional<stream_statistics> device_manager::getStreamStatistics(const int device_id) const
+    {
+        const auto it = captures.find(device_id);
+        if(it == captures.end())
+            return std::nullopt;
+        return it->second->getStatistics();
+    }
+
+    std::optional<latency_snapshot> device_manager::getLatencySnapshot(const int device_id) const
+    {
+        const auto it = captures.find(device_id);
+        if(it == captures.end())
+            return std::nullopt;
+        return it->second->getLatencySnapshot();
+    }
+
+    Result device_manager::writeLatencyTrace(const std::string& path) const
+    {
+        std::vector<const latency_tracer*> tracers;
+        for(const auto& [device_id, capture] : captures)
+        {
+            if(capture->getTracer().isTracing())
+                tracers.push_back(&capture->getTracer());
+        }
+        if(tracers.empty())
+            return {Status::NotFound, "No opened device keeps a latency trace!"};
+        return latency_tracer::writeChromeTrace(path, tracers);
+    }
+
+    Result device_manager::startRecording(const std::string& path, const recorder_config& config)
+    {
+        if(recorder)
+            return {Status::Conflict, "A recording is already running!"};
+
+        auto _recorder = std::make_unique<frame_recorder>(config);
+        if(Result result = _recorder->open(path); result.status != Status::Success)
+            return result;
+        if(Result result = _recorder->attach(scheduler); result.status != Status::Success)
+            return result;
+
+        recorder = std::move(_recorder);
+        console_logger->info("Recording to {}", path);
+        return {Status::Success, "Recording started."};
+    }
+
+    Result device_manager::stopRecording()
+    {
+        if(!recorder)
+            return {Status::NotFound, "No recording is running!"};
+
+        Result result = recorder->close();
+        const recorder_statistics statistics = recorder->getStatistics();
+        recorder.reset();
+        console_logger->info("Recording stopped: {} frames written, {} dropped.",
+                             statistics.frames_written, statistics.dropped);
+        return result;
+    }
+
+    std::optional<recorder_statistics> device_manager::getRecordingStatistics() const
+    {
+        if(!recorder)
+            return std::nullopt;
+        return recorder->getStatistics();
+    }
+
+    Result device_manager::startPublishing(const std::string& name, const publisher_config& config)
+    {
+        if(publisher)
+            return {Status::Conflict, "A publisher is already running!"};
+
+        auto _publisher = std::make_unique<shm_publisher>(config);
+        if(Result result = _publisher->open(name); result.status != Status::Success)
+            return result;
+        if(Result result = _publisher->attach(bus); result.status != Status::Success)
+            return result;
+
+        publisher = std::move(_publisher);
+        console_logger->info("Publishing to shared memory {}", name);
+        return {Status::Success, "Publishing started."};
+    }
+
+    Result device_manager::stopPublishing()
+    {
+        if(!publisher)
+            return {Status::NotFound, "No publisher is running!"};
+
+        Result result = publisher->close();
+        const publisher_statistics statistics = publisher->getStatistics();
+        publisher.reset();
+        console_logger->info("Publishing stopped: {} frames published, {} dropped.",
+                             statistics.frames_published, statistics.dropped);
+        return result;
+    }
+
+    std::optional<publisher_statistics> device_manager::getPublisherStatistics() const
+    {
+        if(!publisher)
+            return std::nullopt;
+        return publisher->getStatistics();
+    }
+
+    Result device_manager::startStreaming(const stream_server_config& config)
+    {
+        if(streamer)
+            return {Status::Conflict, "A streaming server is already running!"};
+
+        auto _streamer = std::make_unique<stream_server>(config);
+        if(Result result = _streamer->start(); result.status != Status::Success)
+            return result;
+        if(Result result = _streamer->attach(bus); result.status != Status::Success)
+            return result;
+
+        streamer = std::move(_streamer);
+        console_logger->info("Streaming on {}:{}", config.address, streamer->getPort());
+        return {Status::Success, "Streaming started."};
+    }
+
+    Result device_manager::stopStreaming()
+    {
+        if(!streamer)
+            return {Status::NotFound, "No streaming server is running!"};
+
+        Result result = streamer->stop();
+        const stream_server_statistics statistics = streamer->getStatistics();
+        streamer.reset();
+        console_logger->info("Streaming stopped: {} frames sent, {} dropped.",
+                             statistics.frames_sent, statistics.dropped);
+        return result;
+    }
+
+    std::optional<stream_server_statistics> device_manager::getStreamingStatistics() const
+    {
+        if(!streamer)
+            return std::nullopt;
+        return streamer->getStatistics();
+    }
+
+    std::uint16_t device_manager::getStreamingPort() const
+    {
+        return streamer ? streamer->getPort() : 0;
+    }
+
+    int device_manager::addVirtualDevice(const virtual_device_config& config)
+    {
+        const int device_id = next_virtual_id++;
+        virtual_devices.emplace(device_id, config);
+        devices.emplace_back(device_id, config.serial, "virtual");
+        return device_id;
+    }
+
+    bool device_manager::removeVirtualDevice(const int device_id)
+    {
+        if(virtual_devices.erase(device_id) == 0)
+            return false;
+
+        stopDevice(device_id);
+        std::erase_if(devices, [device_id](const device& _device) { return _device.getIdx() == device_id; });
+        std::erase_if(selected_devices, [device_id](const device& _device) { return _device.getIdx() == device_id; });
+        return true;
+    }
 }
@@ -0,0 +1,243 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/device_registry.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Builds a table from a scan, ordered by index.
+         */
+        std::unique_ptr<device_table> makeTable(std::vector<registry_entry> entries, const std::uint64_t version)
+        {
+            auto table = std::make_unique<device_table>();
+            std::ranges::sort(entries, {}, &registry_entry::index);
+            table->version = version;
+            table->entries = std::move(entries);
+            table->by_serial.reserve(table->entries.size());
+            for(std::size_t i = 0; i < table->entries.size(); ++i)
+                table->by_serial.emplace(table->entries[i].serial, i);
+            return table;
+        }
+
+        /**
+         * @brief Waits for a descriptor to become readable; returns false on timeout.
+         */
+        bool waitReadable(const int fd, const std::chrono::milliseconds timeout)
+        {
+            pollfd request{fd, POLLIN, 0};
+            int ready;
+            do
+                ready = poll(&request, 1, static_cast<int>(timeout.count()));
+            while(ready < 0 && errno == EINTR);
+            return ready > 0;
+        }
+    }
+
+    const registry_entry* device_table::find(const int index) const
+    {
+        const auto it = std::ranges::lower_bound(entries, index, {}, &registry_entry::index);
+        return it != entries.end() && it->index == index ? &*it : nullptr;
+    }
+
+    const registry_entry* device_table::findSerial(const std::string& serial) const
+    {
+        const auto it = by_serial.find(serial);
+        return it != by_serial.end() ? &entries[it->second] : nullptr;
+    }
+
+    device_registry::device_registry(scanner scan, const registry_config& config)
+        : scan(std::move(scan)),
+          config(config)
+    {
+        current.store(new device_table(), std::memory_order_release);
+    }
+
+    device_registry::~device_registry()
+    {
+        stop();
+        delete current.load(std::memory_order_acquire);
+    }
+
+    Result device_registry::start()
+    {
+        if(isRunning())
+            return {Status::Conflict, "Registry is already running!"};
+
+        refresh();
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(wake_fd < 0)
+            return {Status::Error, std::format("Registry thread could not be woken: {}", std::strerror(errno))};
+        // Watching before the thread starts catches a device plugged right after start() returns.
+        inotify_fd = watchBus();
+        watcher = std::thread(&device_registry::run, this);
+        return {Status::Success, "Registry started."};
+    }
+
+    void device_registry::stop()
+    {
+        if(!isRunning())
+            return;
+
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(wake_fd, &one, sizeof(one));
+        watcher.join();
+        for(int* fd : {&wake_fd, &inotify_fd})
+        {
+            if(*fd >= 0)
+                ::close(*fd);
+            *fd = -1;
+        }
+    }
+
+    int device_registry::watchBus() const
+    {
+        if(!config.watch_hotplug)
+            return -1;
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(fd < 0)
+            return -1;
+        // Device nodes live in one directory per bus; a new bus directory is watched on the next event.
+        if(inotify_add_watch(fd, config.usb_path.c_str(), IN_CREATE | IN_DELETE | IN_ONLYDIR) < 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        std::error_code error;
+        for(const auto& bus : std::filesystem::directory_iterator(config.usb_path, error))
+            if(bus.is_directory(error))
+                inotify_add_watch(fd, bus.path().c_str(), IN_CREATE | IN_DELETE | IN_ONLYDIR);
+        return fd;
+    }
+
+    void device_registry::run()
+    {
+        for(;;)
+        {
+            pollfd requests[2] = {{wake_fd, POLLIN, 0}, {inotify_fd, POLLIN, 0}};
+            const int ready = poll(requests, inotify_fd >= 0 ? 2 : 1, static_cast<int>(config.refresh_interval.count()));
+            if(ready < 0 && errno != EINTR)
+                break;
+            if(requests[0].revents != 0)
+                break;
+
+            if(requests[1].revents != 0)
+            {
+                // A plug creates several nodes in a burst; they are drained until the bus settles.
+                alignas(inotify_event) char events[4096];
+                do
+                    while(::read(inotify_fd, events, sizeof(events)) > 0) {}
+                while(waitReadable(inotify_fd, config.settle_time) && !waitReadable(wake_fd, std::chrono::milliseconds(0)));
+                if(waitReadable(wake_fd, std::chrono::milliseconds(0)))
+                    break;
+                ::close(inotify_fd);
+                inotify_fd = watchBus();
+            }
+            refresh();
+        }
+    }
+
+    Result device_registry::refresh()
+    {
+        std::lock_guard lock(refresh_mutex);
+        std::vector<registry_entry> found = scan();
+        scans.fetch_add(1, std::memory_order_relaxed);
+
+        const device_table* previous = current.load(std::memory_order_acquire);
+        std::unique_ptr<device_table> table = makeTable(std::move(found), previous->version + 1);
+        if(table->entries == previous->entries)
+            return {Status::Unsuccess, "Devices unchanged."};
+
+        std::vector<device_event> events;
+        for(const registry_entry& entry : previous->entries)
+            if(table->findSerial(entry.serial) == nullptr)
+                events.push_back({device_event_type::Removed, entry, table->version});
+        for(const registry_entry& entry : table->entries)
+        {
+            const registry_entry* old = previous->findSerial(entry.serial);
+            if(old == nullptr)
+                events.push_back({device_event_type::Added, entry, table->version});
+            else if(old->index != entry.index)
+                events.push_back({device_event_type::Reindexed, entry, table->version});
+        }
+
+        // A reader that counted itself in may still be inside a replaced table; later readers only see the new one.
+        retired.emplace_back(current.exchange(table.release(), std::memory_order_seq_cst));
+        if(readers.load(std::memory_order_seq_cst) == 0)
+            retired.clear();
+
+        std::shared_lock listeners_lock(listeners_mutex);
+        for(const device_event& event : events)
+            for(const auto& [id, callback] : listeners)
+                callback(event);
+        return {Status::Success, std::format("{} device changes.", events.size())};
+    }
+
+    std::vector<registry_entry> device_registry::entries() const
+    {
+        return read([](const device_table& table) { return table.entries; });
+    }
+
+    std::size_t device_registry::size() const
+    {
+        return read([](const device_table& table) { return table.entries.size(); });
+    }
+
+    std::optional<registry_entry> device_registry::find(const int index) const
+    {
+        return read([index](const device_table& table) -> std::optional<registry_entry> {
+            const registry_entry* entry = table.find(index);
+            return entry != nullptr ? std::optional(*entry) : std::nullopt;
+        });
+    }
+
+    std::optional<registry_entry> device_registry::findSerial(const std::string& serial) const
+    {
+        return read([&serial](const device_table& table) -> std::optional<registry_entry> {
+            const registry_entry* entry = table.findSerial(serial);
+            return entry != nullptr ? std::optional(*entry) : std::nullopt;
+        });
+    }
+
+    bool device_registry::getSerial(const int index, std::string& serial) const
+    {
+        return read([index, &serial](const device_table& table) {
+            const registry_entry* entry = table.find(index);
+            if(entry != nullptr)
+                serial = entry->serial;
+            return entry != nullptr;
+        });
+    }
+
+    std::uint64_t device_registry::getVersion() const
+    {
+        return read([](const device_table& table) { return table.version; });
+    }
+
+    int device_registry::subscribe(listener callback)
+    {
+        std::unique_lock lock(listeners_mutex);
+        const int id = next_subscription++;
+        listeners.emplace(id, std::move(callback));
+        return id;
+    }
+
+    bool device_registry::unsubscribe(const int subscription_id)
+    {
+        std::unique_lock lock(listeners_mutex);
+        return listeners.erase(subscription_id) > 0;
+    }
+}
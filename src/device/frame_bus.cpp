@@ -0,0 +1,179 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/frame_bus.h"
+
+#include <algorithm>
+
+namespace vision
+{
+    frame_bus::subscription::subscription(const subscriber_config& config)
+        : config(config),
+          queue(config.policy == backpressure::LatestOnly ? 1 : std::max<std::size_t>(config.queue_depth, 1))
+    {
+    }
+
+    bool frame_bus::subscription::accepts(const scheduled_frame& frame) const
+    {
+        return (config.device_id < 0 || config.device_id == frame.device_id)
+               && (config.types & static_cast<unsigned int>(frame.type)) != 0;
+    }
+
+    void frame_bus::subscription::push(const scheduled_frame& frame)
+    {
+        std::unique_lock lock(mutex);
+        if(closed)
+            return;
+        ++metrics.received;
+
+        if(count == queue.size())
+        {
+            switch (config.policy)
+            {
+                case backpressure::DropOldest:
+                case backpressure::LatestOnly:
+                    queue[head].frame.reset();
+                    head = (head + 1) % queue.size();
+                    --count;
+                    ++metrics.dropped;
+                    break;
+                case backpressure::DropNewest:
+                    ++metrics.dropped;
+                    return;
+                case backpressure::Block:
+                    ++metrics.blocked;
+                    if(!not_full.wait_for(lock, config.block_timeout, [this] { return closed || count < queue.size(); })
+                       || closed)
+                    {
+                        ++metrics.dropped;
+                        return;
+                    }
+                    break;
+            }
+        }
+
+        queue[(head + count) % queue.size()] = frame;
+        ++count;
+        metrics.peak_queued = std::max(metrics.peak_queued, count);
+        lock.unlock();
+        not_empty.notify_one();
+    }
+
+    void frame_bus::subscription::take(scheduled_frame& frame)
+    {
+        frame = std::move(queue[head]);
+        queue[head].frame.reset();
+        head = (head + 1) % queue.size();
+        --count;
+
+        ++metrics.delivered;
+        if(const std::int64_t arrival_ns = frame.frame.arrivalTime(); arrival_ns != 0)
+        {
+            const auto now = std::chrono::steady_clock::now().time_since_epoch();
+            metrics.last_lag_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - arrival_ns;
+            metrics.max_lag_ns = std::max(metrics.max_lag_ns, metrics.last_lag_ns);
+        }
+    }
+
+    void frame_bus::subscription::close()
+    {
+        {
+            std::lock_guard lock(mutex);
+            closed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    bool frame_bus::subscription::pop(scheduled_frame& frame, const std::chrono::nanoseconds timeout)
+    {
+        std::unique_lock lock(mutex);
+        if(!not_empty.wait_for(lock, timeout, [this] { return closed || count > 0; }) || count == 0)
+            return false;
+        take(frame);
+        lock.unlock();
+        not_full.notify_one();
+        return true;
+    }
+
+    bool frame_bus::subscription::tryPop(scheduled_frame& frame)
+    {
+        std::unique_lock lock(mutex);
+        if(count == 0)
+            return false;
+        take(frame);
+        lock.unlock();
+        not_full.notify_one();
+        return true;
+    }
+
+    subscriber_metrics frame_bus::subscription::getMetrics() const
+    {
+        std::lock_guard lock(mutex);
+        subscriber_metrics _metrics = metrics;
+        _metrics.queued = count;
+        return _metrics;
+    }
+
+    bool frame_bus::subscription::isClosed() const
+    {
+        std::lock_guard lock(mutex);
+        return closed;
+    }
+
+    frame_bus::frame_bus(frame_scheduler& scheduler)
+        : scheduler(scheduler),
+          scheduler_subscription(scheduler.subscribe([this](const scheduled_frame& frame) { publish(frame); }))
+    {
+    }
+
+    frame_bus::~frame_bus()
+    {
+        {
+            std::shared_lock lock(subscriptions_mutex);
+            for(const auto& _subscription : subscriptions)
+                _subscription->close();
+        }
+        scheduler.unsubscribe(scheduler_subscription);
+    }
+
+    void frame_bus::publish(const scheduled_frame& frame)
+    {
+        std::shared_lock lock(subscriptions_mutex);
+        for(const auto& _subscription : subscriptions)
+            if(_subscription->accepts(frame))
+                _subscription->push(frame);
+    }
+
+    std::shared_ptr<frame_bus::subscription> frame_bus::subscribe(const subscriber_config& config)
+    {
+        auto _subscription = std::make_shared<subscription>(config);
+        std::unique_lock lock(subscriptions_mutex);
+        subscriptions.push_back(_subscription);
+        return _subscription;
+    }
+
+    bool frame_bus::unsubscribe(const std::shared_ptr<subscription>& subscriber)
+    {
+        {
+            std::shared_lock lock(subscriptions_mutex);
+            if(std::find(subscriptions.begin(), subscriptions.end(), subscriber) == subscriptions.end())
+                return false;
+        }
+        // Close first so a capture thread blocked on this subscriber lets go of the shared lock.
+        subscriber->close();
+        std::unique_lock lock(subscriptions_mutex);
+        const auto it = std::find(subscriptions.begin(), subscriptions.end(), subscriber);
+        if(it == subscriptions.end())
+            return false;
+        subscriptions.erase(it);
+        return true;
+    }
+
+    std::size_t frame_bus::subscriberCount() const
+    {
+        std::shared_lock lock(subscriptions_mutex);
+        return subscriptions.size();
+    }
+}
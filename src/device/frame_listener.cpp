@@ -0,0 +1,217 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/frame_listener.h"
+#include "logger/console_logger.h"
+
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace vision
+{
+    frame_listener::frame_listener(std::shared_ptr<frame_pool> pool)
+        : pool(std::move(pool))
+    {
+    }
+
+    frame_listener::~frame_listener()
+    {
+        clear();
+    }
+
+    frame_listener::ring* frame_listener::getRing(const libfreenect2::Frame::Type type)
+    {
+        switch (type)
+        {
+            case libfreenect2::Frame::Color: return &color_ring;
+            case libfreenect2::Frame::Ir: return &ir_ring;
+            case libfreenect2::Frame::Depth: return &depth_ring;
+            default: return nullptr;
+        }
+    }
+
+    frame_handle frame_listener::acquire(const libfreenect2::Frame::Type type, const std::size_t bytes,
+                                         const std::uint32_t sequence)
+    {
+        frame_handle handle = pool->acquire(type);
+        if(!handle || bytes > handle.capacity())
+        {
+            ConsoleLogger::getInstance()->debug("Frame {} of type {} dropped: no pooled buffer of {} bytes.",
+                                                sequence, static_cast<int>(type), bytes);
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        return handle;
+    }
+
+    void frame_listener::deliver(ring& _ring, frame_handle handle)
+    {
+        received.fetch_add(1, std::memory_order_relaxed);
+        if(const auto evicted = _ring.push(handle.release()))
+        {
+            frame_handle(*evicted).reset();
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        wakeConsumer();
+    }
+
+    bool frame_listener::onNewFrame(const libfreenect2::Frame::Type type, libfreenect2::Frame* frame)
+    {
+        if(decoder != nullptr && frame->format == libfreenect2::Frame::Raw
+           && (type == libfreenect2::Frame::Ir || type == libfreenect2::Frame::Depth))
+        {
+            // The raw IR frame of a DumpPacketPipeline only repeats the camera parameters.
+            if(type == libfreenect2::Frame::Depth)
+                decodeDepthPacket(*frame);
+            return false;
+        }
+
+        ring* _ring = getRing(type);
+        if(_ring == nullptr || !isFrameTypeEnabled(type))
+        {
+            ignored.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const auto arrival = std::chrono::steady_clock::now().time_since_epoch();
+        const std::size_t bytes = frame->width * frame->height * frame->bytes_per_pixel;
+        frame_handle handle = acquire(type, bytes, frame->sequence);
+        if(!handle)
+            return false;
+
+        libfreenect2::Frame& pooled = *handle;
+        pooled.width = frame->width;
+        pooled.height = frame->height;
+        pooled.bytes_per_pixel = frame->bytes_per_pixel;
+        pooled.timestamp = frame->timestamp;
+        pooled.sequence = frame->sequence;
+        pooled.exposure = frame->exposure;
+        pooled.gain = frame->gain;
+        pooled.gamma = frame->gamma;
+        pooled.status = frame->status;
+        pooled.format = frame->format;
+        std::memcpy(pooled.data, frame->data, bytes);
+        handle.setArrivalTime(std::chrono::duration_cast<std::chrono::nanoseconds>(arrival).count());
+        handle.stamp(latency_stage::Decoded);
+
+        deliver(*_ring, std::move(handle));
+        // libfreenect2 keeps its frame and decodes the next one into the same buffer.
+        return false;
+    }
+
+    void frame_listener::decodeDepthPacket(const libfreenect2::Frame& packet)
+    {
+        const bool want_ir = isFrameTypeEnabled(libfreenect2::Frame::Ir);
+        const bool want_depth = isFrameTypeEnabled(libfreenect2::Frame::Depth);
+        if(!want_ir && !want_depth)
+        {
+            ignored.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto arrival = std::chrono::steady_clock::now().time_since_epoch();
+        constexpr std::size_t bytes = depth_decoder::width * depth_decoder::height * sizeof(float);
+        frame_handle ir, depth;
+        if(want_ir && !(ir = acquire(libfreenect2::Frame::Ir, bytes, packet.sequence)))
+            return;
+        if(want_depth && !(depth = acquire(libfreenect2::Frame::Depth, bytes, packet.sequence)))
+            return;
+
+        const Result result = decoder->decode(packet.data, packet.bytes_per_pixel,
+                                              ir ? reinterpret_cast<float*>(ir->data) : nullptr,
+                                              depth ? reinterpret_cast<float*>(depth->data) : nullptr);
+        if(result.status != Status::Success)
+        {
+            ConsoleLogger::getInstance()->debug("Depth packet {} dropped: {}", packet.sequence, result.message);
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const std::int64_t arrival_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(arrival).count();
+        for(frame_handle* handle : {&ir, &depth})
+        {
+            if(!*handle)
+                continue;
+            libfreenect2::Frame& decoded = **handle;
+            decoded.width = depth_decoder::width;
+            decoded.height = depth_decoder::height;
+            decoded.bytes_per_pixel = sizeof(float);
+            decoded.timestamp = packet.timestamp;
+            decoded.sequence = packet.sequence;
+            decoded.exposure = 0;
+            decoded.gain = 0;
+            decoded.gamma = 0;
+            decoded.status = 0;
+            decoded.format = libfreenect2::Frame::Float;
+            handle->setArrivalTime(arrival_ns);
+            handle->stamp(latency_stage::Decoded);
+            ring& _ring = *getRing(handle->type());
+            deliver(_ring, std::move(*handle));
+        }
+    }
+
+    void frame_listener::setDepthDecoder(depth_decoder* decoder)
+    {
+        this->decoder = decoder;
+    }
+
+    void frame_listener::setFrameTypeEnabled(const libfreenect2::Frame::Type type, const bool enabled)
+    {
+        if(enabled)
+            frame_types.fetch_or(type, std::memory_order_acq_rel);
+        else
+            frame_types.fetch_and(~static_cast<unsigned int>(type), std::memory_order_acq_rel);
+    }
+
+    bool frame_listener::isFrameTypeEnabled(const libfreenect2::Frame::Type type) const
+    {
+        return (frame_types.load(std::memory_order_acquire) & type) != 0;
+    }
+
+    frame_handle frame_listener::popFrame(const libfreenect2::Frame::Type type)
+    {
+        ring* _ring = getRing(type);
+        frame_slot* slot = nullptr;
+        if(_ring == nullptr || !_ring->pop(slot))
+            return {};
+        return frame_handle(slot);
+    }
+
+    std::uint32_t frame_listener::getSignal() const
+    {
+        return frame_signal.load(std::memory_order_acquire);
+    }
+
+    void frame_listener::waitForFrame(const std::uint32_t seen) const
+    {
+        frame_signal.wait(seen, std::memory_order_acquire);
+    }
+
+    void frame_listener::wakeConsumer()
+    {
+        // Cheap when the consumer is busy; a futex wake only happens for a parked waiter.
+        frame_signal.fetch_add(1, std::memory_order_release);
+        frame_signal.notify_one();
+    }
+
+    void frame_listener::clear()
+    {
+        for(const auto type : {libfreenect2::Frame::Color, libfreenect2::Frame::Ir, libfreenect2::Frame::Depth})
+        {
+            frame_slot* slot = nullptr;
+            while(getRing(type)->pop(slot))
+                frame_handle(slot).reset();
+        }
+    }
+
+    stream_statistics frame_listener::getStatistics() const
+    {
+        return {
+            received.load(std::memory_order_relaxed),
+            dropped.load(std::memory_order_relaxed),
+            ignored.load(std::memory_order_relaxed)
+        };
+    }
+}
@@ -0,0 +1,103 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/frame_mat.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @class frame_allocator
+         * @brief Ties the UMatData of a frame view to a reference on its pooled slot.
+         *
+         * The slot is stored in UMatData::userdata and released when OpenCV drops the
+         * last Mat and UMat reference. Mats that reallocate (create() with another size)
+         * get ordinary memory from the standard allocator.
+         */
+        class frame_allocator final : public cv::MatAllocator {
+        public:
+            cv::UMatData* allocate(const int dims, const int* sizes, const int type, void* data, size_t* step,
+                                   const cv::AccessFlag flags, const cv::UMatUsageFlags usage_flags) const override
+            {
+                return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usage_flags);
+            }
+
+            bool allocate(cv::UMatData* data, cv::AccessFlag, cv::UMatUsageFlags) const override
+            {
+                return data != nullptr;
+            }
+
+            void deallocate(cv::UMatData* data) const override
+            {
+                if(data == nullptr || data->refcount != 0 || data->urefcount != 0)
+                    return;
+                // Adopt the reference taken in wrap() and drop it.
+                frame_handle(static_cast<frame_slot*>(data->userdata));
+                delete data;
+            }
+
+            /**
+             * @brief Builds the UMatData of a view, taking one reference on the frame.
+             */
+            cv::UMatData* wrap(const frame_handle& frame, const std::size_t bytes) const
+            {
+                auto* data = new cv::UMatData(this);
+                data->data = data->origdata = frame->data;
+                data->size = bytes;
+                data->flags = cv::UMatData::USER_ALLOCATED;
+                data->userdata = frame_handle(frame).release();
+                return data;
+            }
+        };
+
+        frame_allocator allocator; ///< Shared by every frame view; stateless.
+    }
+
+    int toMatType(const libfreenect2::Frame::Format format)
+    {
+        switch (format)
+        {
+            case libfreenect2::Frame::BGRX:
+            case libfreenect2::Frame::RGBX: return CV_8UC4;
+            case libfreenect2::Frame::Float: return CV_32FC1;
+            case libfreenect2::Frame::Gray:
+            case libfreenect2::Frame::Raw: return CV_8UC1;
+            default: return -1;
+        }
+    }
+
+    cv::Mat toMat(const frame_handle& frame)
+    {
+        if(!frame)
+            return {};
+        const int type = toMatType(frame->format);
+        if(type < 0)
+            return {};
+
+        // Raw frames keep their length in bytes_per_pixel; expose them as one row of bytes.
+        const bool raw = frame->format == libfreenect2::Frame::Raw;
+        const std::size_t rows = raw ? 1 : frame->height;
+        const std::size_t cols = raw ? frame->width * frame->height * frame->bytes_per_pixel : frame->width;
+        const std::size_t step = raw ? cols : frame->width * frame->bytes_per_pixel;
+        if(rows == 0 || cols == 0 || (!raw && frame->bytes_per_pixel != static_cast<std::size_t>(CV_ELEM_SIZE(type)))
+           || rows * step > frame.capacity())
+            return {};
+
+        cv::Mat mat(static_cast<int>(rows), static_cast<int>(cols), type, frame->data, step);
+        mat.allocator = &allocator;
+        mat.u = allocator.wrap(frame, rows * step);
+        mat.u->refcount = 1;
+        return mat;
+    }
+
+    cv::UMat toUMat(const frame_handle& frame, const cv::AccessFlag access)
+    {
+        const cv::Mat mat = toMat(frame);
+        if(mat.empty())
+            return {};
+        // The UMat takes its own references on the UMatData, so the Mat may go.
+        return mat.getUMat(access);
+    }
+}
@@ -0,0 +1,221 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/frame_pool.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace vision
+{
+    frame_slot::frame_slot(unsigned char* buffer, const libfreenect2::Frame::Type type,
+                           const std::size_t capacity, frame_pool* pool, const std::uint32_t index)
+        : frame(0, 0, 0, buffer), type(type), capacity(capacity), pool(pool), index(index)
+    {
+    }
+
+    frame_handle::frame_handle(const frame_handle& other)
+        : slot(other.slot)
+    {
+        if(slot != nullptr)
+            slot->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    frame_handle::frame_handle(frame_handle&& other) noexcept
+        : slot(other.slot)
+    {
+        other.slot = nullptr;
+    }
+
+    frame_handle& frame_handle::operator=(const frame_handle& other)
+    {
+        if(this != &other)
+        {
+            frame_handle copy(other);
+            std::swap(slot, copy.slot);
+        }
+        return *this;
+    }
+
+    frame_handle& frame_handle::operator=(frame_handle&& other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            slot = other.slot;
+            other.slot = nullptr;
+        }
+        return *this;
+    }
+
+    frame_handle::~frame_handle()
+    {
+        reset();
+    }
+
+    void frame_handle::reset()
+    {
+        if(slot == nullptr)
+            return;
+        if(slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            slot->pool->recycle(slot);
+        slot = nullptr;
+    }
+
+    frame_slot* frame_handle::release()
+    {
+        frame_slot* _slot = slot;
+        slot = nullptr;
+        return _slot;
+    }
+
+    void frame_handle::stamp(const latency_stage stage) const
+    {
+        if(slot == nullptr || slot->arrival_ns == 0 || slot->pool->tracer == nullptr)
+            return;
+        slot->pool->tracer->record(stage, slot->type, slot->frame.sequence, slot->arrival_ns, latency_tracer::now());
+    }
+
+    std::shared_ptr<frame_pool> frame_pool::create(const frame_pool_config& config)
+    {
+        return {new frame_pool(config), [](frame_pool* pool) { pool->unref(); }};
+    }
+
+    frame_pool::frame_pool(const frame_pool_config& config)
+    {
+        allocateSlots(libfreenect2::Frame::Color, config.color_frames, 1920, 1080, 4);
+        allocateSlots(libfreenect2::Frame::Ir, config.ir_frames, 512, 424, 4);
+        allocateSlots(libfreenect2::Frame::Depth, config.depth_frames, 512, 424, 4);
+    }
+
+    frame_pool::~frame_pool()
+    {
+        for(auto& _slots : slots)
+            _slots.clear();
+        for(unsigned char* buffer : buffers)
+            std::free(buffer);
+    }
+
+    int frame_pool::typeIndex(const libfreenect2::Frame::Type type)
+    {
+        switch (type)
+        {
+            case libfreenect2::Frame::Color: return 0;
+            case libfreenect2::Frame::Ir: return 1;
+            case libfreenect2::Frame::Depth: return 2;
+            default: return -1;
+        }
+    }
+
+    void frame_pool::allocateSlots(const libfreenect2::Frame::Type type, const std::size_t count,
+                                   const std::size_t width, const std::size_t height,
+                                   const std::size_t bytes_per_pixel)
+    {
+        const int idx = typeIndex(type);
+        const std::size_t frame_bytes = width * height * bytes_per_pixel;
+        const std::size_t capacity = (frame_bytes + buffer_alignment - 1) / buffer_alignment * buffer_alignment;
+
+        free_list& list = free_slots[idx];
+        list.next = std::make_unique<std::atomic<std::uint32_t>[]>(count);
+        slots[idx].reserve(count);
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            auto* buffer = static_cast<unsigned char*>(std::aligned_alloc(buffer_alignment, capacity));
+            if(buffer == nullptr)
+                break;
+            // Touch every page now so the capture path never takes a page fault.
+            std::memset(buffer, 0, capacity);
+            buffers.push_back(buffer);
+
+            auto slot = std::make_unique<frame_slot>(buffer, type, capacity, this, static_cast<std::uint32_t>(i));
+            slot->frame.width = width;
+            slot->frame.height = height;
+            slot->frame.bytes_per_pixel = bytes_per_pixel;
+            slots[idx].push_back(std::move(slot));
+        }
+
+        for(std::size_t i = slots[idx].size(); i-- > 0;)
+            pushFree(slots[idx][i].get());
+    }
+
+    void frame_pool::unref()
+    {
+        if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    frame_handle frame_pool::acquire(const libfreenect2::Frame::Type type)
+    {
+        const int idx = typeIndex(type);
+        if(idx < 0)
+            return {};
+
+        free_list& list = free_slots[idx];
+        std::uint64_t head = list.head.load(std::memory_order_acquire);
+        while(static_cast<std::uint32_t>(head) != 0)
+        {
+            const std::uint32_t slot_index = static_cast<std::uint32_t>(head) - 1;
+            const std::uint64_t next = list.next[slot_index].load(std::memory_order_relaxed);
+            const std::uint64_t new_head = ((head >> 32) + 1) << 32 | next;
+            if(list.head.compare_exchange_weak(head, new_head, std::memory_order_acquire,
+                                               std::memory_order_acquire))
+            {
+                list.size.fetch_sub(1, std::memory_order_relaxed);
+                frame_slot* slot = slots[idx][slot_index].get();
+                slot->refs.store(1, std::memory_order_relaxed);
+                refs.fetch_add(1, std::memory_order_relaxed);
+                return frame_handle(slot);
+            }
+        }
+        return {};
+    }
+
+    void frame_pool::setTracer(std::shared_ptr<latency_tracer> tracer)
+    {
+        this->tracer = std::move(tracer);
+    }
+
+    void frame_pool::recycle(frame_slot* slot)
+    {
+        if(tracer != nullptr && slot->arrival_ns != 0)
+            tracer->record(latency_stage::Released, slot->type, slot->frame.sequence, slot->arrival_ns,
+                           latency_tracer::now());
+        // A buffer taken but never filled, such as one dropped mid-decode, must not be traced on its next release.
+        slot->arrival_ns = 0;
+        // No handle is left to derive from, so the derived frames can be dropped without their locks.
+        for(frame_slot*& derived : slot->derived)
+            frame_handle(std::exchange(derived, nullptr)).reset();
+        pushFree(slot);
+        unref();
+    }
+
+    void frame_pool::pushFree(frame_slot* slot)
+    {
+        free_list& list = free_slots[typeIndex(slot->type)];
+        const std::uint32_t node = slot->index + 1;
+        std::uint64_t head = list.head.load(std::memory_order_relaxed);
+        std::uint64_t new_head;
+        do
+        {
+            list.next[slot->index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+            new_head = ((head >> 32) + 1) << 32 | node;
+        } while(!list.head.compare_exchange_weak(head, new_head, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        list.size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::size_t frame_pool::slotCount(const libfreenect2::Frame::Type type) const
+    {
+        const int idx = typeIndex(type);
+        return idx < 0 ? 0 : slots[idx].size();
+    }
+
+    std::size_t frame_pool::freeCount(const libfreenect2::Frame::Type type) const
+    {
+        const int idx = typeIndex(type);
+        return idx < 0 ? 0 : free_slots[idx].size.load(std::memory_order_relaxed);
+    }
+}
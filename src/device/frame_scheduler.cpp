@@ -0,0 +1,96 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/frame_scheduler.h"
+
+namespace vision
+{
+    frame_scheduler::source::~source()
+    {
+        for(auto& ring : pull_rings)
+        {
+            frame_slot* slot = nullptr;
+            while(ring.pop(slot))
+                frame_handle(slot).reset();
+        }
+    }
+
+    frame_scheduler::source::ring* frame_scheduler::source::getRing(const libfreenect2::Frame::Type type)
+    {
+        switch (type)
+        {
+            case libfreenect2::Frame::Color: return &pull_rings[0];
+            case libfreenect2::Frame::Ir: return &pull_rings[1];
+            case libfreenect2::Frame::Depth: return &pull_rings[2];
+            default: return nullptr;
+        }
+    }
+
+    void frame_scheduler::source::deliver(const frame_handle& frame)
+    {
+        if(!frame)
+            return;
+
+        const scheduled_frame scheduled{device_id, frame.type(), frame};
+        {
+            std::shared_lock lock(scheduler.consumers_mutex);
+            for(const auto& [id, callback] : scheduler.consumers)
+                callback(scheduled);
+        }
+
+        if(ring* _ring = getRing(scheduled.type))
+        {
+            frame_handle kept = frame;
+            if(const auto evicted = _ring->push(kept.release()))
+                frame_handle(*evicted).reset();
+        }
+    }
+
+    frame_handle frame_scheduler::source::pull(const libfreenect2::Frame::Type type)
+    {
+        ring* _ring = getRing(type);
+        frame_slot* slot = nullptr;
+        if(_ring == nullptr || !_ring->pop(slot))
+            return {};
+        return frame_handle(slot);
+    }
+
+    int frame_scheduler::subscribe(consumer callback)
+    {
+        std::unique_lock lock(consumers_mutex);
+        const int id = next_subscription++;
+        consumers.emplace(id, std::move(callback));
+        return id;
+    }
+
+    bool frame_scheduler::unsubscribe(const int subscription_id)
+    {
+        std::unique_lock lock(consumers_mutex);
+        return consumers.erase(subscription_id) > 0;
+    }
+
+    frame_scheduler::source* frame_scheduler::attach(const int device_id)
+    {
+        std::lock_guard lock(sources_mutex);
+        auto& _source = sources[device_id];
+        if(!_source)
+            _source.reset(new source(*this, device_id));
+        return _source.get();
+    }
+
+    void frame_scheduler::detach(const int device_id)
+    {
+        std::lock_guard lock(sources_mutex);
+        sources.erase(device_id);
+    }
+
+    frame_handle frame_scheduler::pull(const int device_id, const libfreenect2::Frame::Type type)
+    {
+        std::lock_guard lock(sources_mutex);
+        const auto it = sources.find(device_id);
+        if(it == sources.end())
+            return {};
+        return it->second->pull(type);
+    }
+}
@@ -0,0 +1,221 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/frame_synchronizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vision
+{
+    frame_synchronizer::frame_synchronizer(frame_scheduler& scheduler, const std::vector<int>& device_ids,
+                                           set_callback callback, const sync_config& config)
+        : scheduler(scheduler), config(config), callback(std::move(callback))
+    {
+        this->config.max_pending = std::clamp<std::size_t>(config.max_pending, 1, queue_capacity);
+        for(const int device_id : device_ids)
+        {
+            if(devices.size() == frame_set::max_devices)
+                break;
+            devices.emplace_back().device_id = device_id;
+        }
+        subscription = scheduler.subscribe([this](const scheduled_frame& frame) { onFrame(frame); });
+    }
+
+    frame_synchronizer::~frame_synchronizer()
+    {
+        scheduler.unsubscribe(subscription);
+    }
+
+    void frame_synchronizer::push(const scheduled_frame& frame)
+    {
+        onFrame(frame);
+    }
+
+    void frame_synchronizer::onFrame(const scheduled_frame& frame)
+    {
+        if(!frame.frame || (frame.type != libfreenect2::Frame::Depth && frame.type != libfreenect2::Frame::Color))
+            return;
+
+        std::optional<frame_set> set;
+        {
+            std::lock_guard lock(mutex);
+            const auto it = std::ranges::find_if(devices, [&frame](const device_state& state) {
+                return state.device_id == frame.device_id;
+            });
+            if(it == devices.end())
+                return;
+
+            device_clock& clock = it->clock;
+            const double device_s = unwrapSeconds(clock, frame.frame->timestamp);
+            if(frame.type == libfreenect2::Frame::Depth)
+                updateClock(clock, device_s, frame.frame.arrivalTime());
+
+            if(clock.samples == 0)
+            {
+                // No depth frame yet, so this color frame cannot be placed on the host clock.
+                ++statistics.unmatched;
+                return;
+            }
+
+            pending_queue& queue = frame.type == libfreenect2::Frame::Depth ? it->depth : it->color;
+            if(queue.count >= config.max_pending)
+            {
+                queue.pop();
+                ++statistics.dropped;
+            }
+            queue.push({frame.frame, toHostTime(clock, device_s)});
+            set = matchOne();
+        }
+
+        // Sets are handed out without the lock so other capture threads keep matching meanwhile.
+        while(set)
+        {
+            if(callback)
+                callback(*set);
+            std::lock_guard lock(mutex);
+            set = matchOne();
+        }
+    }
+
+    double frame_synchronizer::unwrapSeconds(device_clock& clock, const std::uint32_t ticks)
+    {
+        constexpr std::uint32_t half_range = 0x80000000u;
+        if(!clock.initialized)
+        {
+            clock.initialized = true;
+            clock.last_ticks = ticks;
+        }
+
+        std::int64_t wraps = clock.wraps;
+        if(ticks < clock.last_ticks && clock.last_ticks - ticks > half_range)
+        {
+            wraps = ++clock.wraps;
+            clock.last_ticks = ticks;
+        }
+        else if(ticks > clock.last_ticks && ticks - clock.last_ticks > half_range)
+        {
+            // A late frame from before the last wrap.
+            --wraps;
+        }
+        else if(ticks > clock.last_ticks)
+        {
+            clock.last_ticks = ticks;
+        }
+
+        return (static_cast<double>(wraps) * 4294967296.0 + ticks) * tick_seconds;
+    }
+
+    void frame_synchronizer::updateClock(device_clock& clock, const double device_s, const std::int64_t arrival_ns) const
+    {
+        if(clock.samples == 0)
+        {
+            clock.origin_device_s = device_s;
+            clock.origin_host_ns = arrival_ns;
+        }
+
+        const double x = device_s - clock.origin_device_s;
+        const double r = static_cast<double>(arrival_ns - clock.origin_host_ns) * 1e-9 - x;
+        const double drift = clock.var_x > 1e-12 ? clock.cov_xr / clock.var_x : 0.0;
+
+        // Arrival times only ever get later than the capture time; drop frames that were held up.
+        constexpr std::uint64_t warmup_samples = 30;
+        const double gate_s = std::chrono::duration<double>(config.outlier_gate).count();
+        if(clock.samples >= warmup_samples && r - (clock.mean_r + drift * (x - clock.mean_x)) > gate_s)
+            return;
+
+        // Plain average until enough samples, exponential forgetting afterwards so drift can be tracked.
+        const double alpha = std::max(config.clock_smoothing, 1.0 / static_cast<double>(clock.samples + 1));
+        const double dx = x - clock.mean_x;
+        const double dr = r - clock.mean_r;
+        clock.mean_x += alpha * dx;
+        clock.mean_r += alpha * dr;
+        clock.var_x = (1.0 - alpha) * (clock.var_x + alpha * dx * dx);
+        clock.cov_xr = (1.0 - alpha) * (clock.cov_xr + alpha * dx * dr);
+        ++clock.samples;
+    }
+
+    std::int64_t frame_synchronizer::toHostTime(const device_clock& clock, const double device_s)
+    {
+        const double x = device_s - clock.origin_device_s;
+        const double drift = clock.var_x > 1e-12 ? clock.cov_xr / clock.var_x : 0.0;
+        const double r = clock.mean_r + drift * (x - clock.mean_x);
+        return clock.origin_host_ns + static_cast<std::int64_t>(std::llround((x + r) * 1e9));
+    }
+
+    std::optional<frame_set> frame_synchronizer::matchOne()
+    {
+        const std::int64_t tolerance_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(config.tolerance).count();
+
+        while(true)
+        {
+            std::int64_t reference = std::numeric_limits<std::int64_t>::min();
+            for(auto& state : devices)
+            {
+                if(state.depth.count == 0 || state.color.count == 0)
+                    return std::nullopt;
+                reference = std::max({reference, state.depth.at(0).time_ns, state.color.at(0).time_ns});
+            }
+
+            bool aligned = true;
+            for(auto& state : devices)
+            {
+                for(pending_queue* queue : {&state.depth, &state.color})
+                {
+                    // Frames too old to ever join a set around the reference, or superseded by a closer one.
+                    while(queue->count > 0 && (queue->at(0).time_ns < reference - tolerance_ns
+                          || (queue->count > 1 && std::llabs(queue->at(1).time_ns - reference)
+                                                  < std::llabs(queue->at(0).time_ns - reference))))
+                    {
+                        queue->pop();
+                        ++statistics.unmatched;
+                    }
+                    if(queue->count == 0)
+                        return std::nullopt;
+                    aligned = aligned && queue->at(0).time_ns <= reference + tolerance_ns;
+                }
+            }
+            if(!aligned)
+                continue;
+
+            frame_set set;
+            set.index = next_index++;
+            set.reference_ns = reference;
+            set.device_count = devices.size();
+            for(std::size_t i = 0; i < devices.size(); ++i)
+            {
+                pending_frame depth = devices[i].depth.pop();
+                pending_frame color = devices[i].color.pop();
+                set.devices[i] = {devices[i].device_id, std::move(depth.frame), std::move(color.frame),
+                                  depth.time_ns, color.time_ns};
+            }
+            ++statistics.emitted;
+            return set;
+        }
+    }
+
+    sync_statistics frame_synchronizer::getStatistics() const
+    {
+        std::lock_guard lock(mutex);
+        return statistics;
+    }
+
+    std::optional<clock_estimate> frame_synchronizer::getClockEstimate(const int device_id) const
+    {
+        std::lock_guard lock(mutex);
+        const auto it = std::ranges::find_if(devices, [device_id](const device_state& state) {
+            return state.device_id == device_id;
+        });
+        if(it == devices.end())
+            return std::nullopt;
+
+        const device_clock& clock = it->clock;
+        const double drift = clock.var_x > 1e-12 ? clock.cov_xr / clock.var_x : 0.0;
+        const double offset_s = static_cast<double>(clock.origin_host_ns) * 1e-9 - clock.origin_device_s
+                                + clock.mean_r - drift * clock.mean_x;
+        // The model slope is host-minus-device time per device second, i.e. the negated device rate error.
+        return clock_estimate{offset_s * 1e3, -drift * 1e6, clock.samples};
+    }
+}
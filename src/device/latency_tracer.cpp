@@ -0,0 +1,301 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/latency_tracer.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::size_t linear_buckets = std::size_t{2} << latency_histogram::sub_bucket_bits; ///< Buckets of one nanosecond each.
+
+        std::atomic<std::uint64_t> next_tracer_id{1}; ///< ID of the next latency_tracer.
+
+        /**
+         * @struct cached_shard
+         * @brief Thread-local cache entry mapping a tracer to the calling thread's shard.
+         */
+        struct cached_shard
+        {
+            std::uint64_t tracer_id = 0; ///< Tracer ID, 0 if unused.
+            void* shard = nullptr; ///< The thread's shard of that tracer.
+        };
+
+        thread_local std::array<cached_shard, 4> shard_cache; ///< Shards of the tracers this thread stamps most.
+        thread_local std::size_t shard_cache_next = 0; ///< Entry replaced on the next miss.
+
+        int typeIndex(const libfreenect2::Frame::Type type)
+        {
+            switch (type)
+            {
+                case libfreenect2::Frame::Color: return 0;
+                case libfreenect2::Frame::Ir: return 1;
+                case libfreenect2::Frame::Depth: return 2;
+                default: return -1;
+            }
+        }
+
+        constexpr const char* type_names[3] = {"color", "ir", "depth"};
+
+        /// Adds to a counter only the calling thread writes; a plain store, no locked instruction.
+        template<typename T>
+        void addOwned(std::atomic<T>& counter, const T value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+    }
+
+    const char* latencyStageName(const latency_stage stage)
+    {
+        switch (stage)
+        {
+            case latency_stage::Decoded: return "decoded";
+            case latency_stage::Filtered: return "filtered";
+            case latency_stage::Delivered: return "delivered";
+            case latency_stage::Registered: return "registered";
+            case latency_stage::Released: return "released";
+        }
+        return "unknown";
+    }
+
+    latency_histogram::latency_histogram()
+        : buckets(bucket_count, 0)
+    {
+    }
+
+    std::size_t latency_histogram::bucketIndex(const std::int64_t ns)
+    {
+        const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(ns, 0));
+        if(value < linear_buckets)
+            return value;
+        const unsigned shift = std::bit_width(value) - 1 - sub_bucket_bits;
+        const std::size_t index = (static_cast<std::size_t>(shift) << sub_bucket_bits) + (value >> shift);
+        return std::min(index, bucket_count - 1);
+    }
+
+    std::int64_t latency_histogram::bucketUpperBound(const std::size_t index)
+    {
+        if(index < linear_buckets)
+            return static_cast<std::int64_t>(index);
+        const std::size_t shift = (index >> sub_bucket_bits) - 1;
+        const std::uint64_t sub_bucket = (index & ((std::size_t{1} << sub_bucket_bits) - 1)) + (std::size_t{1} << sub_bucket_bits);
+        return static_cast<std::int64_t>(((sub_bucket + 1) << shift) - 1);
+    }
+
+    void latency_histogram::addBucket(const std::size_t index, const std::uint64_t count)
+    {
+        buckets[std::min(index, bucket_count - 1)] += count;
+        samples += count;
+    }
+
+    void latency_histogram::addTotals(const std::int64_t _total_ns, const std::int64_t _min_ns, const std::int64_t _max_ns)
+    {
+        total_ns += _total_ns;
+        min_ns = std::min(min_ns, _min_ns);
+        max_ns = std::max(max_ns, _max_ns);
+    }
+
+    void latency_histogram::add(const std::int64_t ns)
+    {
+        addBucket(bucketIndex(ns), 1);
+        addTotals(ns, ns, ns);
+    }
+
+    std::int64_t latency_histogram::percentile(const double fraction) const
+    {
+        if(samples == 0)
+            return 0;
+        const auto rank = static_cast<std::uint64_t>(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(samples - 1)) + 1;
+        std::uint64_t seen = 0;
+        for(std::size_t i = 0; i < bucket_count; ++i)
+        {
+            seen += buckets[i];
+            if(seen >= rank)
+                return std::clamp(bucketUpperBound(i), min(), max_ns);
+        }
+        return max_ns;
+    }
+
+    double latency_histogram::mean() const
+    {
+        return samples > 0 ? static_cast<double>(total_ns) / static_cast<double>(samples) : 0.0;
+    }
+
+    const latency_histogram& latency_snapshot::get(const libfreenect2::Frame::Type type, const latency_stage stage) const
+    {
+        const int index = typeIndex(type);
+        return histograms[index < 0 ? 0 : index][static_cast<std::size_t>(stage)];
+    }
+
+    latency_tracer::latency_tracer(const int device_id, const latency_tracer_config& config)
+        : device_id(device_id),
+          id(next_tracer_id.fetch_add(1, std::memory_order_relaxed)),
+          trace_capacity(config.trace_events)
+    {
+        if(trace_capacity > 0)
+            trace = std::make_unique<trace_record[]>(trace_capacity);
+    }
+
+    std::int64_t latency_tracer::now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    latency_tracer::shard& latency_tracer::localShard()
+    {
+        for(const cached_shard& cached : shard_cache)
+        {
+            if(cached.tracer_id == id)
+                return *static_cast<shard*>(cached.shard);
+        }
+
+        shard* _shard;
+        {
+            std::lock_guard lock(shards_mutex);
+            auto& owned = shards[std::this_thread::get_id()];
+            if(!owned)
+            {
+                owned = std::make_unique<shard>();
+                for(auto& per_type : owned->min_ns)
+                    for(auto& min : per_type)
+                        min.store(std::numeric_limits<std::int64_t>::max(), std::memory_order_relaxed);
+            }
+            _shard = owned.get();
+        }
+        shard_cache[shard_cache_next] = {id, _shard};
+        shard_cache_next = (shard_cache_next + 1) % shard_cache.size();
+        return *_shard;
+    }
+
+    void latency_tracer::record(const latency_stage stage, const libfreenect2::Frame::Type type,
+                                const std::uint32_t sequence, const std::int64_t arrival_ns,
+                                const std::int64_t stage_ns)
+    {
+        const int type_index = typeIndex(type);
+        if(type_index < 0)
+            return;
+
+        const auto stage_index = static_cast<std::size_t>(stage);
+        const std::int64_t latency = std::max<std::int64_t>(stage_ns - arrival_ns, 0);
+        shard& _shard = localShard();
+        addOwned(_shard.buckets[type_index][stage_index][latency_histogram::bucketIndex(latency)], std::uint64_t{1});
+        addOwned(_shard.total_ns[type_index][stage_index], latency);
+        auto& min = _shard.min_ns[type_index][stage_index];
+        if(latency < min.load(std::memory_order_relaxed))
+            min.store(latency, std::memory_order_relaxed);
+        auto& max = _shard.max_ns[type_index][stage_index];
+        if(latency > max.load(std::memory_order_relaxed))
+            max.store(latency, std::memory_order_relaxed);
+
+        if(trace == nullptr)
+            return;
+        // Sequence lock: readers skip a record whose ticket changed while they copied it.
+        const std::uint64_t ticket = trace_next.fetch_add(1, std::memory_order_relaxed);
+        trace_record& _record = trace[ticket % trace_capacity];
+        _record.ticket.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _record.arrival_ns.store(arrival_ns, std::memory_order_relaxed);
+        _record.stage_ns.store(stage_ns, std::memory_order_relaxed);
+        _record.sequence.store(sequence, std::memory_order_relaxed);
+        _record.type.store(static_cast<std::uint8_t>(type_index), std::memory_order_relaxed);
+        _record.stage.store(static_cast<std::uint8_t>(stage), std::memory_order_relaxed);
+        _record.ticket.store(ticket + 1, std::memory_order_release);
+    }
+
+    latency_snapshot latency_tracer::snapshot() const
+    {
+        latency_snapshot _snapshot;
+        _snapshot.device_id = device_id;
+
+        std::lock_guard lock(shards_mutex);
+        for(const auto& [thread_id, _shard] : shards)
+        {
+            for(std::size_t type = 0; type < 3; ++type)
+            {
+                for(std::size_t stage = 0; stage < latency_stage_count; ++stage)
+                {
+                    latency_histogram& histogram = _snapshot.histograms[type][stage];
+                    std::uint64_t added = 0;
+                    for(std::size_t i = 0; i < latency_histogram::bucket_count; ++i)
+                    {
+                        const std::uint64_t count = _shard->buckets[type][stage][i].load(std::memory_order_relaxed);
+                        if(count == 0)
+                            continue;
+                        histogram.addBucket(i, count);
+                        added += count;
+                    }
+                    if(added > 0)
+                        histogram.addTotals(_shard->total_ns[type][stage].load(std::memory_order_relaxed),
+                                            _shard->min_ns[type][stage].load(std::memory_order_relaxed),
+                                            _shard->max_ns[type][stage].load(std::memory_order_relaxed));
+                }
+            }
+        }
+        return _snapshot;
+    }
+
+    Result latency_tracer::writeChromeTrace(const std::string& path, const std::vector<const latency_tracer*>& tracers)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if(!file)
+            return {Status::PermissionDenied, "Cannot write " + path + "."};
+
+        file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        bool first = true;
+        char event[256];
+        for(const latency_tracer* tracer : tracers)
+        {
+            if(tracer == nullptr || !tracer->isTracing())
+                continue;
+
+            for(int type = 0; type < 3; ++type)
+            {
+                std::snprintf(event, sizeof(event),
+                              "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+                              first ? "" : ",", tracer->device_id, type, type_names[type]);
+                file << event;
+                first = false;
+            }
+
+            const std::uint64_t written = tracer->trace_next.load(std::memory_order_acquire);
+            const std::uint64_t begin = written > tracer->trace_capacity ? written - tracer->trace_capacity : 0;
+            for(std::uint64_t ticket = begin; ticket < written; ++ticket)
+            {
+                const trace_record& _record = tracer->trace[ticket % tracer->trace_capacity];
+                if(_record.ticket.load(std::memory_order_acquire) != ticket + 1)
+                    continue;
+                const std::int64_t arrival_ns = _record.arrival_ns.load(std::memory_order_relaxed);
+                const std::int64_t stage_ns = _record.stage_ns.load(std::memory_order_relaxed);
+                const std::uint32_t sequence = _record.sequence.load(std::memory_order_relaxed);
+                const std::uint8_t type = _record.type.load(std::memory_order_relaxed);
+                const std::uint8_t stage = _record.stage.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(_record.ticket.load(std::memory_order_relaxed) != ticket + 1 || type >= 3 || stage >= latency_stage_count)
+                    continue;
+
+                std::snprintf(event, sizeof(event),
+                              ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                              "\"pid\": %d, \"tid\": %d, \"args\": {\"sequence\": %u}}",
+                              latencyStageName(static_cast<latency_stage>(stage)), type_names[type],
+                              static_cast<double>(arrival_ns) / 1000.0,
+                              static_cast<double>(std::max<std::int64_t>(stage_ns - arrival_ns, 0)) / 1000.0,
+                              tracer->device_id, static_cast<int>(type), sequence);
+                file << event;
+            }
+        }
+        file << "\n]}\n";
+
+        if(!file.flush())
+            return {Status::Error, "Cannot write " + path + "."};
+        return Result(Status::Success);
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/lazy_color_frame.h"
+
+#include <bit>
+#include <utility>
+#include "logger/console_logger.h"
+
+#ifdef VISION_WITH_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+namespace vision
+{
+#ifdef VISION_WITH_TURBOJPEG
+    namespace
+    {
+        /**
+         * @struct decompressor
+         * @brief TurboJPEG decompressor of the calling thread.
+         */
+        struct decompressor
+        {
+            tjhandle handle = tjInitDecompress(); ///< The decompressor, or nullptr if it could not be created.
+
+            ~decompressor()
+            {
+                if(handle != nullptr)
+                    tjDestroy(handle);
+            }
+        };
+
+        tjhandle threadDecompressor()
+        {
+            thread_local decompressor local;
+            return local.handle;
+        }
+    }
+#endif
+
+    lazy_color_frame::lazy_color_frame(frame_handle frame)
+        : jpeg(std::move(frame))
+    {
+    }
+
+    bool lazy_color_frame::isCompressed(const frame_handle& frame)
+    {
+        return frame && frame.type() == libfreenect2::Frame::Color && frame->format == libfreenect2::Frame::Raw;
+    }
+
+    bool lazy_color_frame::canDecode()
+    {
+#ifdef VISION_WITH_TURBOJPEG
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    const unsigned char* lazy_color_frame::data() const
+    {
+        return isCompressed(jpeg) ? jpeg->data : nullptr;
+    }
+
+    std::size_t lazy_color_frame::size() const
+    {
+        // Raw frames keep their length in bytes_per_pixel.
+        return isCompressed(jpeg) ? jpeg->width * jpeg->height * jpeg->bytes_per_pixel : 0;
+    }
+
+    Result lazy_color_frame::dimensions(int& width, int& height, const jpeg_scale scale) const
+    {
+        if(!isCompressed(jpeg))
+            return {Status::InvalidParam, "Frame is not a compressed color frame!"};
+#ifdef VISION_WITH_TURBOJPEG
+        tjhandle handle = threadDecompressor();
+        if(handle == nullptr)
+            return {Status::Error, "TurboJPEG decompressor could not be created!"};
+
+        int subsampling = 0;
+        int colorspace = 0;
+        if(tjDecompressHeader3(handle, jpeg->data, size(), &width, &height, &subsampling, &colorspace) != 0)
+            return {Status::InvalidParam, std::string("Invalid JPEG header: ") + tjGetErrorStr2(handle)};
+        const tjscalingfactor factor{1, static_cast<int>(scale)};
+        width = TJSCALED(width, factor);
+        height = TJSCALED(height, factor);
+        return Result(Status::Success);
+#else
+        (void)width;
+        (void)height;
+        (void)scale;
+        return {Status::Error, "Built without TurboJPEG; compressed color frames cannot be decoded!"};
+#endif
+    }
+
+    Result lazy_color_frame::decodeInto(libfreenect2::Frame& target, const std::size_t capacity,
+                                        const jpeg_scale scale) const
+    {
+        int width = 0;
+        int height = 0;
+        if(Result result = dimensions(width, height, scale); result.status != Status::Success)
+            return result;
+
+        const std::size_t bytes = static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+        if(target.data == nullptr || bytes > capacity)
+            return {Status::InvalidParam, "Target buffer is too small for the decoded frame!"};
+#ifdef VISION_WITH_TURBOJPEG
+        tjhandle handle = threadDecompressor();
+        if(tjDecompress2(handle, jpeg->data, size(), target.data, width, width * tjPixelSize[TJPF_BGRX], height,
+                         TJPF_BGRX, 0) != 0)
+            return {Status::Error, std::string("JPEG could not be decoded: ") + tjGetErrorStr2(handle)};
+#endif
+
+        target.width = static_cast<std::size_t>(width);
+        target.height = static_cast<std::size_t>(height);
+        target.bytes_per_pixel = 4;
+        target.timestamp = jpeg->timestamp;
+        target.sequence = jpeg->sequence;
+        target.exposure = jpeg->exposure;
+        target.gain = jpeg->gain;
+        target.gamma = jpeg->gamma;
+        target.status = jpeg->status;
+        target.format = libfreenect2::Frame::BGRX;
+        return Result(Status::Success);
+    }
+
+    frame_handle lazy_color_frame::decode(frame_pool& pool, const jpeg_scale scale) const
+    {
+        if(!isCompressed(jpeg))
+            return {};
+
+        return jpeg.derive(std::countr_zero(static_cast<unsigned int>(scale)), [&]() -> frame_handle {
+            frame_handle decoded = pool.acquire(libfreenect2::Frame::Color);
+            if(!decoded)
+                return {};
+
+            if(const Result result = decodeInto(*decoded, decoded.capacity(), scale); result.status != Status::Success)
+            {
+                ConsoleLogger::getInstance()->debug("Color frame {} not decoded: {}", jpeg->sequence, result.message);
+                return {};
+            }
+            decoded.setArrivalTime(jpeg.arrivalTime());
+            return decoded;
+        });
+    }
+}
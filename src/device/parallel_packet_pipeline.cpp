@@ -0,0 +1,30 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/parallel_packet_pipeline.h"
+
+namespace vision
+{
+    parallel_packet_pipeline::parallel_packet_pipeline(depth_decoder& decoder, const bool compressed_color)
+        : decoder(decoder),
+          color_pipeline(compressed_color ? nullptr : std::make_unique<libfreenect2::CpuPacketPipeline>())
+    {
+        decoder.setTableSource(this);
+    }
+
+    parallel_packet_pipeline::~parallel_packet_pipeline()
+    {
+        decoder.setTableSource(nullptr);
+    }
+
+    libfreenect2::PacketPipeline::PacketParser* parallel_packet_pipeline::getRgbPacketParser() const
+    {
+        return color_pipeline ? color_pipeline->getRgbPacketParser() : DumpPacketPipeline::getRgbPacketParser();
+    }
+
+    libfreenect2::RgbPacketProcessor* parallel_packet_pipeline::getRgbPacketProcessor() const
+    {
+        return color_pipeline ? color_pipeline->getRgbPacketProcessor() : DumpPacketPipeline::getRgbPacketProcessor();
+    }
+}
@@ -0,0 +1,35 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/simd_dispatch.h"
+
+namespace vision
+{
+    simd_kernel cpuKernel()
+    {
+        static const simd_kernel widest = [] {
+#ifdef VISION_X86_KERNELS
+            if(__builtin_cpu_supports("avx2"))
+                return simd_kernel::AVX2;
+            if(__builtin_cpu_supports("sse2"))
+                return simd_kernel::SSE;
+#endif
+            return simd_kernel::Scalar;
+        }();
+        return widest;
+    }
+
+    simd_kernel resolveKernel(const simd_kernel requested, const std::initializer_list<simd_kernel> implemented)
+    {
+        const simd_kernel cpu = cpuKernel();
+        const simd_kernel limit = requested == simd_kernel::Auto || requested > cpu ? cpu : requested;
+        simd_kernel chosen = simd_kernel::Scalar;
+        for(const simd_kernel kernel : implemented)
+        {
+            if(kernel <= limit && kernel > chosen)
+                chosen = kernel;
+        }
+        return chosen;
+    }
+}
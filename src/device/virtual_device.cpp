@@ -0,0 +1,382 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/virtual_device.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include "libfreenect2/packet_pipeline.h"
+#include "logger/console_logger.h"
+
+namespace vision
+{
+    namespace
+    {
+        constexpr double tick_seconds = 0.000125; ///< Length of a Kinect timestamp tick.
+
+        std::uint32_t ticksSince(const std::chrono::steady_clock::time_point origin)
+        {
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+            return static_cast<std::uint32_t>(static_cast<std::uint64_t>(elapsed / tick_seconds));
+        }
+
+        /**
+         * @brief Fills a BGRX frame with a static gradient pattern.
+         */
+        void fillColorPattern(libfreenect2::Frame& frame)
+        {
+            for(std::size_t r = 0; r < frame.height; ++r)
+            {
+                unsigned char* row = frame.data + r * frame.width * 4;
+                for(std::size_t c = 0; c < frame.width; ++c)
+                {
+                    row[4 * c + 0] = static_cast<unsigned char>(c * 255 / frame.width);
+                    row[4 * c + 1] = static_cast<unsigned char>(r * 255 / frame.height);
+                    row[4 * c + 2] = static_cast<unsigned char>((c ^ r) & 0xff);
+                    row[4 * c + 3] = 0;
+                }
+            }
+            frame.format = libfreenect2::Frame::BGRX;
+        }
+    }
+
+    virtual_device::virtual_device(const virtual_device_config& config)
+        : config(config)
+    {
+        // Typical factory calibration of a Kinect2, scaled to the configured depth resolution.
+        const float depth_scale = static_cast<float>(config.depth_width) / 512.0f;
+        ir_params.fx = ir_params.fy = 365.456f * depth_scale;
+        ir_params.cx = 254.878f * depth_scale;
+        ir_params.cy = 205.395f * static_cast<float>(config.depth_height) / 424.0f;
+
+        const float color_scale = static_cast<float>(config.color_width) / 1920.0f;
+        color_params.fx = color_params.fy = 1081.37f * color_scale;
+        color_params.cx = 959.5f * color_scale;
+        color_params.cy = 539.5f * static_cast<float>(config.color_height) / 1080.0f;
+    }
+
+    virtual_device* virtual_device::open(const virtual_device_config& config)
+    {
+        auto device = std::unique_ptr<virtual_device>(new virtual_device(config));
+        switch (config.source)
+        {
+            case virtual_source::Synthetic:
+                if(config.depth_width == 0 || config.depth_height == 0 || config.color_width == 0
+                   || config.color_height == 0)
+                    return nullptr;
+                break;
+            case virtual_source::Replay:
+                device->replay = std::make_unique<libfreenect2::Freenect2Replay>();
+                device->replay_device = device->replay->openDevice(config.replay_files,
+                                                                   new libfreenect2::CpuPacketPipeline());
+                if(device->replay_device == nullptr)
+                    return nullptr;
+                device->replay_device->setColorFrameListener(&device->color_pacer);
+                device->replay_device->setIrAndDepthFrameListener(&device->ir_depth_pacer);
+                break;
+            case virtual_source::Recording:
+                device->reader = std::make_unique<recording_reader>();
+                if(const Result result = device->reader->open(config.recording_path); result.status != Status::Success)
+                {
+                    ConsoleLogger::getInstance()->log(logger::Error, result.message);
+                    return nullptr;
+                }
+                if(device->reader->size() == 0)
+                    return nullptr;
+                if(device->config.recording_device_id < 0)
+                    device->config.recording_device_id = device->reader->entry(0).device_id;
+                break;
+        }
+        return device.release();
+    }
+
+    virtual_device::~virtual_device()
+    {
+        close();
+    }
+
+    std::string virtual_device::getSerialNumber()
+    {
+        return config.serial;
+    }
+
+    std::string virtual_device::getFirmwareVersion()
+    {
+        return "virtual";
+    }
+
+    libfreenect2::Freenect2Device::ColorCameraParams virtual_device::getColorCameraParams()
+    {
+        return replay_device != nullptr ? replay_device->getColorCameraParams() : color_params;
+    }
+
+    libfreenect2::Freenect2Device::IrCameraParams virtual_device::getIrCameraParams()
+    {
+        return replay_device != nullptr ? replay_device->getIrCameraParams() : ir_params;
+    }
+
+    void virtual_device::setColorCameraParams(const ColorCameraParams& params)
+    {
+        color_params = params;
+        if(replay_device != nullptr)
+            replay_device->setColorCameraParams(params);
+    }
+
+    void virtual_device::setIrCameraParams(const IrCameraParams& params)
+    {
+        ir_params = params;
+        if(replay_device != nullptr)
+            replay_device->setIrCameraParams(params);
+    }
+
+    void virtual_device::setConfiguration(const Config& config)
+    {
+        min_depth = config.MinDepth * 1000.0f;
+        max_depth = config.MaxDepth * 1000.0f;
+        if(replay_device != nullptr)
+            replay_device->setConfiguration(config);
+    }
+
+    void virtual_device::setColorFrameListener(libfreenect2::FrameListener* listener)
+    {
+        std::lock_guard lock(listener_mutex);
+        color_listener = listener;
+    }
+
+    void virtual_device::setIrAndDepthFrameListener(libfreenect2::FrameListener* listener)
+    {
+        std::lock_guard lock(listener_mutex);
+        ir_depth_listener = listener;
+    }
+
+    // A virtual sensor has no exposure, gain or LED; the settings are accepted and ignored.
+    void virtual_device::setColorAutoExposure(float) {}
+    void virtual_device::setColorSemiAutoExposure(float) {}
+    void virtual_device::setColorManualExposure(float, float) {}
+    void virtual_device::setColorSetting(libfreenect2::ColorSettingCommandType, std::uint32_t) {}
+    void virtual_device::setColorSetting(libfreenect2::ColorSettingCommandType, float) {}
+    std::uint32_t virtual_device::getColorSetting(libfreenect2::ColorSettingCommandType) { return 0; }
+    float virtual_device::getColorSettingFloat(libfreenect2::ColorSettingCommandType) { return 0.0f; }
+    void virtual_device::setLedStatus(libfreenect2::LedSettings) {}
+
+    bool virtual_device::start()
+    {
+        return startStreams(true, true);
+    }
+
+    bool virtual_device::startStreams(const bool rgb, const bool depth)
+    {
+        if(replay_device != nullptr)
+            return replay_device->startStreams(rgb, depth);
+
+        stop();
+        rgb_enabled = rgb;
+        depth_enabled = depth;
+        running.store(true, std::memory_order_release);
+        thread = std::thread([this] {
+            if(config.source == virtual_source::Recording)
+                runRecording();
+            else
+                runSynthetic();
+        });
+        return true;
+    }
+
+    bool virtual_device::stop()
+    {
+        if(replay_device != nullptr)
+            return replay_device->stop();
+
+        running.store(false, std::memory_order_release);
+        if(thread.joinable())
+            thread.join();
+        return true;
+    }
+
+    bool virtual_device::close()
+    {
+        stop();
+        if(replay_device != nullptr)
+        {
+            replay_device->close();
+            delete replay_device;
+            replay_device = nullptr;
+        }
+        replay.reset();
+        reader.reset();
+        return true;
+    }
+
+    void virtual_device::pace(std::chrono::steady_clock::time_point& next_frame) const
+    {
+        if(config.fps <= 0.0)
+            return;
+        next_frame += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / config.fps));
+        // After a stall, restart the schedule instead of bursting to catch up.
+        const auto now = std::chrono::steady_clock::now();
+        if(next_frame < now)
+            next_frame = now;
+        std::this_thread::sleep_until(next_frame);
+    }
+
+    bool virtual_device::dispatch(const libfreenect2::Frame::Type type, std::unique_ptr<libfreenect2::Frame>& frame)
+    {
+        std::lock_guard lock(listener_mutex);
+        libfreenect2::FrameListener* listener = type == libfreenect2::Frame::Color ? color_listener : ir_depth_listener;
+        if(listener == nullptr)
+            return false;
+
+        // A listener returning true owns the frame from now on, as with a real device.
+        if(listener->onNewFrame(type, frame.get()))
+        {
+            const libfreenect2::Frame* kept = frame.release();
+            frame = std::make_unique<libfreenect2::Frame>(kept->width, kept->height, kept->bytes_per_pixel);
+        }
+        return true;
+    }
+
+    void virtual_device::runSynthetic()
+    {
+        const std::size_t width = config.depth_width;
+        const std::size_t height = config.depth_height;
+        auto color = std::make_unique<libfreenect2::Frame>(config.color_width, config.color_height, 4);
+        auto ir = std::make_unique<libfreenect2::Frame>(width, height, 4);
+        auto depth = std::make_unique<libfreenect2::Frame>(width, height, 4);
+        fillColorPattern(*color);
+
+        const auto origin = std::chrono::steady_clock::now();
+        auto next_frame = origin;
+        for(std::uint32_t sequence = 0; running.load(std::memory_order_acquire); ++sequence)
+        {
+            const std::uint32_t timestamp = ticksSince(origin);
+            if(depth_enabled)
+            {
+                // Back wall at 3 m with ripples, and a 30 cm sphere at 1.8 m swinging left and right.
+                const float phase = static_cast<float>(sequence) * 0.05f;
+                const float sphere_x = 600.0f * std::sin(phase);
+                const float sphere_z = 1800.0f;
+                const float radius = 300.0f;
+                auto* depth_data = reinterpret_cast<float*>(depth->data);
+                auto* ir_data = reinterpret_cast<float*>(ir->data);
+                for(std::size_t r = 0; r < height; ++r)
+                {
+                    const float ray_y = (static_cast<float>(r) + 0.5f - ir_params.cy) / ir_params.fy;
+                    for(std::size_t c = 0; c < width; ++c)
+                    {
+                        const float ray_x = (static_cast<float>(c) + 0.5f - ir_params.cx) / ir_params.fx;
+                        float z = 3000.0f + 40.0f * std::sin(ray_x * 20.0f + phase) * std::cos(ray_y * 20.0f);
+
+                        // Ray (ray_x, ray_y, 1) * t against the sphere; the nearer root is the visible surface.
+                        const float a = ray_x * ray_x + ray_y * ray_y + 1.0f;
+                        const float b = -2.0f * (ray_x * sphere_x + sphere_z);
+                        const float k = sphere_x * sphere_x + sphere_z * sphere_z - radius * radius;
+                        const float discriminant = b * b - 4.0f * a * k;
+                        if(discriminant >= 0.0f)
+                            z = std::min(z, (-b - std::sqrt(discriminant)) / (2.0f * a));
+
+                        const std::size_t i = r * width + c;
+                        depth_data[i] = z >= min_depth && z <= max_depth ? z : 0.0f;
+                        ir_data[i] = std::min(65535.0f, 4.0e10f / (z * z));
+                    }
+                }
+                for(auto* frame : {ir.get(), depth.get()})
+                {
+                    frame->timestamp = timestamp;
+                    frame->sequence = sequence;
+                    frame->format = libfreenect2::Frame::Float;
+                }
+                dispatch(libfreenect2::Frame::Ir, ir);
+                dispatch(libfreenect2::Frame::Depth, depth);
+            }
+            if(rgb_enabled)
+            {
+                const libfreenect2::Frame* previous = color.get();
+                color->timestamp = timestamp;
+                color->sequence = sequence;
+                color->exposure = 10.0f;
+                color->gain = 1.0f;
+                color->gamma = 1.0f;
+                // The first pixel carries the sequence, so consumers can tell frames apart.
+                std::memcpy(color->data, &sequence, sizeof(sequence));
+                dispatch(libfreenect2::Frame::Color, color);
+                if(color.get() != previous)
+                    fillColorPattern(*color);
+            }
+            pace(next_frame);
+        }
+    }
+
+    void virtual_device::runRecording()
+    {
+        auto frame = std::make_unique<libfreenect2::Frame>(0, 0, 0);
+        auto decoded = std::make_unique<libfreenect2::Frame>(0, 0, 0);
+        auto next_frame = std::chrono::steady_clock::now();
+        std::int64_t previous_ns = -1;
+        bool delivered = false;
+
+        for(std::size_t i = 0; running.load(std::memory_order_acquire); ++i)
+        {
+            if(i >= reader->size())
+            {
+                // Nothing playable, or played once without looping: idle until stopped.
+                if(!config.loop || !delivered)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    i = reader->size() - 1;
+                    continue;
+                }
+                i = 0;
+                previous_ns = -1;
+                delivered = false;
+            }
+
+            const recording::index_entry& entry = reader->entry(i);
+            const auto type = static_cast<libfreenect2::Frame::Type>(entry.type);
+            const bool enabled = type == libfreenect2::Frame::Color ? rgb_enabled : depth_enabled;
+            if(entry.device_id != config.recording_device_id || !enabled)
+                continue;
+
+            if(config.fps > 0.0 && previous_ns >= 0)
+            {
+                next_frame += std::chrono::nanoseconds(std::max<std::int64_t>(entry.record_ns - previous_ns, 0));
+                std::this_thread::sleep_until(next_frame);
+            }
+            else
+                next_frame = std::chrono::steady_clock::now();
+            previous_ns = entry.record_ns;
+
+            if(reader->isCompressed(i))
+            {
+                // A view would hand listeners the short compressed payload under the decoded size, so it is decoded instead.
+                const std::size_t size = static_cast<std::size_t>(entry.width) * entry.height * entry.bytes_per_pixel;
+                if(decoded->width * decoded->height * decoded->bytes_per_pixel < size)
+                    decoded = std::make_unique<libfreenect2::Frame>(entry.width, entry.height, entry.bytes_per_pixel);
+                if(reader->read(i, *decoded, size).status != Status::Success)
+                    continue;
+                dispatch(type, decoded);
+            }
+            else
+            {
+                reader->view(i, *frame);
+                dispatch(type, frame);
+            }
+            delivered = true;
+        }
+    }
+
+    bool virtual_device::pacing_listener::onNewFrame(const libfreenect2::Frame::Type type, libfreenect2::Frame* frame)
+    {
+        // IR and depth come from the same packet; pacing one of them paces both.
+        if(type != libfreenect2::Frame::Ir)
+            owner.pace(next_frame);
+
+        std::lock_guard lock(owner.listener_mutex);
+        libfreenect2::FrameListener* listener = type == libfreenect2::Frame::Color
+                                                ? owner.color_listener : owner.ir_depth_listener;
+        return listener != nullptr && listener->onNewFrame(type, frame);
+    }
+}
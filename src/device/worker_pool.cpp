@@ -0,0 +1,91 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "device/worker_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace vision
+{
+    worker_pool::worker_pool(const std::size_t threads, const std::vector<int>& cpus)
+    {
+        for(std::size_t i = 1; i < threads; ++i)
+        {
+            const int cpu = cpus.empty() ? -1 : cpus[(i - 1) % cpus.size()];
+            workers.emplace_back(&worker_pool::runWorker, this, cpu);
+        }
+    }
+
+    worker_pool::~worker_pool()
+    {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        job_ready.notify_all();
+        for(auto& worker : workers)
+            worker.join();
+    }
+
+    void worker_pool::work()
+    {
+        for(std::size_t i = next_task.fetch_add(1, std::memory_order_relaxed); i < task_count;
+            i = next_task.fetch_add(1, std::memory_order_relaxed))
+            (*task)(i);
+    }
+
+    void worker_pool::runWorker(const int cpu)
+    {
+        if(cpu >= 0)
+        {
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(cpu, &cpu_set);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        }
+
+        std::uint64_t seen = 0;
+        std::unique_lock lock(mutex);
+        while(true)
+        {
+            job_ready.wait(lock, [&] { return stopping || generation != seen; });
+            if(stopping)
+                return;
+            seen = generation;
+
+            lock.unlock();
+            work();
+            lock.lock();
+            if(--active == 0)
+                job_done.notify_one();
+        }
+    }
+
+    void worker_pool::run(const std::size_t count, const std::function<void(std::size_t)>& body)
+    {
+        if(workers.empty() || count <= 1)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+                body(i);
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            task = &body;
+            task_count = count;
+            next_task.store(0, std::memory_order_relaxed);
+            active = workers.size();
+            ++generation;
+        }
+        job_ready.notify_all();
+
+        work();
+
+        std::unique_lock lock(mutex);
+        job_done.wait(lock, [&] { return active == 0; });
+        task = nullptr;
+    }
+}
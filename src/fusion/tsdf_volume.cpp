@@ -0,0 +1,565 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "fusion/tsdf_volume.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#ifdef VISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::uint64_t empty_key = ~0ull; ///< Marks a free hash slot; never produced by brickKey().
+        constexpr std::int64_t key_offset = 1 << 20; ///< Bias making 21-bit brick coordinates unsigned.
+        constexpr std::uint64_t key_mask = (1ull << 21) - 1; ///< One packed coordinate.
+        constexpr std::size_t initial_slots = 4096; ///< Hash slots of an empty volume.
+        constexpr std::size_t band_rows = 16; ///< Depth rows per allocation task.
+        constexpr std::size_t seed_stride = 2; ///< Pixel stride of the brick allocation pass.
+        constexpr int max_cube_indices = 36; ///< Edge indices of the largest marching-cubes case, twelve triangles.
+
+        /**
+         * @struct cube_tables
+         * @brief Marching-cubes case table.
+         */
+        struct cube_tables
+        {
+            int edge_corners[12][2]; ///< Corners at the ends of every cube edge.
+            std::int8_t triangles[256][max_cube_indices + 1]; ///< Edge triples of every case, -1 terminated.
+        };
+
+        /**
+         * @brief Builds the marching-cubes case table.
+         *
+         * Corner c of a cube sits at (c & 1, c >> 1 & 1, c >> 2 & 1); it is inside when its
+         * distance is negative. On every face, each run of inside corners is cut off by one
+         * segment, so a face with two diagonal inside corners is always split the same way
+         * whichever cube it is seen from and the surface has no holes. The segments are
+         * oriented along the counter-clockwise face order, chained into loops over the
+         * cube, and each loop is fanned into triangles that face the outside corners.
+         */
+        cube_tables buildCubeTables()
+        {
+            static constexpr int faces[6][4] = {{0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4},
+                                                {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6}};
+            cube_tables tables{};
+            int edge_of[8][8];
+            int edges = 0;
+            for(int a = 0; a < 8; ++a)
+                for(const int bit : {1, 2, 4})
+                    if((a & bit) == 0)
+                    {
+                        edge_of[a][a | bit] = edge_of[a | bit][a] = edges;
+                        tables.edge_corners[edges][0] = a;
+                        tables.edge_corners[edges][1] = a | bit;
+                        ++edges;
+                    }
+
+            for(int cube = 0; cube < 256; ++cube)
+            {
+                const auto inside = [cube](const int corner) { return (cube >> corner & 1) != 0; };
+                int next[12];
+                std::fill(std::begin(next), std::end(next), -1);
+                for(const auto& face : faces)
+                    for(int q = 0; q < 4; ++q)
+                    {
+                        const int a = face[q], b = face[(q + 1) % 4];
+                        if(inside(a) || !inside(b))
+                            continue;
+                        for(int s = 1; s < 4; ++s)
+                        {
+                            const int c = face[(q + s) % 4], d = face[(q + s + 1) % 4];
+                            if(inside(c) && !inside(d))
+                            {
+                                next[edge_of[a][b]] = edge_of[c][d];
+                                break;
+                            }
+                        }
+                    }
+
+                int count = 0;
+                bool used[12] = {};
+                for(int first = 0; first < 12; ++first)
+                {
+                    if(next[first] < 0 || used[first])
+                        continue;
+                    int loop[12];
+                    int length = 0;
+                    for(int e = first; !used[e]; e = next[e])
+                    {
+                        used[e] = true;
+                        loop[length++] = e;
+                    }
+                    for(int m = 1; m + 1 < length; ++m)
+                    {
+                        tables.triangles[cube][count++] = static_cast<std::int8_t>(loop[0]);
+                        tables.triangles[cube][count++] = static_cast<std::int8_t>(loop[m]);
+                        tables.triangles[cube][count++] = static_cast<std::int8_t>(loop[m + 1]);
+                    }
+                }
+                tables.triangles[cube][count] = -1;
+            }
+            return tables;
+        }
+
+        const cube_tables& cubeTables()
+        {
+            static const cube_tables tables = buildCubeTables();
+            return tables;
+        }
+
+        std::size_t hashKey(const std::uint64_t key)
+        {
+            return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> 20);
+        }
+
+        /**
+         * @brief Rounds toward negative infinity when dividing by the brick size.
+         */
+        int brickOf(const int voxel)
+        {
+            return voxel >= 0 ? voxel / tsdf_volume::brick_size : (voxel + 1) / tsdf_volume::brick_size - 1;
+        }
+
+        /**
+         * @struct brick_arguments
+         * @brief Inputs and outputs of the integration of one brick.
+         */
+        struct brick_arguments
+        {
+            float* tsdf;
+            float* weight;
+            float base[3];    ///< Camera coordinates of voxel (0, 0, 0).
+            float step[3][3]; ///< Camera offset of one voxel along world x, y and z.
+            const float* depth;
+            int width;
+            int height;
+            float fx, fy, cx, cy;
+            float min_depth, max_depth;
+            float truncation;
+            float inv_truncation;
+            float max_weight;
+        };
+
+        // Both kernels use the same operations in the same order, without fused multiply-adds.
+        bool scalarBrick(const brick_arguments& a)
+        {
+            bool changed = false;
+            const float width = static_cast<float>(a.width), height = static_cast<float>(a.height);
+            for(int k = 0; k < tsdf_volume::brick_size; ++k)
+                for(int j = 0; j < tsdf_volume::brick_size; ++j)
+                {
+                    const float fk = static_cast<float>(k), fj = static_cast<float>(j);
+                    const float row_x = a.base[0] + fk * a.step[2][0] + fj * a.step[1][0];
+                    const float row_y = a.base[1] + fk * a.step[2][1] + fj * a.step[1][1];
+                    const float row_z = a.base[2] + fk * a.step[2][2] + fj * a.step[1][2];
+                    for(int i = 0; i < tsdf_volume::brick_size; ++i)
+                    {
+                        const float fi = static_cast<float>(i);
+                        const float x = row_x + fi * a.step[0][0];
+                        const float y = row_y + fi * a.step[0][1];
+                        const float z = row_z + fi * a.step[0][2];
+                        const float inv_z = 1.0f / z;
+                        const float u = x * inv_z * a.fx + a.cx;
+                        const float v = y * inv_z * a.fy + a.cy;
+                        if(!(z > 0.0f && u >= 0.0f && u < width && v >= 0.0f && v < height))
+                            continue;
+
+                        const float d = a.depth[static_cast<int>(v) * a.width + static_cast<int>(u)] * 0.001f;
+                        const float sdf = d - z;
+                        if(!(d >= a.min_depth && d <= a.max_depth && sdf >= -a.truncation))
+                            continue;
+
+                        const int n = (k * tsdf_volume::brick_size + j) * tsdf_volume::brick_size + i;
+                        const float t = std::min(1.0f, sdf * a.inv_truncation);
+                        const float w = a.weight[n];
+                        a.tsdf[n] = (a.tsdf[n] * w + t) / (w + 1.0f);
+                        a.weight[n] = std::min(w + 1.0f, a.max_weight);
+                        changed = true;
+                    }
+                }
+            return changed;
+        }
+
+#ifdef VISION_X86_KERNELS
+        __attribute__((target("avx2")))
+        bool avx2Brick(const brick_arguments& a)
+        {
+            const __m256 lanes = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256 step_x = _mm256_mul_ps(lanes, _mm256_set1_ps(a.step[0][0]));
+            const __m256 step_y = _mm256_mul_ps(lanes, _mm256_set1_ps(a.step[0][1]));
+            const __m256 step_z = _mm256_mul_ps(lanes, _mm256_set1_ps(a.step[0][2]));
+            const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+            const __m256 width = _mm256_set1_ps(static_cast<float>(a.width));
+            const __m256 height = _mm256_set1_ps(static_cast<float>(a.height));
+            const __m256 fx = _mm256_set1_ps(a.fx), fy = _mm256_set1_ps(a.fy);
+            const __m256 cx = _mm256_set1_ps(a.cx), cy = _mm256_set1_ps(a.cy);
+            const __m256 min_depth = _mm256_set1_ps(a.min_depth), max_depth = _mm256_set1_ps(a.max_depth);
+            const __m256 neg_truncation = _mm256_set1_ps(-a.truncation);
+            const __m256 inv_truncation = _mm256_set1_ps(a.inv_truncation);
+            const __m256 max_weight = _mm256_set1_ps(a.max_weight);
+            const __m256 millimeters = _mm256_set1_ps(0.001f);
+            const __m256i stride = _mm256_set1_epi32(a.width);
+
+            int changed = 0;
+            for(int k = 0; k < tsdf_volume::brick_size; ++k)
+                for(int j = 0; j < tsdf_volume::brick_size; ++j)
+                {
+                    const float fk = static_cast<float>(k), fj = static_cast<float>(j);
+                    const float row_x = a.base[0] + fk * a.step[2][0] + fj * a.step[1][0];
+                    const float row_y = a.base[1] + fk * a.step[2][1] + fj * a.step[1][1];
+                    const float row_z = a.base[2] + fk * a.step[2][2] + fj * a.step[1][2];
+                    const __m256 x = _mm256_add_ps(_mm256_set1_ps(row_x), step_x);
+                    const __m256 y = _mm256_add_ps(_mm256_set1_ps(row_y), step_y);
+                    const __m256 z = _mm256_add_ps(_mm256_set1_ps(row_z), step_z);
+                    const __m256 inv_z = _mm256_div_ps(one, z);
+                    const __m256 u = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(x, inv_z), fx), cx);
+                    const __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(y, inv_z), fy), cy);
+                    __m256 valid = _mm256_and_ps(_mm256_cmp_ps(z, zero, _CMP_GT_OQ),
+                                                 _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ),
+                                                               _mm256_cmp_ps(u, width, _CMP_LT_OQ)));
+                    valid = _mm256_and_ps(valid, _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_GE_OQ),
+                                                               _mm256_cmp_ps(v, height, _CMP_LT_OQ)));
+                    if(_mm256_movemask_ps(valid) == 0)
+                        continue;
+
+                    const __m256i pixel = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(v), stride),
+                                                           _mm256_cvttps_epi32(u));
+                    const __m256i index = _mm256_and_si256(pixel, _mm256_castps_si256(valid));
+                    const __m256 d = _mm256_mul_ps(_mm256_mask_i32gather_ps(zero, a.depth, index, valid, 4), millimeters);
+                    const __m256 sdf = _mm256_sub_ps(d, z);
+                    valid = _mm256_and_ps(valid, _mm256_and_ps(_mm256_cmp_ps(d, min_depth, _CMP_GE_OQ),
+                                                               _mm256_cmp_ps(d, max_depth, _CMP_LE_OQ)));
+                    valid = _mm256_and_ps(valid, _mm256_cmp_ps(sdf, neg_truncation, _CMP_GE_OQ));
+                    const int mask = _mm256_movemask_ps(valid);
+                    if(mask == 0)
+                        continue;
+
+                    const int n = (k * tsdf_volume::brick_size + j) * tsdf_volume::brick_size;
+                    const __m256 t = _mm256_min_ps(one, _mm256_mul_ps(sdf, inv_truncation));
+                    const __m256 w = _mm256_load_ps(a.weight + n);
+                    const __m256 old = _mm256_load_ps(a.tsdf + n);
+                    const __m256 fused = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(old, w), t), _mm256_add_ps(w, one));
+                    const __m256 weight = _mm256_min_ps(_mm256_add_ps(w, one), max_weight);
+                    _mm256_store_ps(a.tsdf + n, _mm256_blendv_ps(old, fused, valid));
+                    _mm256_store_ps(a.weight + n, _mm256_blendv_ps(w, weight, valid));
+                    changed |= mask;
+                }
+            return changed != 0;
+        }
+#endif
+
+        using brick_kernel = bool (*)(const brick_arguments&);
+
+        brick_kernel selectKernel(const tsdf_volume::kernel kernel)
+        {
+#ifdef VISION_X86_KERNELS
+            if(kernel == tsdf_volume::kernel::AVX2)
+                return avx2Brick;
+#endif
+            return scalarBrick;
+        }
+    }
+
+    tsdf_volume::brick::brick(const int x, const int y, const int z)
+        : x(x), y(y), z(z)
+    {
+        std::fill(std::begin(tsdf), std::end(tsdf), 1.0f);
+        std::fill(std::begin(weight), std::end(weight), 0.0f);
+    }
+
+    tsdf_volume::tsdf_volume(const tsdf_config& config, const kernel requested)
+        : config(config),
+          pool(std::make_unique<worker_pool>(config.threads > 0 ? config.threads
+                                                                : std::max(1u, std::thread::hardware_concurrency()),
+                                             config.cpus)),
+          table_keys(initial_slots, empty_key),
+          table_bricks(initial_slots, -1)
+    {
+        active_kernel = resolveKernel(requested);
+    }
+
+    std::uint64_t tsdf_volume::brickKey(const int x, const int y, const int z)
+    {
+        return (static_cast<std::uint64_t>(x + key_offset) & key_mask)
+               | (static_cast<std::uint64_t>(y + key_offset) & key_mask) << 21
+               | (static_cast<std::uint64_t>(z + key_offset) & key_mask) << 42;
+    }
+
+    std::int32_t tsdf_volume::findBrick(const std::uint64_t key) const
+    {
+        const std::size_t mask = table_keys.size() - 1;
+        for(std::size_t slot = hashKey(key) & mask;; slot = (slot + 1) & mask)
+        {
+            if(table_keys[slot] == key)
+                return table_bricks[slot];
+            if(table_keys[slot] == empty_key)
+                return -1;
+        }
+    }
+
+    std::int32_t tsdf_volume::insertBrick(const std::uint64_t key)
+    {
+        if((bricks.size() + 1) * 2 > table_keys.size())
+        {
+            // Keep the load factor under one half so probe chains stay short.
+            std::vector<std::uint64_t> keys(table_keys.size() * 2, empty_key);
+            std::vector<std::int32_t> indices(table_keys.size() * 2, -1);
+            const std::size_t mask = keys.size() - 1;
+            for(std::size_t i = 0; i < table_keys.size(); ++i)
+            {
+                if(table_keys[i] == empty_key)
+                    continue;
+                std::size_t slot = hashKey(table_keys[i]) & mask;
+                while(keys[slot] != empty_key)
+                    slot = (slot + 1) & mask;
+                keys[slot] = table_keys[i];
+                indices[slot] = table_bricks[i];
+            }
+            table_keys.swap(keys);
+            table_bricks.swap(indices);
+        }
+
+        const std::size_t mask = table_keys.size() - 1;
+        std::size_t slot = hashKey(key) & mask;
+        for(; table_keys[slot] != empty_key; slot = (slot + 1) & mask)
+            if(table_keys[slot] == key)
+                return table_bricks[slot];
+
+        const auto index = static_cast<std::int32_t>(bricks.size());
+        const auto coordinate = [key](const int shift) {
+            return static_cast<int>(static_cast<std::int64_t>(key >> shift & key_mask) - key_offset);
+        };
+        bricks.push_back(std::make_unique<brick>(coordinate(0), coordinate(21), coordinate(42)));
+        table_keys[slot] = key;
+        table_bricks[slot] = index;
+        return index;
+    }
+
+    Result tsdf_volume::integrate(const libfreenect2::Frame& depth,
+                                  const libfreenect2::Freenect2Device::IrCameraParams& params,
+                                  const pose& world_from_camera)
+    {
+        if(depth.data == nullptr || depth.width == 0 || depth.height == 0)
+            return {Status::EmptyData, "Depth frame is empty."};
+        if(depth.bytes_per_pixel != sizeof(float))
+            return {Status::InvalidParam, "Depth frame is not a float frame."};
+        if(!(params.fx > 0.0f && params.fy > 0.0f))
+            return {Status::InvalidParam, "Depth camera focal length is not positive."};
+
+        ++frame_count;
+        const auto* pixels = reinterpret_cast<const float*>(depth.data);
+        const auto width = static_cast<int>(depth.width), height = static_cast<int>(depth.height);
+        const float brick_edge = config.voxel_size * brick_size;
+        const float inv_brick_edge = 1.0f / brick_edge;
+        const pose& m = world_from_camera;
+
+        // Allocate the bricks crossed by the truncation band of every depth sample.
+        const int samples = static_cast<int>(std::ceil(2.0f * config.truncation / (0.5f * brick_edge))) + 1;
+        const std::size_t bands = (depth.height + band_rows - 1) / band_rows;
+        if(band_keys.size() < bands)
+            band_keys.resize(bands);
+        pool->run(bands, [&](const std::size_t band) {
+            std::vector<std::uint64_t>& keys = band_keys[band];
+            keys.clear();
+            std::uint64_t recent[16];
+            std::fill(std::begin(recent), std::end(recent), empty_key);
+            const std::size_t last_row = std::min(depth.height, (band + 1) * band_rows);
+            for(std::size_t r = band * band_rows; r < last_row; r += seed_stride)
+            {
+                const float ray_y = (static_cast<float>(r) + 0.5f - params.cy) / params.fy;
+                for(std::size_t c = 0; c < depth.width; c += seed_stride)
+                {
+                    const float d = pixels[r * depth.width + c] * 0.001f;
+                    if(!(d >= config.min_depth && d <= config.max_depth))
+                        continue;
+                    const float ray_x = (static_cast<float>(c) + 0.5f - params.cx) / params.fx;
+                    for(int s = 0; s < samples; ++s)
+                    {
+                        const float range = d - config.truncation
+                                            + 2.0f * config.truncation * static_cast<float>(s) / static_cast<float>(samples - 1);
+                        const float x = ray_x * range, y = ray_y * range;
+                        const float wx = m[0] * x + m[1] * y + m[2] * range + m[3];
+                        const float wy = m[4] * x + m[5] * y + m[6] * range + m[7];
+                        const float wz = m[8] * x + m[9] * y + m[10] * range + m[11];
+                        const std::uint64_t key = brickKey(static_cast<int>(std::floor(wx * inv_brick_edge)),
+                                                           static_cast<int>(std::floor(wy * inv_brick_edge)),
+                                                           static_cast<int>(std::floor(wz * inv_brick_edge)));
+                        // Neighbouring samples mostly hit the same few bricks; skip the recent ones.
+                        std::uint64_t& seen = recent[hashKey(key) & 15];
+                        if(seen == key)
+                            continue;
+                        seen = key;
+                        keys.push_back(key);
+                    }
+                }
+            }
+        });
+
+        visible.clear();
+        for(std::size_t band = 0; band < bands; ++band)
+            for(const std::uint64_t key : band_keys[band])
+            {
+                const std::int32_t index = insertBrick(key);
+                if(bricks[index]->visible_frame != frame_count)
+                {
+                    bricks[index]->visible_frame = frame_count;
+                    visible.push_back(index);
+                }
+            }
+
+        // camera_from_world is the inverse rigid transform: R^T and -R^T t.
+        const float rotation[3][3] = {{m[0], m[4], m[8]}, {m[1], m[5], m[9]}, {m[2], m[6], m[10]}};
+        float translation[3];
+        for(int row = 0; row < 3; ++row)
+            translation[row] = -(rotation[row][0] * m[3] + rotation[row][1] * m[7] + rotation[row][2] * m[11]);
+
+        const brick_kernel integrate_brick = selectKernel(active_kernel);
+        updated.assign(visible.size(), 0);
+        pool->run(visible.size(), [&](const std::size_t i) {
+            brick& _brick = *bricks[visible[i]];
+            const float origin[3] = {static_cast<float>(_brick.x * brick_size) * config.voxel_size,
+                                     static_cast<float>(_brick.y * brick_size) * config.voxel_size,
+                                     static_cast<float>(_brick.z * brick_size) * config.voxel_size};
+            brick_arguments arguments{_brick.tsdf, _brick.weight, {}, {}, pixels, width, height,
+                                      params.fx, params.fy, params.cx, params.cy,
+                                      config.min_depth, config.max_depth, config.truncation,
+                                      1.0f / config.truncation, config.max_weight};
+            for(int row = 0; row < 3; ++row)
+            {
+                arguments.base[row] = rotation[row][0] * origin[0] + rotation[row][1] * origin[1]
+                                      + rotation[row][2] * origin[2] + translation[row];
+                for(int axis = 0; axis < 3; ++axis)
+                    arguments.step[axis][row] = rotation[row][axis] * config.voxel_size;
+            }
+            updated[i] = integrate_brick(arguments);
+        });
+
+        // A changed brick also invalidates the cubes of the lower neighbours that reach into it.
+        for(std::size_t i = 0; i < visible.size(); ++i)
+        {
+            if(!updated[i])
+                continue;
+            const brick& _brick = *bricks[visible[i]];
+            for(int n = 0; n < 8; ++n)
+            {
+                const std::int32_t neighbour = n == 0 ? visible[i]
+                        : findBrick(brickKey(_brick.x - (n & 1), _brick.y - (n >> 1 & 1), _brick.z - (n >> 2 & 1)));
+                if(neighbour >= 0)
+                    bricks[neighbour]->dirty = true;
+            }
+        }
+        return Result(Status::Success);
+    }
+
+    void tsdf_volume::meshBrick(const std::int32_t index)
+    {
+        brick& _brick = *bricks[index];
+        _brick.mesh.clear();
+        const cube_tables& tables = cubeTables();
+
+        // Bricks holding the upper corners of the cubes on the brick faces, by (dx | dy << 1 | dz << 2).
+        const brick* around[8];
+        for(int n = 0; n < 8; ++n)
+        {
+            const std::int32_t found = n == 0 ? index
+                    : findBrick(brickKey(_brick.x + (n & 1), _brick.y + (n >> 1 & 1), _brick.z + (n >> 2 & 1)));
+            around[n] = found >= 0 ? bricks[found].get() : nullptr;
+        }
+
+        const float voxel = config.voxel_size;
+        for(int k = 0; k < brick_size; ++k)
+            for(int j = 0; j < brick_size; ++j)
+                for(int i = 0; i < brick_size; ++i)
+                {
+                    float value[8];
+                    int cube = 0;
+                    bool usable = true;
+                    for(int c = 0; c < 8 && usable; ++c)
+                    {
+                        const int ci = i + (c & 1), cj = j + (c >> 1 & 1), ck = k + (c >> 2 & 1);
+                        const brick* owner = around[(ci >> 3) | (cj >> 3) << 1 | (ck >> 3) << 2];
+                        if(owner == nullptr)
+                        {
+                            usable = false;
+                            break;
+                        }
+                        const int n = ((ck & 7) * brick_size + (cj & 7)) * brick_size + (ci & 7);
+                        value[c] = owner->tsdf[n];
+                        // Unobserved voxels and clamped distances carry no zero crossing.
+                        usable = owner->weight[n] > 0.0f && value[c] > -1.0f && value[c] < 1.0f;
+                        cube |= (value[c] < 0.0f ? 1 : 0) << c;
+                    }
+                    if(!usable || cube == 0 || cube == 255)
+                        continue;
+
+                    const int gx = _brick.x * brick_size + i, gy = _brick.y * brick_size + j, gz = _brick.z * brick_size + k;
+                    for(const std::int8_t* e = tables.triangles[cube]; *e >= 0; ++e)
+                    {
+                        const int a = tables.edge_corners[*e][0], b = tables.edge_corners[*e][1];
+                        const float t = value[a] / (value[a] - value[b]);
+                        const float px = static_cast<float>(gx + (a & 1)) + t * static_cast<float>((b & 1) - (a & 1));
+                        const float py = static_cast<float>(gy + (a >> 1 & 1)) + t * static_cast<float>((b >> 1 & 1) - (a >> 1 & 1));
+                        const float pz = static_cast<float>(gz + (a >> 2 & 1)) + t * static_cast<float>((b >> 2 & 1) - (a >> 2 & 1));
+                        _brick.mesh.insert(_brick.mesh.end(), {px * voxel, py * voxel, pz * voxel});
+                    }
+                }
+        _brick.dirty = false;
+    }
+
+    std::size_t tsdf_volume::extractMesh(triangle_mesh& mesh)
+    {
+        std::vector<std::int32_t> dirty;
+        for(std::size_t i = 0; i < bricks.size(); ++i)
+            if(bricks[i]->dirty)
+                dirty.push_back(static_cast<std::int32_t>(i));
+        pool->run(dirty.size(), [&](const std::size_t i) { meshBrick(dirty[i]); });
+
+        std::size_t total = 0;
+        for(const auto& _brick : bricks)
+            total += _brick->mesh.size();
+        mesh.vertices.resize(total);
+        float* out = mesh.vertices.data();
+        for(const auto& _brick : bricks)
+        {
+            std::copy(_brick->mesh.begin(), _brick->mesh.end(), out);
+            out += _brick->mesh.size();
+        }
+        return dirty.size();
+    }
+
+    bool tsdf_volume::sample(const float x, const float y, const float z, float& tsdf, float& weight) const
+    {
+        const int vx = static_cast<int>(std::floor(x / config.voxel_size + 0.5f));
+        const int vy = static_cast<int>(std::floor(y / config.voxel_size + 0.5f));
+        const int vz = static_cast<int>(std::floor(z / config.voxel_size + 0.5f));
+        const int bx = brickOf(vx), by = brickOf(vy), bz = brickOf(vz);
+        const std::int32_t index = findBrick(brickKey(bx, by, bz));
+        if(index < 0)
+            return false;
+        const int n = ((vz - bz * brick_size) * brick_size + (vy - by * brick_size)) * brick_size + (vx - bx * brick_size);
+        tsdf = bricks[index]->tsdf[n];
+        weight = bricks[index]->weight[n];
+        return true;
+    }
+
+    void tsdf_volume::reset()
+    {
+        bricks.clear();
+        table_keys.assign(initial_slots, empty_key);
+        table_bricks.assign(initial_slots, -1);
+    }
+
+    std::size_t tsdf_volume::getDirtyBrickCount() const
+    {
+        return static_cast<std::size_t>(std::count_if(bricks.begin(), bricks.end(),
+                                                      [](const auto& _brick) { return _brick->dirty; }));
+    }
+}
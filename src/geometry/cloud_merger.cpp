@@ -0,0 +1,122 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "geometry/cloud_merger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef VISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Transform kernel signature: points [0, count) of the inputs to the outputs.
+         */
+        using transform_kernel = void (*)(const pose& m, const float* x, const float* y, const float* z,
+                                          float* out_x, float* out_y, float* out_z, std::size_t count);
+
+        // Both kernels use the same operations in the same order, without fused multiply-adds.
+        void scalarTransform(const pose& m, const float* x, const float* y, const float* z,
+                             float* out_x, float* out_y, float* out_z, const std::size_t count)
+        {
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                out_x[i] = m[0] * x[i] + m[1] * y[i] + m[2] * z[i] + m[3];
+                out_y[i] = m[4] * x[i] + m[5] * y[i] + m[6] * z[i] + m[7];
+                out_z[i] = m[8] * x[i] + m[9] * y[i] + m[10] * z[i] + m[11];
+            }
+        }
+
+#ifdef VISION_X86_KERNELS
+        __attribute__((target("avx2")))
+        void avx2Transform(const pose& m, const float* x, const float* y, const float* z,
+                           float* out_x, float* out_y, float* out_z, const std::size_t count)
+        {
+            __m256 row[12];
+            for(int i = 0; i < 12; ++i)
+                row[i] = _mm256_set1_ps(m[i]);
+
+            std::size_t i = 0;
+            for(; i + 8 <= count; i += 8)
+            {
+                const __m256 px = _mm256_loadu_ps(x + i);
+                const __m256 py = _mm256_loadu_ps(y + i);
+                const __m256 pz = _mm256_loadu_ps(z + i);
+                for(int r = 0; r < 3; ++r)
+                {
+                    const __m256 value = _mm256_add_ps(
+                            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(row[r * 4], px), _mm256_mul_ps(row[r * 4 + 1], py)),
+                                          _mm256_mul_ps(row[r * 4 + 2], pz)),
+                            row[r * 4 + 3]);
+                    _mm256_storeu_ps((r == 0 ? out_x : r == 1 ? out_y : out_z) + i, value);
+                }
+            }
+            scalarTransform(m, x + i, y + i, z + i, out_x + i, out_y + i, out_z + i, count - i);
+        }
+#endif
+    }
+
+    cloud_merger::cloud_merger(const std::size_t threads, const std::vector<int>& cpus, const kernel requested)
+        : pool(std::make_unique<worker_pool>(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()),
+                                             cpus))
+    {
+        active_kernel = resolveKernel(requested);
+    }
+
+    Result cloud_merger::merge(const std::vector<merge_source>& sources, point_cloud& merged)
+    {
+        std::size_t total = 0;
+        bool with_color = false;
+        for(const merge_source& source : sources)
+        {
+            if(source.cloud == nullptr)
+                return {Status::InvalidParam, "Merge source has no cloud."};
+            const point_cloud& cloud = *source.cloud;
+            if(cloud.x.size() != cloud.size() || cloud.y.size() != cloud.size() || cloud.z.size() != cloud.size()
+               || (!cloud.rgb.empty() && cloud.rgb.size() != cloud.size()))
+                return {Status::InvalidParam, "Merge source arrays do not match its size."};
+            total += cloud.size();
+            with_color |= !cloud.rgb.empty();
+        }
+        merged.resize(total, 1, with_color);
+
+        chunks.clear();
+        std::size_t offset = 0;
+        for(std::size_t s = 0; s < sources.size(); ++s)
+        {
+            const std::size_t size = sources[s].cloud->size();
+            for(std::size_t begin = 0; begin < size; begin += chunk_points)
+                chunks.push_back({s, begin, std::min(size, begin + chunk_points), offset + begin});
+            offset += size;
+        }
+
+#ifdef VISION_X86_KERNELS
+        const transform_kernel transform = active_kernel == kernel::AVX2 ? avx2Transform : scalarTransform;
+#else
+        const transform_kernel transform = scalarTransform;
+#endif
+        pool->run(chunks.size(), [&](const std::size_t i) {
+            const chunk& _chunk = chunks[i];
+            const merge_source& source = sources[_chunk.source];
+            const point_cloud& cloud = *source.cloud;
+            const std::size_t count = _chunk.end - _chunk.begin;
+            transform(source.world_from_camera, cloud.x.data() + _chunk.begin, cloud.y.data() + _chunk.begin,
+                      cloud.z.data() + _chunk.begin, merged.x.data() + _chunk.offset, merged.y.data() + _chunk.offset,
+                      merged.z.data() + _chunk.offset, count);
+            if(!with_color)
+                return;
+            if(cloud.rgb.empty())
+                std::fill_n(merged.rgb.data() + _chunk.offset, count, 0.0f);
+            else
+                std::memcpy(merged.rgb.data() + _chunk.offset, cloud.rgb.data() + _chunk.begin, count * sizeof(float));
+        });
+        return Result(Status::Success);
+    }
+}
@@ -0,0 +1,136 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "geometry/extrinsics_store.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+
+namespace vision
+{
+    namespace
+    {
+        bool isToken(const std::string& serial)
+        {
+            return !serial.empty() && serial.find_first_of(" \t\r\n#") == std::string::npos;
+        }
+    }
+
+    std::string extrinsics_store::defaultPath()
+    {
+        std::filesystem::path base;
+        if(const char* xdg = std::getenv("XDG_CONFIG_HOME"); xdg != nullptr && *xdg != '\0')
+            base = xdg;
+        else if(const char* home = std::getenv("HOME"); home != nullptr && *home != '\0')
+            base = std::filesystem::path(home) / ".config";
+        else
+            base = std::filesystem::current_path();
+        return (base / "fusion-kinect2" / "extrinsics.txt").string();
+    }
+
+    Result extrinsics_store::load(const std::string& path)
+    {
+        std::ifstream file(path);
+        if(!file)
+        {
+            std::error_code error;
+            return std::filesystem::exists(path, error)
+                   ? Result(Status::PermissionDenied, "Cannot read " + path + ".")
+                   : Result(Status::NotFound, path + " does not exist.");
+        }
+
+        std::map<std::string, pose> loaded;
+        std::string line;
+        for(std::size_t number = 1; std::getline(file, line); ++number)
+        {
+            std::istringstream fields(line);
+            std::string serial;
+            if(!(fields >> serial) || serial[0] == '#')
+                continue;
+
+            pose _pose = identity_pose;
+            for(int i = 0; i < 12; ++i)
+            {
+                if(!(fields >> _pose[i]) || !std::isfinite(_pose[i]))
+                    return {Status::InvalidParam, path + ":" + std::to_string(number) + ": expected 12 numbers after the serial."};
+            }
+            if(std::string extra; fields >> extra)
+                return {Status::InvalidParam, path + ":" + std::to_string(number) + ": unexpected '" + extra + "'."};
+            if(!loaded.emplace(serial, _pose).second)
+                return {Status::Conflict, path + ":" + std::to_string(number) + ": " + serial + " is listed twice."};
+        }
+
+        std::unique_lock lock(mutex);
+        poses.swap(loaded);
+        return Result(Status::Success);
+    }
+
+    Result extrinsics_store::save(const std::string& path) const
+    {
+        std::error_code error;
+        if(const auto directory = std::filesystem::path(path).parent_path(); !directory.empty())
+            std::filesystem::create_directories(directory, error);
+
+        // Written next to the target and renamed over it, so a crash never leaves half a calibration.
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::trunc);
+            if(!file)
+                return {Status::PermissionDenied, "Cannot write " + temporary + "."};
+            file.precision(std::numeric_limits<float>::max_digits10);
+            file << "# serial  r00 r01 r02 tx  r10 r11 r12 ty  r20 r21 r22 tz (world_from_camera, meters)\n";
+            std::shared_lock lock(mutex);
+            for(const auto& [serial, _pose] : poses)
+            {
+                file << serial;
+                for(int i = 0; i < 12; ++i)
+                    file << ' ' << _pose[i];
+                file << '\n';
+            }
+            if(!file.flush())
+                return {Status::Error, "Cannot write " + temporary + "."};
+        }
+        std::filesystem::rename(temporary, path, error);
+        if(error)
+            return {Status::Error, "Cannot replace " + path + ": " + error.message()};
+        return Result(Status::Success);
+    }
+
+    bool extrinsics_store::set(const std::string& serial, const pose& world_from_camera)
+    {
+        if(!isToken(serial))
+            return false;
+        pose _pose = world_from_camera;
+        _pose[12] = _pose[13] = _pose[14] = 0.0f;
+        _pose[15] = 1.0f;
+        std::unique_lock lock(mutex);
+        poses[serial] = _pose;
+        return true;
+    }
+
+    bool extrinsics_store::remove(const std::string& serial)
+    {
+        std::unique_lock lock(mutex);
+        return poses.erase(serial) != 0;
+    }
+
+    std::optional<pose> extrinsics_store::find(const std::string& serial) const
+    {
+        std::shared_lock lock(mutex);
+        if(const auto it = poses.find(serial); it != poses.end())
+            return it->second;
+        return std::nullopt;
+    }
+
+    std::size_t extrinsics_store::size() const
+    {
+        std::shared_lock lock(mutex);
+        return poses.size();
+    }
+}
@@ -0,0 +1,236 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "geometry/point_cloud_builder.h"
+
+#include <cmath>
+#include <limits>
+
+#ifdef VISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Row kernel signature. color and rgb are nullptr when no color is requested.
+         */
+        using row_kernel = void (*)(const double* ray_x, double ray_y, const float* depth, const float* color,
+                                    float* x, float* y, float* z, float* rgb, std::size_t begin, std::size_t end);
+
+        // Mirrors RegistrationImpl::getPointXYZ: the depth is scaled in float, the rays are
+        // applied in double and the validity test compares in double.
+        void scalarRow(const double* ray_x, const double ray_y, const float* depth, const float* color,
+                       float* x, float* y, float* z, float* rgb, const std::size_t begin, const std::size_t end)
+        {
+            const float bad_point = std::numeric_limits<float>::quiet_NaN();
+            for(std::size_t c = begin; c < end; ++c)
+            {
+                const float depth_val = depth[c] / 1000.0f;
+                if(std::isnan(depth_val) || depth_val <= 0.001)
+                {
+                    x[c] = y[c] = z[c] = bad_point;
+                    if(rgb != nullptr)
+                        rgb[c] = 0.0f;
+                }
+                else
+                {
+                    x[c] = static_cast<float>(ray_x[c] * depth_val);
+                    y[c] = static_cast<float>(ray_y * depth_val);
+                    z[c] = depth_val;
+                    if(rgb != nullptr)
+                        rgb[c] = color[c];
+                }
+            }
+        }
+
+#ifdef VISION_X86_KERNELS
+        void sseRow(const double* ray_x, const double ray_y, const float* depth, const float* color,
+                    float* x, float* y, float* z, float* rgb, const std::size_t begin, const std::size_t end)
+        {
+            const __m128 scale = _mm_set1_ps(1000.0f);
+            const __m128d threshold = _mm_set1_pd(0.001);
+            const __m128d bad_point = _mm_set1_pd(std::numeric_limits<double>::quiet_NaN());
+            const __m128d ray_y_d = _mm_set1_pd(ray_y);
+
+            // Blends in double: a double quiet NaN narrows to the same float quiet NaN the scalar path stores.
+            const auto blend = [](const __m128d mask, const __m128d bad, const __m128d value) {
+                return _mm_or_pd(_mm_and_pd(mask, bad), _mm_andnot_pd(mask, value));
+            };
+
+            std::size_t c = begin;
+            for(; c + 4 <= end; c += 4)
+            {
+                const __m128 depth_val = _mm_div_ps(_mm_loadu_ps(depth + c), scale);
+                const __m128d d_lo = _mm_cvtps_pd(depth_val);
+                const __m128d d_hi = _mm_cvtps_pd(_mm_movehl_ps(depth_val, depth_val));
+                const __m128d invalid_lo = _mm_cmpngt_pd(d_lo, threshold);
+                const __m128d invalid_hi = _mm_cmpngt_pd(d_hi, threshold);
+
+                const __m128d x_lo = blend(invalid_lo, bad_point, _mm_mul_pd(_mm_loadu_pd(ray_x + c), d_lo));
+                const __m128d x_hi = blend(invalid_hi, bad_point, _mm_mul_pd(_mm_loadu_pd(ray_x + c + 2), d_hi));
+                const __m128d y_lo = blend(invalid_lo, bad_point, _mm_mul_pd(ray_y_d, d_lo));
+                const __m128d y_hi = blend(invalid_hi, bad_point, _mm_mul_pd(ray_y_d, d_hi));
+                const __m128d z_lo = blend(invalid_lo, bad_point, d_lo);
+                const __m128d z_hi = blend(invalid_hi, bad_point, d_hi);
+
+                _mm_storeu_ps(x + c, _mm_movelh_ps(_mm_cvtpd_ps(x_lo), _mm_cvtpd_ps(x_hi)));
+                _mm_storeu_ps(y + c, _mm_movelh_ps(_mm_cvtpd_ps(y_lo), _mm_cvtpd_ps(y_hi)));
+                _mm_storeu_ps(z + c, _mm_movelh_ps(_mm_cvtpd_ps(z_lo), _mm_cvtpd_ps(z_hi)));
+
+                if(rgb != nullptr)
+                {
+                    // An all-ones double narrows to an all-ones float, so the mask survives the conversion.
+                    const __m128 mask = _mm_movelh_ps(_mm_cvtpd_ps(invalid_lo), _mm_cvtpd_ps(invalid_hi));
+                    _mm_storeu_ps(rgb + c, _mm_andnot_ps(mask, _mm_loadu_ps(color + c)));
+                }
+            }
+            scalarRow(ray_x, ray_y, depth, color, x, y, z, rgb, c, end);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2Row(const double* ray_x, const double ray_y, const float* depth, const float* color,
+                     float* x, float* y, float* z, float* rgb, const std::size_t begin, const std::size_t end)
+        {
+            const __m128 scale = _mm_set1_ps(1000.0f);
+            const __m256d threshold = _mm256_set1_pd(0.001);
+            const __m256d bad_point = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+            const __m256d ray_y_d = _mm256_set1_pd(ray_y);
+
+            std::size_t c = begin;
+            for(; c + 4 <= end; c += 4)
+            {
+                const __m128 depth_val = _mm_div_ps(_mm_loadu_ps(depth + c), scale);
+                const __m256d d = _mm256_cvtps_pd(depth_val);
+                const __m256d invalid = _mm256_cmp_pd(d, threshold, _CMP_NGT_UQ);
+
+                const __m256d x_d = _mm256_blendv_pd(_mm256_mul_pd(_mm256_loadu_pd(ray_x + c), d), bad_point, invalid);
+                const __m256d y_d = _mm256_blendv_pd(_mm256_mul_pd(ray_y_d, d), bad_point, invalid);
+                const __m256d z_d = _mm256_blendv_pd(d, bad_point, invalid);
+
+                _mm_storeu_ps(x + c, _mm256_cvtpd_ps(x_d));
+                _mm_storeu_ps(y + c, _mm256_cvtpd_ps(y_d));
+                _mm_storeu_ps(z + c, _mm256_cvtpd_ps(z_d));
+
+                if(rgb != nullptr)
+                {
+                    // An all-ones double narrows to an all-ones float, so the mask survives the conversion.
+                    const __m128 mask = _mm256_cvtpd_ps(invalid);
+                    _mm_storeu_ps(rgb + c, _mm_blendv_ps(_mm_loadu_ps(color + c), _mm_setzero_ps(), mask));
+                }
+            }
+            scalarRow(ray_x, ray_y, depth, color, x, y, z, rgb, c, end);
+        }
+#endif
+
+        row_kernel selectKernel(const point_cloud_builder::kernel kernel)
+        {
+            switch (kernel)
+            {
+#ifdef VISION_X86_KERNELS
+                case point_cloud_builder::kernel::AVX2: return avx2Row;
+                case point_cloud_builder::kernel::SSE: return sseRow;
+#endif
+                default: return scalarRow;
+            }
+        }
+
+        bool isDepthFrame(const libfreenect2::Frame& frame)
+        {
+            return frame.width == point_cloud_builder::depth_width
+                   && frame.height == point_cloud_builder::depth_height
+                   && frame.bytes_per_pixel == 4
+                   && frame.data != nullptr;
+        }
+    }
+
+    void point_cloud::resize(const std::size_t width, const std::size_t height, const bool with_color)
+    {
+        this->width = width;
+        this->height = height;
+        x.resize(width * height);
+        y.resize(width * height);
+        z.resize(width * height);
+        rgb.resize(with_color ? width * height : 0);
+    }
+
+    point_cloud_builder::point_cloud_builder(const libfreenect2::Freenect2Device::IrCameraParams& params,
+                                             const kernel requested)
+        : ray_x(depth_width), ray_y(depth_height)
+    {
+        // Same operand types and order as getPointXYZ: float reciprocal, double ray.
+        const float cx(params.cx), cy(params.cy);
+        const float fx(1 / params.fx), fy(1 / params.fy);
+        for(std::size_t c = 0; c < depth_width; ++c)
+            ray_x[c] = (static_cast<int>(c) + 0.5 - cx) * fx;
+        for(std::size_t r = 0; r < depth_height; ++r)
+            ray_y[r] = (static_cast<int>(r) + 0.5 - cy) * fy;
+
+        active_kernel = resolveKernel(requested, {kernel::SSE, kernel::AVX2});
+    }
+
+    void point_cloud_builder::buildRow(const float* depth, const float* color, const std::size_t row,
+                                       float* x, float* y, float* z, float* rgb) const
+    {
+        const std::size_t offset = row * depth_width;
+        selectKernel(active_kernel)(ray_x.data(), ray_y[row], depth + offset,
+                                    color != nullptr ? color + offset : nullptr,
+                                    x + offset, y + offset, z + offset,
+                                    rgb != nullptr ? rgb + offset : nullptr,
+                                    0, depth_width);
+    }
+
+    bool point_cloud_builder::build(const libfreenect2::Frame& undistorted, point_cloud& cloud) const
+    {
+        if(!isDepthFrame(undistorted))
+            return false;
+
+        cloud.resize(depth_width, depth_height, false);
+        const auto* depth = reinterpret_cast<const float*>(undistorted.data);
+        for(std::size_t r = 0; r < depth_height; ++r)
+            buildRow(depth, nullptr, r, cloud.x.data(), cloud.y.data(), cloud.z.data(), nullptr);
+        return true;
+    }
+
+    bool point_cloud_builder::build(const libfreenect2::Frame& undistorted, const libfreenect2::Frame& registered,
+                                    point_cloud& cloud) const
+    {
+        if(!isDepthFrame(undistorted) || !isDepthFrame(registered))
+            return false;
+
+        cloud.resize(depth_width, depth_height, true);
+        const auto* depth = reinterpret_cast<const float*>(undistorted.data);
+        const auto* color = reinterpret_cast<const float*>(registered.data);
+        for(std::size_t r = 0; r < depth_height; ++r)
+            buildRow(depth, color, r, cloud.x.data(), cloud.y.data(), cloud.z.data(), cloud.rgb.data());
+        return true;
+    }
+
+    bool point_cloud_builder::buildPacked(const libfreenect2::Frame& undistorted,
+                                          const libfreenect2::Frame& registered,
+                                          std::vector<point_xyzrgb>& points) const
+    {
+        if(!isDepthFrame(undistorted) || !isDepthFrame(registered))
+            return false;
+
+        points.resize(depth_width * depth_height);
+        const auto* depth = reinterpret_cast<const float*>(undistorted.data);
+        const auto* color = reinterpret_cast<const float*>(registered.data);
+
+        // One row of SoA scratch on the stack, interleaved into the packed output.
+        alignas(32) float x[depth_width], y[depth_width], z[depth_width], rgb[depth_width];
+        for(std::size_t r = 0; r < depth_height; ++r)
+        {
+            const std::size_t offset = r * depth_width;
+            selectKernel(active_kernel)(ray_x.data(), ray_y[r], depth + offset, color + offset,
+                                        x, y, z, rgb, 0, depth_width);
+            point_xyzrgb* out = points.data() + offset;
+            for(std::size_t c = 0; c < depth_width; ++c)
+                out[c] = {x[c], y[c], z[c], rgb[c]};
+        }
+        return true;
+    }
+}
@@ -0,0 +1,479 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "geometry/registration_engine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include "logger/console_logger.h"
+
+#ifdef VISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace vision
+{
+    namespace
+    {
+        constexpr float depth_q = 0.01f;   ///< Depth coordinate scale of the color mapping polynomial.
+        constexpr float color_q = 0.002199f; ///< Color coordinate scale of the color mapping polynomial.
+        constexpr int filter_width_half = 2;  ///< Half width of the occlusion filter window.
+        constexpr int filter_height_half = 1; ///< Half height of the occlusion filter window.
+        constexpr float filter_tolerance = 0.01f; ///< Relative depth noise allowed by the occlusion filter.
+
+        constexpr std::size_t depth_size = registration_engine::depth_width * registration_engine::depth_height;
+        constexpr std::int32_t color_size = registration_engine::color_width * registration_engine::color_height;
+        constexpr std::int32_t filter_size = registration_engine::color_width * registration_engine::bigdepth_height;
+        constexpr std::size_t band_pixels = 16 * registration_engine::depth_width; ///< Depth pixels per task.
+
+        constexpr std::uint64_t cache_magic = 0x314c425447455246ull; ///< "FREGTBL1".
+        constexpr std::uint32_t cache_version = 1; ///< Cache file format version.
+
+        /**
+         * @struct cache_header
+         * @brief Start of a cache file; followed by distort_map, color_x and color_y.
+         */
+        struct cache_header
+        {
+            std::uint64_t magic; ///< cache_magic.
+            std::uint32_t version; ///< cache_version.
+            std::uint32_t pixels; ///< Entries per table.
+            libfreenect2::Freenect2Device::IrCameraParams depth; ///< Parameters the tables were built from.
+            libfreenect2::Freenect2Device::ColorCameraParams color; ///< Parameters the tables were built from.
+        };
+
+        /**
+         * @struct map_arguments
+         * @brief Inputs and outputs of the undistortion pass.
+         */
+        struct map_arguments
+        {
+            const std::int32_t* distort_map;
+            const float* color_x;
+            const std::int32_t* color_row;
+            const float* depth;
+            float* undistorted;
+            std::int32_t* offsets;
+            float shift_m;
+            float fx;
+            float color_cx;
+        };
+
+        /**
+         * @brief Truncates like cvttss2si: out-of-range values and NaN give INT32_MIN.
+         */
+        std::int32_t truncate(const float value)
+        {
+            if(!(value >= -2147483648.0f && value < 2147483648.0f))
+                return std::numeric_limits<std::int32_t>::min();
+            return static_cast<std::int32_t>(value);
+        }
+
+        // Mirrors the first loop of RegistrationImpl::apply.
+        void scalarMap(const map_arguments& args, const std::size_t begin, const std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                const std::int32_t index = args.distort_map[i];
+                if(index < 0)
+                {
+                    args.offsets[i] = -1;
+                    args.undistorted[i] = 0;
+                    continue;
+                }
+
+                const float z = args.depth[index];
+                args.undistorted[i] = z;
+                if(z <= 0.0f)
+                {
+                    args.offsets[i] = -1;
+                    continue;
+                }
+
+                const float rx = (args.color_x[i] + (args.shift_m / z)) * args.fx + args.color_cx;
+                // Wraps like the vector kernel; any wrapped value is rejected by the range test.
+                const auto offset = static_cast<std::int32_t>(static_cast<std::uint32_t>(truncate(rx))
+                        + static_cast<std::uint32_t>(args.color_row[i]) * static_cast<std::uint32_t>(registration_engine::color_width));
+                args.offsets[i] = offset >= 0 && offset < color_size ? offset : -1;
+            }
+        }
+
+        // Mirrors the registered-image loops of RegistrationImpl::apply; filter is nullptr without the filter.
+        void scalarLookup(const std::int32_t* offsets, const float* undistorted, const float* filter,
+                          const std::uint32_t* rgb, std::uint32_t* registered,
+                          const std::size_t begin, const std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                const std::int32_t offset = offsets[i];
+                if(offset < 0)
+                    registered[i] = 0;
+                else if(filter != nullptr)
+                {
+                    const float min_z = filter[offset];
+                    const float z = undistorted[i];
+                    registered[i] = (z - min_z) / z > filter_tolerance ? 0 : rgb[offset];
+                }
+                else
+                    registered[i] = rgb[offset];
+            }
+        }
+
+#ifdef VISION_X86_KERNELS
+        __attribute__((target("avx2")))
+        void avx2Map(const map_arguments& args, const std::size_t begin, const std::size_t end)
+        {
+            const __m256i minus_one = _mm256_set1_epi32(-1);
+            const __m256i row_stride = _mm256_set1_epi32(registration_engine::color_width);
+            const __m256i color_end = _mm256_set1_epi32(color_size);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 shift_m = _mm256_set1_ps(args.shift_m);
+            const __m256 fx = _mm256_set1_ps(args.fx);
+            const __m256 color_cx = _mm256_set1_ps(args.color_cx);
+
+            std::size_t i = begin;
+            for(; i + 8 <= end; i += 8)
+            {
+                const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(args.distort_map + i));
+                const __m256i inside = _mm256_cmpgt_epi32(index, minus_one);
+                // Pixels outside the distorted image gather nothing and keep the zero.
+                const __m256 z = _mm256_mask_i32gather_ps(zero, args.depth, index, _mm256_castsi256_ps(inside), 4);
+                _mm256_storeu_ps(args.undistorted + i, z);
+
+                const __m256 rx = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(args.color_x + i),
+                                                                            _mm256_div_ps(shift_m, z)), fx), color_cx);
+                const __m256i row = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(args.color_row + i));
+                const __m256i offset = _mm256_add_epi32(_mm256_cvttps_epi32(rx), _mm256_mullo_epi32(row, row_stride));
+
+                const __m256i valid = _mm256_and_si256(
+                        _mm256_castps_si256(_mm256_cmp_ps(z, zero, _CMP_NLE_UQ)),
+                        _mm256_and_si256(_mm256_cmpgt_epi32(offset, minus_one), _mm256_cmpgt_epi32(color_end, offset)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(args.offsets + i), _mm256_blendv_epi8(minus_one, offset, valid));
+            }
+            scalarMap(args, i, end);
+        }
+
+        __attribute__((target("avx2")))
+        void avx2Lookup(const std::int32_t* offsets, const float* undistorted, const float* filter,
+                        const std::uint32_t* rgb, std::uint32_t* registered,
+                        const std::size_t begin, const std::size_t end)
+        {
+            const __m256i minus_one = _mm256_set1_epi32(-1);
+            const __m256 tolerance = _mm256_set1_ps(filter_tolerance);
+            const __m256 zero = _mm256_setzero_ps();
+
+            std::size_t i = begin;
+            for(; i + 8 <= end; i += 8)
+            {
+                const __m256i offset = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + i));
+                __m256i use = _mm256_cmpgt_epi32(offset, minus_one);
+                if(filter != nullptr)
+                {
+                    const __m256 min_z = _mm256_mask_i32gather_ps(zero, filter, offset, _mm256_castsi256_ps(use), 4);
+                    const __m256 z = _mm256_loadu_ps(undistorted + i);
+                    const __m256 occluded = _mm256_cmp_ps(_mm256_div_ps(_mm256_sub_ps(z, min_z), z), tolerance, _CMP_GT_OQ);
+                    use = _mm256_andnot_si256(_mm256_castps_si256(occluded), use);
+                }
+                const __m256i color = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(),
+                                                                  reinterpret_cast<const int*>(rgb), offset, use, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(registered + i), color);
+            }
+            scalarLookup(offsets, undistorted, filter, rgb, registered, i, end);
+        }
+#endif
+
+        bool hasSize(const libfreenect2::Frame& frame, const std::size_t width, const std::size_t height)
+        {
+            return frame.width == width && frame.height == height && frame.bytes_per_pixel == 4 && frame.data != nullptr;
+        }
+
+        bool readAll(const int fd, void* data, std::size_t size)
+        {
+            auto* out = static_cast<unsigned char*>(data);
+            while(size > 0)
+            {
+                const ssize_t count = ::read(fd, out, size);
+                if(count < 0 && errno == EINTR)
+                    continue;
+                if(count <= 0)
+                    return false;
+                out += count;
+                size -= static_cast<std::size_t>(count);
+            }
+            return true;
+        }
+
+        bool writeAll(const int fd, const void* data, std::size_t size)
+        {
+            const auto* in = static_cast<const unsigned char*>(data);
+            while(size > 0)
+            {
+                const ssize_t count = ::write(fd, in, size);
+                if(count < 0 && errno == EINTR)
+                    continue;
+                if(count <= 0)
+                    return false;
+                in += count;
+                size -= static_cast<std::size_t>(count);
+            }
+            return true;
+        }
+    }
+
+    registration_engine::registration_engine(const std::string& serial,
+                                             const libfreenect2::Freenect2Device::IrCameraParams& depth,
+                                             const libfreenect2::Freenect2Device::ColorCameraParams& color,
+                                             const registration_config& config, const kernel requested)
+        : depth_params(depth),
+          color_params(color),
+          pool(std::make_unique<worker_pool>(std::max<std::size_t>(config.threads, 1), config.cpus)),
+          color_offsets(depth_size),
+          filter_map(filter_size)
+    {
+        active_kernel = resolveKernel(requested);
+
+        // A serial is a plain token; anything that could escape the cache directory disables the cache.
+        const bool cacheable = config.use_cache && !serial.empty()
+                               && serial.find_first_of("/\\") == std::string::npos && serial != "." && serial != "..";
+        const std::string path = cacheable
+                ? (std::filesystem::path(config.cache_directory.empty() ? defaultCacheDirectory() : config.cache_directory)
+                   / (serial + ".regtable")).string()
+                : std::string();
+
+        if(!path.empty() && loadTables(path).status == Status::Success)
+        {
+            from_cache = true;
+            return;
+        }
+
+        buildTables();
+        if(!path.empty())
+        {
+            if(const Result result = saveTables(path); result.status != Status::Success)
+                ConsoleLogger::getInstance()->warning("Registration tables of {} not cached: {}", serial, result.message);
+        }
+    }
+
+    std::string registration_engine::defaultCacheDirectory()
+    {
+        std::filesystem::path base;
+        if(const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0')
+            base = xdg;
+        else if(const char* home = std::getenv("HOME"); home != nullptr && *home != '\0')
+            base = std::filesystem::path(home) / ".cache";
+        else
+            base = std::filesystem::temp_directory_path();
+        return (base / "fusion-kinect2" / "registration").string();
+    }
+
+    void registration_engine::buildTables()
+    {
+        // Same operations and order as RegistrationImpl's constructor, distort() and depth_to_color().
+        const auto& depth = depth_params;
+        const auto& color = color_params;
+        distort_map.resize(depth_size);
+        color_x.resize(depth_size);
+        color_y.resize(depth_size);
+        color_row.resize(depth_size);
+
+        std::size_t i = 0;
+        for(int y = 0; y < static_cast<int>(depth_height); ++y)
+        {
+            for(int x = 0; x < static_cast<int>(depth_width); ++x, ++i)
+            {
+                const float dx = (static_cast<float>(x) - depth.cx) / depth.fx;
+                const float dy = (static_cast<float>(y) - depth.cy) / depth.fy;
+                const float dx2 = dx * dx;
+                const float dy2 = dy * dy;
+                const float r2 = dx2 + dy2;
+                const float dxdy2 = 2 * dx * dy;
+                const float kr = 1 + ((depth.k3 * r2 + depth.k2) * r2 + depth.k1) * r2;
+                const float mx = depth.fx * (dx * kr + depth.p2 * (r2 + 2 * dx2) + depth.p1 * dxdy2) + depth.cx;
+                const float my = depth.fy * (dy * kr + depth.p1 * (r2 + 2 * dy2) + depth.p2 * dxdy2) + depth.cy;
+
+                const int ix = static_cast<int>(mx + 0.5f);
+                const int iy = static_cast<int>(my + 0.5f);
+                distort_map[i] = ix < 0 || ix >= static_cast<int>(depth_width) || iy < 0 || iy >= static_cast<int>(depth_height)
+                                 ? -1 : iy * static_cast<int>(depth_width) + ix;
+
+                const float px = (static_cast<float>(x) - depth.cx) * depth_q;
+                const float py = (static_cast<float>(y) - depth.cy) * depth_q;
+                const float wx =
+                        (px * px * px * color.mx_x3y0) + (py * py * py * color.mx_x0y3) +
+                        (px * px * py * color.mx_x2y1) + (py * py * px * color.mx_x1y2) +
+                        (px * px * color.mx_x2y0) + (py * py * color.mx_x0y2) + (px * py * color.mx_x1y1) +
+                        (px * color.mx_x1y0) + (py * color.mx_x0y1) + (color.mx_x0y0);
+                const float wy =
+                        (px * px * px * color.my_x3y0) + (py * py * py * color.my_x0y3) +
+                        (px * px * py * color.my_x2y1) + (py * py * px * color.my_x1y2) +
+                        (px * px * color.my_x2y0) + (py * py * color.my_x0y2) + (px * py * color.my_x1y1) +
+                        (px * color.my_x1y0) + (py * color.my_x0y1) + (color.my_x0y0);
+
+                color_x[i] = (wx / (color.fx * color_q)) - (color.shift_m / color.shift_d);
+                color_y[i] = (wy / color_q) + color.cy;
+                color_row[i] = truncate(color_y[i] + 0.5f);
+            }
+        }
+    }
+
+    Result registration_engine::loadTables(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0)
+            return {Status::NotFound, "No cached registration tables."};
+
+        cache_header header{};
+        std::vector<std::int32_t> _distort_map(depth_size);
+        std::vector<float> _color_x(depth_size), _color_y(depth_size);
+        const bool read = readAll(fd, &header, sizeof(header))
+                          && header.magic == cache_magic && header.version == cache_version && header.pixels == depth_size
+                          && std::memcmp(&header.depth, &depth_params, sizeof(depth_params)) == 0
+                          && std::memcmp(&header.color, &color_params, sizeof(color_params)) == 0
+                          && readAll(fd, _distort_map.data(), depth_size * sizeof(std::int32_t))
+                          && readAll(fd, _color_x.data(), depth_size * sizeof(float))
+                          && readAll(fd, _color_y.data(), depth_size * sizeof(float));
+        ::close(fd);
+        if(!read)
+            return {Status::Conflict, "Cached registration tables are stale or damaged."};
+
+        distort_map = std::move(_distort_map);
+        color_x = std::move(_color_x);
+        color_y = std::move(_color_y);
+        color_row.resize(depth_size);
+        for(std::size_t i = 0; i < depth_size; ++i)
+        {
+            if(distort_map[i] < -1 || distort_map[i] >= static_cast<std::int32_t>(depth_size))
+                return {Status::Conflict, "Cached registration tables are damaged."};
+            color_row[i] = truncate(color_y[i] + 0.5f);
+        }
+        return Result(Status::Success);
+    }
+
+    Result registration_engine::saveTables(const std::string& path) const
+    {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+        if(error)
+            return {Status::PermissionDenied, error.message()};
+
+        const std::string temporary = path + ".tmp";
+        const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(fd < 0)
+            return {Status::PermissionDenied, std::strerror(errno)};
+
+        cache_header header{};
+        header.magic = cache_magic;
+        header.version = cache_version;
+        header.pixels = static_cast<std::uint32_t>(depth_size);
+        header.depth = depth_params;
+        header.color = color_params;
+        const bool written = writeAll(fd, &header, sizeof(header))
+                             && writeAll(fd, distort_map.data(), depth_size * sizeof(std::int32_t))
+                             && writeAll(fd, color_x.data(), depth_size * sizeof(float))
+                             && writeAll(fd, color_y.data(), depth_size * sizeof(float));
+        const bool closed = ::close(fd) == 0;
+        if(!written || !closed || ::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            ::unlink(temporary.c_str());
+            return {Status::Error, "Registration tables could not be written."};
+        }
+        return Result(Status::Success);
+    }
+
+    void registration_engine::apply(const int dx, const int dy, const float dz, float& cx, float& cy) const
+    {
+        const int index = dx + dy * static_cast<int>(depth_width);
+        const float rx = color_x[index] + color_params.shift_m / dz;
+        cy = color_y[index];
+        cx = rx * color_params.fx + color_params.cx;
+    }
+
+    bool registration_engine::apply(const libfreenect2::Frame& rgb, const libfreenect2::Frame& depth,
+                                    libfreenect2::Frame& undistorted, libfreenect2::Frame& registered,
+                                    const bool enable_filter, libfreenect2::Frame* bigdepth, int* color_depth_map)
+    {
+        if(!hasSize(rgb, color_width, color_height) || !hasSize(depth, depth_width, depth_height)
+           || !hasSize(undistorted, depth_width, depth_height) || !hasSize(registered, depth_width, depth_height)
+           || (bigdepth != nullptr && !hasSize(*bigdepth, color_width, bigdepth_height)))
+            return false;
+
+        const bool avx2 = active_kernel == kernel::AVX2;
+        const std::size_t bands = (depth_size + band_pixels - 1) / band_pixels;
+        std::int32_t* offsets = color_depth_map != nullptr ? color_depth_map : color_offsets.data();
+        auto* undistorted_data = reinterpret_cast<float*>(undistorted.data);
+
+        const map_arguments args{
+            distort_map.data(), color_x.data(), color_row.data(),
+            reinterpret_cast<const float*>(depth.data), undistorted_data, offsets,
+            color_params.shift_m, color_params.fx, color_params.cx + 0.5f // 0.5 rounds the truncation.
+        };
+        pool->run(bands, [&](const std::size_t band) {
+            const std::size_t begin = band * band_pixels, end = std::min(depth_size, begin + band_pixels);
+#ifdef VISION_X86_KERNELS
+            if(avx2)
+                return avx2Map(args, begin, end);
+#endif
+            scalarMap(args, begin, end);
+        });
+
+        // The filter map has a blank row above and below the color image, so windows need no row checks.
+        float* filter = nullptr;
+        if(enable_filter)
+        {
+            float* map = bigdepth != nullptr ? reinterpret_cast<float*>(bigdepth->data) : filter_map.data();
+            filter = map + color_width;
+
+            // Each task owns a slice of the map and applies the windows that reach into it, so no
+            // two threads write the same value; min() makes the order irrelevant.
+            const std::size_t slices = pool->size();
+            pool->run(slices, [&](const std::size_t slice) {
+                const std::int32_t first = static_cast<std::int32_t>(filter_size / slices * slice);
+                const std::int32_t last = slice + 1 == slices ? filter_size
+                                                              : static_cast<std::int32_t>(filter_size / slices * (slice + 1));
+                std::fill(map + first, map + last, std::numeric_limits<float>::infinity());
+
+                constexpr std::int32_t stride = color_width;
+                for(std::size_t i = 0; i < depth_size; ++i)
+                {
+                    const std::int32_t offset = offsets[i];
+                    if(offset < 0)
+                        continue;
+                    // Window of the pixel in map indices: rows offset / stride .. + 2, columns +-2.
+                    const std::int32_t window_first = offset - filter_width_half;
+                    const std::int32_t window_last = offset + 2 * filter_height_half * stride + filter_width_half;
+                    if(window_last < first || window_first >= last)
+                        continue;
+
+                    const float z = undistorted_data[i];
+                    for(std::int32_t row = 0; row <= 2 * filter_height_half; ++row)
+                    {
+                        const std::int32_t from = std::max(first, offset + row * stride - filter_width_half);
+                        const std::int32_t to = std::min(last - 1, offset + row * stride + filter_width_half);
+                        for(std::int32_t index = from; index <= to; ++index)
+                            if(z < map[index])
+                                map[index] = z;
+                    }
+                }
+            });
+        }
+
+        const auto* rgb_data = reinterpret_cast<const std::uint32_t*>(rgb.data);
+        auto* registered_data = reinterpret_cast<std::uint32_t*>(registered.data);
+        pool->run(bands, [&](const std::size_t band) {
+            const std::size_t begin = band * band_pixels, end = std::min(depth_size, begin + band_pixels);
+#ifdef VISION_X86_KERNELS
+            if(avx2)
+                return avx2Lookup(offsets, undistorted_data, filter, rgb_data, registered_data, begin, end);
+#endif
+            scalarLookup(offsets, undistorted_data, filter, rgb_data, registered_data, begin, end);
+        });
+        return true;
+    }
+}
@@ -0,0 +1,204 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "geometry/voxel_downsampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::uint64_t empty_key = ~0ull; ///< Key of invalid points and free hash slots.
+        constexpr float coordinate_limit = static_cast<float>(1 << 20); ///< Voxel coordinates must be in [-limit, limit).
+        constexpr std::uint64_t key_mask = (1ull << 21) - 1; ///< One packed coordinate.
+
+        std::uint64_t hashKey(const std::uint64_t key)
+        {
+            return key * 0x9e3779b97f4a7c15ull;
+        }
+
+        std::size_t partitionOf(const std::uint64_t key)
+        {
+            return static_cast<std::size_t>(hashKey(key) >> (64 - voxel_downsampler::partition_bits));
+        }
+
+        std::uint32_t colorBits(const float rgb)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &rgb, sizeof(bits));
+            return bits;
+        }
+    }
+
+    voxel_downsampler::voxel_downsampler(const voxel_config& config)
+        : config(config),
+          pool(std::make_unique<worker_pool>(config.threads > 0 ? config.threads
+                                                                : std::max(1u, std::thread::hardware_concurrency()),
+                                             config.cpus)),
+          partition_begin(partitions + 1),
+          tables(partitions)
+    {
+    }
+
+    void voxel_downsampler::gatherPartition(const std::size_t index)
+    {
+        partition& table = tables[index];
+        table.voxels.clear();
+        const std::size_t begin = partition_begin[index], end = partition_begin[index + 1];
+        if(begin == end)
+            return;
+
+        // The partition already used the top bits of the hash; the slot takes the bits below them.
+        std::size_t bits = 4;
+        while((std::size_t{1} << bits) < 2 * (end - begin))
+            ++bits;
+        const std::size_t mask = (std::size_t{1} << bits) - 1;
+        table.keys.assign(mask + 1, empty_key);
+        table.slots.resize(mask + 1);
+
+        const bool centroid = config.point == voxel_point::Centroid;
+        for(std::size_t i = begin; i < end; ++i)
+        {
+            const keyed_point& point = order[i];
+            const std::uint64_t key = point.key;
+            std::size_t slot = static_cast<std::size_t>(hashKey(key) >> (64 - partition_bits - bits)) & mask;
+            while(table.keys[slot] != empty_key && table.keys[slot] != key)
+                slot = (slot + 1) & mask;
+
+            const std::uint32_t color = point.color;
+            if(table.keys[slot] == empty_key)
+            {
+                table.keys[slot] = key;
+                table.slots[slot] = static_cast<std::uint32_t>(table.voxels.size());
+                table.voxels.push_back({point.x, point.y, point.z,
+                                        color & 0xff, color >> 8 & 0xff, color >> 16 & 0xff, 1, point.index});
+                continue;
+            }
+
+            voxel_sum& voxel = table.voxels[table.slots[slot]];
+            ++voxel.count;
+            if(!centroid)
+                continue;
+            voxel.x += point.x;
+            voxel.y += point.y;
+            voxel.z += point.z;
+            voxel.b += color & 0xff;
+            voxel.g += color >> 8 & 0xff;
+            voxel.r += color >> 16 & 0xff;
+        }
+    }
+
+    Result voxel_downsampler::downsample(const point_cloud& cloud, point_cloud& downsampled)
+    {
+        const std::size_t size = cloud.size();
+        if(cloud.x.size() != size || cloud.y.size() != size || cloud.z.size() != size
+           || (!cloud.rgb.empty() && cloud.rgb.size() != size))
+            return {Status::InvalidParam, "Cloud arrays do not match its size."};
+        if(size > std::numeric_limits<std::uint32_t>::max())
+            return {Status::InvalidParam, "Cloud has too many points."};
+        if(!(config.voxel_size > 0.0f))
+            return {Status::InvalidParam, "Voxel size is not positive."};
+
+        // Key every point and count the points of each chunk falling in each partition.
+        const float inv_voxel = 1.0f / config.voxel_size;
+        const std::size_t chunks = (size + chunk_points - 1) / chunk_points;
+        keys.resize(size);
+        counts.assign(chunks * partitions, 0);
+        pool->run(chunks, [&](const std::size_t c) {
+            std::uint32_t* chunk_counts = counts.data() + c * partitions;
+            const std::size_t end = std::min(size, (c + 1) * chunk_points);
+            for(std::size_t i = c * chunk_points; i < end; ++i)
+            {
+                const float vx = std::floor(cloud.x[i] * inv_voxel);
+                const float vy = std::floor(cloud.y[i] * inv_voxel);
+                const float vz = std::floor(cloud.z[i] * inv_voxel);
+                if(!(vx >= -coordinate_limit && vx < coordinate_limit && vy >= -coordinate_limit
+                     && vy < coordinate_limit && vz >= -coordinate_limit && vz < coordinate_limit))
+                {
+                    keys[i] = empty_key;
+                    continue;
+                }
+                const auto biased = [](const float v) {
+                    return static_cast<std::uint64_t>(static_cast<std::int64_t>(v) + (1 << 20)) & key_mask;
+                };
+                keys[i] = biased(vx) | biased(vy) << 21 | biased(vz) << 42;
+                ++chunk_counts[partitionOf(keys[i])];
+            }
+        });
+
+        // Turn the counts into write offsets: partition by partition, chunks in order within each.
+        std::uint32_t running = 0;
+        for(std::size_t p = 0; p < partitions; ++p)
+        {
+            partition_begin[p] = running;
+            for(std::size_t c = 0; c < chunks; ++c)
+            {
+                const std::uint32_t count = counts[c * partitions + p];
+                counts[c * partitions + p] = running;
+                running += count;
+            }
+        }
+        partition_begin[partitions] = running;
+
+        const bool with_color = !cloud.rgb.empty();
+        order.resize(running);
+        pool->run(chunks, [&](const std::size_t c) {
+            std::uint32_t* offsets = counts.data() + c * partitions;
+            const std::size_t end = std::min(size, (c + 1) * chunk_points);
+            for(std::size_t i = c * chunk_points; i < end; ++i)
+                if(keys[i] != empty_key)
+                    order[offsets[partitionOf(keys[i])]++] = {keys[i], cloud.x[i], cloud.y[i], cloud.z[i],
+                                                              with_color ? colorBits(cloud.rgb[i]) : 0,
+                                                              static_cast<std::uint32_t>(i)};
+        });
+
+        pool->run(partitions, [&](const std::size_t p) { gatherPartition(p); });
+
+        // Write the voxels partition by partition; partition_begin now holds output offsets.
+        std::size_t total = 0;
+        for(std::size_t p = 0; p < partitions; ++p)
+        {
+            partition_begin[p] = static_cast<std::uint32_t>(total);
+            total += tables[p].voxels.size();
+        }
+        downsampled.resize(total, 1, with_color);
+        const bool centroid = config.point == voxel_point::Centroid;
+        pool->run(partitions, [&](const std::size_t p) {
+            std::size_t out = partition_begin[p];
+            for(const voxel_sum& voxel : tables[p].voxels)
+            {
+                if(centroid)
+                {
+                    const double count = voxel.count;
+                    downsampled.x[out] = static_cast<float>(voxel.x / count);
+                    downsampled.y[out] = static_cast<float>(voxel.y / count);
+                    downsampled.z[out] = static_cast<float>(voxel.z / count);
+                    if(with_color)
+                    {
+                        const std::uint32_t half = voxel.count / 2;
+                        const std::uint32_t color = (voxel.b + half) / voxel.count
+                                                    | (voxel.g + half) / voxel.count << 8
+                                                    | (voxel.r + half) / voxel.count << 16;
+                        std::memcpy(&downsampled.rgb[out], &color, sizeof(color));
+                    }
+                }
+                else
+                {
+                    downsampled.x[out] = cloud.x[voxel.first];
+                    downsampled.y[out] = cloud.y[voxel.first];
+                    downsampled.z[out] = cloud.z[voxel.first];
+                    if(with_color)
+                        downsampled.rgb[out] = cloud.rgb[voxel.first];
+                }
+                ++out;
+            }
+        });
+        return Result(Status::Success);
+    }
+}
@@ -0,0 +1,202 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "ipc/shm_client.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Checks that a region of the segment lies inside the mapping.
+         */
+        bool fits(const std::uint64_t offset, const std::uint64_t count, const std::uint64_t size,
+                  const std::size_t mapping_size)
+        {
+            return offset <= mapping_size && (size == 0 || count <= (mapping_size - offset) / size);
+        }
+    }
+
+    shm_client::~shm_client()
+    {
+        close();
+    }
+
+    Result shm_client::open(const std::string& name)
+    {
+        close();
+
+        const std::string object_name = shm::objectName(name);
+        const int fd = shm_open(object_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if(fd < 0)
+            return {Status::NotFound, std::format("Segment {} could not be opened: {}", object_name, std::strerror(errno))};
+        struct stat info{};
+        void* mapping = MAP_FAILED;
+        if(fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(shm::segment_header))
+        {
+            segment_size = static_cast<std::size_t>(info.st_size);
+            mapping = mmap(nullptr, segment_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if(mapping == MAP_FAILED)
+        {
+            segment_size = 0;
+            return {Status::InvalidParam, std::format("Segment {} could not be mapped!", object_name)};
+        }
+        segment = static_cast<const unsigned char*>(mapping);
+
+        const shm::segment_header& _header = header();
+        bool valid = _header.magic == shm::magic && _header.version == shm::version
+                     && _header.header_size == sizeof(shm::segment_header) && _header.segment_size <= segment_size;
+        for(const shm::ring_header& ring : _header.rings)
+            valid = valid && (ring.slot_count == 0
+                              || (ring.slots_offset % alignof(shm::slot_header) == 0
+                                  && fits(ring.slots_offset, ring.slot_count, sizeof(shm::slot_header), segment_size)
+                                  && fits(ring.payload_offset, ring.slot_count, ring.slot_size, segment_size)));
+        if(!valid)
+        {
+            close();
+            return {Status::InvalidParam, std::format("Segment {} has an unsupported format!", object_name)};
+        }
+
+        for(std::size_t r = 0; r < shm::ring_count; ++r)
+        {
+            cursors[r] = _header.rings[r].published.load(std::memory_order_acquire);
+            lost[r] = 0;
+        }
+        return {Status::Success, "Segment opened."};
+    }
+
+    void shm_client::close()
+    {
+        if(segment != nullptr)
+            munmap(const_cast<unsigned char*>(segment), segment_size);
+        segment = nullptr;
+        segment_size = 0;
+    }
+
+    bool shm_client::isPublisherOpen() const
+    {
+        return segment != nullptr && header().open.load(std::memory_order_acquire) != 0;
+    }
+
+    bool shm_client::readSlot(const shm::ring_header& ring, const std::uint64_t slot, shm_frame& frame) const
+    {
+        const auto& _slot = *reinterpret_cast<const shm::slot_header*>(segment + ring.slots_offset
+                                                                       + slot * sizeof(shm::slot_header));
+        // An odd lock is a slot being written, a zero lock one never written.
+        const std::uint64_t lock = _slot.lock.load(std::memory_order_acquire);
+        if((lock & 1) != 0 || lock == 0)
+            return false;
+        // The copy may be torn by the publisher; the second lock read discards it then.
+        std::memcpy(&frame.info, &_slot.info, sizeof(frame.info));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(_slot.lock.load(std::memory_order_relaxed) != lock || frame.info.size > ring.slot_size)
+            return false;
+
+        frame.data = segment + ring.payload_offset + slot * ring.slot_size;
+        frame.slot = &_slot;
+        frame.lock = lock;
+        return true;
+    }
+
+    std::optional<shm_frame> shm_client::next(const libfreenect2::Frame::Type type)
+    {
+        const int index = shm::ringIndex(type);
+        if(segment == nullptr || index < 0)
+            return std::nullopt;
+        const shm::ring_header& ring = header().rings[index];
+        if(ring.slot_count == 0)
+            return std::nullopt;
+
+        std::uint64_t& cursor = cursors[index];
+        const std::uint64_t published = ring.published.load(std::memory_order_acquire);
+        if(published > cursor + ring.slot_count)
+        {
+            lost[index] += published - ring.slot_count - cursor;
+            cursor = published - ring.slot_count;
+        }
+        while(cursor < published)
+        {
+            shm_frame frame;
+            if(!readSlot(ring, cursor % ring.slot_count, frame))
+                return std::nullopt;
+            // An older frame in the slot means the publisher has claimed it but not written it yet.
+            if(frame.info.frame_number < cursor)
+                return std::nullopt;
+            if(frame.info.frame_number == cursor)
+            {
+                ++cursor;
+                return frame;
+            }
+            ++lost[index];
+            ++cursor;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<shm_frame> shm_client::latest(const libfreenect2::Frame::Type type)
+    {
+        const int index = shm::ringIndex(type);
+        if(segment == nullptr || index < 0)
+            return std::nullopt;
+        const shm::ring_header& ring = header().rings[index];
+        if(ring.slot_count == 0)
+            return std::nullopt;
+
+        std::uint64_t& cursor = cursors[index];
+        const std::uint64_t published = ring.published.load(std::memory_order_acquire);
+        const std::uint64_t oldest = std::max(cursor, published > ring.slot_count ? published - ring.slot_count : 0);
+        for(std::uint64_t number = published; number > oldest; --number)
+        {
+            shm_frame frame;
+            if(readSlot(ring, (number - 1) % ring.slot_count, frame) && frame.info.frame_number == number - 1)
+            {
+                cursor = number;
+                return frame;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool shm_client::isValid(const shm_frame& frame) const
+    {
+        if(segment == nullptr || frame.slot == nullptr)
+            return false;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return frame.slot->lock.load(std::memory_order_relaxed) == frame.lock;
+    }
+
+    std::uint64_t shm_client::getLost(const libfreenect2::Frame::Type type) const
+    {
+        const int index = shm::ringIndex(type);
+        return index < 0 ? 0 : lost[index];
+    }
+
+    void shm_client::view(const shm_frame& _frame, libfreenect2::Frame& frame)
+    {
+        const shm::frame_info& info = _frame.info;
+        frame.width = info.width;
+        frame.height = info.height;
+        frame.bytes_per_pixel = info.bytes_per_pixel;
+        frame.data = const_cast<unsigned char*>(_frame.data);
+        frame.timestamp = info.timestamp;
+        frame.sequence = info.sequence;
+        frame.exposure = info.exposure;
+        frame.gain = info.gain;
+        frame.gamma = info.gamma;
+        frame.status = info.status;
+        frame.format = static_cast<libfreenect2::Frame::Format>(info.format);
+    }
+}
@@ -0,0 +1,235 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "ipc/shm_publisher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace vision
+{
+    shm_publisher::shm_publisher(const publisher_config& config)
+        : config(config)
+    {
+    }
+
+    shm_publisher::~shm_publisher()
+    {
+        close();
+    }
+
+    Result shm_publisher::open(const std::string& name)
+    {
+        if(isOpen())
+            return {Status::Conflict, "Publisher is already open!"};
+
+        // Lay out the rings of the published types after the header page.
+        shm::segment_header layout;
+        std::size_t offset = shm::page_size;
+        for(const libfreenect2::Frame::Type type : {libfreenect2::Frame::Color, libfreenect2::Frame::Ir,
+                                                    libfreenect2::Frame::Depth})
+        {
+            if((config.frame_types & type) == 0)
+                continue;
+            shm::ring_header& ring = layout.rings[shm::ringIndex(type)];
+            ring.slot_count = static_cast<std::uint32_t>(std::max<std::size_t>(config.slot_count, 1));
+            ring.slot_size = shm::alignUp(type == libfreenect2::Frame::Color ? config.color_slot_size
+                                                                             : config.depth_slot_size, shm::page_size);
+            ring.slots_offset = offset;
+            offset += shm::alignUp(ring.slot_count * sizeof(shm::slot_header), shm::page_size);
+            ring.payload_offset = offset;
+            offset += ring.slot_count * ring.slot_size;
+        }
+        layout.segment_size = offset;
+
+        object_name = shm::objectName(name);
+        // A segment left by a crashed publisher is replaced; its readers keep their old mapping.
+        shm_unlink(object_name.c_str());
+        const int fd = shm_open(object_name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0640);
+        if(fd < 0)
+            return {Status::Error, std::format("Segment {} could not be created: {}", object_name, std::strerror(errno))};
+        void* mapping = MAP_FAILED;
+        if(ftruncate(fd, static_cast<off_t>(offset)) == 0)
+            mapping = mmap(nullptr, offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        if(mapping == MAP_FAILED)
+        {
+            shm_unlink(object_name.c_str());
+            return {Status::Error, std::format("Segment {} could not be mapped: {}", object_name, reason)};
+        }
+
+        segment = static_cast<unsigned char*>(mapping);
+        segment_size = offset;
+        auto* _header = new(segment) shm::segment_header;
+        _header->segment_size = layout.segment_size;
+        _header->publisher_pid = static_cast<std::int32_t>(getpid());
+        for(std::size_t r = 0; r < shm::ring_count; ++r)
+        {
+            shm::ring_header& ring = _header->rings[r];
+            ring.slot_count = layout.rings[r].slot_count;
+            ring.slot_size = layout.rings[r].slot_size;
+            ring.slots_offset = layout.rings[r].slots_offset;
+            ring.payload_offset = layout.rings[r].payload_offset;
+            for(std::size_t slot = 0; slot < ring.slot_count; ++slot)
+                new(segment + ring.slots_offset + slot * sizeof(shm::slot_header)) shm::slot_header;
+        }
+        _header->open.store(1, std::memory_order_release);
+
+        frames_published = bytes_published = dropped = 0;
+        return {Status::Success, "Segment opened."};
+    }
+
+    Result shm_publisher::attach(frame_bus& bus)
+    {
+        if(!isOpen())
+            return {Status::Unsuccess, "Publisher is not open!"};
+        if(this->bus != nullptr)
+            return {Status::Conflict, "Publisher is already attached!"};
+
+        subscriber_config _config;
+        _config.queue_depth = config.queue_depth;
+        _config.policy = backpressure::DropOldest;
+        _config.device_id = config.device_ids.size() == 1 ? config.device_ids.front() : -1;
+        _config.types = config.frame_types;
+        this->bus = &bus;
+        subscriber = bus.subscribe(_config);
+        publisher_thread = std::thread(&shm_publisher::run, this);
+        return {Status::Success, "Publisher attached."};
+    }
+
+    void shm_publisher::run()
+    {
+        scheduled_frame frame;
+        // pop() also fails on a timeout; once the subscription is closed it fails only when drained.
+        while(subscriber->pop(frame, std::chrono::milliseconds(100)) || !subscriber->isClosed())
+        {
+            if(frame.frame)
+                publish(frame.device_id, frame.frame);
+            frame.frame.reset();
+        }
+    }
+
+    Result shm_publisher::close()
+    {
+        // The thread publishes what is still queued and exits once the closed subscription is drained.
+        if(bus != nullptr)
+        {
+            bus->unsubscribe(subscriber);
+            publisher_thread.join();
+            dropped.fetch_add(subscriber->getMetrics().dropped, std::memory_order_relaxed);
+            subscriber.reset();
+            bus = nullptr;
+        }
+        if(!isOpen())
+            return {Status::Unsuccess, "Publisher is not open!"};
+
+        header().open.store(0, std::memory_order_release);
+        munmap(segment, segment_size);
+        shm_unlink(object_name.c_str());
+        segment = nullptr;
+        segment_size = 0;
+        return {Status::Success, "Segment closed."};
+    }
+
+    bool shm_publisher::accepts(const int device_id, const libfreenect2::Frame::Type type) const
+    {
+        if((config.frame_types & type) == 0)
+            return false;
+        return config.device_ids.empty()
+               || std::find(config.device_ids.begin(), config.device_ids.end(), device_id) != config.device_ids.end();
+    }
+
+    bool shm_publisher::publish(const int device_id, const libfreenect2::Frame& frame,
+                                const libfreenect2::Frame::Type type, const std::int64_t arrival_ns)
+    {
+        const int index = shm::ringIndex(type);
+        if(!isOpen() || index < 0 || !accepts(device_id, type) || frame.data == nullptr)
+            return false;
+
+        shm::ring_header& ring = header().rings[index];
+        const std::size_t size = frame.width * frame.height * frame.bytes_per_pixel;
+        if(size == 0 || size > ring.slot_size)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const std::uint64_t number = ring.published.fetch_add(1, std::memory_order_relaxed);
+        const std::uint64_t slot_index = number % ring.slot_count;
+        auto& slot = *reinterpret_cast<shm::slot_header*>(segment + ring.slots_offset
+                                                           + slot_index * sizeof(shm::slot_header));
+
+        // Capture threads of several devices share a ring; wait out one still copying an older frame.
+        std::uint64_t lock = slot.lock.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            if((lock & 1) != 0)
+            {
+                std::this_thread::yield();
+                lock = slot.lock.load(std::memory_order_relaxed);
+            }
+            else if(slot.lock.compare_exchange_weak(lock, lock + 1, std::memory_order_acquire,
+                                                    std::memory_order_relaxed))
+                break;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if(lock != 0 && slot.info.frame_number > number)
+        {
+            // A newer frame got the slot first; leave it and its readers untouched.
+            slot.lock.store(lock, std::memory_order_release);
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        shm::frame_info& info = slot.info;
+        info.frame_number = number;
+        info.size = size;
+        info.arrival_ns = arrival_ns;
+        info.device_id = device_id;
+        info.type = type;
+        info.format = frame.format;
+        info.timestamp = frame.timestamp;
+        info.sequence = frame.sequence;
+        info.status = frame.status;
+        info.width = static_cast<std::uint32_t>(frame.width);
+        info.height = static_cast<std::uint32_t>(frame.height);
+        info.bytes_per_pixel = static_cast<std::uint32_t>(frame.bytes_per_pixel);
+        info.exposure = frame.exposure;
+        info.gain = frame.gain;
+        info.gamma = frame.gamma;
+        std::memcpy(segment + ring.payload_offset + slot_index * ring.slot_size, frame.data, size);
+        slot.lock.store(lock + 2, std::memory_order_release);
+
+        frames_published.fetch_add(1, std::memory_order_relaxed);
+        bytes_published.fetch_add(size, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool shm_publisher::publish(const int device_id, const frame_handle& frame)
+    {
+        if(!frame)
+            return false;
+        return publish(device_id, *frame, frame.type(), frame.arrivalTime());
+    }
+
+    publisher_statistics shm_publisher::getStatistics() const
+    {
+        publisher_statistics statistics;
+        statistics.frames_published = frames_published.load(std::memory_order_relaxed);
+        statistics.bytes_published = bytes_published.load(std::memory_order_relaxed);
+        statistics.dropped = dropped.load(std::memory_order_relaxed);
+        if(subscriber != nullptr)
+            statistics.dropped += subscriber->getMetrics().dropped;
+        return statistics;
+    }
+}
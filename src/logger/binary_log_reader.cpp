@@ -0,0 +1,239 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "logger/binary_log_reader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Formats one argument with a replacement field's format spec.
+         */
+        template<typename T>
+        void appendArgument(std::string& out, const std::string_view spec, T value)
+        {
+            if(!spec.empty())
+            {
+                try
+                {
+                    out += std::vformat("{:" + std::string(spec) + "}", std::make_format_args(value));
+                    return;
+                }
+                catch(const std::format_error&)
+                {
+                    // The spec does not fit the recorded type; fall back to the plain value.
+                }
+            }
+            out += std::format("{}", value);
+        }
+    }
+
+    binary_log_reader::~binary_log_reader()
+    {
+        close();
+    }
+
+    Result binary_log_reader::open(const std::string& path)
+    {
+        close();
+
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0)
+            return {Status::NotFound, std::format("Binary log {} could not be opened: {}", path, std::strerror(errno))};
+
+        struct stat info{};
+        void* _mapping = MAP_FAILED;
+        if(fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            mapping_size = static_cast<std::size_t>(info.st_size);
+            _mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if(_mapping == MAP_FAILED)
+        {
+            mapping_size = 0;
+            return {Status::Error, std::format("Binary log {} could not be mapped!", path)};
+        }
+        mapping = static_cast<unsigned char*>(_mapping);
+
+        if(mapping_size < binary_log::header_size + binary_log::format_table_size)
+        {
+            close();
+            return {Status::InvalidParam, std::format("Binary log {} is truncated!", path)};
+        }
+        std::memcpy(&header, mapping, sizeof(header));
+        if(header.magic != binary_log::magic || header.version != binary_log::version
+           || header.capacity == 0 || header.capacity % binary_log::block_size != 0
+           || mapping_size < binary_log::header_size + binary_log::format_table_size + header.capacity
+           || header.format_table_used > binary_log::format_table_size)
+        {
+            close();
+            return {Status::InvalidParam, std::format("Binary log {} has an unsupported format!", path)};
+        }
+
+        const auto* table = reinterpret_cast<const char*>(mapping + binary_log::header_size);
+        for(std::size_t offset = 0; formats.size() < header.format_count && offset < header.format_table_used;)
+        {
+            formats.emplace_back(table + offset, strnlen(table + offset, header.format_table_used - offset));
+            offset += formats.back().size() + 1;
+        }
+        return {Status::Success, "Binary log opened."};
+    }
+
+    void binary_log_reader::close()
+    {
+        if(mapping != nullptr)
+            munmap(mapping, mapping_size);
+        mapping = nullptr;
+        mapping_size = 0;
+        header = {};
+        formats.clear();
+    }
+
+    std::vector<binary_log_record> binary_log_reader::read() const
+    {
+        std::vector<binary_log_record> records;
+        if(mapping == nullptr)
+            return records;
+
+        const unsigned char* ring = mapping + binary_log::header_size + binary_log::format_table_size;
+        const std::uint64_t end = header.write_position;
+        // Once the ring has wrapped, the oldest complete block starts after the overwritten part.
+        std::uint64_t position = end > header.capacity
+                                 ? binary_log::alignUp(end - header.capacity, binary_log::block_size) : 0;
+
+        while(position < end)
+        {
+            const std::uint64_t block_end = position - position % binary_log::block_size + binary_log::block_size;
+            binary_log::record_header _header;
+            if(block_end - position < sizeof(_header))
+            {
+                position = block_end;
+                continue;
+            }
+
+            const unsigned char* record = ring + position % header.capacity;
+            std::memcpy(&_header, record, sizeof(_header));
+            if(_header.position != position || _header.size < sizeof(_header) || position + _header.size > block_end)
+            {
+                // Unfinished or overwritten; the next block starts with a record again.
+                position = block_end;
+                continue;
+            }
+
+            if(_header.format_id != binary_log::padding_format)
+            {
+                binary_log_record _record;
+                _record.position = position;
+                _record.timestamp_ns = _header.timestamp_ns;
+                _record.thread_id = _header.thread_id;
+                _record.level = static_cast<logger::Level>(_header.level);
+                _record.format_id = _header.format_id;
+                const std::string_view format = _header.format_id < formats.size()
+                                                ? std::string_view(formats[_header.format_id]) : "{?}";
+                _record.text = render(format, record + sizeof(_header), record + _header.size,
+                                      _header.argument_count);
+                records.push_back(std::move(_record));
+            }
+            position += _header.size;
+        }
+        return records;
+    }
+
+    std::string binary_log_reader::render(const std::string_view format, const unsigned char* arguments,
+                                          const unsigned char* end, std::size_t count)
+    {
+        std::string out;
+        for(std::size_t i = 0; i < format.size(); ++i)
+        {
+            const char c = format[i];
+            if((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c)
+            {
+                out += c;
+                ++i;
+                continue;
+            }
+            const std::size_t close = c == '{' ? format.find('}', i) : std::string_view::npos;
+            if(close == std::string_view::npos)
+            {
+                out += c;
+                continue;
+            }
+
+            const std::string_view field = format.substr(i + 1, close - i - 1);
+            const std::size_t colon = field.find(':');
+            const std::string_view spec = colon == std::string_view::npos ? std::string_view() : field.substr(colon + 1);
+            i = close;
+
+            if(count == 0 || arguments >= end)
+            {
+                out += "{?}";
+                continue;
+            }
+            --count;
+
+            const auto type = static_cast<binary_log::argument_type>(*arguments);
+            if(type == binary_log::argument_type::String && end - arguments >= 3)
+            {
+                std::uint16_t length;
+                std::memcpy(&length, arguments + 1, sizeof(length));
+                if(end - arguments - 3 < length)
+                {
+                    out += "{?}";
+                    count = 0;
+                    continue;
+                }
+                appendArgument(out, spec, std::string_view(reinterpret_cast<const char*>(arguments + 3), length));
+                arguments += 3 + length;
+                continue;
+            }
+            if(end - arguments < 9)
+            {
+                out += "{?}";
+                count = 0;
+                continue;
+            }
+
+            switch(type)
+            {
+                case binary_log::argument_type::Signed:
+                {
+                    std::int64_t value;
+                    std::memcpy(&value, arguments + 1, sizeof(value));
+                    appendArgument(out, spec, value);
+                    break;
+                }
+                case binary_log::argument_type::Unsigned:
+                {
+                    std::uint64_t value;
+                    std::memcpy(&value, arguments + 1, sizeof(value));
+                    appendArgument(out, spec, value);
+                    break;
+                }
+                case binary_log::argument_type::Float:
+                {
+                    double value;
+                    std::memcpy(&value, arguments + 1, sizeof(value));
+                    appendArgument(out, spec, value);
+                    break;
+                }
+                default:
+                    out += "{?}";
+                    count = 0;
+                    continue;
+            }
+            arguments += 9;
+        }
+        return out;
+    }
+}
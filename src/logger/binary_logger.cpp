@@ -0,0 +1,149 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "logger/binary_logger.h"
+
+#include <atomic>
+#include <cerrno>
+#include <format>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace vision
+{
+    binary_logger::binary_logger()
+    {
+        level_ = Debug;
+    }
+
+    binary_logger::~binary_logger()
+    {
+        close();
+    }
+
+    Result binary_logger::open(const std::string& path, const std::size_t ring_capacity)
+    {
+        close();
+
+        capacity = binary_log::alignUp(std::max<std::size_t>(ring_capacity, 1), binary_log::block_size);
+        mapping_size = binary_log::header_size + binary_log::format_table_size + capacity;
+
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(fd < 0)
+            return {Status::Error, std::format("Binary log {} could not be created: {}", path, std::strerror(errno))};
+
+        void* _mapping = MAP_FAILED;
+        if(ftruncate(fd, static_cast<off_t>(mapping_size)) == 0)
+            _mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        if(_mapping == MAP_FAILED)
+        {
+            mapping_size = capacity = 0;
+            return {Status::Error, std::format("Binary log {} could not be mapped: {}", path, reason)};
+        }
+
+        mapping = static_cast<unsigned char*>(_mapping);
+        header = new(mapping) binary_log::file_header;
+        header->capacity = capacity;
+        ring = mapping + binary_log::header_size + binary_log::format_table_size;
+
+        format_ids.clear();
+        text_format = registerFormat("{}");
+        return {Status::Success, "Binary log opened."};
+    }
+
+    void binary_logger::close()
+    {
+        if(mapping != nullptr)
+            munmap(mapping, mapping_size);
+        mapping = ring = nullptr;
+        header = nullptr;
+        mapping_size = capacity = 0;
+        text_format = binary_log::invalid_format;
+    }
+
+    std::uint16_t binary_logger::registerFormat(const std::string_view format)
+    {
+        std::lock_guard lock(format_mutex);
+        if(header == nullptr)
+            return binary_log::invalid_format;
+        if(const auto it = format_ids.find(std::string(format)); it != format_ids.end())
+            return it->second;
+
+        if(header->format_count >= binary_log::invalid_format
+           || header->format_table_used + format.size() + 1 > binary_log::format_table_size)
+            return binary_log::invalid_format;
+
+        unsigned char* table = mapping + binary_log::header_size;
+        std::memcpy(table + header->format_table_used, format.data(), format.size());
+        table[header->format_table_used + format.size()] = '\0';
+        header->format_table_used += static_cast<std::uint32_t>(format.size() + 1);
+
+        const auto id = static_cast<std::uint16_t>(header->format_count++);
+        format_ids.emplace(format, id);
+        return id;
+    }
+
+    void binary_logger::log(const Level level, const std::string& message)
+    {
+        write(level, text_format, message);
+    }
+
+    unsigned char* binary_logger::reserve(const std::size_t size, std::uint64_t& position)
+    {
+        if(size > binary_log::block_size)
+            return nullptr;
+
+        std::atomic_ref<std::uint64_t> write_position(header->write_position);
+        std::uint64_t start = write_position.load(std::memory_order_relaxed);
+        std::uint64_t _position;
+        do
+        {
+            const std::uint64_t offset = start % binary_log::block_size;
+            _position = offset + size > binary_log::block_size ? start + binary_log::block_size - offset : start;
+        } while(!write_position.compare_exchange_weak(start, _position + size, std::memory_order_relaxed));
+
+        // Fill the skipped end of the block so readers can step over it.
+        if(_position != start && _position - start >= sizeof(binary_log::record_header))
+        {
+            binary_log::record_header padding;
+            padding.size = static_cast<std::uint32_t>(_position - start);
+            padding.format_id = binary_log::padding_format;
+            unsigned char* record = ring + start % capacity;
+            std::memcpy(record, &padding, sizeof(padding));
+            commit(record, start);
+        }
+
+        position = _position;
+        return ring + _position % capacity;
+    }
+
+    void binary_logger::commit(unsigned char* record, const std::uint64_t position)
+    {
+        std::atomic_ref(reinterpret_cast<binary_log::record_header*>(record)->position)
+                .store(position, std::memory_order_release);
+    }
+
+    std::uint32_t binary_logger::threadId()
+    {
+        thread_local const auto id = static_cast<std::uint32_t>(syscall(SYS_gettid));
+        return id;
+    }
+
+    void binary_logger::flush()
+    {
+        if(mapping != nullptr)
+            msync(mapping, mapping_size, MS_ASYNC);
+    }
+
+    std::uint64_t binary_logger::getWritePosition() const
+    {
+        if(header == nullptr)
+            return 0;
+        return std::atomic_ref(header->write_position).load(std::memory_order_relaxed);
+    }
+}
@@ -2,8 +2,12 @@
 // Created by main on 19.09.2024.
 //
 
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
 #include <format>
 #include <iostream>
+#include <iterator>
 #include <ostream>
 #include "logger/console_logger.h"
 #include "config/config.h"
@@ -16,12 +20,17 @@ namespace vision
 {
 
     ConsoleLogger* ConsoleLogger::instance;
-    ConsoleLogger::ConsoleLogger()
+    ConsoleLogger::ConsoleLogger() : stream(&std::cout)
     {
         level_ = Info;
         this->log(Info,"Console Logger initialized.");
     }
 
+    ConsoleLogger::log_ring::log_ring(const std::size_t capacity)
+        : records(std::bit_ceil(std::max<std::size_t>(capacity, 2))), mask(records.size() - 1)
+    {
+    }
+
     ConsoleLogger* ConsoleLogger::getInstance()
     {
         if (instance == nullptr)
@@ -43,10 +52,279 @@ namespace vision
 
     void ConsoleLogger::log(Level level, const std::string& message)
     {
-        if(level <= level_)
+        if(level > level_)
+            return;
+
+        if(async_enabled.load(std::memory_order_acquire))
+        {
+            const std::uint64_t epoch = async_epoch.load(std::memory_order_acquire);
+            log_ring& ring = localRing(epoch);
+
+            // Pairs with stopAsync(): either it sees this thread writing and waits, or we see it stopping.
+            ring.writing.store(true, std::memory_order_seq_cst);
+            if(async_enabled.load(std::memory_order_seq_cst) && async_epoch.load(std::memory_order_seq_cst) == epoch)
+            {
+                const std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+                while(head - ring.tail.load(std::memory_order_acquire) > ring.mask)
+                {
+                    if(config.overflow == log_overflow::Drop)
+                    {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        ring.writing.store(false, std::memory_order_release);
+                        return;
+                    }
+                    requestDrain();
+                    std::this_thread::yield();
+                }
+
+                log_record& record = ring.records[head & ring.mask];
+                record.time_ns = std::chrono::steady_clock::now().time_since_epoch().count();
+                record.level = level;
+                record.length = static_cast<std::uint32_t>(message.size());
+                std::memcpy(record.text, message.data(), std::min(message.size(), record_text_size));
+                ring.head.store(head + 1, std::memory_order_release);
+                ring.writing.store(false, std::memory_order_release);
+
+                // Wake the sink early on errors and when the ring gets half full, once per crossing.
+                if(level == Error || head + 1 - ring.tail.load(std::memory_order_relaxed) == (ring.mask + 1) / 2)
+                    requestDrain();
+                return;
+            }
+            ring.writing.store(false, std::memory_order_release);
+        }
+
+        write(level, message);
+    }
+
+    void ConsoleLogger::write(const Level level, const std::string& message)
+    {
+        std::lock_guard lock(output_mutex);
+        *stream << std::format("[{}] [{}] {}",getLevelString(level), APP_NAME, message ) << std::endl;
+    }
+
+    void ConsoleLogger::setStream(std::ostream& output)
+    {
+        std::lock_guard lock(output_mutex);
+        stream = &output;
+    }
+
+    ConsoleLogger::log_ring& ConsoleLogger::localRing(const std::uint64_t epoch)
+    {
+        /**
+         * @brief The calling thread's ring; marked retired when the thread exits so the sink can drop it once drained.
+         */
+        thread_local struct local_ring
+        {
+            std::shared_ptr<log_ring> ring;
+            std::uint64_t epoch = 0;
+
+            ~local_ring()
+            {
+                if(ring)
+                    ring->retired.store(true, std::memory_order_release);
+            }
+        } local;
+
+        if(!local.ring || local.epoch != epoch)
+        {
+            if(local.ring)
+                local.ring->retired.store(true, std::memory_order_release);
+            local.ring = std::make_shared<log_ring>(config.ring_capacity);
+            local.epoch = epoch;
+            std::lock_guard lock(rings_mutex);
+            rings.push_back(local.ring);
+        }
+        return *local.ring;
+    }
+
+    void ConsoleLogger::requestDrain()
+    {
+        {
+            std::lock_guard lock(wake_mutex);
+            wake_requested = true;
+        }
+        wake.notify_one();
+    }
+
+    bool ConsoleLogger::startAsync(const async_log_config& async_config)
+    {
+        std::lock_guard lock(async_mutex);
+        if(async_enabled.load())
+            return false;
+
+        config = async_config;
+        {
+            std::lock_guard wake_lock(wake_mutex);
+            stopping = false;
+            wake_requested = false;
+        }
+        sink = std::thread(&ConsoleLogger::runSink, this);
+        async_epoch.fetch_add(1);
+        async_enabled.store(true);
+
+        static std::once_flag exit_hook;
+        std::call_once(exit_hook, [] {
+            std::atexit([] { instance->stopAsync(); });
+        });
+        return true;
+    }
+
+    void ConsoleLogger::stopAsync()
+    {
+        std::lock_guard lock(async_mutex);
+        if(!async_enabled.load())
+            return;
+
+        async_enabled.store(false);
+        {
+            std::lock_guard rings_lock(rings_mutex);
+            for(const auto& ring : rings)
+                while(ring->writing.load())
+                    std::this_thread::yield();
+        }
+        {
+            std::lock_guard wake_lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        sink.join();
+
+        std::lock_guard rings_lock(rings_mutex);
+        rings.clear();
+    }
+
+    void ConsoleLogger::flush()
+    {
+        std::unique_lock lock(async_mutex);
+        if(!async_enabled.load())
+        {
+            std::lock_guard output_lock(output_mutex);
+            stream->flush();
+            return;
+        }
+
+        std::unique_lock wake_lock(wake_mutex);
+        const std::uint64_t ticket = ++flush_requested;
+        wake_requested = true;
+        wake.notify_one();
+        flushed.wait(wake_lock, [&] { return flush_completed >= ticket; });
+    }
+
+    bool ConsoleLogger::isAsync() const
+    {
+        return async_enabled.load(std::memory_order_acquire);
+    }
+
+    std::uint64_t ConsoleLogger::getDroppedCount() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    void ConsoleLogger::runSink()
+    {
+        bool busy = false;
+        while(true)
+        {
+            std::uint64_t ticket;
+            bool stop;
+            {
+                std::unique_lock lock(wake_mutex);
+                if(!busy)
+                    wake.wait_for(lock, config.flush_interval, [&] { return wake_requested || stopping; });
+                wake_requested = false;
+                ticket = flush_requested;
+                stop = stopping;
+            }
+
+            busy = drain();
+
+            {
+                std::lock_guard lock(wake_mutex);
+                flush_completed = ticket;
+            }
+            flushed.notify_all();
+
+            if(stop && !busy)
+                return;
+        }
+    }
+
+    bool ConsoleLogger::drain()
+    {
+        /**
+         * @brief Unread records of one ring in this pass.
+         */
+        struct cursor
         {
-            std::cout << std::format("[{}] [{}] {}",getLevelString(level), APP_NAME, message ) << std::endl;
+            log_ring* ring;
+            std::uint64_t position;
+            std::uint64_t end;
+        };
+
+        std::vector<std::shared_ptr<log_ring>> active;
+        {
+            std::lock_guard lock(rings_mutex);
+            std::erase_if(rings, [](const std::shared_ptr<log_ring>& ring) {
+                return ring->retired.load(std::memory_order_acquire)
+                       && ring->head.load(std::memory_order_acquire) == ring->tail.load(std::memory_order_relaxed);
+            });
+            active = rings;
         }
 
+        std::vector<cursor> cursors;
+        cursors.reserve(active.size());
+        for(const auto& ring : active)
+        {
+            const std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+            if(head != tail)
+                cursors.push_back({ring.get(), tail, head});
+        }
+
+        // Each ring is in order already; repeatedly take the oldest front record across the rings.
+        while(true)
+        {
+            cursor* oldest = nullptr;
+            for(cursor& _cursor : cursors)
+            {
+                if(_cursor.position == _cursor.end)
+                    continue;
+                if(oldest == nullptr || _cursor.ring->records[_cursor.position & _cursor.ring->mask].time_ns
+                                        < oldest->ring->records[oldest->position & oldest->ring->mask].time_ns)
+                    oldest = &_cursor;
+            }
+            if(oldest == nullptr)
+                break;
+
+            const log_record& record = oldest->ring->records[oldest->position & oldest->ring->mask];
+            std::format_to(std::back_inserter(batch), "[{}] [{}] {}", getLevelString(record.level), APP_NAME,
+                           std::string_view(record.text, std::min<std::size_t>(record.length, record_text_size)));
+            if(record.length > record_text_size)
+                batch += "...";
+            batch += '\n';
+            ++oldest->position;
+        }
+
+        for(const cursor& _cursor : cursors)
+            _cursor.ring->tail.store(_cursor.end, std::memory_order_release);
+
+        const std::uint64_t dropped_now = dropped.load(std::memory_order_relaxed);
+        if(dropped_now != reported_dropped)
+        {
+            std::format_to(std::back_inserter(batch), "[{}] [{}] {} log records dropped.\n",
+                           getLevelString(Warning), APP_NAME, dropped_now - reported_dropped);
+            reported_dropped = dropped_now;
+        }
+
+        if(batch.empty())
+            return false;
+
+        {
+            std::lock_guard lock(output_mutex);
+            stream->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            stream->flush();
+        }
+        batch.clear();
+        return true;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,36 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "logger/logger.h"
+
+namespace vision
+{
+    void logger::setLevel(const Level level)
+    {
+        level_ = level;
+    }
+
+    logger::Level logger::getDefaultLevel()
+    {
+        return Info;
+    }
+
+    std::string logger::getLevelString(const Level level)
+    {
+        switch (level)
+        {
+            case None: return "None";
+            case Error: return "Error";
+            case Warning: return "Warning";
+            case Info: return "Info";
+            case Debug: return "Debug";
+            default: return "Unknown";
+        }
+    }
+
+    logger::Level logger::getLevel() const
+    {
+        return level_;
+    }
+}
@@ -0,0 +1,143 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "net/stream_client.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::uint64_t max_payload = 1ull << 30; ///< Larger payloads are taken for a corrupt stream.
+    }
+
+    stream_client::~stream_client()
+    {
+        close();
+    }
+
+    Result stream_client::connect(const std::string& address, const std::uint16_t port)
+    {
+        close();
+
+        sockaddr_in server{};
+        server.sin_family = AF_INET;
+        server.sin_port = htons(port);
+        if(inet_pton(AF_INET, address.c_str(), &server.sin_addr) != 1)
+            return {Status::InvalidParam, std::format("Invalid server address {}!", address)};
+
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0)
+            return {Status::Error, std::format("Socket could not be created: {}", std::strerror(errno))};
+        if(::connect(fd, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) != 0)
+        {
+            const Result result{Status::Error, std::format("Could not connect to {}:{}: {}", address, port,
+                                                           std::strerror(errno))};
+            close();
+            return result;
+        }
+        const int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return {Status::Success, std::format("Connected to {}:{}.", address, port)};
+    }
+
+    Result stream_client::subscribe(const std::uint32_t streams, const std::uint32_t max_fps, const std::int32_t device_id)
+    {
+        if(!isConnected())
+            return {Status::Unsuccess, "Client is not connected!"};
+
+        stream::subscribe_message message;
+        message.streams = streams;
+        message.max_fps = max_fps;
+        message.device_id = device_id;
+        const auto* data = reinterpret_cast<const unsigned char*>(&message);
+        std::size_t sent = 0;
+        while(sent < sizeof(message))
+        {
+            const ssize_t written = send(fd, data + sent, sizeof(message) - sent, MSG_NOSIGNAL);
+            if(written < 0 && errno == EINTR)
+                continue;
+            if(written <= 0)
+            {
+                close();
+                return {Status::Error, std::format("Subscription could not be sent: {}", std::strerror(errno))};
+            }
+            sent += static_cast<std::size_t>(written);
+        }
+        return {Status::Success, "Subscribed."};
+    }
+
+    Result stream_client::readExact(void* data, const std::size_t size,
+                                    const std::chrono::steady_clock::time_point deadline) const
+    {
+        auto* out = static_cast<unsigned char*>(data);
+        std::size_t received = 0;
+        while(received < size)
+        {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+            pollfd request{fd, POLLIN, 0};
+            const int ready = poll(&request, 1, static_cast<int>(std::max<std::int64_t>(left, 0)));
+            if(ready < 0 && errno == EINTR)
+                continue;
+            if(ready == 0)
+                return {Status::Timeout, "No frame arrived in time."};
+            const ssize_t count = ready < 0 ? -1 : recv(fd, out + received, size - received, 0);
+            if(count < 0 && errno == EINTR)
+                continue;
+            if(count <= 0)
+                return {Status::Error, count == 0 ? "Server closed the connection!"
+                                                  : std::format("Receive failed: {}", std::strerror(errno))};
+            received += static_cast<std::size_t>(count);
+        }
+        return {Status::Success, "Received."};
+    }
+
+    Result stream_client::receive(received_frame& frame, const std::chrono::milliseconds timeout)
+    {
+        if(!isConnected())
+            return {Status::Unsuccess, "Client is not connected!"};
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        pollfd request{fd, POLLIN, 0};
+        int ready;
+        do
+            ready = poll(&request, 1, static_cast<int>(timeout.count()));
+        while(ready < 0 && errno == EINTR);
+        if(ready == 0)
+            return {Status::Timeout, "No frame arrived in time."};
+
+        // A frame cut short cannot be resumed, so any failure past this point closes the stream.
+        Result result = readExact(&frame.header, sizeof(frame.header), deadline);
+        if(result.status == Status::Success
+           && (frame.header.magic != stream::frame_magic || frame.header.version != stream::version
+               || frame.header.header_size != sizeof(stream::frame_header) || frame.header.payload_size > max_payload))
+            result = {Status::InvalidParam, "Server sent an invalid frame header!"};
+        if(result.status == Status::Success)
+        {
+            frame.payload.resize(frame.header.payload_size);
+            result = readExact(frame.payload.data(), frame.payload.size(), deadline);
+        }
+        if(result.status != Status::Success)
+            close();
+        return result;
+    }
+
+    void stream_client::close()
+    {
+        if(fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+}
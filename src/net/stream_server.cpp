@@ -0,0 +1,609 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "net/stream_server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <arpa/inet.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::size_t header_size = sizeof(stream::frame_header);
+        constexpr std::size_t max_batch = 64; ///< Upper bound of stream_server_config::max_batch.
+
+        std::int64_t steadyNow()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool subscribed(const stream::subscribe_message& subscription, const int device_id, const std::uint32_t type)
+        {
+            return (subscription.streams & type) != 0
+                   && (subscription.device_id < 0 || subscription.device_id == device_id);
+        }
+    }
+
+    stream_server::stream_server(const stream_server_config& config)
+        : config(config)
+    {
+        this->config.max_queued_frames = std::max<std::size_t>(config.max_queued_frames, 1);
+        this->config.max_batch = std::clamp<std::size_t>(config.max_batch, 1, max_batch);
+        if(config.compress_depth)
+            codec = std::make_unique<depth_codec>(config.depth_codec);
+    }
+
+    stream_server::~stream_server()
+    {
+        stop();
+    }
+
+    Result stream_server::start()
+    {
+        if(isRunning())
+            return {Status::Conflict, "Server is already running!"};
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(config.port);
+        if(inet_pton(AF_INET, config.address.c_str(), &address.sin_addr) != 1)
+            return {Status::InvalidParam, std::format("Invalid listen address {}!", config.address)};
+
+        const auto fail = [this](const std::string& what) {
+            const Result result{Status::Error, std::format("Server could not {}: {}", what, std::strerror(errno))};
+            for(int* fd : {&listen_fd, &epoll_fd, &wake_fd})
+            {
+                if(*fd >= 0)
+                    ::close(*fd);
+                *fd = -1;
+            }
+            return result;
+        };
+
+        listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if(listen_fd < 0)
+            return fail("create its socket");
+        const int one = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if(bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+            return fail(std::format("bind {}:{}", config.address, config.port));
+        if(listen(listen_fd, 16) != 0)
+            return fail("listen");
+        socklen_t length = sizeof(address);
+        getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &length);
+        port = ntohs(address.sin_port);
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(epoll_fd < 0 || wake_fd < 0)
+            return fail("create its event loop");
+        for(const int fd : {listen_fd, wake_fd})
+        {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+                return fail("create its event loop");
+        }
+
+        stopping = false;
+        frames_sent = bytes_sent = dropped = copied = send_calls = zerocopy_calls = 0;
+        loop = std::thread(&stream_server::run, this);
+        return {Status::Success, std::format("Streaming on {}:{}.", config.address, port)};
+    }
+
+    Result stream_server::attach(frame_bus& bus)
+    {
+        if(!isRunning())
+            return {Status::Unsuccess, "Server is not running!"};
+        if(this->bus != nullptr)
+            return {Status::Conflict, "Server is already attached!"};
+
+        subscriber_config _config;
+        _config.queue_depth = config.bus_queue_depth;
+        _config.policy = backpressure::DropOldest;
+        this->bus = &bus;
+        subscriber = bus.subscribe(_config);
+        publisher_thread = std::thread(&stream_server::publishQueued, this);
+        return {Status::Success, "Server attached."};
+    }
+
+    void stream_server::publishQueued()
+    {
+        scheduled_frame frame;
+        // pop() also fails on a timeout; once the subscription is closed it fails only when drained.
+        while(subscriber->pop(frame, std::chrono::milliseconds(100)) || !subscriber->isClosed())
+        {
+            if(frame.frame)
+                publish(frame.device_id, frame.frame);
+            frame.frame.reset();
+        }
+    }
+
+    Result stream_server::stop()
+    {
+        // The publishing thread is joined before the loop, so nothing is queued for clients being removed.
+        if(bus != nullptr)
+        {
+            bus->unsubscribe(subscriber);
+            publisher_thread.join();
+            dropped.fetch_add(subscriber->getMetrics().dropped, std::memory_order_relaxed);
+            subscriber.reset();
+            bus = nullptr;
+        }
+        if(!isRunning())
+            return {Status::Unsuccess, "Server is not running!"};
+
+        stopping = true;
+        wake();
+        loop.join();
+        while(!clients.empty())
+            removeClient(clients.begin()->first);
+        for(int* fd : {&listen_fd, &epoll_fd, &wake_fd})
+        {
+            ::close(*fd);
+            *fd = -1;
+        }
+        port = 0;
+        return {Status::Success, "Server stopped."};
+    }
+
+    void stream_server::wake() const
+    {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(wake_fd, &one, sizeof(one));
+    }
+
+    void stream_server::run()
+    {
+        epoll_event events[64];
+        while(!stopping.load(std::memory_order_acquire))
+        {
+            const int count = epoll_wait(epoll_fd, events, 64, 100);
+            if(count < 0 && errno != EINTR)
+                break;
+            for(int i = 0; i < count; ++i)
+            {
+                const int fd = events[i].data.fd;
+                if(fd == listen_fd)
+                {
+                    acceptClients();
+                    continue;
+                }
+                if(fd == wake_fd)
+                {
+                    std::uint64_t value = 0;
+                    [[maybe_unused]] const ssize_t read_size = read(wake_fd, &value, sizeof(value));
+                    continue;
+                }
+
+                const auto it = clients.find(fd);
+                if(it == clients.end())
+                    continue;
+                client& _client = *it->second;
+                bool alive = (events[i].events & EPOLLHUP) == 0;
+                if(events[i].events & EPOLLERR)
+                {
+                    // The error queue carries MSG_ZEROCOPY completions as well as real errors.
+                    reapZerocopy(_client);
+                    int error = 0;
+                    socklen_t length = sizeof(error);
+                    alive = alive && getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+                }
+                if(alive && (events[i].events & EPOLLIN))
+                    alive = readClient(_client);
+                if(alive && (events[i].events & EPOLLOUT))
+                    _client.writable = true;
+                if(!alive)
+                    removeClient(fd);
+            }
+
+            // Every frame wakes the loop, so flushing all writable clients here serves each frame once.
+            for(auto it = clients.begin(); it != clients.end();)
+            {
+                const int fd = it->first;
+                client& _client = *it->second;
+                ++it;
+                if(!_client.completing.empty())
+                    reapZerocopy(_client);
+                if(_client.writable && !flushClient(_client))
+                    removeClient(fd);
+            }
+        }
+    }
+
+    void stream_server::acceptClients()
+    {
+        for(;;)
+        {
+            const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if(fd < 0)
+                return;
+            if(clients.size() >= config.max_clients)
+            {
+                ::close(fd);
+                continue;
+            }
+
+            auto _client = std::make_unique<client>();
+            _client->fd = fd;
+            const int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if(config.socket_buffer > 0)
+            {
+                const int size = static_cast<int>(config.socket_buffer);
+                setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+            }
+#ifdef SO_ZEROCOPY
+            _client->zerocopy = config.zerocopy && setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+#endif
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+            event.data.fd = fd;
+            if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+            {
+                ::close(fd);
+                continue;
+            }
+            std::unique_lock lock(clients_mutex);
+            clients.emplace(fd, std::move(_client));
+        }
+    }
+
+    bool stream_server::readClient(client& _client)
+    {
+        for(;;)
+        {
+            const ssize_t received = recv(_client.fd, _client.request + _client.request_size,
+                                          sizeof(_client.request) - _client.request_size, 0);
+            if(received == 0)
+                return false;
+            if(received < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+
+            _client.request_size += static_cast<std::size_t>(received);
+            if(_client.request_size < sizeof(_client.request))
+                continue;
+            _client.request_size = 0;
+            stream::subscribe_message _subscription;
+            std::memcpy(&_subscription, _client.request, sizeof(_subscription));
+            if(_subscription.magic != stream::subscribe_magic || _subscription.version != stream::version)
+                return false;
+            std::lock_guard lock(_client.mutex);
+            _client.subscription = _subscription;
+            _client.last_queued.clear();
+        }
+    }
+
+    bool stream_server::flushClient(client& _client)
+    {
+        iovec vectors[2 * max_batch];
+        bool zerocopy_allowed = _client.zerocopy;
+        for(;;)
+        {
+            if(_client.sending.empty())
+            {
+                std::lock_guard lock(_client.mutex);
+                while(!_client.queued.empty() && _client.sending.size() < config.max_batch)
+                {
+                    _client.sending.push_back(std::move(_client.queued.front()));
+                    _client.queued.pop_front();
+                }
+                if(!_client.sending.empty())
+                {
+                    _client.sending.front()->header.dropped = _client.dropped;
+                    _client.dropped = 0;
+                }
+            }
+            if(_client.sending.empty())
+                return true;
+
+            // Headers and payloads of the whole batch go out in one call.
+            std::size_t count = 0, total = 0;
+            bool large = false;
+            for(const auto& queued : _client.sending)
+            {
+                message& _message = *queued;
+                if(_message.sent < header_size)
+                {
+                    vectors[count++] = {reinterpret_cast<unsigned char*>(&_message.header) + _message.sent,
+                                        header_size - _message.sent};
+                    total += header_size - _message.sent;
+                }
+                const std::size_t payload_sent = _message.sent > header_size ? _message.sent - header_size : 0;
+                const std::size_t payload_left = _message.header.payload_size - payload_sent;
+                if(payload_left > 0)
+                {
+                    vectors[count++] = {const_cast<unsigned char*>(_message.payload) + payload_sent, payload_left};
+                    total += payload_left;
+                    large = large || payload_left >= config.zerocopy_threshold;
+                }
+            }
+
+            msghdr header{};
+            header.msg_iov = vectors;
+            header.msg_iovlen = count;
+            const bool zerocopy = zerocopy_allowed && large;
+            int flags = MSG_NOSIGNAL;
+#ifdef MSG_ZEROCOPY
+            if(zerocopy)
+                flags |= MSG_ZEROCOPY;
+#endif
+            const ssize_t written = sendmsg(_client.fd, &header, flags);
+            if(written < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                if(errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    _client.writable = false;
+                    return true;
+                }
+                if(errno == ENOBUFS && zerocopy)
+                {
+                    // Out of option memory for pinned pages; this batch is copied instead.
+                    zerocopy_allowed = false;
+                    continue;
+                }
+                return false;
+            }
+            send_calls.fetch_add(1, std::memory_order_relaxed);
+            bytes_sent.fetch_add(static_cast<std::uint64_t>(written), std::memory_order_relaxed);
+            std::uint32_t zerocopy_id = 0;
+            if(zerocopy)
+            {
+                zerocopy_id = _client.next_zerocopy_id++;
+                zerocopy_calls.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            auto left = static_cast<std::size_t>(written);
+            while(!_client.sending.empty() && left > 0)
+            {
+                message& _message = *_client.sending.front();
+                const std::size_t taken = std::min(left, header_size + _message.header.payload_size - _message.sent);
+                _message.sent += taken;
+                left -= taken;
+                if(zerocopy && taken > 0)
+                {
+                    _message.zerocopy = true;
+                    _message.zerocopy_id = zerocopy_id;
+                }
+                if(_message.sent < header_size + _message.header.payload_size)
+                    break;
+                frames_sent.fetch_add(1, std::memory_order_relaxed);
+                // The kernel may still read a zero-copy header and payload, so the message is kept until completion.
+                if(_message.zerocopy)
+                    _client.completing.push_back(std::move(_client.sending.front()));
+                _client.sending.pop_front();
+            }
+            if(static_cast<std::size_t>(written) < total)
+            {
+                _client.writable = false;
+                return true;
+            }
+        }
+    }
+
+    void stream_server::reapZerocopy(client& _client)
+    {
+#ifdef SO_EE_ORIGIN_ZEROCOPY
+        for(;;)
+        {
+            alignas(cmsghdr) unsigned char control[128];
+            msghdr header{};
+            header.msg_control = control;
+            header.msg_controllen = sizeof(control);
+            if(recvmsg(_client.fd, &header, MSG_ERRQUEUE) < 0)
+                break;
+            for(cmsghdr* message = CMSG_FIRSTHDR(&header); message != nullptr; message = CMSG_NXTHDR(&header, message))
+            {
+                if(!(message->cmsg_level == SOL_IP && message->cmsg_type == IP_RECVERR)
+                   && !(message->cmsg_level == SOL_IPV6 && message->cmsg_type == IPV6_RECVERR))
+                    continue;
+                sock_extended_err error{};
+                std::memcpy(&error, CMSG_DATA(message), sizeof(error));
+                // TCP completes its zero-copy sends in order; ee_data is the last ID of the range.
+                if(error.ee_errno == 0 && error.ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+                    _client.completed_zerocopy_id = error.ee_data + 1;
+            }
+        }
+#endif
+        while(!_client.completing.empty()
+              && static_cast<std::int32_t>(_client.completing.front()->zerocopy_id - _client.completed_zerocopy_id) < 0)
+            _client.completing.pop_front();
+    }
+
+    void stream_server::removeClient(const int fd)
+    {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        std::unique_lock lock(clients_mutex);
+        clients.erase(fd);
+    }
+
+    bool stream_server::enqueue(const message& _message)
+    {
+        const std::int64_t now = steadyNow();
+        const stream::frame_header& header = _message.header;
+        bool queued = false;
+        {
+            std::shared_lock lock(clients_mutex);
+            for(auto& [fd, _client] : clients)
+            {
+                std::lock_guard client_lock(_client->mutex);
+                const stream::subscribe_message& _subscription = _client->subscription;
+                if(!subscribed(_subscription, header.device_id, header.type))
+                    continue;
+                if(_subscription.max_fps > 0)
+                {
+                    // A quarter period of slack keeps a 30 fps stream at 30 fps despite arrival jitter.
+                    const std::int64_t period = 1'000'000'000 / _subscription.max_fps;
+                    std::int64_t& last = _client->last_queued[{header.device_id, header.type}];
+                    if(last != 0 && now - last < period - period / 4)
+                        continue;
+                    last = now;
+                }
+                if(_client->queued.size() >= config.max_queued_frames)
+                {
+                    _client->queued.pop_front();
+                    ++_client->dropped;
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                _client->queued.push_back(std::make_unique<message>(_message));
+                _client->queued.back()->header.queued_ns = now;
+                queued = true;
+            }
+        }
+        if(queued)
+            wake();
+        return queued;
+    }
+
+    bool stream_server::publish(const int device_id, const frame_handle& frame)
+    {
+        if(!isRunning() || !frame || frame->data == nullptr)
+            return false;
+        const libfreenect2::Frame::Type type = frame.type();
+        {
+            // Frames nobody subscribed to are neither compressed nor referenced.
+            std::shared_lock lock(clients_mutex);
+            if(std::none_of(clients.begin(), clients.end(), [&](const auto& entry) {
+                std::lock_guard client_lock(entry.second->mutex);
+                return subscribed(entry.second->subscription, device_id, type);
+            }))
+                return false;
+        }
+
+        message _message;
+        stream::frame_header& header = _message.header;
+        header.arrival_ns = frame.arrivalTime();
+        header.device_id = device_id;
+        header.type = type;
+        header.format = frame->format;
+        header.timestamp = frame->timestamp;
+        header.sequence = frame->sequence;
+        header.status = frame->status;
+        header.width = static_cast<std::uint32_t>(frame->width);
+        header.height = static_cast<std::uint32_t>(frame->height);
+        header.bytes_per_pixel = static_cast<std::uint32_t>(frame->bytes_per_pixel);
+        header.exposure = frame->exposure;
+        header.gain = frame->gain;
+        header.gamma = frame->gamma;
+
+        if(config.compress_depth && type == libfreenect2::Frame::Depth && frame->format == libfreenect2::Frame::Float
+           && frame->bytes_per_pixel == sizeof(float))
+        {
+            auto buffer = std::make_shared<std::vector<unsigned char>>();
+            std::unique_lock lock(codec_mutex);
+            if(codec->encode(reinterpret_cast<const float*>(frame->data), frame->width, frame->height, *buffer).status
+               != Status::Success)
+                return false;
+            lock.unlock();
+            header.format = stream::compressed_depth_format;
+            header.payload_size = buffer->size();
+            _message.payload = buffer->data();
+            _message.buffer = std::move(buffer);
+        }
+        else
+        {
+            header.payload_size = frame->width * frame->height * frame->bytes_per_pixel;
+            std::shared_ptr<std::atomic<std::size_t>> held;
+            {
+                std::lock_guard lock(pins_mutex);
+                auto& counter = pins[{device_id, type}];
+                if(!counter)
+                    counter = std::make_shared<std::atomic<std::size_t>>(0);
+                held = counter;
+            }
+            if(held->fetch_add(1, std::memory_order_acquire) < config.max_pinned_frames)
+            {
+                _message.payload = frame->data;
+                _message.frame = std::make_shared<const pinned_frame>(frame, std::move(held));
+            }
+            else
+            {
+                // Stalled clients already hold enough of this pool; capture keeps the rest.
+                held->fetch_sub(1, std::memory_order_relaxed);
+                auto buffer = std::make_shared<std::vector<unsigned char>>(frame->data, frame->data + header.payload_size);
+                _message.payload = buffer->data();
+                _message.buffer = std::move(buffer);
+                copied.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if(header.payload_size == 0)
+            return false;
+        return enqueue(_message);
+    }
+
+    bool stream_server::publishCloud(const int device_id, const point_cloud& cloud, const std::uint32_t sequence,
+                                     const std::int64_t arrival_ns)
+    {
+        if(!isRunning() || cloud.size() == 0)
+            return false;
+
+        const bool with_color = cloud.rgb.size() == cloud.size();
+        const std::size_t plane = cloud.size() * sizeof(float);
+        auto buffer = std::make_shared<std::vector<unsigned char>>(plane * (with_color ? 4 : 3));
+        unsigned char* out = buffer->data();
+        for(const std::vector<float>* values : {&cloud.x, &cloud.y, &cloud.z})
+        {
+            std::memcpy(out, values->data(), plane);
+            out += plane;
+        }
+        if(with_color)
+            std::memcpy(out, cloud.rgb.data(), plane);
+
+        message _message;
+        stream::frame_header& header = _message.header;
+        header.arrival_ns = arrival_ns;
+        header.device_id = device_id;
+        header.type = stream::cloud_type;
+        header.format = libfreenect2::Frame::Float;
+        header.sequence = sequence;
+        header.width = static_cast<std::uint32_t>(cloud.width);
+        header.height = static_cast<std::uint32_t>(cloud.height);
+        header.bytes_per_pixel = with_color ? 16 : 12;
+        header.payload_size = buffer->size();
+        _message.payload = buffer->data();
+        _message.buffer = std::move(buffer);
+        return enqueue(_message);
+    }
+
+    stream_server_statistics stream_server::getStatistics() const
+    {
+        stream_server_statistics statistics;
+        {
+            std::shared_lock lock(clients_mutex);
+            statistics.clients = clients.size();
+        }
+        statistics.frames_sent = frames_sent.load(std::memory_order_relaxed);
+        statistics.bytes_sent = bytes_sent.load(std::memory_order_relaxed);
+        statistics.dropped = dropped.load(std::memory_order_relaxed);
+        if(subscriber != nullptr)
+            statistics.dropped += subscriber->getMetrics().dropped;
+        statistics.copied = copied.load(std::memory_order_relaxed);
+        statistics.send_calls = send_calls.load(std::memory_order_relaxed);
+        statistics.zerocopy_calls = zerocopy_calls.load(std::memory_order_relaxed);
+        return statistics;
+    }
+}
@@ -0,0 +1,411 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "recorder/frame_recorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fcntl.h>
+#include <unistd.h>
+#include "logger/console_logger.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Writes a whole buffer at an offset, retrying short writes.
+         */
+        bool writeAll(const int fd, const unsigned char* data, std::size_t size, off_t offset)
+        {
+            while(size > 0)
+            {
+                const ssize_t written = pwrite(fd, data, size, offset);
+                if(written < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+                    return false;
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+                offset += written;
+            }
+            return true;
+        }
+
+        int openOutput(const std::string& path, const bool direct_io)
+        {
+            constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+            if(direct_io)
+            {
+                // tmpfs and some network file systems reject O_DIRECT; fall back to buffered I/O there.
+                const int fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+                if(fd >= 0 || errno != EINVAL)
+                    return fd;
+            }
+            return ::open(path.c_str(), flags, 0644);
+        }
+    }
+
+    frame_recorder::frame_recorder(const recorder_config& config)
+        : config(config), chunks(std::max<std::size_t>(config.chunk_count, 2))
+    {
+        if(config.compress_depth)
+            codec = std::make_unique<depth_codec>(config.depth_codec);
+        this->config.chunk_size = std::max(recording::alignUp(config.chunk_size, recording::page_size),
+                                           recording::page_size);
+        free_chunks.reserve(chunks.size());
+        write_queue.reserve(chunks.size());
+        for(auto& _chunk : chunks)
+        {
+            _chunk.data = static_cast<unsigned char*>(std::aligned_alloc(recording::page_size, this->config.chunk_size));
+            // Touch every page up front so the capture threads never take a page fault on first use.
+            std::memset(_chunk.data, 0, this->config.chunk_size);
+            _chunk.entries.reserve(config.max_chunk_frames);
+            free_chunks.push_back(&_chunk);
+        }
+    }
+
+    frame_recorder::~frame_recorder()
+    {
+        close();
+        for(auto& _chunk : chunks)
+            std::free(_chunk.data);
+    }
+
+    Result frame_recorder::open(const std::string& path)
+    {
+        if(isRecording() || writer.joinable())
+            return {Status::Conflict, "Recorder is already open!"};
+
+        data_fd = openOutput(recording::dataPath(path), config.direct_io);
+        index_fd = ::open(recording::indexPath(path).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(data_fd < 0 || index_fd < 0)
+        {
+            const std::string reason = std::strerror(errno);
+            closeFiles();
+            return {Status::Error, std::format("Recording {} could not be created: {}", path, reason)};
+        }
+
+        // The header page goes through a staging buffer so it satisfies O_DIRECT alignment too.
+        unsigned char* page = free_chunks.back()->data;
+        std::memset(page, 0, recording::page_size);
+        recording::data_header _data_header;
+        _data_header.chunk_size = config.chunk_size;
+        std::memcpy(page, &_data_header, sizeof(_data_header));
+
+        recording::index_header _index_header;
+        _index_header.entry_size = sizeof(recording::index_entry);
+        if(!writeAll(data_fd, page, recording::page_size, 0)
+           || !writeAll(index_fd, reinterpret_cast<const unsigned char*>(&_index_header), sizeof(_index_header), 0))
+        {
+            const std::string reason = std::strerror(errno);
+            closeFiles();
+            return {Status::Error, std::format("Recording {} could not be written: {}", path, reason)};
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            next_offset = recording::page_size;
+            data_end = recording::page_size;
+            statistics = {};
+            stopping = false;
+            recording = true;
+        }
+        writer = std::thread(&frame_recorder::run, this);
+        return {Status::Success, "Recording started."};
+    }
+
+    Result frame_recorder::attach(frame_scheduler& scheduler)
+    {
+        if(!isRecording())
+            return {Status::Unsuccess, "Recorder is not open!"};
+        if(this->scheduler != nullptr)
+            return {Status::Conflict, "Recorder is already attached!"};
+
+        this->scheduler = &scheduler;
+        subscription = scheduler.subscribe([this](const scheduled_frame& frame) {
+            record(frame.device_id, frame.frame);
+        });
+        return {Status::Success, "Recorder attached."};
+    }
+
+    Result frame_recorder::close()
+    {
+        // Unsubscribing waits for deliveries in progress, so no capture thread is left inside record().
+        if(scheduler != nullptr)
+        {
+            scheduler->unsubscribe(subscription);
+            scheduler = nullptr;
+            subscription = -1;
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            if(!writer.joinable())
+                return {Status::Unsuccess, "Recorder is not open!"};
+            recording = false;
+            sealCurrent();
+            stopping = true;
+        }
+        writer_signal.notify_all();
+        writer.join();
+
+        // O_DIRECT writes whole pages; cut the zero padding after the last payload.
+        if(ftruncate(data_fd, static_cast<off_t>(data_end)) != 0)
+            ++statistics.write_errors;
+        closeFiles();
+
+        if(statistics.write_errors > 0)
+            return {Status::Error, std::format("Recording closed with {} write errors!", statistics.write_errors)};
+        return {Status::Success, "Recording closed."};
+    }
+
+    void frame_recorder::closeFiles()
+    {
+        if(data_fd >= 0)
+            ::close(data_fd);
+        if(index_fd >= 0)
+            ::close(index_fd);
+        data_fd = index_fd = -1;
+    }
+
+    bool frame_recorder::accepts(const int device_id, const libfreenect2::Frame::Type type) const
+    {
+        if((config.frame_types & type) == 0)
+            return false;
+        return config.device_ids.empty()
+               || std::find(config.device_ids.begin(), config.device_ids.end(), device_id) != config.device_ids.end();
+    }
+
+    bool frame_recorder::record(const int device_id, const libfreenect2::Frame& frame,
+                                const libfreenect2::Frame::Type type, const std::int64_t arrival_ns)
+    {
+        if(!accepts(device_id, type) || frame.data == nullptr)
+            return false;
+
+        const std::size_t size = frame.width * frame.height * frame.bytes_per_pixel;
+        // Marked compressed here and encoded by the writer thread, which reverts the mark if encoding does not pay off.
+        const bool compress = config.compress_depth && type == libfreenect2::Frame::Depth
+                              && frame.format == libfreenect2::Frame::Float && frame.bytes_per_pixel == sizeof(float);
+
+        chunk* target = nullptr;
+        std::size_t offset = 0;
+        {
+            std::lock_guard lock(mutex);
+            if(!recording)
+                return false;
+            if(size == 0 || size > config.chunk_size)
+            {
+                ++statistics.dropped;
+                return false;
+            }
+
+            if(current != nullptr && (current->used + size > config.chunk_size
+                                      || current->entries.size() >= config.max_chunk_frames))
+                sealCurrent();
+            if(current == nullptr)
+            {
+                if(free_chunks.empty())
+                {
+                    ++statistics.dropped;
+                    return false;
+                }
+                current = free_chunks.back();
+                free_chunks.pop_back();
+                current->used = 0;
+                current->entries.clear();
+                current->sealed = false;
+            }
+
+            target = current;
+            offset = target->used;
+            target->used = recording::alignUp(offset + size, recording::payload_alignment);
+            ++target->writers;
+
+            recording::index_entry& entry = target->entries.emplace_back();
+            entry.offset = offset;
+            entry.size = size;
+            entry.arrival_ns = arrival_ns;
+            entry.record_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+            entry.device_id = device_id;
+            entry.type = type;
+            entry.format = compress ? recording::compressed_depth_format : static_cast<std::uint32_t>(frame.format);
+            entry.timestamp = frame.timestamp;
+            entry.sequence = frame.sequence;
+            entry.status = frame.status;
+            entry.width = static_cast<std::uint32_t>(frame.width);
+            entry.height = static_cast<std::uint32_t>(frame.height);
+            entry.bytes_per_pixel = static_cast<std::uint32_t>(frame.bytes_per_pixel);
+            entry.exposure = frame.exposure;
+            entry.gain = frame.gain;
+            entry.gamma = frame.gamma;
+        }
+
+        // The copy runs outside the lock so capture threads of different devices copy in parallel.
+        std::memcpy(target->data + offset, frame.data, size);
+
+        std::lock_guard lock(mutex);
+        if(--target->writers == 0 && target->sealed)
+            writer_signal.notify_one();
+        return true;
+    }
+
+    bool frame_recorder::record(const int device_id, const frame_handle& frame)
+    {
+        if(!frame)
+            return false;
+        return record(device_id, *frame, frame.type(), frame.arrivalTime());
+    }
+
+    void frame_recorder::sealCurrent()
+    {
+        if(current == nullptr || current->used == 0)
+            return;
+
+        chunk* sealed = current;
+        current = nullptr;
+        sealed->sealed = true;
+        ++in_flight;
+        write_queue.push_back(sealed);
+        if(sealed->writers == 0)
+            writer_signal.notify_one();
+    }
+
+    void frame_recorder::flush()
+    {
+        std::unique_lock lock(mutex);
+        sealCurrent();
+        written_signal.wait(lock, [this] { return in_flight == 0; });
+    }
+
+    void frame_recorder::compressChunk(chunk& _chunk)
+    {
+        std::uint64_t compressed = 0;
+        std::uint64_t saved = 0;
+        std::size_t end = 0;
+        for(auto& entry : _chunk.entries)
+        {
+            unsigned char* payload = _chunk.data + entry.offset;
+            if(entry.format == recording::compressed_depth_format)
+            {
+                if(codec->encode(reinterpret_cast<const float*>(payload), entry.width, entry.height, encoded).status
+                   == Status::Success && encoded.size() < entry.size)
+                {
+                    std::memcpy(payload, encoded.data(), encoded.size());
+                    saved += entry.size - encoded.size();
+                    entry.size = encoded.size();
+                    ++compressed;
+                }
+                else
+                    entry.format = libfreenect2::Frame::Float;
+            }
+            // Payloads move down over the space the encoded frames before them gave up.
+            if(entry.offset != end)
+                std::memmove(_chunk.data + end, payload, entry.size);
+            entry.offset = end;
+            end = recording::alignUp(end + entry.size, recording::payload_alignment);
+        }
+        _chunk.used = end;
+
+        std::lock_guard lock(mutex);
+        statistics.compressed_frames += compressed;
+        statistics.bytes_saved += saved;
+    }
+
+    bool frame_recorder::writeChunk(chunk& _chunk)
+    {
+        const std::size_t padded = recording::alignUp(_chunk.used, recording::page_size);
+        std::memset(_chunk.data + _chunk.used, 0, padded - _chunk.used);
+        if(!writeAll(data_fd, _chunk.data, padded, static_cast<off_t>(_chunk.file_offset)))
+            return false;
+
+        for(auto& entry : _chunk.entries)
+            entry.offset += _chunk.file_offset;
+
+        // The index is append-only; entries follow their payloads so a crash never leaves dangling entries.
+        const auto* entries = reinterpret_cast<const unsigned char*>(_chunk.entries.data());
+        const std::size_t size = _chunk.entries.size() * sizeof(recording::index_entry);
+        const off_t end = lseek(index_fd, 0, SEEK_END);
+        return end >= 0 && writeAll(index_fd, entries, size, end);
+    }
+
+    void frame_recorder::run()
+    {
+        // Chunks are written strictly in seal order, so the index stays in recording order even
+        // when a later chunk finishes its copies first.
+        const auto ready = [this] {
+            return !write_queue.empty() && write_queue.front()->writers == 0;
+        };
+
+        std::unique_lock lock(mutex);
+        while(true)
+        {
+            const bool woken = writer_signal.wait_for(lock, config.flush_interval, [&] {
+                return ready() || (stopping && write_queue.empty());
+            });
+            if(!ready())
+            {
+                if(stopping && write_queue.empty())
+                    break;
+                // Idle for a whole interval: write the partly filled chunk so a slow stream still reaches disk.
+                if(!woken)
+                    sealCurrent();
+                continue;
+            }
+
+            chunk* next = write_queue.front();
+            const bool failed = statistics.write_errors > 0;
+
+            lock.unlock();
+            if(codec != nullptr && !failed)
+                compressChunk(*next);
+            // Chunks are written one at a time in seal order, so offsets are handed out after packing.
+            next->file_offset = next_offset;
+            next_offset += recording::alignUp(next->used, recording::page_size);
+            const bool written = !failed && writeChunk(*next);
+            const int error = errno;
+            lock.lock();
+
+            write_queue.erase(write_queue.begin());
+            if(written)
+            {
+                statistics.frames_written += next->entries.size();
+                statistics.bytes_written += recording::alignUp(next->used, recording::page_size);
+                data_end = next->file_offset + next->used;
+            }
+            else
+            {
+                if(!failed)
+                {
+                    ConsoleLogger::getInstance()->error("Recording write failed, recording stopped: {}",
+                                                        std::strerror(error));
+                    ++statistics.write_errors;
+                }
+                statistics.dropped += next->entries.size();
+                recording = false;
+            }
+            --in_flight;
+            free_chunks.push_back(next);
+            written_signal.notify_all();
+        }
+    }
+
+    recorder_statistics frame_recorder::getStatistics() const
+    {
+        std::lock_guard lock(mutex);
+        return statistics;
+    }
+
+    bool frame_recorder::isRecording() const
+    {
+        std::lock_guard lock(mutex);
+        return recording;
+    }
+}
@@ -0,0 +1,178 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include "recorder/recording_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "device/depth_codec.h"
+
+namespace vision
+{
+    namespace
+    {
+        depth_codec& threadCodec()
+        {
+            thread_local depth_codec codec;
+            return codec;
+        }
+
+        /**
+         * @brief Maps a whole file privately.
+         *
+         * @return unsigned char* The mapping, or nullptr on failure.
+         */
+        unsigned char* mapFile(const std::string& path, std::size_t& size)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if(fd < 0)
+                return nullptr;
+
+            struct stat info{};
+            void* mapping = MAP_FAILED;
+            if(fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                size = static_cast<std::size_t>(info.st_size);
+                mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            }
+            ::close(fd);
+            return mapping != MAP_FAILED ? static_cast<unsigned char*>(mapping) : nullptr;
+        }
+    }
+
+    recording_reader::~recording_reader()
+    {
+        close();
+    }
+
+    Result recording_reader::open(const std::string& path)
+    {
+        close();
+
+        data = mapFile(recording::dataPath(path), data_size);
+        index = mapFile(recording::indexPath(path), index_size);
+        if(data == nullptr || index == nullptr)
+        {
+            const std::string reason = std::strerror(errno);
+            close();
+            return {Status::NotFound, std::format("Recording {} could not be opened: {}", path, reason)};
+        }
+
+        recording::data_header _data_header;
+        recording::index_header _index_header;
+        if(data_size < sizeof(_data_header) || index_size < sizeof(_index_header))
+        {
+            close();
+            return {Status::InvalidParam, std::format("Recording {} is truncated!", path)};
+        }
+        std::memcpy(&_data_header, data, sizeof(_data_header));
+        std::memcpy(&_index_header, index, sizeof(_index_header));
+        if(_data_header.magic != recording::data_magic || _index_header.magic != recording::index_magic
+           || _data_header.version < recording::min_version || _data_header.version > recording::version
+           || _index_header.version < recording::min_version || _index_header.version > recording::version
+           || _index_header.entry_size != sizeof(recording::index_entry))
+        {
+            close();
+            return {Status::InvalidParam, std::format("Recording {} has an unsupported format!", path)};
+        }
+
+        entries = reinterpret_cast<const recording::index_entry*>(index + sizeof(_index_header));
+        count = (index_size - sizeof(_index_header)) / sizeof(recording::index_entry);
+        // Entries are written after their payloads, but a truncated data file must still not be read past.
+        while(count > 0 && entries[count - 1].offset + entries[count - 1].size > data_size)
+            --count;
+
+        return {Status::Success, "Recording opened."};
+    }
+
+    void recording_reader::close()
+    {
+        if(data != nullptr)
+            munmap(data, data_size);
+        if(index != nullptr)
+            munmap(index, index_size);
+        data = index = nullptr;
+        entries = nullptr;
+        data_size = index_size = count = 0;
+    }
+
+    std::size_t recording_reader::seek(const std::int64_t record_ns) const
+    {
+        const auto* it = std::lower_bound(entries, entries + count, record_ns,
+                                          [](const recording::index_entry& entry, const std::int64_t time) {
+                                              return entry.record_ns < time;
+                                          });
+        return static_cast<std::size_t>(it - entries);
+    }
+
+    std::optional<std::size_t> recording_reader::next(const std::size_t from, const int device_id,
+                                                      const libfreenect2::Frame::Type type) const
+    {
+        for(std::size_t i = from; i < count; ++i)
+        {
+            if(entries[i].device_id == device_id && entries[i].type == static_cast<std::uint32_t>(type))
+                return i;
+        }
+        return std::nullopt;
+    }
+
+    void recording_reader::view(const std::size_t i, libfreenect2::Frame& frame) const
+    {
+        const recording::index_entry& _entry = entries[i];
+        frame.width = _entry.width;
+        frame.height = _entry.height;
+        frame.bytes_per_pixel = _entry.bytes_per_pixel;
+        frame.data = payload(i);
+        frame.timestamp = _entry.timestamp;
+        frame.sequence = _entry.sequence;
+        frame.exposure = _entry.exposure;
+        frame.gain = _entry.gain;
+        frame.gamma = _entry.gamma;
+        frame.status = _entry.status;
+        frame.format = static_cast<libfreenect2::Frame::Format>(_entry.format);
+    }
+
+    bool recording_reader::isCompressed(const std::size_t i) const
+    {
+        return entries[i].format == recording::compressed_depth_format;
+    }
+
+    Result recording_reader::read(const std::size_t i, libfreenect2::Frame& frame, const std::size_t capacity) const
+    {
+        const recording::index_entry& _entry = entries[i];
+        const std::size_t size = static_cast<std::size_t>(_entry.width) * _entry.height * _entry.bytes_per_pixel;
+        if(frame.data == nullptr || size > capacity)
+            return {Status::InvalidParam, "Target buffer is too small for the recorded frame!"};
+
+        if(isCompressed(i))
+        {
+            std::size_t width = 0, height = 0;
+            if(Result result = depth_codec::readHeader(payload(i), _entry.size, width, height);
+               result.status != Status::Success)
+                return result;
+            if(width != _entry.width || height != _entry.height || _entry.bytes_per_pixel != sizeof(float))
+                return {Status::InvalidParam, std::format("Frame {} does not match its index entry!", i)};
+            if(Result result = threadCodec().decode(payload(i), _entry.size, reinterpret_cast<float*>(frame.data),
+                                                    width * height); result.status != Status::Success)
+                return result;
+        }
+        else
+        {
+            std::memcpy(frame.data, payload(i), std::min<std::size_t>(size, _entry.size));
+        }
+
+        unsigned char* data = frame.data;
+        view(i, frame);
+        frame.data = data;
+        if(isCompressed(i))
+            frame.format = libfreenect2::Frame::Float;
+        return Result(Status::Success);
+    }
+}
@@ -0,0 +1,56 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#ifndef CAMERA_PARAMS_H
+#define CAMERA_PARAMS_H
+
+#include "libfreenect2/libfreenect2.hpp"
+
+namespace vision::test
+{
+    /**
+     * @brief Gets depth camera parameters close to those of a real Kinect2.
+     *
+     * @return libfreenect2::Freenect2Device::IrCameraParams Intrinsics and radial distortion.
+     */
+    inline libfreenect2::Freenect2Device::IrCameraParams makeIrParams()
+    {
+        libfreenect2::Freenect2Device::IrCameraParams params{};
+        params.fx = 365.456f;
+        params.fy = 365.456f;
+        params.cx = 254.878f;
+        params.cy = 205.395f;
+        params.k1 = 0.0905474f;
+        params.k2 = -0.26819f;
+        params.k3 = 0.0950862f;
+        return params;
+    }
+
+    /**
+     * @brief Gets color camera parameters close to those of a real Kinect2.
+     *
+     * @return libfreenect2::Freenect2Device::ColorCameraParams Intrinsics and the depth-to-color mapping.
+     */
+    inline libfreenect2::Freenect2Device::ColorCameraParams makeColorParams()
+    {
+        libfreenect2::Freenect2Device::ColorCameraParams params{};
+        params.fx = 1081.37f;
+        params.fy = 1081.37f;
+        params.cx = 959.5f;
+        params.cy = 539.5f;
+        params.shift_d = 863.0f;
+        params.shift_m = 52.0f;
+        params.mx_x1y0 = 0.6514f;
+        params.mx_x0y0 = 0.1345f;
+        params.mx_x2y0 = 0.0012f;
+        params.mx_x1y2 = 0.0007f;
+        params.my_x0y1 = 0.6502f;
+        params.my_x0y0 = 0.0081f;
+        params.my_x1y1 = 0.0009f;
+        params.my_x0y3 = 0.0004f;
+        return params;
+    }
+}
+
+#endif //CAMERA_PARAMS_H
@@ -0,0 +1,143 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "device/depth_codec.h"
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::size_t width = 512;
+        constexpr std::size_t height = 424;
+
+        /**
+         * @brief Noisy slanted wall with a box, holes, NaNs, negative and far depths.
+         */
+        std::vector<float> makeFrame(const unsigned seed)
+        {
+            std::vector<float> depth(width * height);
+            std::mt19937 rng(seed);
+            std::normal_distribution<float> noise(0.0f, 6.0f);
+            std::uniform_int_distribution<int> kind(0, 999);
+            for(std::size_t r = 0; r < height; ++r)
+                for(std::size_t c = 0; c < width; ++c)
+                {
+                    const int k = kind(rng);
+                    const bool box = c > 180 && c < 330 && r > 140 && r < 300;
+                    const float base = box ? 1400.25f : 2200.0f + static_cast<float>(c) * 2.3f;
+                    depth[r * width + c] = k < 40 ? 0.0f
+                                         : k < 45 ? std::numeric_limits<float>::quiet_NaN()
+                                         : k < 48 ? -20.0f
+                                         : k < 50 ? 70000.0f
+                                         : base + noise(rng);
+                }
+            // A hole run longer than a SIMD block.
+            std::fill_n(depth.begin() + 10 * width + 3, 200, 0.0f);
+            return depth;
+        }
+
+        float quantized(const float d)
+        {
+            return d > 0.0f ? std::nearbyint(std::min(d, 65535.0f)) : 0.0f;
+        }
+    }
+
+    /**
+     * @brief Tests that a frame decodes to its quantized depths, whatever the kernel, bands or threads.
+     */
+    TEST(depth_codec, roundTrip) {
+        const std::vector<float> depth = makeFrame(3);
+        depth_codec reference({1, {}, 1}, depth_codec::kernel::Scalar);
+        std::vector<unsigned char> expected;
+        ASSERT_EQ(reference.encode(depth.data(), width, height, expected).status, Status::Success);
+        EXPECT_LT(expected.size(), width * height * 2);
+
+        std::vector<float> decoded(width * height, -1.0f);
+        ASSERT_EQ(reference.decode(expected.data(), expected.size(), decoded.data(), decoded.size()).status,
+                  Status::Success);
+        for(std::size_t i = 0; i < depth.size(); ++i)
+            ASSERT_EQ(decoded[i], quantized(depth[i])) << "pixel " << i;
+
+        std::size_t decoded_width = 0, decoded_height = 0;
+        ASSERT_EQ(depth_codec::readHeader(expected.data(), expected.size(), decoded_width, decoded_height).status,
+                  Status::Success);
+        EXPECT_EQ(decoded_width, width);
+        EXPECT_EQ(decoded_height, height);
+
+        for(const auto kernel : {depth_codec::kernel::Scalar, depth_codec::kernel::Auto})
+        {
+            // Bands change the stream, threads and kernels must not.
+            depth_codec single({1, {}, 8}, kernel);
+            depth_codec parallel({4, {}, 8}, kernel);
+            std::vector<unsigned char> a, b;
+            ASSERT_EQ(single.encode(depth.data(), width, height, a).status, Status::Success);
+            ASSERT_EQ(parallel.encode(depth.data(), width, height, b).status, Status::Success);
+            EXPECT_EQ(a, b);
+
+            std::fill(decoded.begin(), decoded.end(), -1.0f);
+            ASSERT_EQ(parallel.decode(a.data(), a.size(), decoded.data(), decoded.size()).status, Status::Success);
+            for(std::size_t i = 0; i < depth.size(); ++i)
+                ASSERT_EQ(decoded[i], quantized(depth[i])) << "pixel " << i;
+        }
+    }
+
+    /**
+     * @brief Tests frames smaller than a SIMD block and with more bands than rows.
+     */
+    TEST(depth_codec, smallFrames) {
+        depth_codec codec({2, {}, 8});
+        const std::vector<float> depth = {0.0f, 1.0f, 65535.0f, 1.0f, 0.0f, 0.0f, 300.4f};
+        std::vector<unsigned char> encoded;
+        std::vector<float> decoded(depth.size());
+        for(const std::size_t rows : {1u, 7u})
+        {
+            ASSERT_EQ(codec.encode(depth.data(), depth.size() / rows, rows, encoded).status, Status::Success);
+            ASSERT_EQ(codec.decode(encoded.data(), encoded.size(), decoded.data(), decoded.size()).status,
+                      Status::Success);
+            for(std::size_t i = 0; i < depth.size(); ++i)
+                EXPECT_EQ(decoded[i], quantized(depth[i]));
+        }
+        EXPECT_EQ(codec.encode(depth.data(), 0, 1, encoded).status, Status::InvalidParam);
+    }
+
+    /**
+     * @brief Tests that truncated, corrupt and oversized input is refused instead of decoded.
+     */
+    TEST(depth_codec, rejectsMalformed) {
+        const std::vector<float> depth = makeFrame(5);
+        depth_codec codec;
+        std::vector<unsigned char> encoded;
+        ASSERT_EQ(codec.encode(depth.data(), width, height, encoded).status, Status::Success);
+        std::vector<float> decoded(width * height);
+
+        EXPECT_EQ(codec.decode(encoded.data(), encoded.size(), decoded.data(), decoded.size() - 1).status,
+                  Status::InvalidParam);
+        for(const std::size_t size : {std::size_t{0}, std::size_t{10}, std::size_t{40}, encoded.size() - 4})
+            EXPECT_EQ(codec.decode(encoded.data(), size, decoded.data(), decoded.size()).status, Status::InvalidParam);
+
+        std::vector<unsigned char> corrupt = encoded;
+        corrupt[0] ^= 0xff;
+        EXPECT_EQ(codec.decode(corrupt.data(), corrupt.size(), decoded.data(), decoded.size()).status,
+                  Status::InvalidParam);
+
+        // Flipping payload bits must never write out of bounds, and usually fails.
+        std::mt19937 rng(9);
+        for(int trial = 0; trial < 50; ++trial)
+        {
+            corrupt = encoded;
+            std::uniform_int_distribution<std::size_t> position(sizeof(depth_codec_header), corrupt.size() - 1);
+            corrupt[position(rng)] ^= static_cast<unsigned char>(1u << trial % 8);
+            codec.decode(corrupt.data(), corrupt.size(), decoded.data(), decoded.size());
+        }
+
+        std::size_t size = 0;
+        EXPECT_EQ(codec.encode(depth.data(), width, height, encoded.data(), 100, size).status, Status::InvalidParam);
+        EXPECT_EQ(size, 0u);
+    }
+}
@@ -0,0 +1,196 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+#include "device/depth_decoder.h"
+#include "device/frame_listener.h"
+#include "device/frame_pool.h"
+
+namespace vision
+{
+    namespace
+    {
+        constexpr std::size_t width = depth_decoder::width;
+        constexpr std::size_t height = depth_decoder::height;
+        constexpr double pi = 3.14159265358979323846;
+        constexpr double phase_in_rad[3] = {0.0, 2.094395, 4.18879};
+        constexpr double frequency_cycles[3] = {10.0, 2.0, 15.0}; ///< Phase wraps of each frequency over the range.
+
+        /**
+         * @brief Synthetic calibration: zero P0 offsets, no depth fit correction, z factor 1000 + output row.
+         */
+        struct synthetic_tables
+        {
+            std::vector<unsigned char> p0 = std::vector<unsigned char>(depth_decoder::p0_tables_size, 0);
+            std::vector<float> x = std::vector<float>(width * height, 0.0f);
+            std::vector<float> z = std::vector<float>(width * height);
+            std::vector<short> lookup = std::vector<short>(depth_decoder::lookup_table_size);
+
+            synthetic_tables()
+            {
+                for (std::size_t row = 0; row < height; ++row)
+                    std::fill_n(&z[row * width], width, 1000.0f + static_cast<float>(row));
+                for (std::size_t i = 0; i < lookup.size(); ++i)
+                    lookup[i] = static_cast<short>(static_cast<int>(i) - 1024);
+            }
+
+            Result load(depth_decoder& decoder) const
+            {
+                return decoder.loadTables(p0.data(), p0.size(), x.data(), z.data(), x.size(),
+                                          lookup.data(), lookup.size());
+            }
+        };
+
+        /**
+         * @brief Packs measurements into a raw depth packet.
+         *
+         * @param value Measurement in [-1024, 1023] of an output pixel (column, row) in a sub-image.
+         */
+        std::vector<unsigned char> makePacket(const std::function<int(std::size_t, std::size_t, std::size_t)>& value)
+        {
+            std::vector<unsigned char> packet(10 * depth_decoder::sub_image_size, 0);
+            for (std::size_t image = 0; image < 9; ++image) {
+                for (std::size_t row = 0; row < height; ++row) {
+                    const std::size_t y = height - 1 - row;
+                    const std::size_t packed_row = y < height / 2 ? y + height / 2 : height - 1 - y;
+                    unsigned char* bits = packet.data() + image * depth_decoder::sub_image_size + packed_row * 704;
+                    for (std::size_t x = 1; x < width - 1; ++x) {
+                        const std::size_t offset = ((x >> 2) + ((x & 3) << 7)) * 11;
+                        const auto code = static_cast<unsigned int>(value(x, row, image) + 1024);
+                        for (std::size_t bit = 0; bit < 11; ++bit)
+                            if (code >> bit & 1)
+                                bits[(offset + bit) / 8] |= static_cast<unsigned char>(1u << (offset + bit) % 8);
+                    }
+                }
+            }
+            return packet;
+        }
+
+        /**
+         * @brief Measurements of a surface at a fraction u of the unambiguous range, with amplitude 100 + output row.
+         */
+        std::vector<unsigned char> makeSurfacePacket(const double u)
+        {
+            return makePacket([u](std::size_t, const std::size_t row, const std::size_t image) {
+                const std::size_t frequency = image / 3;
+                const double cycles = u * frequency_cycles[frequency];
+                const double phase = 2.0 * pi * (cycles - std::floor(cycles));
+                const double amplitude = 100.0 + static_cast<double>(row);
+                return static_cast<int>(std::lround(amplitude * std::cos(phase + phase_in_rad[image % 3])));
+            });
+        }
+    }
+
+    /**
+     * @brief Tests that a flat surface decodes to the expected depth and IR, in output row order.
+     */
+    TEST(depth_decoder, decodesSurface) {
+        depth_decoder decoder({2});
+        ASSERT_EQ(synthetic_tables().load(decoder).status, Status::Success);
+
+        constexpr double u = 0.3;
+        const std::vector<unsigned char> packet = makeSurfacePacket(u);
+        std::vector<float> ir(width * height), depth(width * height);
+        ASSERT_EQ(decoder.decode(packet.data(), packet.size(), ir.data(), depth.data()).status, Status::Success);
+
+        for (std::size_t row = 2; row < height - 2; ++row) {
+            for (std::size_t x = 2; x < width - 2; ++x) {
+                const double expected_depth = (1000.0 + static_cast<double>(row)) * 9.0 * u;
+                const double expected_ir = (100.0 + static_cast<double>(row)) * 3.935484 / 3.0 * 16.0;
+                ASSERT_NEAR(depth[row * width + x], expected_depth, expected_depth * 0.01) << x << "," << row;
+                ASSERT_NEAR(ir[row * width + x], expected_ir, expected_ir * 0.01) << x << "," << row;
+            }
+        }
+    }
+
+    /**
+     * @brief Tests that the images do not depend on the number of decoding threads.
+     */
+    TEST(depth_decoder, threadCountDoesNotChangeOutput) {
+        std::mt19937 random(7);
+        std::uniform_int_distribution<int> noise(-40, 40);
+        const std::vector<unsigned char> surface = makeSurfacePacket(0.45);
+        std::vector<unsigned char> packet = makePacket([&](const std::size_t x, const std::size_t row, std::size_t) {
+            // A noisy patch and a hard edge give the filters something to do.
+            if (x > 200 && x < 300 && row > 100 && row < 200)
+                return noise(random) * 20;
+            return x < 350 ? noise(random) : 400 + noise(random);
+        });
+        for (std::size_t i = 0; i < packet.size() / 2; ++i)
+            packet[i] ^= surface[i] & 0x0f;
+
+        const synthetic_tables tables;
+        std::vector<float> ir[2], depth[2];
+        for (const std::size_t threads : {1u, 3u}) {
+            depth_decoder decoder({threads});
+            ASSERT_EQ(decoder.getThreadCount(), threads);
+            ASSERT_EQ(tables.load(decoder).status, Status::Success);
+            std::vector<float>& _ir = ir[threads == 1 ? 0 : 1];
+            std::vector<float>& _depth = depth[threads == 1 ? 0 : 1];
+            _ir.resize(width * height);
+            _depth.resize(width * height);
+            ASSERT_EQ(decoder.decode(packet.data(), packet.size(), _ir.data(), _depth.data()).status, Status::Success);
+        }
+        EXPECT_EQ(std::memcmp(ir[0].data(), ir[1].data(), ir[0].size() * sizeof(float)), 0);
+        EXPECT_EQ(std::memcmp(depth[0].data(), depth[1].data(), depth[0].size() * sizeof(float)), 0);
+    }
+
+    /**
+     * @brief Tests that packets are refused without tables and that short tables and packets are rejected.
+     */
+    TEST(depth_decoder, rejectsMissingTablesAndShortInput) {
+        depth_decoder decoder({1});
+        const std::vector<unsigned char> packet(depth_decoder::packet_size, 0);
+        std::vector<float> depth(width * height);
+        EXPECT_FALSE(decoder.hasTables());
+        EXPECT_NE(decoder.decode(packet.data(), packet.size(), nullptr, depth.data()).status, Status::Success);
+
+        const synthetic_tables tables;
+        EXPECT_EQ(decoder.loadTables(tables.p0.data(), tables.p0.size() - 1, tables.x.data(), tables.z.data(),
+                                     tables.x.size(), tables.lookup.data(), tables.lookup.size()).status,
+                  Status::InvalidParam);
+        EXPECT_FALSE(decoder.hasTables());
+        ASSERT_EQ(tables.load(decoder).status, Status::Success);
+        EXPECT_EQ(decoder.decode(packet.data(), packet.size() - 1, nullptr, depth.data()).status, Status::InvalidParam);
+        EXPECT_EQ(decoder.decode(packet.data(), packet.size(), nullptr, depth.data()).status, Status::Success);
+    }
+
+    /**
+     * @brief Tests that a listener with a decoder turns a raw depth packet into pooled IR and depth frames.
+     */
+    TEST(depth_decoder, listenerDecodesRawPackets) {
+        depth_decoder decoder({2});
+        ASSERT_EQ(synthetic_tables().load(decoder).status, Status::Success);
+        frame_listener listener(frame_pool::create({1, 2, 2}));
+        listener.setDepthDecoder(&decoder);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Ir, true);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Depth, true);
+
+        std::vector<unsigned char> packet = makeSurfacePacket(0.3);
+        libfreenect2::Frame raw(1, 1, packet.size(), packet.data());
+        raw.format = libfreenect2::Frame::Raw;
+        raw.sequence = 42;
+        EXPECT_FALSE(listener.onNewFrame(libfreenect2::Frame::Depth, &raw));
+        EXPECT_FALSE(listener.onNewFrame(libfreenect2::Frame::Ir, &raw));
+
+        const frame_handle ir = listener.popFrame(libfreenect2::Frame::Ir);
+        const frame_handle depth = listener.popFrame(libfreenect2::Frame::Depth);
+        ASSERT_TRUE(ir);
+        ASSERT_TRUE(depth);
+        EXPECT_FALSE(listener.popFrame(libfreenect2::Frame::Ir));
+        EXPECT_EQ(depth->width, width);
+        EXPECT_EQ(depth->height, height);
+        EXPECT_EQ(depth->format, libfreenect2::Frame::Float);
+        EXPECT_EQ(ir->sequence, 42u);
+
+        const float* depth_data = reinterpret_cast<const float*>(depth->data);
+        EXPECT_NEAR(depth_data[100 * width + 256], 1100.0f * 9.0f * 0.3f, 30.0f);
+        EXPECT_EQ(listener.getStatistics().received, 2u);
+    }
+}
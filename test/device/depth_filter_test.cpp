@@ -0,0 +1,162 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+#include "device/depth_filter.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Noisy depth frame with holes, NaNs and out-of-range depths.
+         */
+        std::vector<float> makeDepth(const std::size_t width, const std::size_t height, const unsigned int seed)
+        {
+            std::vector<float> depth(width * height);
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<float> noise(-40.0f, 40.0f);
+            std::uniform_int_distribution<int> kind(0, 99);
+            for(std::size_t i = 0; i < depth.size(); ++i)
+            {
+                const int k = kind(rng);
+                const float base = (i % width) < width / 2 ? 1200.0f : 2400.0f;
+                depth[i] = k < 5 ? 0.0f
+                         : k < 6 ? std::numeric_limits<float>::quiet_NaN()
+                         : k < 8 ? 6000.0f
+                         : base + noise(rng);
+            }
+            return depth;
+        }
+
+        using filter_factory = std::function<std::unique_ptr<depth_filter>(depth_filter::kernel)>;
+    }
+
+    /**
+     * @brief Tests that every filter gives bit-identical frames with the scalar and AVX2 kernels.
+     */
+    TEST(depth_filter, kernelsAgree) {
+        const std::vector<filter_factory> factories = {
+                [](const depth_filter::kernel k) { return std::make_unique<range_filter>(500.0f, 4500.0f, k); },
+                [](const depth_filter::kernel k) { return std::make_unique<flying_pixel_filter>(0.04f, 2, k); },
+                [](const depth_filter::kernel k) { return std::make_unique<median_filter>(k); },
+                [](const depth_filter::kernel k) { return std::make_unique<temporal_filter>(0.4f, 30.0f, k); }};
+
+        for(const auto& factory : factories)
+            for(const auto& [width, height] : {std::pair<std::size_t, std::size_t>{512, 424}, {37, 5}})
+            {
+                const auto scalar = factory(depth_filter::kernel::Scalar);
+                const auto best = factory(depth_filter::kernel::Auto);
+                for(unsigned int frame = 0; frame < 3; ++frame)
+                {
+                    std::vector<float> expected = makeDepth(width, height, frame);
+                    std::vector<float> actual = expected;
+                    scalar->apply(expected.data(), width, height);
+                    best->apply(actual.data(), width, height);
+                    ASSERT_EQ(std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)), 0)
+                        << scalar->getName() << " " << width << "x" << height << ", frame " << frame;
+                }
+            }
+    }
+
+    /**
+     * @brief Tests range clipping and flying pixel removal on a step edge.
+     */
+    TEST(depth_filter, removesFlyingPixels) {
+        constexpr std::size_t width = 16, height = 5;
+        std::vector<float> depth(width * height, 1000.0f);
+        for(std::size_t r = 0; r < height; ++r)
+        {
+            for(std::size_t c = 9; c < width; ++c)
+                depth[r * width + c] = 2000.0f;
+            depth[r * width + 8] = 1500.0f; // Hanging between the two surfaces.
+        }
+        depth[2 * width + 3] = 200.0f;
+
+        range_filter range(500.0f, 4500.0f);
+        range.apply(depth.data(), width, height);
+        EXPECT_EQ(depth[2 * width + 3], 0.0f);
+
+        flying_pixel_filter flying(0.04f, 2);
+        flying.apply(depth.data(), width, height);
+        EXPECT_EQ(depth[2 * width + 8], 0.0f) << "flying pixel";
+        EXPECT_EQ(depth[2 * width + 7], 1000.0f) << "foreground edge";
+        EXPECT_EQ(depth[2 * width + 9], 2000.0f) << "background edge";
+        EXPECT_EQ(depth[0 * width + 8], 1500.0f) << "border pixels are kept";
+    }
+
+    /**
+     * @brief Tests that the median removes speckles without growing holes.
+     */
+    TEST(depth_filter, medianKeepsHoles) {
+        constexpr std::size_t width = 12, height = 6;
+        std::vector<float> depth(width * height, 1500.0f);
+        depth[2 * width + 4] = 3000.0f;
+        depth[3 * width + 8] = 0.0f;
+
+        median_filter median;
+        median.apply(depth.data(), width, height);
+        EXPECT_EQ(depth[2 * width + 4], 1500.0f) << "speckle";
+        EXPECT_EQ(depth[3 * width + 8], 0.0f) << "hole";
+        EXPECT_EQ(depth[3 * width + 7], 1500.0f) << "hole neighbor";
+    }
+
+    /**
+     * @brief Tests smoothing, motion restarts and hole preservation of the temporal filter.
+     */
+    TEST(depth_filter, temporalPreservesHoles) {
+        temporal_filter temporal(0.5f, 30.0f);
+        float pixel[8] = {1000.0f, 1000.0f, 1000.0f, 1000.0f, 1000.0f, 1000.0f, 1000.0f, 1000.0f};
+        temporal.apply(pixel, 8, 1);
+        EXPECT_EQ(pixel[0], 1000.0f) << "no history yet";
+
+        float next[8] = {1020.0f, 1500.0f, 0.0f, 1010.0f, 1000.0f, 1000.0f, 1000.0f, 1000.0f};
+        temporal.apply(next, 8, 1);
+        EXPECT_EQ(next[0], 1010.0f) << "blended";
+        EXPECT_EQ(next[1], 1500.0f) << "motion restarts the history";
+        EXPECT_EQ(next[2], 0.0f) << "hole kept";
+        EXPECT_EQ(next[3], 1005.0f);
+
+        float after[8] = {1010.0f, 1500.0f, 1200.0f, 1005.0f, 1000.0f, 1000.0f, 1000.0f, 1000.0f};
+        temporal.apply(after, 8, 1);
+        EXPECT_EQ(after[2], 1200.0f) << "a filled hole starts from the new depth";
+
+        temporal.reset();
+        float fresh[8] = {1020.0f, 1020.0f, 1020.0f, 1020.0f, 1020.0f, 1020.0f, 1020.0f, 1020.0f};
+        temporal.apply(fresh, 8, 1);
+        EXPECT_EQ(fresh[0], 1020.0f);
+    }
+
+    /**
+     * @brief Tests that a chain applies the configured filters in order on a frame.
+     */
+    TEST(depth_filter, chainsFilters) {
+        depth_filter_config config;
+        config.range = true;
+        config.median = true;
+        config.temporal = true;
+        depth_filter_chain chain(config);
+        ASSERT_EQ(chain.getFilters().size(), 3u);
+        EXPECT_STREQ(chain.getFilters()[0]->getName(), "range");
+        EXPECT_STREQ(chain.getFilters()[1]->getName(), "median");
+        EXPECT_STREQ(chain.getFilters()[2]->getName(), "temporal");
+        EXPECT_TRUE(depth_filter_chain().empty());
+
+        std::vector<float> depth = makeDepth(512, 424, 9);
+        libfreenect2::Frame frame(512, 424, 4, reinterpret_cast<unsigned char*>(depth.data()));
+        ASSERT_EQ(chain.apply(frame).status, Status::Success);
+        for(const float d : depth)
+            ASSERT_TRUE(d == 0.0f || (d >= 500.0f && d <= 4500.0f)) << d;
+
+        std::vector<unsigned char> gray(512 * 424);
+        libfreenect2::Frame gray_frame(512, 424, 1, gray.data());
+        EXPECT_EQ(chain.apply(gray_frame).status, Status::InvalidParam);
+    }
+}
@@ -22,40 +22,42 @@ namespace vision
     }
 
     /**
-     * @brief Tests the singleton instance of DeviceManager.
+     * @brief Tests the singleton instance of device_manager.
      *
      * This test checks that multiple calls to getInstance return the same instance
      * and that it is not null.
      */
-    TEST(DeviceManager, getInstance) {
-        DeviceManager* device_manager1 = DeviceManager::getInstance();
-        DeviceManager* device_manager2 = DeviceManager::getInstance();
+    TEST(device_manager, getInstance) {
+        device_manager* device_manager1 = device_manager::getInstance();
+        device_manager* device_manager2 = device_manager::getInstance();
         EXPECT_NE(device_manager1, nullptr);
         EXPECT_NE(device_manager2, nullptr);
         EXPECT_EQ(device_manager1, device_manager2);
     }
 
     /**
-     * @brief Tests the available device count against the Freenect device count.
+     * @brief Tests that the available device count follows registered devices.
      *
-     * This test compares the number of devices reported by the DeviceManager
-     * with the number reported by the libfreenect2 library.
+     * This test adds and removes a virtual device, so it needs no Kinect2 and
+     * holds whatever the bus has.
      */
-    TEST(DeviceManager, availableDeviceCount) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
-        int freenect_enumerate = std::make_unique<libfreenect2::Freenect2>()->enumerateDevices();
-        int dm_enumerate = device_manager->availableDeviceCount();
-        EXPECT_EQ(dm_enumerate, freenect_enumerate);
+    TEST(device_manager, availableDeviceCount) {
+        device_manager* device_manager = device_manager::getInstance();
+        const int base_count = device_manager->availableDeviceCount();
+        const int device_id = device_manager->addVirtualDevice({});
+        EXPECT_EQ(device_manager->availableDeviceCount(), base_count + 1);
+        EXPECT_TRUE(device_manager->removeVirtualDevice(device_id));
+        EXPECT_EQ(device_manager->availableDeviceCount(), base_count);
     }
 
     /**
      * @brief Tests the retrieval of the device list.
      *
-     * This test verifies that the device count from the DeviceManager matches
+     * This test verifies that the device count from the device_manager matches
      * the size of the retrieved device list.
      */
-    TEST(DeviceManager, getDeviceList) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, getDeviceList) {
+        device_manager* device_manager = device_manager::getInstance();
         int enum_device = device_manager->availableDeviceCount();
         unsigned int device_count = device_manager->getDeviceList().size();
         EXPECT_EQ(enum_device, device_count);
@@ -66,8 +68,8 @@ namespace vision
      *
      * This test checks that logging the devices does not result in an error status.
      */
-    TEST(DeviceManager, logDeviceList) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, logDeviceList) {
+        device_manager* device_manager = device_manager::getInstance();
         auto result = device_manager->logDevicesList();
         EXPECT_NE(result.status, Status::Error);
     }
@@ -75,28 +77,33 @@ namespace vision
     /**
      * @brief Tests whether the device list is empty.
      *
-     * This test verifies that the device list's emptiness matches the
-     * enumeration result from the Freenect library.
+     * This test verifies that the list is not empty while a virtual device is registered.
      */
-    TEST(DeviceManager, deviceListIsEmpty) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
-        bool freenect_result = std::make_unique<libfreenect2::Freenect2>()->enumerateDevices();
-        bool result = !device_manager->deviceListIsEmpty();
-        EXPECT_EQ(freenect_result, result);
+    TEST(device_manager, deviceListIsEmpty) {
+        device_manager* device_manager = device_manager::getInstance();
+        const int device_id = device_manager->addVirtualDevice({});
+        EXPECT_FALSE(device_manager->deviceListIsEmpty());
+        EXPECT_TRUE(device_manager->removeVirtualDevice(device_id));
     }
 
     /**
      * @brief Tests refreshing the device list.
      *
-     * This test checks that the device count in DeviceManager is updated
-     * after calling refreshDeviceList.
+     * This test checks that a refresh keeps registered virtual devices listed
+     * and that the count matches the refreshed list.
      */
-    TEST(DeviceManager, refreshDeviceList) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
-        int freenect_enumerate = std::make_unique<libfreenect2::Freenect2>()->enumerateDevices();
-        device_manager->refreshDeviceList();
-        int dm_enum = device_manager->availableDeviceCount();
-        EXPECT_EQ(freenect_enumerate, dm_enum);
+    TEST(device_manager, refreshDeviceList) {
+        device_manager* device_manager = device_manager::getInstance();
+        virtual_device_config config;
+        config.serial = "REFRESH";
+        const int device_id = device_manager->addVirtualDevice(config);
+        EXPECT_EQ(device_manager->refreshDeviceList().status, Status::Success);
+
+        const std::optional<device> refreshed = device_manager->getDevice(device_id);
+        ASSERT_TRUE(refreshed.has_value());
+        EXPECT_EQ(refreshed->getSerial(), "REFRESH");
+        EXPECT_EQ(device_manager->availableDeviceCount(), static_cast<int>(device_manager->getDeviceList().size()));
+        EXPECT_TRUE(device_manager->removeVirtualDevice(device_id));
     }
 
     /**
@@ -104,8 +111,8 @@ namespace vision
      *
      * This test verifies that the selected device list is empty after clearing it.
      */
-    TEST(DeviceManager, getSelectedDeviceList) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, getSelectedDeviceList) {
+        device_manager* device_manager = device_manager::getInstance();
         device_manager->clearSelectedList();
         EXPECT_TRUE(device_manager->getSelectedDeviceList().empty());
     }
@@ -115,8 +122,8 @@ namespace vision
      *
      * This test verifies that a device can be selected if devices are available.
      */
-    TEST(DeviceManager, selectDevice) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, selectDevice) {
+        device_manager* device_manager = device_manager::getInstance();
         if (!device_manager->availableDeviceCount()) {
             GTEST_LOG_(INFO) << "Device not found!" << std::endl;
             GTEST_SKIP();
@@ -130,8 +137,8 @@ namespace vision
      *
      * This test checks that the selected list is indeed empty after clearing it.
      */
-    TEST(DeviceManager, selectListIsEmpty) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, selectListIsEmpty) {
+        device_manager* device_manager = device_manager::getInstance();
         device_manager->clearSelectedList();
         EXPECT_TRUE(device_manager->selectedListIsEmpty());
     }
@@ -142,8 +149,8 @@ namespace vision
      * This test verifies that a device can be deselected correctly
      * after it has been selected.
      */
-    TEST(DeviceManager, deselectDevice) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, deselectDevice) {
+        device_manager* device_manager = device_manager::getInstance();
         if (!device_manager->availableDeviceCount()) {
             GTEST_LOG_(INFO) << "Device not found!" << std::endl;
             GTEST_SKIP();
@@ -159,15 +166,15 @@ namespace vision
      *
      * This test checks that the index of an existing device can be found in the device list.
      */
-    TEST(DeviceManager, findDeviceIndex) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, findDeviceIndex) {
+        device_manager* device_manager = device_manager::getInstance();
         if (!device_manager->availableDeviceCount()) {
             GTEST_LOG_(INFO) << "Device not found!" << std::endl;
             GTEST_SKIP();
         }
         auto device_list = device_manager->getDeviceList();
 
-        std::optional<int> index = vision::DeviceManager::findDeviceIndex(device_list, device_list.front().getIdx());
+        std::optional<int> index = vision::device_manager::findDeviceIndex(device_list, device_list.front().getIdx());
         EXPECT_TRUE(index.has_value());
     }
 
@@ -177,8 +184,8 @@ namespace vision
      * This test verifies that a device's status can be checked successfully
      * if it exists in the device list.
      */
-    TEST(DeviceManager, checkDevice) {
-        DeviceManager* device_manager = DeviceManager::getInstance();
+    TEST(device_manager, checkDevice) {
+        device_manager* device_manager = device_manager::getInstance();
         device_manager->enumerateDevices();
         if (!device_manager->availableDeviceCount()) {
             GTEST_LOG_(INFO) << "Device not found!" << std::endl;
@@ -0,0 +1,193 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include "device/device_registry.h"
+
+namespace vision
+{
+    namespace
+    {
+        using namespace std::chrono_literals;
+
+        /**
+         * @brief A bus whose devices the test plugs and unplugs.
+         */
+        struct fake_bus
+        {
+            std::mutex mutex;
+            std::vector<registry_entry> devices;
+            std::atomic<int> scans{0};
+
+            device_registry::scanner scanner()
+            {
+                return [this] {
+                    ++scans;
+                    std::lock_guard lock(mutex);
+                    return devices;
+                };
+            }
+
+            void set(std::vector<registry_entry> _devices)
+            {
+                std::lock_guard lock(mutex);
+                devices = std::move(_devices);
+            }
+        };
+
+        template<typename Predicate>
+        bool waitFor(Predicate predicate)
+        {
+            for(int i = 0; i < 400 && !predicate(); ++i)
+                std::this_thread::sleep_for(5ms);
+            return predicate();
+        }
+    }
+
+    /**
+     * @brief Tests lookups by index and serial, and the events of a refresh.
+     */
+    TEST(device_registry, lookupsAndEvents) {
+        fake_bus bus;
+        bus.set({{1, "B"}, {0, "A"}});
+        registry_config config;
+        config.watch_hotplug = false;
+        device_registry registry(bus.scanner(), config);
+        std::vector<device_event> events;
+        registry.subscribe([&](const device_event& event) { events.push_back(event); });
+
+        EXPECT_EQ(registry.size(), 0u);
+        EXPECT_EQ(registry.refresh().status, Status::Success);
+        ASSERT_EQ(registry.size(), 2u);
+        EXPECT_EQ(registry.entries()[0].serial, "A");
+        EXPECT_EQ(registry.find(1)->serial, "B");
+        EXPECT_EQ(registry.findSerial("A")->index, 0);
+        EXPECT_FALSE(registry.find(2));
+        std::string serial;
+        EXPECT_TRUE(registry.getSerial(0, serial));
+        EXPECT_EQ(serial, "A");
+        EXPECT_FALSE(registry.getSerial(5, serial));
+        ASSERT_EQ(events.size(), 2u);
+        EXPECT_EQ(events[0].type, device_event_type::Added);
+        const std::uint64_t version = registry.getVersion();
+        EXPECT_EQ(events[0].version, version);
+
+        // An unchanged bus keeps the table and raises nothing.
+        events.clear();
+        EXPECT_EQ(registry.refresh().status, Status::Unsuccess);
+        EXPECT_EQ(registry.getVersion(), version);
+        EXPECT_TRUE(events.empty());
+
+        // Unplugging A moves B to index 0.
+        bus.set({{0, "B"}, {1, "C"}});
+        EXPECT_EQ(registry.refresh().status, Status::Success);
+        EXPECT_GT(registry.getVersion(), version);
+        ASSERT_EQ(events.size(), 3u);
+        EXPECT_EQ(events[0].type, device_event_type::Removed);
+        EXPECT_EQ(events[0].entry, (registry_entry{0, "A"}));
+        EXPECT_EQ(events[1].type, device_event_type::Reindexed);
+        EXPECT_EQ(events[1].entry, (registry_entry{0, "B"}));
+        EXPECT_EQ(events[2].type, device_event_type::Added);
+        EXPECT_EQ(events[2].entry.serial, "C");
+        EXPECT_FALSE(registry.findSerial("A"));
+        EXPECT_EQ(registry.getScanCount(), 3u);
+    }
+
+    /**
+     * @brief Tests that the background thread refreshes on its timer and on device nodes appearing.
+     */
+    TEST(device_registry, backgroundRefresh) {
+        const std::filesystem::path usb = std::filesystem::temp_directory_path()
+                                          / ("fusion_usb_" + std::to_string(getpid()));
+        std::filesystem::create_directories(usb / "001");
+
+        fake_bus bus;
+        registry_config config;
+        config.refresh_interval = 60s;
+        config.settle_time = 20ms;
+        config.usb_path = usb.string();
+        device_registry registry(bus.scanner(), config);
+        std::atomic<int> added{0};
+        registry.subscribe([&](const device_event& event) {
+            if(event.type == device_event_type::Added)
+                ++added;
+        });
+        ASSERT_EQ(registry.start().status, Status::Success);
+        EXPECT_EQ(registry.size(), 0u);
+
+        // A node on a watched bus triggers a scan long before the timer would.
+        bus.set({{0, "A"}});
+        std::ofstream(usb / "001" / "004").put('\0');
+        EXPECT_TRUE(waitFor([&] { return registry.size() == 1; }));
+        // So does a node on a bus that appeared after start.
+        std::filesystem::create_directories(usb / "002");
+        EXPECT_TRUE(waitFor([&] { return bus.scans.load() >= 3; }));
+        bus.set({{0, "A"}, {1, "B"}});
+        std::ofstream(usb / "002" / "001").put('\0');
+        EXPECT_TRUE(waitFor([&] { return registry.size() == 2; }));
+        EXPECT_EQ(added.load(), 2);
+        registry.stop();
+        EXPECT_FALSE(registry.isRunning());
+        std::filesystem::remove_all(usb);
+
+        // Without a hotplug source the timer alone keeps the cache fresh.
+        fake_bus timed_bus;
+        registry_config timed;
+        timed.refresh_interval = 10ms;
+        timed.watch_hotplug = false;
+        device_registry timed_registry(timed_bus.scanner(), timed);
+        ASSERT_EQ(timed_registry.start().status, Status::Success);
+        timed_bus.set({{0, "A"}});
+        EXPECT_TRUE(waitFor([&] { return timed_registry.findSerial("A").has_value(); }));
+    }
+
+    /**
+     * @brief Tests that lookups stay consistent while tables are replaced under them.
+     */
+    TEST(device_registry, concurrentReaders) {
+        fake_bus bus;
+        registry_config config;
+        config.watch_hotplug = false;
+        device_registry registry(bus.scanner(), config);
+
+        std::atomic<bool> done{false};
+        std::atomic<std::uint64_t> lookups{0};
+        std::vector<std::thread> readers;
+        for(int r = 0; r < 3; ++r)
+            readers.emplace_back([&] {
+                while(!done.load())
+                {
+                    // Every table holds either {A, B} at 0 and 1 or {B} at 0.
+                    const std::vector<registry_entry> entries = registry.entries();
+                    if(!entries.empty())
+                    {
+                        EXPECT_EQ(entries.back().serial, "B");
+                    }
+                    const std::optional<registry_entry> b = registry.findSerial("B");
+                    if(b)
+                    {
+                        EXPECT_LE(b->index, 1);
+                    }
+                    ++lookups;
+                }
+            });
+        for(int i = 0; i < 2000; ++i)
+        {
+            bus.set(i % 2 == 0 ? std::vector<registry_entry>{{0, "A"}, {1, "B"}}
+                               : std::vector<registry_entry>{{0, "B"}});
+            registry.refresh();
+        }
+        done = true;
+        for(auto& reader : readers)
+            reader.join();
+        EXPECT_GT(lookups.load(), 0u);
+        EXPECT_EQ(registry.getVersion(), 2000u);
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "device/frame_bus.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Delivers one depth frame with a sequence number through a scheduler source.
+         */
+        void deliverDepth(frame_pool& pool, frame_scheduler::source& source, const std::uint32_t sequence)
+        {
+            frame_handle frame = pool.acquire(libfreenect2::Frame::Depth);
+            ASSERT_TRUE(frame);
+            frame->sequence = sequence;
+            frame.setArrivalTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+            source.deliver(frame);
+        }
+
+        std::vector<std::uint32_t> drain(frame_bus::subscription& subscriber)
+        {
+            std::vector<std::uint32_t> sequences;
+            scheduled_frame frame;
+            while (subscriber.tryPop(frame))
+                sequences.push_back(frame.frame->sequence);
+            return sequences;
+        }
+    }
+
+    /**
+     * @brief Tests that every subscriber gets the same pooled frame and applies its own policy.
+     */
+    TEST(frame_bus, fansOutWithPolicies) {
+        auto pool = frame_pool::create({0, 0, 16});
+        frame_scheduler scheduler;
+        frame_scheduler::source* source = scheduler.attach(1);
+        frame_bus bus(scheduler);
+
+        const auto oldest = bus.subscribe({2, backpressure::DropOldest});
+        const auto newest = bus.subscribe({2, backpressure::DropNewest});
+        const auto latest = bus.subscribe({8, backpressure::LatestOnly});
+        const auto other_device = bus.subscribe({4, backpressure::DropOldest, {}, 2});
+        const auto color_only = bus.subscribe({4, backpressure::DropOldest, {}, -1, libfreenect2::Frame::Color});
+        EXPECT_EQ(bus.subscriberCount(), 5u);
+
+        deliverDepth(*pool, *source, 0);
+        scheduled_frame first;
+        ASSERT_TRUE(oldest->tryPop(first));
+        scheduled_frame same;
+        ASSERT_TRUE(newest->tryPop(same));
+        EXPECT_EQ(first.frame.get(), same.frame.get()) << "subscribers share the pooled frame";
+        EXPECT_EQ(first.device_id, 1);
+        first = {};
+        same = {};
+
+        for (std::uint32_t i = 1; i <= 4; ++i)
+            deliverDepth(*pool, *source, i);
+        EXPECT_EQ(drain(*oldest), (std::vector<std::uint32_t>{3, 4}));
+        EXPECT_EQ(drain(*newest), (std::vector<std::uint32_t>{1, 2}));
+        EXPECT_EQ(drain(*latest), (std::vector<std::uint32_t>{4}));
+        EXPECT_TRUE(drain(*other_device).empty());
+        EXPECT_TRUE(drain(*color_only).empty());
+
+        const subscriber_metrics metrics = oldest->getMetrics();
+        EXPECT_EQ(metrics.received, 5u);
+        EXPECT_EQ(metrics.delivered, 3u);
+        EXPECT_EQ(metrics.dropped, 2u);
+        EXPECT_EQ(metrics.queued, 0u);
+        EXPECT_EQ(metrics.peak_queued, 2u);
+        EXPECT_GE(metrics.max_lag_ns, metrics.last_lag_ns);
+        EXPECT_GT(metrics.last_lag_ns, 0);
+        EXPECT_EQ(latest->getMetrics().dropped, 4u);
+        EXPECT_EQ(other_device->getMetrics().received, 0u);
+
+        // Only the scheduler's pull queue still holds frames.
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 16 - frame_scheduler::pull_capacity);
+    }
+
+    /**
+     * @brief Tests that a blocking subscriber stalls the producer until it pops, and drops after the timeout.
+     */
+    TEST(frame_bus, blockWaitsForRoom) {
+        auto pool = frame_pool::create({0, 0, 8});
+        frame_scheduler scheduler;
+        frame_scheduler::source* source = scheduler.attach(0);
+        frame_bus bus(scheduler);
+        const auto subscriber = bus.subscribe({1, backpressure::Block, std::chrono::milliseconds(5000)});
+
+        deliverDepth(*pool, *source, 0);
+        std::atomic<bool> delivered{false};
+        std::thread producer([&] {
+            deliverDepth(*pool, *source, 1);
+            delivered = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_FALSE(delivered.load());
+
+        scheduled_frame frame;
+        ASSERT_TRUE(subscriber->pop(frame, std::chrono::seconds(1)));
+        EXPECT_EQ(frame.frame->sequence, 0u);
+        producer.join();
+        EXPECT_TRUE(delivered.load());
+        ASSERT_TRUE(subscriber->pop(frame, std::chrono::seconds(1)));
+        EXPECT_EQ(frame.frame->sequence, 1u);
+        EXPECT_EQ(subscriber->getMetrics().blocked, 1u);
+        bus.unsubscribe(subscriber);
+
+        const auto impatient = bus.subscribe({1, backpressure::Block, std::chrono::milliseconds(1)});
+        deliverDepth(*pool, *source, 2);
+        deliverDepth(*pool, *source, 3);
+        EXPECT_EQ(drain(*impatient), (std::vector<std::uint32_t>{2}));
+        EXPECT_EQ(impatient->getMetrics().dropped, 1u);
+    }
+
+    /**
+     * @brief Tests that unsubscribing releases a blocked producer and a waiting consumer.
+     */
+    TEST(frame_bus, unsubscribeReleasesWaiters) {
+        auto pool = frame_pool::create({0, 0, 8});
+        frame_scheduler scheduler;
+        frame_scheduler::source* source = scheduler.attach(0);
+        frame_bus bus(scheduler);
+        const auto subscriber = bus.subscribe({1, backpressure::Block, std::chrono::milliseconds(10000)});
+
+        deliverDepth(*pool, *source, 0);
+        std::thread producer([&] { deliverDepth(*pool, *source, 1); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_TRUE(bus.unsubscribe(subscriber));
+        producer.join();
+        EXPECT_FALSE(bus.unsubscribe(subscriber));
+        EXPECT_TRUE(subscriber->isClosed());
+
+        // The queued frame can still be drained, then pop() returns without waiting for the timeout.
+        scheduled_frame frame;
+        EXPECT_TRUE(subscriber->pop(frame, std::chrono::seconds(10)));
+        const auto begin = std::chrono::steady_clock::now();
+        EXPECT_FALSE(subscriber->pop(frame, std::chrono::seconds(10)));
+        EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(1));
+        EXPECT_EQ(bus.subscriberCount(), 0u);
+    }
+}
@@ -0,0 +1,132 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include "device/frame_mat.h"
+#include "device/frame_pool.h"
+
+namespace vision
+{
+    /**
+     * @brief Tests that every frame format maps to its OpenCV type and shape.
+     */
+    TEST(frame_mat, mapsFormats) {
+        EXPECT_EQ(toMatType(libfreenect2::Frame::BGRX), CV_8UC4);
+        EXPECT_EQ(toMatType(libfreenect2::Frame::RGBX), CV_8UC4);
+        EXPECT_EQ(toMatType(libfreenect2::Frame::Float), CV_32FC1);
+        EXPECT_EQ(toMatType(libfreenect2::Frame::Gray), CV_8UC1);
+        EXPECT_EQ(toMatType(libfreenect2::Frame::Invalid), -1);
+
+        auto pool = frame_pool::create({1, 1, 1});
+        frame_handle color = pool->acquire(libfreenect2::Frame::Color);
+        color->format = libfreenect2::Frame::BGRX;
+        const cv::Mat color_mat = toMat(color);
+        EXPECT_EQ(color_mat.rows, 1080);
+        EXPECT_EQ(color_mat.cols, 1920);
+        EXPECT_EQ(color_mat.type(), CV_8UC4);
+        EXPECT_EQ(color_mat.data, color->data);
+
+        frame_handle depth = pool->acquire(libfreenect2::Frame::Depth);
+        depth->format = libfreenect2::Frame::Float;
+        reinterpret_cast<float*>(depth->data)[3 * 512 + 7] = 1234.5f;
+        const cv::Mat depth_mat = toMat(depth);
+        EXPECT_EQ(depth_mat.rows, 424);
+        EXPECT_EQ(depth_mat.cols, 512);
+        EXPECT_EQ(depth_mat.at<float>(3, 7), 1234.5f);
+
+        // A raw packet keeps its length in bytes_per_pixel.
+        frame_handle raw = pool->acquire(libfreenect2::Frame::Ir);
+        raw->format = libfreenect2::Frame::Raw;
+        raw->width = raw->height = 1;
+        raw->bytes_per_pixel = 1000;
+        const cv::Mat raw_mat = toMat(raw);
+        EXPECT_EQ(raw_mat.rows, 1);
+        EXPECT_EQ(raw_mat.cols, 1000);
+        EXPECT_EQ(raw_mat.type(), CV_8UC1);
+    }
+
+    /**
+     * @brief Tests that a Mat keeps the pooled buffer alive after its handle is gone.
+     */
+    TEST(frame_mat, matSharesBufferLifetime) {
+        auto pool = frame_pool::create({0, 0, 1});
+        frame_handle depth = pool->acquire(libfreenect2::Frame::Depth);
+        depth->format = libfreenect2::Frame::Float;
+
+        cv::Mat mat = toMat(depth);
+        EXPECT_EQ(depth.useCount(), 2u);
+        depth.reset();
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 0u);
+
+        cv::Mat copy = mat;
+        cv::Mat roi = mat(cv::Rect{10, 10, 20, 20});
+        mat.release();
+        copy.release();
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 0u) << "the ROI still references the frame";
+        roi.release();
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 1u);
+
+        // Reallocating a view detaches it from the frame instead of writing into the pool.
+        frame_handle again = pool->acquire(libfreenect2::Frame::Depth);
+        again->format = libfreenect2::Frame::Float;
+        cv::Mat resized = toMat(again);
+        again.reset();
+        resized.create(4, 4, CV_8UC1);
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 1u);
+    }
+
+    /**
+     * @brief Tests that a UMat shares the frame and releases it whichever of the Mat and UMat goes last.
+     */
+    TEST(frame_mat, umatSharesBufferLifetime) {
+        auto pool = frame_pool::create({1, 0, 0});
+        {
+            frame_handle color = pool->acquire(libfreenect2::Frame::Color);
+            color->format = libfreenect2::Frame::RGBX;
+            std::memset(color->data, 7, 16);
+            cv::UMat umat = toUMat(color);
+            ASSERT_FALSE(umat.empty());
+            EXPECT_EQ(umat.type(), CV_8UC4);
+            color.reset();
+            EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 0u);
+            EXPECT_EQ(umat.getMat(cv::ACCESS_READ).at<unsigned char>(0, 3), 7);
+        }
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 1u);
+
+        {
+            frame_handle color = pool->acquire(libfreenect2::Frame::Color);
+            color->format = libfreenect2::Frame::BGRX;
+            cv::Mat mat = toMat(color);
+            cv::UMat umat = mat.getUMat(cv::ACCESS_READ);
+            color.reset();
+            umat.release();
+            EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 0u);
+        }
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 1u);
+    }
+
+    /**
+     * @brief Tests that empty handles and unusable frames give empty views.
+     */
+    TEST(frame_mat, rejectsUnusableFrames) {
+        EXPECT_TRUE(toMat(frame_handle()).empty());
+        EXPECT_TRUE(toUMat(frame_handle()).empty());
+
+        auto pool = frame_pool::create({0, 1, 0});
+        frame_handle ir = pool->acquire(libfreenect2::Frame::Ir);
+        ir->format = libfreenect2::Frame::Invalid;
+        EXPECT_TRUE(toMat(ir).empty());
+        ir->format = libfreenect2::Frame::Raw;
+        ir->bytes_per_pixel = ir.capacity() + 1;
+        ir->width = ir->height = 1;
+        EXPECT_TRUE(toMat(ir).empty());
+        ir->format = libfreenect2::Frame::Gray;
+        ir->width = 512;
+        ir->height = 424;
+        ir->bytes_per_pixel = 4;
+        EXPECT_TRUE(toMat(ir).empty()) << "bytes per pixel must match the format";
+        EXPECT_EQ(ir.useCount(), 1u);
+    }
+}
@@ -0,0 +1,159 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "device/frame_listener.h"
+#include "device/frame_pool.h"
+
+namespace
+{
+    std::atomic<bool> count_allocations{false}; ///< Enables the allocation counter.
+    std::atomic<std::size_t> allocation_count{0}; ///< Allocations made while counting.
+}
+
+// Counting allocator: every global allocation in the test binary goes through here. The array,
+// nothrow and sized forms of the standard library forward to these, aligned ones included.
+void* operator new(const std::size_t size)
+{
+    if (count_allocations.load(std::memory_order_relaxed))
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    if (count_allocations.load(std::memory_order_relaxed))
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a size that is a multiple of the alignment.
+    if (void* ptr = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace vision
+{
+    /**
+     * @brief Tests that handles share a buffer and return it to the pool with the last reference.
+     */
+    TEST(frame_pool, handleRecyclesOnLastRelease) {
+        auto pool = frame_pool::create({1, 1, 1});
+        ASSERT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 1u);
+
+        frame_handle first = pool->acquire(libfreenect2::Frame::Depth);
+        ASSERT_TRUE(first);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first->data) % 64, 0u);
+        EXPECT_FALSE(pool->acquire(libfreenect2::Frame::Depth));
+
+        frame_handle second = first;
+        EXPECT_EQ(second.useCount(), 2u);
+        first.reset();
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 0u);
+        second.reset();
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 1u);
+    }
+
+    /**
+     * @brief Tests that a derived frame is made once, shared by every handle, and released with its frame.
+     */
+    TEST(frame_pool, derivedFrameLivesWithItsFrame) {
+        auto pool = frame_pool::create({2, 0, 1});
+        frame_handle depth = pool->acquire(libfreenect2::Frame::Depth);
+        ASSERT_TRUE(depth);
+
+        int made = 0;
+        const auto make = [&] {
+            ++made;
+            return pool->acquire(libfreenect2::Frame::Color);
+        };
+        const frame_handle first = depth.derive(0, make);
+        ASSERT_TRUE(first);
+        frame_handle copy = depth;
+        EXPECT_EQ(copy.derive(0, make)->data, first->data);
+        EXPECT_EQ(made, 1);
+        EXPECT_NE(depth.derive(1, make)->data, first->data);
+        EXPECT_EQ(made, 2);
+        EXPECT_FALSE(depth.derive(2, make));
+        EXPECT_EQ(made, 3);
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 0u);
+
+        // The frame keeps its derived frames until it is recycled, then drops them.
+        depth.reset();
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 0u);
+        copy.reset();
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 1u);
+    }
+
+    /**
+     * @brief Tests that outstanding handles keep the buffers alive after the owner drops the pool.
+     */
+    TEST(frame_pool, handleOutlivesPool) {
+        auto pool = frame_pool::create({0, 1, 0});
+        frame_handle handle = pool->acquire(libfreenect2::Frame::Ir);
+        pool.reset();
+
+        ASSERT_TRUE(handle);
+        handle->data[0] = 42;
+        EXPECT_EQ(handle->data[0], 42);
+    }
+
+    /**
+     * @brief Tests that steady-state capture through the listener makes zero allocations.
+     */
+    TEST(frame_pool, steadyStateCaptureDoesNotAllocate) {
+        auto pool = frame_pool::create({frame_listener::ring_capacity + 2, 0, frame_listener::ring_capacity + 2});
+        frame_listener listener(pool);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Color, true);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Depth, true);
+
+        libfreenect2::Frame color(1920, 1080, 4);
+        libfreenect2::Frame depth(512, 424, 4);
+
+        allocation_count.store(0);
+        count_allocations.store(true);
+        for (std::uint32_t i = 0; i < 300; ++i) {
+            color.sequence = depth.sequence = i;
+            EXPECT_FALSE(listener.onNewFrame(libfreenect2::Frame::Color, &color));
+            EXPECT_FALSE(listener.onNewFrame(libfreenect2::Frame::Depth, &depth));
+
+            // Let the ring overflow every other frame so eviction is exercised too.
+            if (i % 2 == 0) {
+                frame_handle captured = listener.popFrame(libfreenect2::Frame::Depth);
+                EXPECT_TRUE(captured);
+                captured = listener.popFrame(libfreenect2::Frame::Color);
+            }
+        }
+        count_allocations.store(false);
+
+        EXPECT_EQ(allocation_count.load(), 0u);
+        EXPECT_EQ(listener.getStatistics().received, 600u);
+        EXPECT_GT(listener.getStatistics().dropped, 0u);
+    }
+}
@@ -0,0 +1,84 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <thread>
+#include "device/frame_ring.h"
+
+namespace vision
+{
+    /**
+     * @brief Tests that elements come out in insertion order.
+     */
+    TEST(frame_ring, pushPopOrder) {
+        frame_ring<int*, 4> ring;
+        int values[3] = {0, 1, 2};
+        for (auto& value : values)
+            EXPECT_FALSE(ring.push(&value).has_value());
+
+        EXPECT_EQ(ring.size(), 3u);
+        int* item = nullptr;
+        for (auto& value : values) {
+            ASSERT_TRUE(ring.pop(item));
+            EXPECT_EQ(item, &value);
+        }
+        EXPECT_FALSE(ring.pop(item));
+        EXPECT_TRUE(ring.empty());
+    }
+
+    /**
+     * @brief Tests that a full ring evicts its oldest element instead of rejecting the new one.
+     */
+    TEST(frame_ring, overflowEvictsOldest) {
+        frame_ring<int*, 2> ring;
+        int values[3] = {0, 1, 2};
+        ring.push(&values[0]);
+        ring.push(&values[1]);
+
+        const auto evicted = ring.push(&values[2]);
+        ASSERT_TRUE(evicted.has_value());
+        EXPECT_EQ(*evicted, &values[0]);
+        EXPECT_EQ(ring.size(), 2u);
+
+        int* item = nullptr;
+        ASSERT_TRUE(ring.pop(item));
+        EXPECT_EQ(item, &values[1]);
+        ASSERT_TRUE(ring.pop(item));
+        EXPECT_EQ(item, &values[2]);
+    }
+
+    /**
+     * @brief Tests that every pushed element is either popped or evicted exactly once under contention.
+     */
+    TEST(frame_ring, concurrentProducerConsumer) {
+        constexpr std::uintptr_t count = 200000;
+        frame_ring<std::uintptr_t, 8> ring;
+        std::uint64_t evicted_sum = 0;
+        std::uint64_t popped_sum = 0;
+        std::uintptr_t last_popped = 0;
+        bool ordered = true;
+        std::atomic<bool> done{false};
+
+        std::thread producer([&] {
+            for (std::uintptr_t i = 1; i <= count; ++i) {
+                if (const auto evicted = ring.push(i))
+                    evicted_sum += *evicted;
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        std::uintptr_t item = 0;
+        while (!done.load(std::memory_order_acquire) || !ring.empty()) {
+            if (ring.pop(item)) {
+                ordered = ordered && item > last_popped;
+                last_popped = item;
+                popped_sum += item;
+            }
+        }
+        producer.join();
+
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(evicted_sum + popped_sum, count * (count + 1) / 2);
+    }
+}
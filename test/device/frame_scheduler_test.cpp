@@ -0,0 +1,59 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "device/frame_scheduler.h"
+
+namespace vision
+{
+    /**
+     * @brief Tests that delivered frames reach every consumer and the pull queue of their device.
+     */
+    TEST(frame_scheduler, deliverToConsumersAndPull) {
+        auto pool = frame_pool::create({0, 0, 4});
+        frame_scheduler scheduler;
+        frame_scheduler::source* source = scheduler.attach(3);
+
+        int delivered = 0;
+        const int subscription = scheduler.subscribe([&](const scheduled_frame& frame) {
+            EXPECT_EQ(frame.device_id, 3);
+            EXPECT_EQ(frame.type, libfreenect2::Frame::Depth);
+            ++delivered;
+        });
+
+        frame_handle frame = pool->acquire(libfreenect2::Frame::Depth);
+        frame->sequence = 7;
+        source->deliver(frame);
+        EXPECT_EQ(delivered, 1);
+
+        frame_handle pulled = scheduler.pull(3, libfreenect2::Frame::Depth);
+        ASSERT_TRUE(pulled);
+        EXPECT_EQ(pulled->sequence, 7u);
+        EXPECT_FALSE(scheduler.pull(3, libfreenect2::Frame::Color));
+
+        EXPECT_TRUE(scheduler.unsubscribe(subscription));
+        source->deliver(frame);
+        EXPECT_EQ(delivered, 1);
+    }
+
+    /**
+     * @brief Tests that the pull queue keeps only the latest frames and returns the rest to the pool.
+     */
+    TEST(frame_scheduler, pullQueueDropsOldest) {
+        auto pool = frame_pool::create({0, 0, 4});
+        frame_scheduler scheduler;
+        frame_scheduler::source* source = scheduler.attach(0);
+
+        for (std::uint32_t i = 0; i < 4; ++i) {
+            frame_handle frame = pool->acquire(libfreenect2::Frame::Depth);
+            frame->sequence = i;
+            source->deliver(frame);
+        }
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 4 - frame_scheduler::pull_capacity);
+        EXPECT_EQ(scheduler.pull(0, libfreenect2::Frame::Depth)->sequence, 4 - frame_scheduler::pull_capacity);
+
+        scheduler.detach(0);
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 4u);
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include "device/frame_synchronizer.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @struct simulated_device
+         * @brief A device whose clock runs with its own offset and drift against the host clock.
+         */
+        struct simulated_device
+        {
+            int device_id;
+            double clock_offset_s; ///< Device time at host time zero.
+            double drift;          ///< Relative clock rate error.
+            double phase_s;        ///< Capture phase of the frames on the host clock.
+        };
+
+        std::uint32_t deviceTicks(const simulated_device& device, const double host_s)
+        {
+            const double device_s = device.clock_offset_s + host_s * (1.0 + device.drift);
+            return static_cast<std::uint32_t>(std::llround(device_s / 0.000125));
+        }
+    }
+
+    /**
+     * @brief Tests that frames of two devices with different clocks are matched on capture time.
+     */
+    TEST(frame_synchronizer, matchesAcrossDeviceClocks) {
+        constexpr double period_s = 1.0 / 30.0;
+        constexpr int frame_count = 600;
+        const simulated_device devices[2] = {{0, 12.0, 50e-6, 0.0}, {1, 3000.0, -30e-6, 0.004}};
+
+        auto pool = frame_pool::create({32, 0, 32});
+        frame_scheduler scheduler;
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> matched;
+        frame_synchronizer synchronizer(scheduler, {0, 1}, [&](const frame_set& set) {
+            ASSERT_EQ(set.device_count, 2u);
+            matched.emplace_back(set.devices[0].depth->sequence, set.devices[1].depth->sequence);
+            EXPECT_EQ(set.devices[0].depth->sequence, set.devices[0].color->sequence);
+            EXPECT_EQ(set.devices[1].depth->sequence, set.devices[1].color->sequence);
+        });
+
+        for (std::uint32_t k = 0; k < frame_count; ++k) {
+            for (const auto& device : devices) {
+                const double capture_s = 100.0 + k * period_s + device.phase_s;
+                // Transfer and decoding latency with a little jitter; color decodes slower.
+                const double jitter_s = 0.0005 * ((k * 7 + device.device_id * 3) % 5);
+                for (const auto type : {libfreenect2::Frame::Depth, libfreenect2::Frame::Color}) {
+                    frame_handle frame = pool->acquire(type);
+                    ASSERT_TRUE(frame);
+                    frame->sequence = k;
+                    frame->timestamp = deviceTicks(device, capture_s + (type == libfreenect2::Frame::Color ? 0.002 : 0.0));
+                    const double latency_s = type == libfreenect2::Frame::Depth ? 0.020 : 0.035;
+                    frame.setArrivalTime(static_cast<std::int64_t>((capture_s + latency_s + jitter_s) * 1e9));
+                    synchronizer.push({device.device_id, type, std::move(frame)});
+                }
+            }
+        }
+
+        const auto statistics = synchronizer.getStatistics();
+        EXPECT_GT(statistics.emitted, frame_count * 9u / 10u);
+        EXPECT_EQ(statistics.emitted, matched.size());
+        for (const auto& [first, second] : matched)
+            EXPECT_EQ(first, second);
+
+        const auto estimate = synchronizer.getClockEstimate(0);
+        ASSERT_TRUE(estimate.has_value());
+        EXPECT_NEAR(estimate->drift_ppm, 50.0, 15.0);
+        EXPECT_FALSE(synchronizer.getClockEstimate(7).has_value());
+    }
+
+    /**
+     * @brief Tests that a device that stops sending frames makes the others count as dropped, not stall.
+     */
+    TEST(frame_synchronizer, boundedPendingQueues) {
+        auto pool = frame_pool::create({0, 0, 32});
+        frame_scheduler scheduler;
+        sync_config config;
+        config.max_pending = 4;
+        frame_synchronizer synchronizer(scheduler, {0, 1}, nullptr, config);
+
+        for (std::uint32_t k = 0; k < 20; ++k) {
+            frame_handle frame = pool->acquire(libfreenect2::Frame::Depth);
+            frame->timestamp = k * 267;
+            frame.setArrivalTime(static_cast<std::int64_t>(k) * 33'333'333);
+            synchronizer.push({0, libfreenect2::Frame::Depth, std::move(frame)});
+        }
+
+        EXPECT_EQ(synchronizer.getStatistics().emitted, 0u);
+        EXPECT_EQ(synchronizer.getStatistics().dropped, 16u);
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), 28u);
+    }
+}
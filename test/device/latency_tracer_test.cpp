@@ -0,0 +1,133 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include "device/frame_pool.h"
+#include "device/latency_tracer.h"
+
+namespace vision
+{
+    /**
+     * @brief Tests that every latency falls inside the bounds of its bucket and the error stays within 1/16.
+     */
+    TEST(latency_tracer, histogramBuckets) {
+        for(const std::int64_t ns : {0ll, 1ll, 31ll, 32ll, 33ll, 1000ll, 123456ll, 33'000'000ll, 60'000'000'000ll})
+        {
+            const std::size_t index = latency_histogram::bucketIndex(ns);
+            ASSERT_LT(index, latency_histogram::bucket_count);
+            EXPECT_GE(latency_histogram::bucketUpperBound(index), ns);
+            if(index > 0)
+            {
+                EXPECT_LT(latency_histogram::bucketUpperBound(index - 1), ns);
+            }
+            EXPECT_LE(latency_histogram::bucketUpperBound(index) - ns, ns / 16);
+        }
+        EXPECT_EQ(latency_histogram::bucketIndex(-5), 0u);
+        EXPECT_EQ(latency_histogram::bucketIndex(std::int64_t{1} << 50), latency_histogram::bucket_count - 1);
+
+        latency_histogram histogram;
+        EXPECT_EQ(histogram.percentile(0.5), 0);
+        for(std::int64_t us = 1; us <= 1000; ++us)
+            histogram.add(us * 1000);
+        EXPECT_EQ(histogram.count(), 1000u);
+        EXPECT_EQ(histogram.min(), 1000);
+        EXPECT_EQ(histogram.max(), 1'000'000);
+        EXPECT_NEAR(histogram.mean(), 500'500.0, 1.0);
+        EXPECT_NEAR(static_cast<double>(histogram.percentile(0.5)), 500'000.0, 500'000.0 / 16);
+        EXPECT_NEAR(static_cast<double>(histogram.percentile(0.99)), 990'000.0, 990'000.0 / 16);
+        EXPECT_EQ(histogram.percentile(1.0), 1'000'000);
+    }
+
+    /**
+     * @brief Tests that the stamps of several threads are all summed into the snapshot.
+     */
+    TEST(latency_tracer, snapshotSumsThreads) {
+        latency_tracer tracer(5);
+        constexpr int threads = 4;
+        constexpr int stamps = 1000;
+        std::vector<std::thread> workers;
+        for(int thread = 0; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread] {
+                for(int i = 0; i < stamps; ++i)
+                    tracer.record(latency_stage::Delivered, libfreenect2::Frame::Depth, i, 0, (thread + 1) * 1000);
+            });
+        }
+        for(auto& worker : workers)
+            worker.join();
+        tracer.record(latency_stage::Decoded, libfreenect2::Frame::Color, 0, 100, 300);
+
+        const latency_snapshot snapshot = tracer.snapshot();
+        EXPECT_EQ(snapshot.device_id, 5);
+        const latency_histogram& delivered = snapshot.get(libfreenect2::Frame::Depth, latency_stage::Delivered);
+        EXPECT_EQ(delivered.count(), static_cast<std::uint64_t>(threads * stamps));
+        EXPECT_EQ(delivered.min(), 1000);
+        EXPECT_EQ(delivered.max(), 4000);
+        EXPECT_NEAR(delivered.mean(), 2500.0, 0.5);
+        EXPECT_EQ(snapshot.get(libfreenect2::Frame::Color, latency_stage::Decoded).max(), 200);
+        EXPECT_EQ(snapshot.get(libfreenect2::Frame::Ir, latency_stage::Decoded).count(), 0u);
+    }
+
+    /**
+     * @brief Tests that pooled frames are stamped through their handle and on release, once filled.
+     */
+    TEST(latency_tracer, poolStampsRelease) {
+        auto tracer = std::make_shared<latency_tracer>(0);
+        auto pool = frame_pool::create({0, 0, 2});
+        pool->setTracer(tracer);
+
+        // Never filled: no arrival time, so neither the stamp nor the release is traced.
+        frame_handle empty = pool->acquire(libfreenect2::Frame::Depth);
+        empty.stamp(latency_stage::Delivered);
+        empty.reset();
+
+        frame_handle frame = pool->acquire(libfreenect2::Frame::Depth);
+        frame.setArrivalTime(latency_tracer::now());
+        frame.stamp(latency_stage::Delivered);
+        frame_handle copy = frame;
+        frame.reset();
+        EXPECT_EQ(tracer->snapshot().get(libfreenect2::Frame::Depth, latency_stage::Released).count(), 0u);
+        copy.reset();
+
+        const latency_snapshot snapshot = tracer->snapshot();
+        EXPECT_EQ(snapshot.get(libfreenect2::Frame::Depth, latency_stage::Delivered).count(), 1u);
+        const latency_histogram& released = snapshot.get(libfreenect2::Frame::Depth, latency_stage::Released);
+        EXPECT_EQ(released.count(), 1u);
+        EXPECT_GE(released.max(), snapshot.get(libfreenect2::Frame::Depth, latency_stage::Delivered).max());
+
+        // The recycled buffer starts without an arrival time.
+        pool->acquire(libfreenect2::Frame::Depth).reset();
+        EXPECT_EQ(tracer->snapshot().get(libfreenect2::Frame::Depth, latency_stage::Released).count(), 1u);
+    }
+
+    /**
+     * @brief Tests that the Chrome trace keeps only the latest stamps, as complete events.
+     */
+    TEST(latency_tracer, chromeTrace) {
+        latency_tracer tracer(2, {4});
+        latency_tracer untraced(3);
+        for(std::uint32_t sequence = 0; sequence < 6; ++sequence)
+            tracer.record(latency_stage::Filtered, libfreenect2::Frame::Depth, sequence, 1'000'000, 1'250'000);
+
+        const auto path = std::filesystem::temp_directory_path() / "latency_tracer_test.json";
+        ASSERT_EQ(latency_tracer::writeChromeTrace(path.string(), {&tracer, &untraced}).status, Status::Success);
+
+        std::ifstream file(path);
+        const std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::filesystem::remove(path);
+
+        EXPECT_EQ(json.find("\"sequence\": 1}"), std::string::npos);
+        for(const char* sequence : {"\"sequence\": 2}", "\"sequence\": 5}"})
+            EXPECT_NE(json.find(sequence), std::string::npos);
+        EXPECT_NE(json.find("\"name\": \"filtered\", \"cat\": \"depth\", \"ph\": \"X\", \"ts\": 1000.000, \"dur\": 250.000, \"pid\": 2"),
+                  std::string::npos);
+        EXPECT_EQ(json.find("\"pid\": 3"), std::string::npos);
+        EXPECT_EQ(json.back(), '\n');
+    }
+}
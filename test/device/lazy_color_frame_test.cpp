@@ -0,0 +1,139 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "device/frame_listener.h"
+#include "device/lazy_color_frame.h"
+
+#ifdef VISION_WITH_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Passes bytes through a frame_listener as the Raw color frame of a compressed pipeline.
+         */
+        frame_handle receiveRawColor(frame_listener& listener, std::vector<unsigned char>& bytes,
+                                     const std::uint32_t sequence)
+        {
+            libfreenect2::Frame raw(1, 1, bytes.size(), bytes.data());
+            raw.format = libfreenect2::Frame::Raw;
+            raw.sequence = sequence;
+            raw.timestamp = sequence * 10;
+            listener.onNewFrame(libfreenect2::Frame::Color, &raw);
+            return listener.popFrame(libfreenect2::Frame::Color);
+        }
+    }
+
+    /**
+     * @brief Tests that a Raw color frame passes the listener undecoded and is recognized as compressed.
+     */
+    TEST(lazy_color_frame, passthroughKeepsBytes) {
+        auto pool = frame_pool::create({2, 0, 1});
+        frame_listener listener(pool);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Color, true);
+
+        std::vector<unsigned char> bytes(12345);
+        for(std::size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<unsigned char>(i * 7);
+        frame_handle frame = receiveRawColor(listener, bytes, 3);
+        ASSERT_TRUE(frame);
+        ASSERT_TRUE(lazy_color_frame::isCompressed(frame));
+
+        const lazy_color_frame color(frame);
+        ASSERT_EQ(color.size(), bytes.size());
+        EXPECT_EQ(std::memcmp(color.data(), bytes.data(), bytes.size()), 0);
+        EXPECT_EQ(color.frame()->sequence, 3u);
+
+        // Not a JPEG: decoding fails without touching the pool.
+        int width = 0, height = 0;
+        EXPECT_NE(color.dimensions(width, height).status, Status::Success);
+        EXPECT_FALSE(color.decode(*pool));
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Color), 1u);
+
+        frame_handle depth = pool->acquire(libfreenect2::Frame::Depth);
+        EXPECT_FALSE(lazy_color_frame::isCompressed(depth));
+        EXPECT_EQ(lazy_color_frame(depth).size(), 0u);
+        EXPECT_FALSE(lazy_color_frame::isCompressed(frame_handle()));
+    }
+
+    /**
+     * @brief Tests that a Kinect-sized JPEG decodes to BGRX at full and reduced scale.
+     */
+    TEST(lazy_color_frame, decodeScales) {
+#ifdef VISION_WITH_TURBOJPEG
+        constexpr int width = 1920;
+        constexpr int height = 1080;
+        std::vector<unsigned char> bgrx(width * height * 4);
+        for(int y = 0; y < height; ++y)
+            for(int x = 0; x < width; ++x)
+            {
+                unsigned char* pixel = &bgrx[(y * width + x) * 4];
+                pixel[0] = static_cast<unsigned char>(x / 8);
+                pixel[1] = static_cast<unsigned char>(y / 5);
+                pixel[2] = 128;
+                pixel[3] = 0;
+            }
+
+        tjhandle compressor = tjInitCompress();
+        ASSERT_NE(compressor, nullptr);
+        unsigned char* jpeg = nullptr;
+        unsigned long jpeg_size = 0;
+        ASSERT_EQ(tjCompress2(compressor, bgrx.data(), width, width * 4, height, TJPF_BGRX, &jpeg, &jpeg_size,
+                              TJSAMP_422, 90, 0), 0);
+        std::vector<unsigned char> bytes(jpeg, jpeg + jpeg_size);
+        tjFree(jpeg);
+        tjDestroy(compressor);
+
+        auto pool = frame_pool::create({3, 0, 0});
+        frame_listener listener(pool);
+        listener.setFrameTypeEnabled(libfreenect2::Frame::Color, true);
+        const lazy_color_frame color(receiveRawColor(listener, bytes, 9));
+
+        frame_handle full = color.decode(*pool);
+        ASSERT_TRUE(full);
+        EXPECT_EQ(full->width, 1920u);
+        EXPECT_EQ(full->height, 1080u);
+        EXPECT_EQ(full->format, libfreenect2::Frame::BGRX);
+        EXPECT_EQ(full->sequence, 9u);
+        EXPECT_EQ(full.arrivalTime(), color.frame().arrivalTime());
+        const unsigned char* pixel = full->data + (540 * width + 960) * 4;
+        EXPECT_NEAR(pixel[0], 120, 3);
+        EXPECT_NEAR(pixel[1], 108, 3);
+        EXPECT_NEAR(pixel[2], 128, 3);
+
+        int scaled_width = 0, scaled_height = 0;
+        ASSERT_EQ(color.dimensions(scaled_width, scaled_height, jpeg_scale::Eighth).status, Status::Success);
+        EXPECT_EQ(scaled_width, 240);
+        EXPECT_EQ(scaled_height, 135);
+
+        // The frame is decoded once per scale; every wrapper of the frame shares the decoded frames.
+        const lazy_color_frame other(color.frame());
+        EXPECT_EQ(other.decode(*pool)->data, full->data);
+        EXPECT_EQ(color.decode(*pool)->data, full->data);
+
+        frame_handle quarter = color.decode(*pool, jpeg_scale::Quarter);
+        ASSERT_TRUE(quarter);
+        EXPECT_NE(quarter->data, full->data);
+        EXPECT_EQ(quarter->width, 480u);
+        EXPECT_EQ(quarter->height, 270u);
+        pixel = quarter->data + (135 * 480 + 240) * 4;
+        EXPECT_NEAR(pixel[0], 120, 3);
+        EXPECT_NEAR(pixel[1], 108, 3);
+
+        // A buffer too small for the frame is refused.
+        std::vector<unsigned char> small(100);
+        libfreenect2::Frame target(0, 0, 0, small.data());
+        EXPECT_EQ(color.decodeInto(target, small.size()).status, Status::InvalidParam);
+#else
+        GTEST_SKIP() << "Built without TurboJPEG.";
+#endif
+    }
+}
@@ -0,0 +1,37 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include "device/simd_dispatch.h"
+
+namespace vision
+{
+    /**
+     * @brief Tests that Auto picks the widest kernel both the CPU and the module have.
+     */
+    TEST(simd_dispatch, autoFollowsCpuAndModule) {
+        const simd_kernel cpu = cpuKernel();
+        EXPECT_NE(cpu, simd_kernel::Auto);
+        EXPECT_EQ(cpuKernel(), cpu);
+
+        EXPECT_EQ(resolveKernel(simd_kernel::Auto, {}), simd_kernel::Scalar);
+        EXPECT_EQ(resolveKernel(simd_kernel::Auto, {simd_kernel::SSE, simd_kernel::AVX2}), cpu);
+        EXPECT_EQ(resolveKernel(simd_kernel::Auto),
+                  cpu == simd_kernel::AVX2 ? simd_kernel::AVX2 : simd_kernel::Scalar);
+    }
+
+    /**
+     * @brief Tests that a requested kernel is kept when available and narrowed otherwise.
+     */
+    TEST(simd_dispatch, requestedKernelFallsBack) {
+        const simd_kernel cpu = cpuKernel();
+        EXPECT_EQ(resolveKernel(simd_kernel::Scalar), simd_kernel::Scalar);
+        EXPECT_EQ(resolveKernel(simd_kernel::Scalar, {simd_kernel::SSE, simd_kernel::AVX2}), simd_kernel::Scalar);
+        // A module without an SSE kernel runs its scalar one rather than a wider kernel than asked for.
+        EXPECT_EQ(resolveKernel(simd_kernel::SSE), simd_kernel::Scalar);
+        EXPECT_EQ(resolveKernel(simd_kernel::SSE, {simd_kernel::SSE, simd_kernel::AVX2}),
+                  cpu >= simd_kernel::SSE ? simd_kernel::SSE : simd_kernel::Scalar);
+        EXPECT_EQ(resolveKernel(simd_kernel::AVX2, {simd_kernel::SSE, simd_kernel::AVX2}), cpu);
+    }
+}
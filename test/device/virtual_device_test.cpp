@@ -0,0 +1,241 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include "device/device_manager.h"
+#include "device/virtual_device.h"
+#include "recorder/frame_recorder.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Counts frames and remembers the last depth frame's center value and sequence.
+         */
+        class counting_listener : public libfreenect2::FrameListener {
+        public:
+            std::atomic<int> color{0};
+            std::atomic<int> ir{0};
+            std::atomic<int> depth{0};
+            std::atomic<std::uint32_t> last_sequence{0};
+            std::atomic<float> center_depth{0.0f};
+            std::atomic<float> last_depth{0.0f};
+            std::atomic<int> depth_format{0};
+            std::atomic<std::uint32_t> first_timestamp{0};
+            std::atomic<std::uint32_t> last_timestamp{0};
+
+            bool onNewFrame(const libfreenect2::Frame::Type type, libfreenect2::Frame* frame) override
+            {
+                switch (type)
+                {
+                    case libfreenect2::Frame::Color: ++color; break;
+                    case libfreenect2::Frame::Ir: ++ir; break;
+                    case libfreenect2::Frame::Depth:
+                        center_depth = reinterpret_cast<float*>(frame->data)[frame->height / 2 * frame->width
+                                                                             + frame->width / 2];
+                        last_depth = reinterpret_cast<float*>(frame->data)[frame->width * frame->height - 1];
+                        depth_format = frame->format;
+                        if (depth == 0)
+                            first_timestamp = frame->timestamp;
+                        last_timestamp = frame->timestamp;
+                        last_sequence = frame->sequence;
+                        ++depth;
+                        break;
+                }
+                return false;
+            }
+        };
+
+        template<typename Predicate>
+        bool waitFor(Predicate predicate, const std::chrono::milliseconds timeout = std::chrono::seconds(5))
+        {
+            const auto deadline = std::chrono::steady_clock::now() + timeout;
+            while(!predicate())
+            {
+                if(std::chrono::steady_clock::now() > deadline)
+                    return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        }
+    }
+
+    /**
+     * @brief Tests that a firehose synthetic device streams all frame types without a rate limit.
+     */
+    TEST(virtual_device, syntheticFirehose) {
+        virtual_device_config config;
+        config.fps = 0.0;
+        config.color_width = 192;
+        config.color_height = 108;
+        std::unique_ptr<virtual_device> device(virtual_device::open(config));
+        ASSERT_NE(device, nullptr);
+
+        counting_listener listener;
+        device->setColorFrameListener(&listener);
+        device->setIrAndDepthFrameListener(&listener);
+        ASSERT_TRUE(device->startStreams(true, true));
+        EXPECT_TRUE(waitFor([&] { return listener.depth >= 100 && listener.color >= 100; }));
+        device->stop();
+
+        EXPECT_EQ(listener.ir.load(), listener.depth.load());
+        EXPECT_GE(listener.last_sequence.load(), 99u);
+        // The sphere sits in front of the wall, in the middle of the frame at the start of its swing.
+        EXPECT_GT(listener.center_depth.load(), 1400.0f);
+        EXPECT_LT(listener.center_depth.load(), 3100.0f);
+    }
+
+    /**
+     * @brief Tests that a paced synthetic device spaces its frames by the frame rate and honors the started streams.
+     *
+     * The spacing is checked on the device's own timestamps against the frame sequence,
+     * so a slow or loaded machine delivers fewer frames but never fails the test.
+     */
+    TEST(virtual_device, syntheticRate) {
+        virtual_device_config config;
+        config.fps = 100.0;
+        std::unique_ptr<virtual_device> device(virtual_device::open(config));
+        ASSERT_NE(device, nullptr);
+
+        counting_listener listener;
+        device->setColorFrameListener(&listener);
+        device->setIrAndDepthFrameListener(&listener);
+        ASSERT_TRUE(device->startStreams(false, true));
+        EXPECT_TRUE(waitFor([&] { return listener.depth >= 20; }));
+        device->stop();
+
+        const int frames = listener.depth.load();
+        ASSERT_GE(frames, 20);
+        EXPECT_EQ(listener.color.load(), 0);
+        EXPECT_EQ(listener.ir.load(), frames);
+        // Every frame of the sequence arrived, none was skipped to keep up.
+        EXPECT_EQ(listener.last_sequence.load(), static_cast<std::uint32_t>(frames - 1));
+        // 100 fps is 80 ticks of 125 us per frame; truncating both timestamps loses at most one tick.
+        EXPECT_GE(listener.last_timestamp.load() - listener.first_timestamp.load(),
+                  static_cast<std::uint32_t>(frames - 1) * 80u - 1u);
+    }
+
+    /**
+     * @brief Tests that a recording made by frame_recorder plays back through a virtual device.
+     */
+    TEST(virtual_device, recordingPlayback) {
+        const std::string path = (std::filesystem::temp_directory_path() / "virtual_device_playback").string();
+        {
+            frame_recorder recorder;
+            ASSERT_EQ(recorder.open(path).status, Status::Success);
+            libfreenect2::Frame depth(512, 424, 4);
+            for (std::uint32_t i = 0; i < 5; ++i) {
+                depth.sequence = i;
+                std::fill_n(reinterpret_cast<float*>(depth.data), 512 * 424, 1000.0f + static_cast<float>(i));
+                recorder.record(7, depth, libfreenect2::Frame::Depth, 0);
+            }
+            ASSERT_EQ(recorder.close().status, Status::Success);
+        }
+
+        virtual_device_config config;
+        config.source = virtual_source::Recording;
+        config.recording_path = path;
+        config.fps = 0.0;
+        config.loop = false;
+        std::unique_ptr<virtual_device> device(virtual_device::open(config));
+        ASSERT_NE(device, nullptr);
+        EXPECT_EQ(device->getConfig().recording_device_id, 7);
+
+        counting_listener listener;
+        device->setIrAndDepthFrameListener(&listener);
+        ASSERT_TRUE(device->startStreams(false, true));
+        EXPECT_TRUE(waitFor([&] { return listener.depth >= 5; }));
+        device->close();
+
+        EXPECT_EQ(listener.depth.load(), 5);
+        EXPECT_EQ(listener.last_sequence.load(), 4u);
+        EXPECT_FLOAT_EQ(listener.center_depth.load(), 1004.0f);
+        std::filesystem::remove(recording::dataPath(path));
+        std::filesystem::remove(recording::indexPath(path));
+    }
+
+    /**
+     * @brief Tests that a recording with compressed depth plays back decoded, at its recorded size.
+     */
+    TEST(virtual_device, compressedRecordingPlayback) {
+        const std::string path = (std::filesystem::temp_directory_path() / "virtual_device_compressed").string();
+        {
+            recorder_config recorder_settings;
+            recorder_settings.compress_depth = true;
+            frame_recorder recorder(recorder_settings);
+            ASSERT_EQ(recorder.open(path).status, Status::Success);
+            libfreenect2::Frame depth(512, 424, 4);
+            depth.format = libfreenect2::Frame::Float;
+            auto* depths = reinterpret_cast<float*>(depth.data);
+            for (std::uint32_t i = 0; i < 5; ++i) {
+                depth.sequence = i;
+                for (std::size_t p = 0; p < 512 * 424; ++p)
+                    depths[p] = 1000.0f + static_cast<float>((p + i) % 700);
+                recorder.record(7, depth, libfreenect2::Frame::Depth, 0);
+            }
+            ASSERT_EQ(recorder.close().status, Status::Success);
+            ASSERT_EQ(recorder.getStatistics().compressed_frames, 5u);
+        }
+
+        virtual_device_config config;
+        config.source = virtual_source::Recording;
+        config.recording_path = path;
+        config.fps = 0.0;
+        config.loop = false;
+        std::unique_ptr<virtual_device> device(virtual_device::open(config));
+        ASSERT_NE(device, nullptr);
+
+        counting_listener listener;
+        device->setIrAndDepthFrameListener(&listener);
+        ASSERT_TRUE(device->startStreams(false, true));
+        EXPECT_TRUE(waitFor([&] { return listener.depth >= 5; }));
+        device->close();
+
+        EXPECT_EQ(listener.depth.load(), 5);
+        EXPECT_EQ(listener.last_sequence.load(), 4u);
+        EXPECT_EQ(listener.depth_format.load(), libfreenect2::Frame::Float);
+        EXPECT_FLOAT_EQ(listener.center_depth.load(), 1000.0f + static_cast<float>((212 * 512 + 256 + 4) % 700));
+        EXPECT_FLOAT_EQ(listener.last_depth.load(), 1000.0f + static_cast<float>((512 * 424 - 1 + 4) % 700));
+        std::filesystem::remove(recording::dataPath(path));
+        std::filesystem::remove(recording::indexPath(path));
+    }
+
+    /**
+     * @brief Tests that a virtual device is listed, opened and captured by device_manager like a Kinect2.
+     */
+    TEST(virtual_device, streamsThroughDeviceManager) {
+        device_manager* manager = device_manager::getInstance();
+        const int kinect_count = manager->availableDeviceCount();
+
+        virtual_device_config config;
+        config.serial = "VIRTUAL-TEST";
+        config.fps = 60.0;
+        const int device_id = manager->addVirtualDevice(config);
+        EXPECT_EQ(manager->availableDeviceCount(), kinect_count + 1);
+        ASSERT_TRUE(manager->getDevice(device_id).has_value());
+        EXPECT_EQ(manager->getDevice(device_id)->getSerial(), "VIRTUAL-TEST");
+
+        ASSERT_EQ(manager->startDepthStream(device_id).status, Status::Success);
+        std::optional<captured_frames> frames;
+        EXPECT_TRUE(waitFor([&] {
+            Result result = manager->captureFrame(device_id);
+            if (result.status != Status::Success)
+                return false;
+            frames = std::any_cast<captured_frames>(*result.data);
+            return static_cast<bool>(frames->depth);
+        }));
+        ASSERT_TRUE(frames.has_value());
+        EXPECT_EQ(frames->depth->width, 512u);
+        EXPECT_FALSE(frames->color);
+        frames.reset();
+
+        EXPECT_TRUE(manager->removeVirtualDevice(device_id));
+        EXPECT_FALSE(manager->removeVirtualDevice(device_id));
+        EXPECT_EQ(manager->availableDeviceCount(), kinect_count);
+    }
+}
@@ -0,0 +1,173 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "fusion/tsdf_volume.h"
+#include "camera_params.h"
+
+namespace vision
+{
+    namespace
+    {
+        using test::makeIrParams;
+
+        constexpr std::size_t depth_width = 512;
+        constexpr std::size_t depth_height = 424;
+
+        /**
+         * @struct depth_image
+         * @brief Undistorted depth frame in millimeters.
+         */
+        struct depth_image
+        {
+            std::vector<float> depth = std::vector<float>(depth_width * depth_height);
+            libfreenect2::Frame frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(depth.data())};
+
+            explicit depth_image(const float millimeters = 0.0f)
+            {
+                std::fill(depth.begin(), depth.end(), millimeters);
+            }
+        };
+
+        /**
+         * @brief Renders a wall at 1.5 m with a sphere of radius 0.25 m in front of it, as seen from the origin.
+         */
+        depth_image makeScene()
+        {
+            const auto params = makeIrParams();
+            depth_image image(1500.0f);
+            const float center[3] = {0.1f, -0.05f, 1.1f};
+            constexpr float radius = 0.25f;
+            for(std::size_t r = 0; r < depth_height; ++r)
+                for(std::size_t c = 0; c < depth_width; ++c)
+                {
+                    const float ray[3] = {(static_cast<float>(c) + 0.5f - params.cx) / params.fx,
+                                          (static_cast<float>(r) + 0.5f - params.cy) / params.fy, 1.0f};
+                    const float a = ray[0] * ray[0] + ray[1] * ray[1] + 1.0f;
+                    const float b = ray[0] * center[0] + ray[1] * center[1] + center[2];
+                    const float c0 = center[0] * center[0] + center[1] * center[1] + center[2] * center[2] - radius * radius;
+                    const float discriminant = b * b - a * c0;
+                    if(discriminant >= 0.0f)
+                        image.depth[r * depth_width + c] = (b - std::sqrt(discriminant)) / a * 1000.0f;
+                }
+            return image;
+        }
+    }
+
+    /**
+     * @brief Tests that a flat wall is fused at the right distance and meshed facing the camera.
+     */
+    TEST(tsdf_volume, fusesWall) {
+        tsdf_volume volume({}, tsdf_volume::kernel::Scalar);
+        const depth_image wall(1500.0f);
+        ASSERT_EQ(volume.integrate(wall.frame, makeIrParams()).status, Status::Success);
+        EXPECT_GT(volume.getBrickCount(), 0u);
+
+        float tsdf = 0.0f, weight = 0.0f;
+        ASSERT_TRUE(volume.sample(0.0f, 0.0f, 1.5f, tsdf, weight));
+        EXPECT_NEAR(tsdf, 0.0f, 1e-3f);
+        EXPECT_EQ(weight, 1.0f);
+        ASSERT_TRUE(volume.sample(0.0f, 0.0f, 1.48f, tsdf, weight));
+        EXPECT_NEAR(tsdf, 0.5f, 1e-3f);
+        ASSERT_TRUE(volume.sample(0.0f, 0.0f, 1.52f, tsdf, weight));
+        EXPECT_NEAR(tsdf, -0.5f, 1e-3f);
+        EXPECT_FALSE(volume.sample(0.0f, 0.0f, 3.0f, tsdf, weight));
+
+        triangle_mesh mesh;
+        EXPECT_EQ(volume.extractMesh(mesh), volume.getBrickCount());
+        ASSERT_GT(mesh.triangleCount(), 1000u);
+        for(std::size_t t = 0; t < mesh.triangleCount(); ++t)
+        {
+            const float* v = mesh.vertices.data() + t * 9;
+            for(int corner = 0; corner < 3; ++corner)
+                ASSERT_NEAR(v[corner * 3 + 2], 1.5f, 0.005f);
+            const float e1[2] = {v[3] - v[0], v[4] - v[1]};
+            const float e2[2] = {v[6] - v[0], v[7] - v[1]};
+            // Counter-clockwise seen from the free side: the normal points back to the camera.
+            ASSERT_LE(e1[0] * e2[1] - e1[1] * e2[0], 0.0f) << "triangle " << t;
+        }
+    }
+
+    /**
+     * @brief Tests that the kernels and thread counts produce the same volume.
+     */
+    TEST(tsdf_volume, kernelsAgree) {
+        const depth_image scene = makeScene();
+        const pose moved = {0.9950042f, 0.0f, 0.0998334f, 0.02f,
+                            0.0f, 1.0f, 0.0f, -0.01f,
+                            -0.0998334f, 0.0f, 0.9950042f, 0.05f,
+                            0.0f, 0.0f, 0.0f, 1.0f};
+
+        std::vector<float> reference;
+        for(const auto kernel : {tsdf_volume::kernel::Scalar, tsdf_volume::kernel::Auto})
+            for(const std::size_t threads : {1u, 3u})
+            {
+                tsdf_config config;
+                config.threads = threads;
+                tsdf_volume volume(config, kernel);
+                EXPECT_EQ(volume.getThreadCount(), threads);
+                ASSERT_EQ(volume.integrate(scene.frame, makeIrParams()).status, Status::Success);
+                ASSERT_EQ(volume.integrate(scene.frame, makeIrParams(), moved).status, Status::Success);
+
+                triangle_mesh mesh;
+                volume.extractMesh(mesh);
+                if(reference.empty())
+                    reference = mesh.vertices;
+                else
+                    EXPECT_EQ(mesh.vertices, reference) << "kernel " << static_cast<int>(volume.getKernel())
+                                                        << ", " << threads << " threads";
+            }
+        EXPECT_GT(reference.size(), 0u);
+    }
+
+    /**
+     * @brief Tests that extractMesh() only re-meshes the bricks a frame changed.
+     */
+    TEST(tsdf_volume, remeshesDirtyBricks) {
+        tsdf_volume volume;
+        ASSERT_EQ(volume.integrate(makeScene().frame, makeIrParams()).status, Status::Success);
+        triangle_mesh mesh;
+        EXPECT_EQ(volume.extractMesh(mesh), volume.getBrickCount());
+        const std::size_t triangles = mesh.triangleCount();
+        EXPECT_EQ(volume.getDirtyBrickCount(), 0u);
+        EXPECT_EQ(volume.extractMesh(mesh), 0u);
+        EXPECT_EQ(mesh.triangleCount(), triangles);
+
+        // A frame observing a small patch only, the rest is invalid.
+        depth_image patch;
+        for(std::size_t r = 40; r < 60; ++r)
+            for(std::size_t c = 40; c < 60; ++c)
+                patch.depth[r * depth_width + c] = 1500.0f;
+        ASSERT_EQ(volume.integrate(patch.frame, makeIrParams()).status, Status::Success);
+        const std::size_t dirty = volume.getDirtyBrickCount();
+        EXPECT_GT(dirty, 0u);
+        EXPECT_LT(dirty * 10, volume.getBrickCount());
+        EXPECT_EQ(volume.extractMesh(mesh), dirty);
+        EXPECT_NEAR(static_cast<double>(mesh.triangleCount()), static_cast<double>(triangles), triangles * 0.01);
+
+        volume.reset();
+        EXPECT_EQ(volume.getBrickCount(), 0u);
+        EXPECT_EQ(volume.extractMesh(mesh), 0u);
+        EXPECT_EQ(mesh.triangleCount(), 0u);
+    }
+
+    /**
+     * @brief Tests that frames the volume cannot fuse are rejected.
+     */
+    TEST(tsdf_volume, rejectsInvalidFrames) {
+        tsdf_volume volume;
+        libfreenect2::Frame empty(0, 0, 4);
+        EXPECT_EQ(volume.integrate(empty, makeIrParams()).status, Status::EmptyData);
+
+        std::vector<unsigned char> bytes(depth_width * depth_height);
+        libfreenect2::Frame gray(depth_width, depth_height, 1, bytes.data());
+        EXPECT_EQ(volume.integrate(gray, makeIrParams()).status, Status::InvalidParam);
+
+        const depth_image wall(1500.0f);
+        EXPECT_EQ(volume.integrate(wall.frame, {}).status, Status::InvalidParam);
+        EXPECT_EQ(volume.getBrickCount(), 0u);
+    }
+}
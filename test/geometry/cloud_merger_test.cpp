@@ -0,0 +1,103 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include "geometry/cloud_merger.h"
+
+namespace vision
+{
+    namespace
+    {
+        point_cloud makeCloud(const std::size_t width, const std::size_t height, const bool with_color,
+                              const unsigned int seed)
+        {
+            point_cloud cloud;
+            cloud.resize(width, height, with_color);
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<float> coordinate(-2.0f, 2.0f);
+            for(std::size_t i = 0; i < cloud.size(); ++i)
+            {
+                const bool invalid = i % 17 == 0;
+                cloud.x[i] = invalid ? std::numeric_limits<float>::quiet_NaN() : coordinate(rng);
+                cloud.y[i] = invalid ? std::numeric_limits<float>::quiet_NaN() : coordinate(rng);
+                cloud.z[i] = invalid ? std::numeric_limits<float>::quiet_NaN() : coordinate(rng) + 3.0f;
+                if(with_color)
+                    cloud.rgb[i] = static_cast<float>(i);
+            }
+            return cloud;
+        }
+
+        bool sameBits(const float a, const float b)
+        {
+            return std::memcmp(&a, &b, sizeof(float)) == 0;
+        }
+    }
+
+    /**
+     * @brief Tests that every kernel and thread count matches a plain per-point transform.
+     */
+    TEST(cloud_merger, matchesReferenceTransform) {
+        // Sizes that split into several chunks with a tail that is not a multiple of eight.
+        const point_cloud first = makeCloud(512, 424, true, 1);
+        const point_cloud second = makeCloud(301, 7, false, 2);
+        const pose turned = {0.0f, -1.0f, 0.0f, 0.5f, 1.0f, 0.0f, 0.0f, -0.25f, 0.0f, 0.0f, 1.0f, 2.0f, 0, 0, 0, 1};
+        const std::vector<merge_source> sources = {{&first, identity_pose}, {&second, turned}};
+
+        for(const auto kernel : {cloud_merger::kernel::Scalar, cloud_merger::kernel::Auto})
+            for(const std::size_t threads : {1u, 3u})
+            {
+                cloud_merger merger(threads, {}, kernel);
+                point_cloud merged;
+                ASSERT_EQ(merger.merge(sources, merged).status, Status::Success);
+                ASSERT_EQ(merged.size(), first.size() + second.size());
+                EXPECT_EQ(merged.height, 1u);
+                ASSERT_EQ(merged.rgb.size(), merged.size());
+
+                std::size_t offset = 0;
+                for(const merge_source& source : sources)
+                {
+                    const point_cloud& cloud = *source.cloud;
+                    const pose& m = source.world_from_camera;
+                    for(std::size_t i = 0; i < cloud.size(); ++i)
+                    {
+                        const float x = m[0] * cloud.x[i] + m[1] * cloud.y[i] + m[2] * cloud.z[i] + m[3];
+                        const float y = m[4] * cloud.x[i] + m[5] * cloud.y[i] + m[6] * cloud.z[i] + m[7];
+                        const float z = m[8] * cloud.x[i] + m[9] * cloud.y[i] + m[10] * cloud.z[i] + m[11];
+                        const std::size_t j = offset + i;
+                        ASSERT_TRUE(sameBits(merged.x[j], x) && sameBits(merged.y[j], y) && sameBits(merged.z[j], z))
+                            << "kernel " << static_cast<int>(merger.getKernel()) << ", point " << j;
+                        ASSERT_EQ(merged.rgb[j], cloud.rgb.empty() ? 0.0f : cloud.rgb[i]);
+                    }
+                    offset += cloud.size();
+                }
+                EXPECT_TRUE(std::isnan(merged.x[0]));
+            }
+    }
+
+    /**
+     * @brief Tests that merging the same devices again reuses the output buffers.
+     */
+    TEST(cloud_merger, reusesOutput) {
+        const point_cloud first = makeCloud(512, 424, false, 3);
+        const point_cloud second = makeCloud(512, 424, false, 4);
+        cloud_merger merger(2);
+        point_cloud merged;
+        ASSERT_EQ(merger.merge({{&first}, {&second}}, merged).status, Status::Success);
+        const float* x = merged.x.data();
+        ASSERT_EQ(merger.merge({{&first}, {&second}}, merged).status, Status::Success);
+        EXPECT_EQ(merged.x.data(), x);
+        EXPECT_TRUE(merged.rgb.empty());
+
+        EXPECT_EQ(merger.merge({{nullptr}}, merged).status, Status::InvalidParam);
+        point_cloud broken = first;
+        broken.y.pop_back();
+        EXPECT_EQ(merger.merge({{&broken}}, merged).status, Status::InvalidParam);
+        ASSERT_EQ(merger.merge({}, merged).status, Status::Success);
+        EXPECT_EQ(merged.size(), 0u);
+    }
+}
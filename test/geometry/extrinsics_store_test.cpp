@@ -0,0 +1,105 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include "geometry/extrinsics_store.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Temporary directory removed with the test.
+         */
+        struct temp_directory
+        {
+            std::filesystem::path path = std::filesystem::temp_directory_path()
+                                         / ("extrinsics_test_" + std::to_string(::getpid()));
+
+            ~temp_directory()
+            {
+                std::filesystem::remove_all(path);
+            }
+        };
+    }
+
+    /**
+     * @brief Tests that poses survive a save and load and are found by serial.
+     */
+    TEST(extrinsics_store, savesAndLoads) {
+        const temp_directory directory;
+        const std::string path = (directory.path / "nested" / "extrinsics.txt").string();
+
+        extrinsics_store store;
+        const pose left = {0.0f, -1.0f, 0.0f, 0.25f, 1.0f, 0.0f, 0.0f, -0.125f, 0.0f, 0.0f, 1.0f, 1.0f / 3.0f, 9, 9, 9, 9};
+        EXPECT_TRUE(store.set("003726334247", left));
+        EXPECT_TRUE(store.set("virtual-1", identity_pose));
+        EXPECT_FALSE(store.set("", identity_pose));
+        EXPECT_FALSE(store.set("two words", identity_pose));
+        ASSERT_EQ(store.save(path).status, Status::Success);
+
+        extrinsics_store loaded;
+        ASSERT_EQ(loaded.load(path).status, Status::Success);
+        EXPECT_EQ(loaded.size(), 2u);
+        const std::optional<pose> found = loaded.find("003726334247");
+        ASSERT_TRUE(found.has_value());
+        for(int i = 0; i < 12; ++i)
+            EXPECT_EQ((*found)[i], left[i]) << i;
+        EXPECT_EQ((*found)[15], 1.0f) << "the last row is always 0 0 0 1";
+        EXPECT_FALSE(loaded.find("unknown").has_value());
+
+        EXPECT_TRUE(loaded.remove("virtual-1"));
+        EXPECT_FALSE(loaded.remove("virtual-1"));
+        EXPECT_EQ(loaded.size(), 1u);
+    }
+
+    /**
+     * @brief Tests that a malformed file is rejected without touching the loaded poses.
+     */
+    TEST(extrinsics_store, rejectsMalformedFiles) {
+        const temp_directory directory;
+        std::filesystem::create_directories(directory.path);
+        const std::string path = (directory.path / "extrinsics.txt").string();
+
+        extrinsics_store store;
+        EXPECT_EQ(store.load(path).status, Status::NotFound);
+        {
+            std::ofstream file(path);
+            file << "# comment\n\nA 1 0 0 0 0 1 0 0 0 0 1 0\n";
+        }
+        ASSERT_EQ(store.load(path).status, Status::Success);
+        ASSERT_EQ(store.size(), 1u);
+
+        {
+            std::ofstream file(path);
+            file << "B 1 0 0 0 0 1 0 0 0 0 1\n";
+        }
+        EXPECT_EQ(store.load(path).status, Status::InvalidParam);
+        {
+            std::ofstream file(path);
+            file << "B 1 0 0 0 0 1 0 0 0 0 1 0 extra\n";
+        }
+        EXPECT_EQ(store.load(path).status, Status::InvalidParam);
+        {
+            std::ofstream file(path);
+            file << "B 1 0 0 0 0 1 0 0 0 0 1 0\nB 1 0 0 0 0 1 0 0 0 0 1 0\n";
+        }
+        EXPECT_EQ(store.load(path).status, Status::Conflict);
+        EXPECT_TRUE(store.find("A").has_value());
+        EXPECT_FALSE(store.find("B").has_value());
+    }
+
+    /**
+     * @brief Tests that composing a pose with its inverse gives the identity.
+     */
+    TEST(extrinsics_store, invertsPoses) {
+        const pose turned = {0.0f, -1.0f, 0.0f, 0.5f, 1.0f, 0.0f, 0.0f, -0.25f, 0.0f, 0.0f, 1.0f, 2.0f, 0, 0, 0, 1};
+        const pose result = compose(turned, invertRigid(turned));
+        for(int i = 0; i < 16; ++i)
+            EXPECT_FLOAT_EQ(result[i], identity_pose[i]) << i;
+    }
+}
@@ -0,0 +1,144 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "libfreenect2/registration.h"
+#include "geometry/point_cloud_builder.h"
+#include "camera_params.h"
+
+namespace vision
+{
+    namespace
+    {
+        using test::makeIrParams;
+
+        constexpr std::size_t width = point_cloud_builder::depth_width;
+        constexpr std::size_t height = point_cloud_builder::depth_height;
+
+        /**
+         * @brief Fills a depth frame with random depths and every edge case of the validity test.
+         */
+        std::vector<float> makeDepth()
+        {
+            std::vector<float> depth(width * height);
+            std::mt19937 rng(42);
+            std::uniform_real_distribution<float> range(0.0f, 8000.0f);
+            for (auto& value : depth)
+                value = range(rng);
+
+            const float edge_cases[] = {
+                std::numeric_limits<float>::quiet_NaN(), 0.0f, -0.0f, -250.0f,
+                1.0f, std::nextafter(1.0f, 0.0f), std::nextafter(1.0f, 2.0f), 1.0001f,
+                std::numeric_limits<float>::infinity(), std::numeric_limits<float>::denorm_min(),
+            };
+            for (std::size_t i = 0; i < depth.size(); i += 7)
+                depth[i] = edge_cases[(i / 7) % std::size(edge_cases)];
+            return depth;
+        }
+
+        std::uint32_t bits(const float value)
+        {
+            std::uint32_t result;
+            std::memcpy(&result, &value, sizeof(result));
+            return result;
+        }
+
+        std::vector<point_cloud_builder::kernel> supportedKernels()
+        {
+            std::vector<point_cloud_builder::kernel> kernels{point_cloud_builder::kernel::Scalar};
+            const simd_kernel best = cpuKernel();
+            if (best >= simd_kernel::SSE)
+                kernels.push_back(point_cloud_builder::kernel::SSE);
+            if (best == simd_kernel::AVX2)
+                kernels.push_back(point_cloud_builder::kernel::AVX2);
+            return kernels;
+        }
+    }
+
+    /**
+     * @brief Tests that every kernel is bit-exact with Registration::getPointXYZ.
+     */
+    TEST(point_cloud_builder, matchesGetPointXYZ) {
+        const auto params = makeIrParams();
+        libfreenect2::Registration registration(params, libfreenect2::Freenect2Device::ColorCameraParams{});
+        std::vector<float> depth = makeDepth();
+        libfreenect2::Frame undistorted(width, height, 4, reinterpret_cast<unsigned char*>(depth.data()));
+
+        for (const auto kernel : supportedKernels()) {
+            point_cloud_builder builder(params, kernel);
+            ASSERT_EQ(builder.getKernel(), kernel);
+
+            point_cloud cloud;
+            ASSERT_TRUE(builder.build(undistorted, cloud));
+            ASSERT_EQ(cloud.size(), width * height);
+            EXPECT_TRUE(cloud.rgb.empty());
+
+            std::size_t mismatches = 0;
+            for (std::size_t r = 0; r < height; ++r)
+                for (std::size_t c = 0; c < width; ++c) {
+                    float x, y, z;
+                    registration.getPointXYZ(&undistorted, static_cast<int>(r), static_cast<int>(c), x, y, z);
+                    const std::size_t i = r * width + c;
+                    if (bits(x) != bits(cloud.x[i]) || bits(y) != bits(cloud.y[i]) || bits(z) != bits(cloud.z[i]))
+                        ++mismatches;
+                }
+            EXPECT_EQ(mismatches, 0u) << "kernel " << static_cast<int>(kernel);
+        }
+    }
+
+    /**
+     * @brief Tests that the colored and packed outputs are bit-exact with Registration::getPointXYZRGB.
+     */
+    TEST(point_cloud_builder, matchesGetPointXYZRGB) {
+        const auto params = makeIrParams();
+        libfreenect2::Registration registration(params, libfreenect2::Freenect2Device::ColorCameraParams{});
+        std::vector<float> depth = makeDepth();
+        std::vector<std::uint32_t> color(width * height);
+        for (std::size_t i = 0; i < color.size(); ++i)
+            color[i] = 0xff000000u | static_cast<std::uint32_t>(i * 2654435761u >> 8);
+        libfreenect2::Frame undistorted(width, height, 4, reinterpret_cast<unsigned char*>(depth.data()));
+        libfreenect2::Frame registered(width, height, 4, reinterpret_cast<unsigned char*>(color.data()));
+
+        for (const auto kernel : supportedKernels()) {
+            point_cloud_builder builder(params, kernel);
+            point_cloud cloud;
+            std::vector<point_xyzrgb> packed;
+            ASSERT_TRUE(builder.build(undistorted, registered, cloud));
+            ASSERT_TRUE(builder.buildPacked(undistorted, registered, packed));
+            ASSERT_EQ(packed.size(), width * height);
+
+            std::size_t mismatches = 0;
+            for (std::size_t r = 0; r < height; ++r)
+                for (std::size_t c = 0; c < width; ++c) {
+                    float x, y, z, rgb;
+                    registration.getPointXYZRGB(&undistorted, &registered, static_cast<int>(r), static_cast<int>(c),
+                                                x, y, z, rgb);
+                    const std::size_t i = r * width + c;
+                    if (bits(x) != bits(cloud.x[i]) || bits(y) != bits(cloud.y[i])
+                        || bits(z) != bits(cloud.z[i]) || bits(rgb) != bits(cloud.rgb[i]))
+                        ++mismatches;
+                    if (bits(x) != bits(packed[i].x) || bits(y) != bits(packed[i].y)
+                        || bits(z) != bits(packed[i].z) || bits(rgb) != bits(packed[i].rgb))
+                        ++mismatches;
+                }
+            EXPECT_EQ(mismatches, 0u) << "kernel " << static_cast<int>(kernel);
+        }
+    }
+
+    /**
+     * @brief Tests that frames of an unexpected size are rejected.
+     */
+    TEST(point_cloud_builder, rejectsWrongFrameSize) {
+        point_cloud_builder builder(makeIrParams());
+        std::vector<float> depth(640 * 480);
+        libfreenect2::Frame wrong(640, 480, 4, reinterpret_cast<unsigned char*>(depth.data()));
+        point_cloud cloud;
+        EXPECT_FALSE(builder.build(wrong, cloud));
+    }
+}
@@ -0,0 +1,200 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <vector>
+#include <unistd.h>
+#include "libfreenect2/registration.h"
+#include "geometry/registration_engine.h"
+#include "camera_params.h"
+
+namespace vision
+{
+    namespace
+    {
+        using test::makeIrParams;
+        using test::makeColorParams;
+
+        constexpr std::size_t depth_width = registration_engine::depth_width;
+        constexpr std::size_t depth_height = registration_engine::depth_height;
+        constexpr std::size_t color_width = registration_engine::color_width;
+        constexpr std::size_t color_height = registration_engine::color_height;
+
+        /**
+         * @struct frames
+         * @brief Inputs and outputs of one registration.
+         */
+        struct frames
+        {
+            std::vector<float> depth = std::vector<float>(depth_width * depth_height);
+            std::vector<std::uint32_t> color = std::vector<std::uint32_t>(color_width * color_height);
+            std::vector<float> undistorted = std::vector<float>(depth_width * depth_height);
+            std::vector<std::uint32_t> registered = std::vector<std::uint32_t>(depth_width * depth_height);
+            std::vector<float> bigdepth = std::vector<float>(color_width * registration_engine::bigdepth_height);
+            std::vector<int> map = std::vector<int>(depth_width * depth_height);
+
+            libfreenect2::Frame depth_frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(depth.data())};
+            libfreenect2::Frame color_frame{color_width, color_height, 4, reinterpret_cast<unsigned char*>(color.data())};
+            libfreenect2::Frame undistorted_frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(undistorted.data())};
+            libfreenect2::Frame registered_frame{depth_width, depth_height, 4, reinterpret_cast<unsigned char*>(registered.data())};
+            libfreenect2::Frame bigdepth_frame{color_width, registration_engine::bigdepth_height, 4,
+                                               reinterpret_cast<unsigned char*>(bigdepth.data())};
+
+            frames()
+            {
+                // A wall with a closer box in front of it, so the occlusion filter drops pixels, and invalid depths.
+                std::mt19937 rng(5);
+                std::uniform_real_distribution<float> noise(-15.0f, 15.0f);
+                for (std::size_t r = 0; r < depth_height; ++r)
+                    for (std::size_t c = 0; c < depth_width; ++c)
+                        depth[r * depth_width + c] = (r > 150 && r < 260 && c > 200 && c < 320 ? 900.0f : 2500.0f)
+                                                     + noise(rng);
+                const float invalid[] = {0.0f, -3.0f, std::numeric_limits<float>::quiet_NaN(), 0.2f};
+                for (std::size_t i = 0; i < depth.size(); i += 97)
+                    depth[i] = invalid[(i / 97) % std::size(invalid)];
+                for (std::size_t i = 0; i < color.size(); ++i)
+                    color[i] = static_cast<std::uint32_t>(i) | 0xff000000u;
+            }
+        };
+
+        void expectSameBits(const void* expected, const void* actual, const std::size_t size, const char* what)
+        {
+            EXPECT_EQ(std::memcmp(expected, actual, size), 0) << what;
+        }
+
+        std::vector<registration_engine::kernel> supportedKernels()
+        {
+            std::vector<registration_engine::kernel> kernels{registration_engine::kernel::Scalar};
+            if (cpuKernel() == simd_kernel::AVX2)
+                kernels.push_back(registration_engine::kernel::AVX2);
+            return kernels;
+        }
+
+        /**
+         * @brief Private cache directory removed with the test.
+         */
+        struct temporary_cache
+        {
+            std::filesystem::path path = std::filesystem::temp_directory_path()
+                                         / ("registration_engine_test_" + std::to_string(::getpid()));
+
+            registration_config config(const std::size_t threads = 1) const
+            {
+                return {true, path.string(), threads, {}};
+            }
+
+            ~temporary_cache()
+            {
+                std::filesystem::remove_all(path);
+            }
+        };
+    }
+
+    /**
+     * @brief Tests that every kernel and thread count is bit-exact with Registration::apply.
+     */
+    TEST(registration_engine, matchesRegistrationApply) {
+        const libfreenect2::Registration registration(makeIrParams(), makeColorParams());
+        frames expected;
+        registration.apply(&expected.color_frame, &expected.depth_frame, &expected.undistorted_frame,
+                           &expected.registered_frame, true, &expected.bigdepth_frame, expected.map.data());
+        frames unfiltered;
+        registration.apply(&unfiltered.color_frame, &unfiltered.depth_frame, &unfiltered.undistorted_frame,
+                           &unfiltered.registered_frame, false);
+
+        for (const auto kernel : supportedKernels()) {
+            for (const std::size_t threads : {1u, 3u}) {
+                SCOPED_TRACE(static_cast<int>(kernel) * 10 + static_cast<int>(threads));
+                registration_engine engine("", makeIrParams(), makeColorParams(), {false, "", threads, {}}, kernel);
+                ASSERT_EQ(engine.getKernel(), kernel);
+
+                frames actual;
+                ASSERT_TRUE(engine.apply(actual.color_frame, actual.depth_frame, actual.undistorted_frame,
+                                         actual.registered_frame, true, &actual.bigdepth_frame, actual.map.data()));
+                expectSameBits(expected.undistorted.data(), actual.undistorted.data(), actual.undistorted.size() * 4, "undistorted");
+                expectSameBits(expected.registered.data(), actual.registered.data(), actual.registered.size() * 4, "registered");
+                expectSameBits(expected.bigdepth.data(), actual.bigdepth.data(), actual.bigdepth.size() * 4, "bigdepth");
+                expectSameBits(expected.map.data(), actual.map.data(), actual.map.size() * 4, "color_depth_map");
+
+                frames plain;
+                ASSERT_TRUE(engine.apply(plain.color_frame, plain.depth_frame, plain.undistorted_frame,
+                                         plain.registered_frame, false));
+                expectSameBits(unfiltered.registered.data(), plain.registered.data(), plain.registered.size() * 4, "unfiltered");
+            }
+        }
+
+        std::size_t dropped = 0;
+        for (std::size_t i = 0; i < expected.map.size(); ++i)
+            dropped += expected.map[i] >= 0 && expected.registered[i] == 0;
+        EXPECT_GT(dropped, 0u) << "the scene should exercise the occlusion filter";
+    }
+
+    /**
+     * @brief Tests that the single-pixel mapping agrees with the color offsets of a frame.
+     */
+    TEST(registration_engine, pointMappingMatchesFrame) {
+        registration_engine engine("", makeIrParams(), makeColorParams(), {false, "", 1, {}});
+        frames actual;
+        ASSERT_TRUE(engine.apply(actual.color_frame, actual.depth_frame, actual.undistorted_frame,
+                                 actual.registered_frame, false, nullptr, actual.map.data()));
+
+        std::size_t checked = 0;
+        for (std::size_t i = 0; i < actual.map.size(); i += 13) {
+            if (actual.map[i] < 0)
+                continue;
+            float cx, cy;
+            engine.apply(static_cast<int>(i % depth_width), static_cast<int>(i / depth_width), actual.undistorted[i], cx, cy);
+            EXPECT_EQ(static_cast<int>(cx + 0.5f) + static_cast<int>(cy + 0.5f) * static_cast<int>(color_width), actual.map[i]);
+            ++checked;
+        }
+        EXPECT_GT(checked, 1000u);
+    }
+
+    /**
+     * @brief Tests that the tables are cached per serial and rebuilt when the parameters change.
+     */
+    TEST(registration_engine, cachesTablesBySerial) {
+        const temporary_cache cache;
+        frames built, cached;
+        {
+            registration_engine engine("012345678912", makeIrParams(), makeColorParams(), cache.config());
+            EXPECT_FALSE(engine.isFromCache());
+            ASSERT_TRUE(engine.apply(built.color_frame, built.depth_frame, built.undistorted_frame, built.registered_frame));
+        }
+        EXPECT_TRUE(std::filesystem::exists(cache.path / "012345678912.regtable"));
+        {
+            registration_engine engine("012345678912", makeIrParams(), makeColorParams(), cache.config(2));
+            EXPECT_TRUE(engine.isFromCache());
+            ASSERT_TRUE(engine.apply(cached.color_frame, cached.depth_frame, cached.undistorted_frame, cached.registered_frame));
+        }
+        expectSameBits(built.registered.data(), cached.registered.data(), built.registered.size() * 4, "registered");
+        expectSameBits(built.undistorted.data(), cached.undistorted.data(), built.undistorted.size() * 4, "undistorted");
+
+        auto changed = makeColorParams();
+        changed.shift_m += 1.0f;
+        EXPECT_FALSE(registration_engine("012345678912", makeIrParams(), changed, cache.config()).isFromCache());
+        EXPECT_TRUE(registration_engine("012345678912", makeIrParams(), changed, cache.config()).isFromCache());
+        EXPECT_FALSE(registration_engine("other", makeIrParams(), changed, cache.config()).isFromCache());
+        EXPECT_FALSE(registration_engine("../escape", makeIrParams(), changed, cache.config()).isFromCache());
+        EXPECT_FALSE(std::filesystem::exists(cache.path.parent_path() / "escape.regtable"));
+    }
+
+    /**
+     * @brief Tests that frames of the wrong size are rejected.
+     */
+    TEST(registration_engine, rejectsWrongFrameSizes) {
+        registration_engine engine("", makeIrParams(), makeColorParams(), {false, "", 1, {}});
+        frames actual;
+        libfreenect2::Frame small(depth_width, depth_height, 4, actual.color_frame.data);
+        EXPECT_FALSE(engine.apply(small, actual.depth_frame, actual.undistorted_frame, actual.registered_frame));
+        libfreenect2::Frame short_bigdepth(color_width, color_height, 4, actual.bigdepth_frame.data);
+        EXPECT_FALSE(engine.apply(actual.color_frame, actual.depth_frame, actual.undistorted_frame,
+                                  actual.registered_frame, true, &short_bigdepth));
+    }
+}
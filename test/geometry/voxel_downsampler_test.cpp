@@ -0,0 +1,175 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <random>
+#include <tuple>
+#include "geometry/voxel_downsampler.h"
+
+namespace vision
+{
+    namespace
+    {
+        using point = std::array<float, 4>;
+
+        /**
+         * @brief Clustered colored cloud with invalid and far-away points.
+         */
+        point_cloud makeCloud(const std::size_t size)
+        {
+            point_cloud cloud;
+            cloud.resize(size, 1, true);
+            std::mt19937 rng(11);
+            std::uniform_real_distribution<float> coordinate(-0.3f, 0.3f);
+            std::uniform_int_distribution<std::uint32_t> channel(0, 255);
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                cloud.x[i] = coordinate(rng);
+                cloud.y[i] = coordinate(rng);
+                cloud.z[i] = coordinate(rng) + 1.5f;
+                const std::uint32_t color = channel(rng) | channel(rng) << 8 | channel(rng) << 16 | 0xff000000u;
+                std::memcpy(&cloud.rgb[i], &color, sizeof(color));
+            }
+            cloud.x[3] = std::numeric_limits<float>::quiet_NaN();
+            cloud.z[size - 1] = 1e9f;
+            return cloud;
+        }
+
+        std::vector<point> sorted(const point_cloud& cloud)
+        {
+            std::vector<point> points;
+            for(std::size_t i = 0; i < cloud.size(); ++i)
+                points.push_back({cloud.x[i], cloud.y[i], cloud.z[i], cloud.rgb.empty() ? 0.0f : cloud.rgb[i]});
+            std::sort(points.begin(), points.end(), [](const point& a, const point& b) {
+                return std::tie(a[0], a[1], a[2]) < std::tie(b[0], b[1], b[2]);
+            });
+            return points;
+        }
+
+        /**
+         * @brief Straightforward reference: an ordered map of voxel coordinates.
+         */
+        std::vector<point> reference(const point_cloud& cloud, const voxel_config& config)
+        {
+            struct sum
+            {
+                double x = 0, y = 0, z = 0;
+                std::uint32_t b = 0, g = 0, r = 0, count = 0;
+                point first{};
+            };
+            std::map<std::tuple<int, int, int>, sum> voxels;
+            const float inv_voxel = 1.0f / config.voxel_size;
+            for(std::size_t i = 0; i < cloud.size(); ++i)
+            {
+                const float vx = std::floor(cloud.x[i] * inv_voxel), vy = std::floor(cloud.y[i] * inv_voxel),
+                            vz = std::floor(cloud.z[i] * inv_voxel);
+                if(!(std::fabs(vx) < 1e6f && std::fabs(vy) < 1e6f && std::fabs(vz) < 1e6f))
+                    continue;
+                sum& voxel = voxels[{static_cast<int>(vx), static_cast<int>(vy), static_cast<int>(vz)}];
+                std::uint32_t color;
+                std::memcpy(&color, &cloud.rgb[i], sizeof(color));
+                if(voxel.count++ == 0)
+                    voxel.first = {cloud.x[i], cloud.y[i], cloud.z[i], cloud.rgb[i]};
+                voxel.x += cloud.x[i];
+                voxel.y += cloud.y[i];
+                voxel.z += cloud.z[i];
+                voxel.b += color & 0xff;
+                voxel.g += color >> 8 & 0xff;
+                voxel.r += color >> 16 & 0xff;
+            }
+
+            point_cloud out;
+            out.resize(voxels.size(), 1, true);
+            std::size_t i = 0;
+            for(const auto& [key, voxel] : voxels)
+            {
+                if(config.point == voxel_point::First)
+                {
+                    out.x[i] = voxel.first[0];
+                    out.y[i] = voxel.first[1];
+                    out.z[i] = voxel.first[2];
+                    out.rgb[i] = voxel.first[3];
+                }
+                else
+                {
+                    out.x[i] = static_cast<float>(voxel.x / voxel.count);
+                    out.y[i] = static_cast<float>(voxel.y / voxel.count);
+                    out.z[i] = static_cast<float>(voxel.z / voxel.count);
+                    const std::uint32_t half = voxel.count / 2;
+                    const std::uint32_t color = (voxel.b + half) / voxel.count | (voxel.g + half) / voxel.count << 8
+                                                | (voxel.r + half) / voxel.count << 16;
+                    std::memcpy(&out.rgb[i], &color, sizeof(color));
+                }
+                ++i;
+            }
+            return sorted(out);
+        }
+    }
+
+    /**
+     * @brief Tests both point modes and several thread counts against the reference.
+     */
+    TEST(voxel_downsampler, matchesReference) {
+        const point_cloud cloud = makeCloud(100000);
+        for(const auto mode : {voxel_point::Centroid, voxel_point::First})
+        {
+            voxel_config config;
+            config.voxel_size = 0.02f;
+            config.point = mode;
+            const std::vector<point> expected = reference(cloud, config);
+
+            std::vector<float> single_thread_x;
+            for(const std::size_t threads : {1u, 3u})
+            {
+                config.threads = threads;
+                voxel_downsampler downsampler(config);
+                point_cloud downsampled;
+                ASSERT_EQ(downsampler.downsample(cloud, downsampled).status, Status::Success);
+                EXPECT_EQ(downsampled.height, 1u);
+                EXPECT_LT(downsampled.size(), cloud.size() / 2);
+                const std::vector<point> actual = sorted(downsampled);
+                ASSERT_EQ(actual.size(), expected.size());
+                for(std::size_t i = 0; i < actual.size(); ++i)
+                    ASSERT_EQ(std::memcmp(actual[i].data(), expected[i].data(), sizeof(point)), 0)
+                        << "mode " << static_cast<int>(mode) << ", voxel " << i;
+
+                if(single_thread_x.empty())
+                    single_thread_x = downsampled.x;
+                else
+                    EXPECT_EQ(downsampled.x, single_thread_x) << "the order does not depend on the thread count";
+            }
+        }
+    }
+
+    /**
+     * @brief Tests that a steady input reuses the buffers and uncolored clouds stay uncolored.
+     */
+    TEST(voxel_downsampler, reusesBuffers) {
+        point_cloud cloud = makeCloud(50000);
+        voxel_downsampler downsampler({0.05f, voxel_point::Centroid, 2});
+        point_cloud downsampled;
+        ASSERT_EQ(downsampler.downsample(cloud, downsampled).status, Status::Success);
+        const std::size_t voxels = downsampled.size();
+        const float* x = downsampled.x.data();
+        ASSERT_EQ(downsampler.downsample(cloud, downsampled).status, Status::Success);
+        EXPECT_EQ(downsampled.size(), voxels);
+        EXPECT_EQ(downsampled.x.data(), x);
+
+        cloud.rgb.clear();
+        ASSERT_EQ(downsampler.downsample(cloud, downsampled).status, Status::Success);
+        EXPECT_EQ(downsampled.size(), voxels);
+        EXPECT_TRUE(downsampled.rgb.empty());
+
+        cloud.z.pop_back();
+        EXPECT_EQ(downsampler.downsample(cloud, downsampled).status, Status::InvalidParam);
+        ASSERT_EQ(downsampler.downsample(point_cloud{}, downsampled).status, Status::Success);
+        EXPECT_EQ(downsampled.size(), 0u);
+    }
+}
@@ -0,0 +1,248 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "device/frame_bus.h"
+#include "ipc/shm_client.h"
+#include "ipc/shm_publisher.h"
+
+namespace vision
+{
+    namespace
+    {
+        std::string segmentName(const std::string& name)
+        {
+            return "/fusion_" + name + "_" + std::to_string(getpid());
+        }
+
+        void fill(libfreenect2::Frame& frame, const std::uint32_t seed)
+        {
+            const std::size_t size = frame.width * frame.height * frame.bytes_per_pixel;
+            for(std::size_t i = 0; i < size; ++i)
+                frame.data[i] = static_cast<unsigned char>(seed * 31 + i * 7);
+        }
+    }
+
+    /**
+     * @brief Tests that published frames are read in order, in place, with their metadata.
+     */
+    TEST(shm_publisher, roundTrip) {
+        const std::string name = segmentName("round_trip");
+        publisher_config config;
+        config.color_slot_size = 64 * 48 * 4;
+        config.device_ids = {0, 1};
+        shm_publisher publisher(config);
+        ASSERT_EQ(publisher.open(name).status, Status::Success);
+
+        shm_client client;
+        ASSERT_EQ(client.open(name).status, Status::Success);
+        EXPECT_TRUE(client.isPublisherOpen());
+        EXPECT_FALSE(client.next(libfreenect2::Frame::Depth));
+
+        libfreenect2::Frame depth(512, 424, 4);
+        libfreenect2::Frame color(64, 48, 4);
+        libfreenect2::Frame large(128, 48, 4);
+        color.format = libfreenect2::Frame::BGRX;
+        color.exposure = 2.5f;
+        for(std::uint32_t i = 0; i < 3; ++i)
+        {
+            depth.sequence = i;
+            fill(depth, i);
+            EXPECT_TRUE(publisher.publish(i % 2, depth, libfreenect2::Frame::Depth, 1000 + i));
+        }
+        fill(color, 9);
+        EXPECT_TRUE(publisher.publish(1, color, libfreenect2::Frame::Color, 2000));
+        EXPECT_FALSE(publisher.publish(1, large, libfreenect2::Frame::Color, 0));
+        EXPECT_FALSE(publisher.publish(0, depth, libfreenect2::Frame::Ir, 0));
+        EXPECT_FALSE(publisher.publish(2, depth, libfreenect2::Frame::Depth, 0));
+        EXPECT_EQ(publisher.getStatistics().frames_published, 4u);
+        EXPECT_EQ(publisher.getStatistics().dropped, 1u);
+
+        for(std::uint32_t i = 0; i < 3; ++i)
+        {
+            const auto frame = client.next(libfreenect2::Frame::Depth);
+            ASSERT_TRUE(frame);
+            EXPECT_EQ(frame->info.frame_number, i);
+            EXPECT_EQ(frame->info.device_id, static_cast<std::int32_t>(i % 2));
+            EXPECT_EQ(frame->info.sequence, i);
+            EXPECT_EQ(frame->info.arrival_ns, 1000 + i);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(frame->data) % shm::page_size, 0u);
+            fill(depth, i);
+            EXPECT_EQ(std::memcmp(frame->data, depth.data, 512 * 424 * 4), 0);
+            EXPECT_TRUE(client.isValid(*frame));
+        }
+        EXPECT_FALSE(client.next(libfreenect2::Frame::Depth));
+        EXPECT_FALSE(client.next(libfreenect2::Frame::Ir));
+
+        const auto frame = client.latest(libfreenect2::Frame::Color);
+        ASSERT_TRUE(frame);
+        libfreenect2::Frame view(0, 0, 0, nullptr);
+        shm_client::view(*frame, view);
+        EXPECT_EQ(view.width, 64u);
+        EXPECT_EQ(view.format, libfreenect2::Frame::BGRX);
+        EXPECT_FLOAT_EQ(view.exposure, 2.5f);
+        EXPECT_EQ(std::memcmp(view.data, color.data, 64 * 48 * 4), 0);
+        EXPECT_EQ(client.getLost(libfreenect2::Frame::Depth), 0u);
+
+        ASSERT_EQ(publisher.close().status, Status::Success);
+        EXPECT_FALSE(client.isPublisherOpen());
+        client.close();
+        EXPECT_EQ(client.open(name).status, Status::NotFound);
+    }
+
+    /**
+     * @brief Tests that a reader falling behind loses the oldest frames and sees its held frame go stale.
+     */
+    TEST(shm_publisher, slowReaderLosesOldest) {
+        const std::string name = segmentName("slow_reader");
+        publisher_config config;
+        config.slot_count = 4;
+        config.frame_types = libfreenect2::Frame::Depth;
+        shm_publisher publisher(config);
+        ASSERT_EQ(publisher.open(name).status, Status::Success);
+        shm_client client;
+        ASSERT_EQ(client.open(name).status, Status::Success);
+
+        libfreenect2::Frame depth(64, 64, 4);
+        depth.sequence = 0;
+        publisher.publish(0, depth, libfreenect2::Frame::Depth, 0);
+        const auto held = client.next(libfreenect2::Frame::Depth);
+        ASSERT_TRUE(held);
+        for(std::uint32_t i = 1; i < 10; ++i)
+        {
+            depth.sequence = i;
+            publisher.publish(0, depth, libfreenect2::Frame::Depth, 0);
+        }
+        EXPECT_FALSE(client.isValid(*held));
+
+        // Frames 1 to 5 were overwritten; 6 to 9 are still in their slots.
+        for(std::uint32_t i = 6; i < 10; ++i)
+        {
+            const auto frame = client.next(libfreenect2::Frame::Depth);
+            ASSERT_TRUE(frame);
+            EXPECT_EQ(frame->info.sequence, i);
+        }
+        EXPECT_EQ(client.getLost(libfreenect2::Frame::Depth), 5u);
+        EXPECT_FALSE(client.latest(libfreenect2::Frame::Depth));
+    }
+
+    /**
+     * @brief Tests that readers never accept a torn frame while several threads publish.
+     */
+    TEST(shm_publisher, concurrentPublishers) {
+        const std::string name = segmentName("concurrent");
+        publisher_config config;
+        config.slot_count = 3;
+        config.frame_types = libfreenect2::Frame::Depth;
+        shm_publisher publisher(config);
+        ASSERT_EQ(publisher.open(name).status, Status::Success);
+        shm_client client;
+        ASSERT_EQ(client.open(name).status, Status::Success);
+
+        constexpr int publishers = 2;
+        constexpr std::uint32_t frames = 2000;
+        std::atomic<bool> done{false};
+        std::vector<std::thread> threads;
+        for(int device = 0; device < publishers; ++device)
+            threads.emplace_back([&, device] {
+                libfreenect2::Frame depth(128, 106, 4);
+                for(std::uint32_t i = 0; i < frames; ++i)
+                {
+                    depth.sequence = i;
+                    std::memset(depth.data, static_cast<int>(i & 0xff), 128 * 106 * 4);
+                    publisher.publish(device, depth, libfreenect2::Frame::Depth, 0);
+                }
+            });
+
+        std::uint64_t read = 0, stale = 0, last = 0;
+        std::thread reader([&] {
+            while(!done.load())
+            {
+                const auto frame = client.next(libfreenect2::Frame::Depth);
+                if(!frame)
+                    continue;
+                EXPECT_TRUE(read == 0 || frame->info.frame_number > last);
+                last = frame->info.frame_number;
+                const auto expected = static_cast<unsigned char>(frame->info.sequence & 0xff);
+                bool intact = true;
+                for(std::size_t i = 0; i < frame->info.size; i += 97)
+                    intact = intact && frame->data[i] == expected;
+                if(!client.isValid(*frame))
+                    ++stale;
+                else
+                    EXPECT_TRUE(intact) << "frame " << frame->info.frame_number;
+                ++read;
+            }
+        });
+        for(auto& thread : threads)
+            thread.join();
+        done = true;
+        reader.join();
+
+        const publisher_statistics statistics = publisher.getStatistics();
+        EXPECT_EQ(statistics.frames_published + statistics.dropped, publishers * frames);
+        EXPECT_GT(read, 0u);
+        EXPECT_LE(read, publishers * frames);
+        EXPECT_LE(stale, read);
+    }
+
+    /**
+     * @brief Tests that an attached publisher copies bus frames on its own thread and releases the pooled buffers.
+     */
+    TEST(shm_publisher, publishesBusFrames) {
+        const std::string name = segmentName("bus");
+        auto pool = frame_pool::create({0, 0, frame_scheduler::pull_capacity + 1});
+        frame_scheduler scheduler;
+        frame_bus bus(scheduler);
+        frame_scheduler::source* source = scheduler.attach(3);
+
+        publisher_config config;
+        config.frame_types = libfreenect2::Frame::Depth;
+        config.slot_count = 16;
+        config.queue_depth = 16;
+        shm_publisher publisher(config);
+        ASSERT_EQ(publisher.open(name).status, Status::Success);
+        ASSERT_EQ(publisher.attach(bus).status, Status::Success);
+        EXPECT_EQ(publisher.attach(bus).status, Status::Conflict);
+        shm_client client;
+        ASSERT_EQ(client.open(name).status, Status::Success);
+
+        for(std::uint32_t i = 0; i < 8; ++i)
+        {
+            frame_handle frame = pool->acquire(libfreenect2::Frame::Depth);
+            ASSERT_TRUE(frame);
+            frame->sequence = i;
+            fill(*frame, i);
+            source->deliver(frame);
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(publisher.getStatistics().frames_published < 8 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_EQ(publisher.getStatistics().frames_published, 8u);
+        EXPECT_EQ(publisher.getStatistics().dropped, 0u);
+
+        libfreenect2::Frame expected(512, 424, 4);
+        for(std::uint32_t i = 0; i < 8; ++i)
+        {
+            const auto frame = client.next(libfreenect2::Frame::Depth);
+            ASSERT_TRUE(frame);
+            EXPECT_EQ(frame->info.device_id, 3);
+            EXPECT_EQ(frame->info.sequence, i);
+            fill(expected, i);
+            EXPECT_EQ(std::memcmp(frame->data, expected.data, 512 * 424 * 4), 0);
+        }
+
+        ASSERT_EQ(publisher.close().status, Status::Success);
+        EXPECT_EQ(bus.subscriberCount(), 0u);
+        scheduler.detach(3);
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), frame_scheduler::pull_capacity + 1);
+    }
+}
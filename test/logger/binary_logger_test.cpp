@@ -0,0 +1,127 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <thread>
+#include <vector>
+#include "logger/binary_log_reader.h"
+#include "logger/binary_logger.h"
+
+namespace vision
+{
+    namespace
+    {
+        std::string logPath(const std::string& name)
+        {
+            return (std::filesystem::temp_directory_path() / name).string();
+        }
+
+        enum class frame_kind { Color = 1, Depth = 4 };
+    }
+
+    /**
+     * @brief Tests that events and text messages decode to the text std::format would produce.
+     */
+    TEST(binary_logger, roundTrip) {
+        const std::string path = logPath("binary_logger_round_trip.blog");
+        {
+            binary_logger telemetry;
+            ASSERT_EQ(telemetry.open(path).status, Status::Success);
+            const std::uint16_t received = telemetry.registerFormat("device {} received frame {} after {:.1f} ms ({})");
+            EXPECT_EQ(telemetry.registerFormat("device {} received frame {} after {:.1f} ms ({})"), received);
+            const std::uint16_t kind = telemetry.registerFormat("kind {}, {{literal}}, {}|{}");
+
+            telemetry.event<logger::Info>(received, 3, 42u, 2.5, "depth");
+            telemetry.log(logger::Warning, "plain text");
+            telemetry.event<logger::Debug>(kind, frame_kind::Depth, std::string("ab"), -7);
+            telemetry.setLevel(logger::Info);
+            telemetry.event<logger::Debug>(kind, frame_kind::Color, "filtered");
+        }
+
+        binary_log_reader reader;
+        ASSERT_EQ(reader.open(path).status, Status::Success);
+        const std::vector<binary_log_record> records = reader.read();
+        ASSERT_EQ(records.size(), logger::min_level >= logger::Debug ? 3u : 2u);
+        EXPECT_EQ(records[0].text, "device 3 received frame 42 after 2.5 ms (depth)");
+        EXPECT_EQ(records[0].level, logger::Info);
+        EXPECT_EQ(records[0].thread_id, records[1].thread_id);
+        EXPECT_LE(records[0].timestamp_ns, records[1].timestamp_ns);
+        EXPECT_EQ(records[1].text, "plain text");
+        EXPECT_EQ(records[1].level, logger::Warning);
+        if (records.size() == 3) {
+            EXPECT_EQ(records[2].text, "kind 4, {literal}, ab|-7");
+        }
+
+        reader.close();
+        std::filesystem::remove(path);
+    }
+
+    /**
+     * @brief Tests that a wrapped ring keeps the newest records, each complete and in order.
+     */
+    TEST(binary_logger, wrapKeepsNewestRecords) {
+        const std::string path = logPath("binary_logger_wrap.blog");
+        constexpr std::uint64_t events = 20000;
+        {
+            binary_logger telemetry;
+            ASSERT_EQ(telemetry.open(path, 2 * binary_log::block_size).status, Status::Success);
+            const std::uint16_t id = telemetry.registerFormat("event {} on {}");
+            for (std::uint64_t i = 0; i < events; ++i)
+                telemetry.event<logger::Info>(id, i, i % 3 == 0 ? "a short string" : "s");
+            EXPECT_GT(telemetry.getWritePosition(), 4 * binary_log::block_size);
+        }
+
+        binary_log_reader reader;
+        ASSERT_EQ(reader.open(path).status, Status::Success);
+        const std::vector<binary_log_record> records = reader.read();
+        ASSERT_GT(records.size(), 1000u);
+        std::uint64_t expected = events - records.size();
+        for (const binary_log_record& record : records) {
+            EXPECT_EQ(record.text, std::format("event {} on {}", expected, expected % 3 == 0 ? "a short string" : "s"));
+            ++expected;
+        }
+
+        reader.close();
+        std::filesystem::remove(path);
+    }
+
+    /**
+     * @brief Tests that concurrent writers never lose or tear a record.
+     */
+    TEST(binary_logger, concurrentWriters) {
+        const std::string path = logPath("binary_logger_concurrent.blog");
+        constexpr int threads = 4;
+        constexpr int events = 5000;
+        {
+            binary_logger telemetry;
+            ASSERT_EQ(telemetry.open(path, 8u << 20).status, Status::Success);
+            const std::uint16_t id = telemetry.registerFormat("{} {}");
+            std::vector<std::thread> writers;
+            for (int thread = 0; thread < threads; ++thread)
+                writers.emplace_back([&, thread] {
+                    for (int i = 0; i < events; ++i)
+                        telemetry.event<logger::Info>(id, thread, i);
+                });
+            for (auto& writer : writers)
+                writer.join();
+        }
+
+        binary_log_reader reader;
+        ASSERT_EQ(reader.open(path).status, Status::Success);
+        const std::vector<binary_log_record> records = reader.read();
+        ASSERT_EQ(records.size(), static_cast<std::size_t>(threads * events));
+        std::vector<int> next(threads, 0);
+        for (const binary_log_record& record : records) {
+            int thread, i;
+            ASSERT_EQ(std::sscanf(record.text.c_str(), "%d %d", &thread, &i), 2);
+            EXPECT_EQ(i, next[thread]++);
+        }
+
+        reader.close();
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,131 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "logger/console_logger.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Redirects the console logger into a string stream for the lifetime of a test.
+         */
+        class captured_output {
+        public:
+            std::ostringstream stream;
+
+            captured_output()
+            {
+                ConsoleLogger::getInstance()->setStream(stream);
+            }
+
+            ~captured_output()
+            {
+                ConsoleLogger::getInstance()->stopAsync();
+                ConsoleLogger::getInstance()->setStream(std::cout);
+            }
+
+            std::vector<std::string> lines() const
+            {
+                std::vector<std::string> result;
+                std::istringstream input(stream.str());
+                for (std::string line; std::getline(input, line);)
+                    result.push_back(line);
+                return result;
+            }
+        };
+    }
+
+    /**
+     * @brief Tests that asynchronous records from several threads are all written, each thread's in order.
+     */
+    TEST(console_logger, asyncKeepsEveryRecordInThreadOrder) {
+        captured_output output;
+        ConsoleLogger* logger = ConsoleLogger::getInstance();
+        const std::uint64_t dropped_before = logger->getDroppedCount();
+        ASSERT_TRUE(logger->startAsync({64, log_overflow::Block, std::chrono::milliseconds(5)}));
+        EXPECT_FALSE(logger->startAsync());
+        EXPECT_TRUE(logger->isAsync());
+
+        constexpr int threads = 4;
+        constexpr int messages = 2000;
+        std::vector<std::thread> workers;
+        for (int thread = 0; thread < threads; ++thread)
+            workers.emplace_back([=] {
+                for (int i = 0; i < messages; ++i)
+                    logger->log(logger::Info, std::format("t{} m{}", thread, i));
+            });
+        for (auto& worker : workers)
+            worker.join();
+        logger->flush();
+
+        std::vector<int> next(threads, 0);
+        int count = 0;
+        for (const std::string& line : output.lines()) {
+            int thread, message;
+            ASSERT_EQ(std::sscanf(line.c_str(), "[Info] [Vision] t%d m%d", &thread, &message), 2) << line;
+            EXPECT_EQ(message, next[thread]++);
+            ++count;
+        }
+        EXPECT_EQ(count, threads * messages);
+        EXPECT_EQ(logger->getDroppedCount(), dropped_before);
+    }
+
+    /**
+     * @brief Tests that a full ring drops records under the Drop policy and reports how many.
+     */
+    TEST(console_logger, asyncDropsWhenFull) {
+        captured_output output;
+        ConsoleLogger* logger = ConsoleLogger::getInstance();
+        const std::uint64_t dropped_before = logger->getDroppedCount();
+        ASSERT_TRUE(logger->startAsync({8, log_overflow::Drop, std::chrono::seconds(10)}));
+
+        constexpr int messages = 100000;
+        for (int i = 0; i < messages; ++i)
+            logger->log(logger::Info, "burst");
+        logger->stopAsync();
+        EXPECT_FALSE(logger->isAsync());
+
+        const std::uint64_t dropped = logger->getDroppedCount() - dropped_before;
+        EXPECT_GT(dropped, 0u);
+        int written = 0;
+        bool reported = false;
+        for (const std::string& line : output.lines()) {
+            if (line == "[Info] [Vision] burst")
+                ++written;
+            else
+                reported |= line.find("log records dropped.") != std::string::npos;
+        }
+        EXPECT_EQ(written + dropped, static_cast<std::uint64_t>(messages));
+        EXPECT_TRUE(reported);
+    }
+
+    /**
+     * @brief Tests that stopping writes pending records, truncates long ones and returns to synchronous logging.
+     */
+    TEST(console_logger, stopWritesPendingRecords) {
+        captured_output output;
+        ConsoleLogger* logger = ConsoleLogger::getInstance();
+        ASSERT_TRUE(logger->startAsync({16, log_overflow::Drop, std::chrono::seconds(10)}));
+        logger->log(logger::Info, "first");
+        logger->log(logger::Debug, "filtered");
+        logger->log(logger::Warning, std::string(ConsoleLogger::record_text_size + 10, 'x'));
+        EXPECT_EQ(output.stream.str(), "");
+        logger->stopAsync();
+
+        logger->log(logger::Info, "synchronous");
+        const std::vector<std::string> lines = output.lines();
+        ASSERT_EQ(lines.size(), 3u);
+        EXPECT_EQ(lines[0], "[Info] [Vision] first");
+        EXPECT_EQ(lines[1], "[Warning] [Vision] " + std::string(ConsoleLogger::record_text_size, 'x') + "...");
+        EXPECT_EQ(lines[2], "[Info] [Vision] synchronous");
+    }
+}
@@ -0,0 +1,65 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "logger/logger.h"
+
+namespace vision
+{
+    namespace
+    {
+        /**
+         * @brief Keeps every logged message.
+         */
+        class recording_logger : public logger {
+        public:
+            std::vector<std::pair<Level, std::string>> messages;
+
+            void log(const Level level, const std::string& message) override
+            {
+                messages.emplace_back(level, message);
+            }
+        };
+    }
+
+    /**
+     * @brief Tests that the front-ends format their arguments at enabled levels.
+     */
+    TEST(logger, formatsEnabledLevels) {
+        recording_logger _logger;
+        _logger.setLevel(logger::Debug);
+        _logger.error("device {} failed", 3);
+        _logger.warning("{} of {}", 1, 2);
+        _logger.info("{}", std::string("info"));
+        _logger.debug("plain");
+
+        ASSERT_EQ(_logger.messages.size(), logger::min_level >= logger::Debug ? 4u : 3u);
+        EXPECT_EQ(_logger.messages[0], std::make_pair(logger::Error, std::string("device 3 failed")));
+        EXPECT_EQ(_logger.messages[1], std::make_pair(logger::Warning, std::string("1 of 2")));
+        EXPECT_EQ(_logger.messages[2], std::make_pair(logger::Info, std::string("info")));
+    }
+
+    /**
+     * @brief Tests that messages above the current level are not logged.
+     */
+    TEST(logger, skipsDisabledLevels) {
+        recording_logger _logger;
+        EXPECT_EQ(_logger.getLevel(), logger::getDefaultLevel());
+        _logger.setLevel(logger::Warning);
+        EXPECT_TRUE(_logger.isEnabled(logger::Error));
+        EXPECT_FALSE(_logger.isEnabled(logger::Info));
+
+        _logger.info("{}", 3);
+        _logger.logFormat<logger::Info>("{} {}", 1, 2);
+        _logger.debug("{}", 4);
+        EXPECT_TRUE(_logger.messages.empty());
+
+        _logger.setLevel(logger::None);
+        _logger.error("{}", 5);
+        EXPECT_TRUE(_logger.messages.empty());
+    }
+}
@@ -0,0 +1,342 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "net/stream_client.h"
+#include "net/stream_server.h"
+
+namespace vision
+{
+    namespace
+    {
+        using namespace std::chrono_literals;
+
+        frame_handle depthFrame(frame_pool& pool, const std::uint32_t sequence)
+        {
+            frame_handle frame = pool.acquire(libfreenect2::Frame::Depth);
+            if(!frame)
+                return frame;
+            frame->format = libfreenect2::Frame::Float;
+            frame->sequence = sequence;
+            frame->timestamp = sequence * 266;
+            auto* depth = reinterpret_cast<float*>(frame->data);
+            for(std::size_t i = 0; i < frame->width * frame->height; ++i)
+                depth[i] = static_cast<float>(500 + (i + sequence) % 4000);
+            frame.setArrivalTime(1000 + sequence);
+            return frame;
+        }
+
+        /**
+         * @brief Polls until the server has the expected number of clients.
+         */
+        bool waitForClients(const stream_server& server, const std::uint64_t count)
+        {
+            for(int i = 0; i < 200 && server.getStatistics().clients != count; ++i)
+                std::this_thread::sleep_for(5ms);
+            return server.getStatistics().clients == count;
+        }
+    }
+
+    /**
+     * @brief Tests that pooled frames arrive with their metadata and pixels, and only on subscribed streams.
+     */
+    TEST(stream_server, roundTrip) {
+        const auto pool = frame_pool::create({2, 1, 4});
+        stream_server server;
+        ASSERT_EQ(server.start().status, Status::Success);
+        ASSERT_NE(server.getPort(), 0);
+
+        stream_client client;
+        ASSERT_EQ(client.connect("127.0.0.1", server.getPort()).status, Status::Success);
+        ASSERT_TRUE(waitForClients(server, 1));
+        // Nothing is sent before a subscription.
+        EXPECT_FALSE(server.publish(0, depthFrame(*pool, 0)));
+        ASSERT_EQ(client.subscribe(libfreenect2::Frame::Depth | libfreenect2::Frame::Color).status, Status::Success);
+
+        bool queued = false;
+        for(int i = 0; i < 200 && !queued; ++i)
+        {
+            queued = server.publish(3, depthFrame(*pool, 1));
+            std::this_thread::sleep_for(5ms);
+        }
+        ASSERT_TRUE(queued);
+        frame_handle color = pool->acquire(libfreenect2::Frame::Color);
+        color->format = libfreenect2::Frame::BGRX;
+        color->exposure = 1.5f;
+        std::memset(color->data, 0x5a, color->width * color->height * 4);
+        EXPECT_TRUE(server.publish(3, color));
+        EXPECT_FALSE(server.publish(3, pool->acquire(libfreenect2::Frame::Ir)));
+
+        received_frame frame;
+        ASSERT_EQ(client.receive(frame).status, Status::Success);
+        EXPECT_EQ(frame.header.type, libfreenect2::Frame::Depth);
+        EXPECT_EQ(frame.header.format, libfreenect2::Frame::Float);
+        EXPECT_EQ(frame.header.device_id, 3);
+        EXPECT_EQ(frame.header.sequence, 1u);
+        EXPECT_EQ(frame.header.timestamp, 266u);
+        EXPECT_EQ(frame.header.arrival_ns, 1001);
+        EXPECT_EQ(frame.header.width, 512u);
+        EXPECT_EQ(frame.header.height, 424u);
+        ASSERT_EQ(frame.payload.size(), 512u * 424 * 4);
+        const frame_handle expected = depthFrame(*pool, 1);
+        EXPECT_EQ(std::memcmp(frame.payload.data(), expected->data, frame.payload.size()), 0);
+
+        ASSERT_EQ(client.receive(frame).status, Status::Success);
+        EXPECT_EQ(frame.header.type, libfreenect2::Frame::Color);
+        EXPECT_EQ(frame.header.format, libfreenect2::Frame::BGRX);
+        EXPECT_FLOAT_EQ(frame.header.exposure, 1.5f);
+        ASSERT_EQ(frame.payload.size(), 1920u * 1080 * 4);
+        EXPECT_EQ(frame.payload[12345], 0x5a);
+        EXPECT_EQ(client.receive(frame, 50ms).status, Status::Timeout);
+        EXPECT_TRUE(client.isConnected());
+
+        EXPECT_EQ(server.stop().status, Status::Success);
+        EXPECT_EQ(client.receive(frame).status, Status::Error);
+        EXPECT_FALSE(client.isConnected());
+    }
+
+    /**
+     * @brief Tests that an attached server streams bus frames from its publishing thread and releases them on stop.
+     */
+    TEST(stream_server, streamsBusFrames) {
+        const auto pool = frame_pool::create({0, 0, frame_scheduler::pull_capacity + 4});
+        frame_scheduler scheduler;
+        frame_bus bus(scheduler);
+        frame_scheduler::source* source = scheduler.attach(6);
+        stream_server_config config;
+        config.bus_queue_depth = 8;
+        config.max_queued_frames = 8;
+        stream_server server(config);
+        ASSERT_EQ(server.start().status, Status::Success);
+        ASSERT_EQ(server.attach(bus).status, Status::Success);
+        EXPECT_EQ(server.attach(bus).status, Status::Conflict);
+
+        stream_client client;
+        ASSERT_EQ(client.connect("127.0.0.1", server.getPort()).status, Status::Success);
+        ASSERT_TRUE(waitForClients(server, 1));
+        client.subscribe(libfreenect2::Frame::Depth);
+
+        // Frame 0 is repeated until the subscription is in.
+        received_frame frame;
+        bool first = false;
+        for(int i = 0; i < 200 && !first; ++i)
+        {
+            source->deliver(depthFrame(*pool, 0));
+            first = client.receive(frame, 20ms).status == Status::Success;
+        }
+        ASSERT_TRUE(first);
+        while(client.receive(frame, 50ms).status == Status::Success)
+            EXPECT_EQ(frame.header.sequence, 0u);
+
+        for(std::uint32_t i = 1; i <= 4; ++i)
+            source->deliver(depthFrame(*pool, i));
+        for(std::uint32_t i = 1; i <= 4; ++i)
+        {
+            ASSERT_EQ(client.receive(frame).status, Status::Success);
+            EXPECT_EQ(frame.header.device_id, 6);
+            EXPECT_EQ(frame.header.sequence, i);
+            const frame_handle expected = depthFrame(*pool, i);
+            ASSERT_EQ(frame.payload.size(), 512u * 424 * 4);
+            EXPECT_EQ(std::memcmp(frame.payload.data(), expected->data, frame.payload.size()), 0);
+        }
+
+        EXPECT_EQ(server.stop().status, Status::Success);
+        EXPECT_EQ(bus.subscriberCount(), 0u);
+        scheduler.detach(6);
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), frame_scheduler::pull_capacity + 4);
+    }
+
+    /**
+     * @brief Tests that clients that do not read lose frames without holding back another client or capture.
+     */
+    TEST(stream_server, slowClientDrops) {
+        // The default pool, as a capture has it: stalled clients must not take its buffers.
+        const auto pool = frame_pool::create();
+        stream_server_config config;
+        config.socket_buffer = 64u << 10;
+        stream_server server(config);
+        ASSERT_EQ(server.start().status, Status::Success);
+
+        constexpr int stalled_count = 3;
+        stream_client fast, stalled[stalled_count];
+        ASSERT_EQ(fast.connect("127.0.0.1", server.getPort()).status, Status::Success);
+        for(stream_client& client : stalled)
+            ASSERT_EQ(client.connect("127.0.0.1", server.getPort()).status, Status::Success);
+        ASSERT_TRUE(waitForClients(server, stalled_count + 1));
+        fast.subscribe(libfreenect2::Frame::Depth);
+        for(stream_client& client : stalled)
+            client.subscribe(libfreenect2::Frame::Depth);
+        // Frame 0 is repeated until the subscriptions are in; stalled clients may count it more than once.
+        std::this_thread::sleep_for(50ms);
+        received_frame frame;
+        std::uint32_t attempts = 0;
+        bool first = false;
+        while(attempts < 200 && !first)
+        {
+            server.publish(0, depthFrame(*pool, 0));
+            ++attempts;
+            first = fast.receive(frame, 20ms).status == Status::Success;
+        }
+        ASSERT_TRUE(first);
+
+        constexpr std::uint32_t frames = 60;
+        std::uint32_t received = 0, reported = 0, last = 0;
+        for(std::uint32_t i = 1; i <= frames; ++i)
+        {
+            frame_handle depth = depthFrame(*pool, i);
+            ASSERT_TRUE(depth) << "capture ran out of pooled buffers at frame " << i;
+            server.publish(0, depth);
+            depth.reset();
+            while(received < i && fast.receive(frame, 500ms).status == Status::Success)
+            {
+                reported += frame.header.dropped;
+                last = frame.header.sequence;
+                received = last;
+            }
+        }
+        EXPECT_EQ(last, frames);
+        EXPECT_EQ(reported, 0u);
+
+        // The stalled sockets filled up long ago, so those clients lost frames, were served from copies and are told how many.
+        const stream_server_statistics statistics = server.getStatistics();
+        EXPECT_GT(statistics.dropped, 0u);
+        EXPECT_GT(statistics.copied, 0u);
+        std::uint64_t stalled_reported = 0;
+        for(stream_client& client : stalled)
+        {
+            std::uint32_t client_received = 0, client_reported = 0;
+            while(client.receive(frame, 200ms).status == Status::Success)
+            {
+                ++client_received;
+                client_reported += frame.header.dropped;
+            }
+            EXPECT_GE(client_received + client_reported, frames);
+            EXPECT_LE(client_received + client_reported, frames + attempts);
+            stalled_reported += client_reported;
+        }
+        EXPECT_EQ(stalled_reported, statistics.dropped);
+    }
+
+    /**
+     * @brief Tests frame-rate limits, point clouds and compressed depth frames.
+     */
+    TEST(stream_server, pacingCloudsAndCompression) {
+        const auto pool = frame_pool::create({0, 0, 4});
+        stream_server_config config;
+        config.compress_depth = true;
+        config.depth_codec.threads = 2;
+        stream_server server(config);
+        ASSERT_EQ(server.start().status, Status::Success);
+
+        stream_client client;
+        ASSERT_EQ(client.connect("127.0.0.1", server.getPort()).status, Status::Success);
+        ASSERT_TRUE(waitForClients(server, 1));
+        client.subscribe(libfreenect2::Frame::Depth | stream::cloud_type, 5, 2);
+
+        point_cloud cloud;
+        cloud.resize(4, 2, true);
+        for(std::size_t i = 0; i < cloud.size(); ++i)
+        {
+            cloud.x[i] = static_cast<float>(i);
+            cloud.y[i] = -static_cast<float>(i);
+            cloud.z[i] = 1.0f;
+            cloud.rgb[i] = 0.5f;
+        }
+        bool queued = false;
+        for(int i = 0; i < 200 && !queued; ++i)
+        {
+            queued = server.publishCloud(2, cloud, 7, 99);
+            std::this_thread::sleep_for(5ms);
+        }
+        ASSERT_TRUE(queued);
+        // A 5 fps limit lets only the first of these depth frames through, and other devices are filtered.
+        EXPECT_TRUE(server.publish(2, depthFrame(*pool, 1)));
+        EXPECT_FALSE(server.publish(2, depthFrame(*pool, 2)));
+        EXPECT_FALSE(server.publish(1, depthFrame(*pool, 3)));
+
+        received_frame frame;
+        ASSERT_EQ(client.receive(frame).status, Status::Success);
+        EXPECT_EQ(frame.header.type, stream::cloud_type);
+        EXPECT_EQ(frame.header.bytes_per_pixel, 16u);
+        EXPECT_EQ(frame.header.sequence, 7u);
+        ASSERT_EQ(frame.payload.size(), 8u * 16);
+        const auto* planes = reinterpret_cast<const float*>(frame.payload.data());
+        EXPECT_EQ(planes[3], 3.0f);
+        EXPECT_EQ(planes[8 + 3], -3.0f);
+        EXPECT_EQ(planes[16 + 3], 1.0f);
+        EXPECT_EQ(planes[24 + 3], 0.5f);
+
+        ASSERT_EQ(client.receive(frame).status, Status::Success);
+        EXPECT_EQ(frame.header.format, stream::compressed_depth_format);
+        EXPECT_EQ(frame.header.sequence, 1u);
+        EXPECT_LT(frame.payload.size(), 512u * 424 * 4);
+        std::vector<float> depth(512 * 424);
+        depth_codec codec;
+        ASSERT_EQ(codec.decode(frame.payload.data(), frame.payload.size(), depth.data(), depth.size()).status,
+                  Status::Success);
+        const frame_handle expected = depthFrame(*pool, 1);
+        EXPECT_EQ(std::memcmp(depth.data(), expected->data, depth.size() * sizeof(float)), 0);
+        EXPECT_EQ(client.receive(frame, 50ms).status, Status::Timeout);
+    }
+
+    /**
+     * @brief Tests that batches sent with MSG_ZEROCOPY arrive with their own headers while the queues are reused.
+     */
+    TEST(stream_server, zerocopyBatchHeaders) {
+        stream_server_config config;
+        config.max_queued_frames = 16;
+        config.max_batch = 16;
+        config.zerocopy_threshold = 1;
+        stream_server server(config);
+        ASSERT_EQ(server.start().status, Status::Success);
+
+        stream_client client;
+        ASSERT_EQ(client.connect("127.0.0.1", server.getPort()).status, Status::Success);
+        ASSERT_TRUE(waitForClients(server, 1));
+        client.subscribe(stream::cloud_type);
+
+        point_cloud cloud;
+        cloud.resize(64, 4, false);
+        bool queued = false;
+        for(int i = 0; i < 200 && !queued; ++i)
+        {
+            queued = server.publishCloud(5, cloud, 0, 0);
+            std::this_thread::sleep_for(5ms);
+        }
+        ASSERT_TRUE(queued);
+        received_frame frame;
+        ASSERT_EQ(client.receive(frame).status, Status::Success);
+
+        // Every round fills the queue again while the messages of the last batch may still wait for completion.
+        for(std::uint32_t round = 0; round < 4; ++round)
+        {
+            for(std::uint32_t i = 1; i <= 16; ++i)
+            {
+                const std::uint32_t sequence = round * 16 + i;
+                cloud.z[0] = static_cast<float>(sequence);
+                ASSERT_TRUE(server.publishCloud(5, cloud, sequence, sequence));
+            }
+            for(std::uint32_t i = 1; i <= 16; ++i)
+            {
+                const std::uint32_t sequence = round * 16 + i;
+                ASSERT_EQ(client.receive(frame).status, Status::Success);
+                EXPECT_EQ(frame.header.type, stream::cloud_type);
+                EXPECT_EQ(frame.header.device_id, 5);
+                EXPECT_EQ(frame.header.sequence, sequence);
+                EXPECT_EQ(frame.header.arrival_ns, sequence);
+                EXPECT_EQ(frame.header.width, 64u);
+                EXPECT_EQ(frame.header.height, 4u);
+                EXPECT_EQ(frame.header.bytes_per_pixel, 12u);
+                ASSERT_EQ(frame.payload.size(), 256u * 12);
+                EXPECT_EQ(reinterpret_cast<const float*>(frame.payload.data())[2 * 256], static_cast<float>(sequence));
+            }
+        }
+        EXPECT_EQ(server.getStatistics().dropped, 0u);
+    }
+}
@@ -0,0 +1,221 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include "recorder/frame_recorder.h"
+#include "recorder/recording_reader.h"
+
+namespace vision
+{
+    namespace
+    {
+        std::string recordingPath(const std::string& name)
+        {
+            return (std::filesystem::temp_directory_path() / name).string();
+        }
+
+        void removeRecording(const std::string& path)
+        {
+            std::filesystem::remove(recording::dataPath(path));
+            std::filesystem::remove(recording::indexPath(path));
+        }
+
+        void fill(libfreenect2::Frame& frame, const std::uint32_t seed)
+        {
+            const std::size_t size = frame.width * frame.height * frame.bytes_per_pixel;
+            for (std::size_t i = 0; i < size; ++i)
+                frame.data[i] = static_cast<unsigned char>(seed * 31 + i * 7);
+        }
+    }
+
+    /**
+     * @brief Tests that recorded frames come back from the mapped reader with their metadata and payload.
+     */
+    TEST(frame_recorder, roundTrip) {
+        const std::string path = recordingPath("frame_recorder_round_trip");
+        recorder_config config;
+        // A 2 MiB chunk holds two depth frames, so the recording spans several chunks; 16 of them
+        // buffer the whole recording, so a slow disk cannot make the recorder drop frames.
+        config.chunk_size = 2u << 20;
+        config.chunk_count = 16;
+        config.frame_types = libfreenect2::Frame::Depth | libfreenect2::Frame::Color;
+
+        libfreenect2::Frame depth(512, 424, 4);
+        libfreenect2::Frame color(64, 48, 4);
+        constexpr std::uint32_t frames = 20;
+        {
+            frame_recorder recorder(config);
+            ASSERT_EQ(recorder.open(path).status, Status::Success);
+            for (std::uint32_t i = 0; i < frames; ++i) {
+                depth.sequence = i;
+                depth.timestamp = i * 266;
+                fill(depth, i);
+                EXPECT_TRUE(recorder.record(i % 2, depth, libfreenect2::Frame::Depth, 1000 + i));
+                color.sequence = i;
+                color.exposure = 1.5f;
+                fill(color, i + 100);
+                EXPECT_TRUE(recorder.record(i % 2, color, libfreenect2::Frame::Color, 2000 + i));
+                EXPECT_FALSE(recorder.record(i % 2, depth, libfreenect2::Frame::Ir, 0));
+            }
+            ASSERT_EQ(recorder.close().status, Status::Success);
+            EXPECT_EQ(recorder.getStatistics().frames_written, 2 * frames);
+            EXPECT_EQ(recorder.getStatistics().dropped, 0u);
+        }
+
+        recording_reader reader;
+        ASSERT_EQ(reader.open(path).status, Status::Success);
+        ASSERT_EQ(reader.size(), 2 * frames);
+
+        for (std::uint32_t i = 0; i < frames; ++i) {
+            const recording::index_entry& entry = reader.entry(2 * i);
+            EXPECT_EQ(entry.device_id, static_cast<std::int32_t>(i % 2));
+            EXPECT_EQ(entry.type, static_cast<std::uint32_t>(libfreenect2::Frame::Depth));
+            EXPECT_EQ(entry.sequence, i);
+            EXPECT_EQ(entry.timestamp, i * 266);
+            EXPECT_EQ(entry.arrival_ns, 1000 + i);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(reader.payload(2 * i)) % recording::payload_alignment, 0u);
+
+            depth.sequence = i;
+            fill(depth, i);
+            EXPECT_EQ(std::memcmp(reader.payload(2 * i), depth.data, entry.size), 0);
+
+            libfreenect2::Frame view(0, 0, 0, nullptr);
+            reader.view(2 * i + 1, view);
+            EXPECT_EQ(view.width, 64u);
+            EXPECT_EQ(view.height, 48u);
+            EXPECT_FLOAT_EQ(view.exposure, 1.5f);
+            fill(color, i + 100);
+            EXPECT_EQ(std::memcmp(view.data, color.data, 64 * 48 * 4), 0);
+        }
+
+        EXPECT_EQ(reader.next(1, 1, libfreenect2::Frame::Depth), 2u);
+        EXPECT_FALSE(reader.next(0, 5, libfreenect2::Frame::Depth).has_value());
+        EXPECT_EQ(reader.seek(reader.entry(7).record_ns), 7u);
+        EXPECT_EQ(reader.seek(reader.entry(2 * frames - 1).record_ns + 1), 2 * frames);
+
+        reader.close();
+        removeRecording(path);
+    }
+
+    /**
+     * @brief Tests that a partly written index entry, as left by a crash, is ignored.
+     */
+    TEST(frame_recorder, truncatedIndexIsIgnored) {
+        const std::string path = recordingPath("frame_recorder_truncated");
+        libfreenect2::Frame depth(512, 424, 4);
+        fill(depth, 1);
+        {
+            frame_recorder recorder;
+            ASSERT_EQ(recorder.open(path).status, Status::Success);
+            for (int i = 0; i < 3; ++i)
+                recorder.record(0, depth, libfreenect2::Frame::Depth, i);
+            recorder.close();
+        }
+        const auto index_size = std::filesystem::file_size(recording::indexPath(path));
+        std::filesystem::resize_file(recording::indexPath(path), index_size - 10);
+
+        recording_reader reader;
+        ASSERT_EQ(reader.open(path).status, Status::Success);
+        EXPECT_EQ(reader.size(), 2u);
+        reader.close();
+        removeRecording(path);
+    }
+
+    /**
+     * @brief Tests that an attached recorder records scheduled frames without holding on to pooled buffers.
+     */
+    TEST(frame_recorder, recordsScheduledFrames) {
+        const std::string path = recordingPath("frame_recorder_scheduled");
+        auto pool = frame_pool::create({0, 0, frame_scheduler::pull_capacity + 1});
+        frame_scheduler scheduler;
+        frame_scheduler::source* source = scheduler.attach(4);
+
+        recorder_config config;
+        config.device_ids = {4};
+        frame_recorder recorder(config);
+        ASSERT_EQ(recorder.open(path).status, Status::Success);
+        ASSERT_EQ(recorder.attach(scheduler).status, Status::Success);
+
+        for (std::uint32_t i = 0; i < 10; ++i) {
+            frame_handle frame = pool->acquire(libfreenect2::Frame::Depth);
+            ASSERT_TRUE(frame);
+            frame->sequence = i;
+            source->deliver(frame);
+        }
+        recorder.flush();
+        EXPECT_EQ(recorder.getStatistics().frames_written, 10u);
+        ASSERT_EQ(recorder.close().status, Status::Success);
+
+        scheduler.detach(4);
+        EXPECT_EQ(pool->freeCount(libfreenect2::Frame::Depth), frame_scheduler::pull_capacity + 1);
+
+        recording_reader reader;
+        ASSERT_EQ(reader.open(path).status, Status::Success);
+        ASSERT_EQ(reader.size(), 10u);
+        EXPECT_EQ(reader.entry(9).sequence, 9u);
+        reader.close();
+        removeRecording(path);
+    }
+
+    /**
+     * @brief Tests that compressed depth frames are smaller on disk and read back quantized to millimeters.
+     */
+    TEST(frame_recorder, compressedDepth) {
+        const std::string path = recordingPath("frame_recorder_compressed");
+        recorder_config config;
+        config.compress_depth = true;
+        config.depth_codec.threads = 2;
+        config.frame_types = libfreenect2::Frame::Depth | libfreenect2::Frame::Color;
+
+        libfreenect2::Frame depth(512, 424, 4);
+        depth.format = libfreenect2::Frame::Float;
+        auto* depths = reinterpret_cast<float*>(depth.data);
+        for (std::size_t i = 0; i < 512 * 424; ++i)
+            depths[i] = i % 13 == 0 ? 0.0f : 1500.0f + static_cast<float>(i % 512) * 0.7f;
+        libfreenect2::Frame color(64, 48, 4);
+        color.format = libfreenect2::Frame::BGRX;
+        fill(color, 7);
+        {
+            frame_recorder recorder(config);
+            ASSERT_EQ(recorder.open(path).status, Status::Success);
+            for (std::uint32_t i = 0; i < 3; ++i) {
+                depth.sequence = i;
+                EXPECT_TRUE(recorder.record(0, depth, libfreenect2::Frame::Depth, 100 + i));
+            }
+            EXPECT_TRUE(recorder.record(0, color, libfreenect2::Frame::Color, 200));
+            ASSERT_EQ(recorder.close().status, Status::Success);
+            EXPECT_EQ(recorder.getStatistics().compressed_frames, 3u);
+            EXPECT_GT(recorder.getStatistics().bytes_saved, 3u * 512 * 424 * 2);
+        }
+
+        recording_reader reader;
+        ASSERT_EQ(reader.open(path).status, Status::Success);
+        ASSERT_EQ(reader.size(), 4u);
+        ASSERT_TRUE(reader.isCompressed(2));
+        EXPECT_LT(reader.entry(2).size, 512u * 424 * 2);
+
+        std::vector<float> decoded(512 * 424);
+        libfreenect2::Frame target(0, 0, 0, reinterpret_cast<unsigned char*>(decoded.data()));
+        EXPECT_EQ(reader.read(2, target, 100).status, Status::InvalidParam);
+        ASSERT_EQ(reader.read(2, target, decoded.size() * sizeof(float)).status, Status::Success);
+        EXPECT_EQ(target.format, libfreenect2::Frame::Float);
+        EXPECT_EQ(target.width, 512u);
+        EXPECT_EQ(target.sequence, 2u);
+        EXPECT_EQ(target.data, reinterpret_cast<unsigned char*>(decoded.data()));
+        for (std::size_t i = 0; i < decoded.size(); ++i)
+            ASSERT_EQ(decoded[i], std::nearbyint(depths[i])) << "pixel " << i;
+
+        ASSERT_FALSE(reader.isCompressed(3));
+        ASSERT_EQ(reader.read(3, target, decoded.size() * sizeof(float)).status, Status::Success);
+        EXPECT_EQ(target.format, libfreenect2::Frame::BGRX);
+        EXPECT_EQ(std::memcmp(target.data, color.data, 64 * 48 * 4), 0);
+
+        reader.close();
+        removeRecording(path);
+    }
+}
@@ -0,0 +1,47 @@
+//
+// Created by Serdar on 17.10.2026.
+//
+
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include "logger/binary_log_reader.h"
+
+using namespace vision;
+
+/**
+ * @brief Prints the records of a binary_logger file as text, oldest first.
+ *
+ * Usage: binary_log_decode <file>
+ */
+int main(int argc, char *argv[])
+{
+    if(argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <file>" << std::endl;
+        return 2;
+    }
+
+    binary_log_reader reader;
+    if(const Result result = reader.open(argv[1]); result.status != Status::Success)
+    {
+        std::cerr << result.message << std::endl;
+        return 1;
+    }
+
+    for(const binary_log_record& record : reader.read())
+    {
+        const std::time_t seconds = record.timestamp_ns / 1000000000;
+        std::tm time{};
+        localtime_r(&seconds, &time);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &time);
+        char fraction[16];
+        std::snprintf(fraction, sizeof(fraction), ".%06lld",
+                      static_cast<long long>(record.timestamp_ns % 1000000000 / 1000));
+
+        std::cout << date << fraction << " [" << logger::getLevelString(record.level) << "] ["
+                  << record.thread_id << "] " << record.text << '\n';
+    }
+    return 0;
+}